@@ -431,6 +431,10 @@ SOURCE=..\..\src\common\threadinfo.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\src\common\threadpool.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\src\common\time.cpp
 # End Source File
 # Begin Source File
@@ -1361,6 +1365,10 @@ SOURCE=..\..\include\wx\thread.h
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\include\wx\threadpool.h
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\include\wx\time.h
 # End Source File
 # Begin Source File
@@ -173,6 +173,22 @@ if (entry.get() != NULL)
 }
 @endcode
 
+For zips on seekable streams, wxZipInputStream::FindEntry() can be used
+instead. It looks the entry up in the zip's central directory without reading
+the entries preceding it, which is much faster for big archives:
+
+@code
+wxFFileInputStream in(wxT("test.zip"));
+wxZipInputStream zip(in);
+
+auto_ptr<wxZipEntry> entry(zip.FindEntry(localname));
+
+if (entry.get() != NULL && zip.OpenEntry(*entry))
+{
+    // read the entry's data...
+}
+@endcode
+
 To access several entries randomly, it is most efficient to transfer the entire
 catalogue of entries to a container such as a std::map or a wxHashMap then
 entries looked up by name can be opened using the
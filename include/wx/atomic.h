@@ -18,9 +18,8 @@
 #include "wx/defs.h"
 
 // constraints on the various functions:
-//  - wxAtomicDec must return a zero value if the value is zero once
-//  decremented else it must return any non-zero value (the true value is OK
-//  but not necessary).
+//  - wxAtomicInc, wxAtomicDec and wxAtomicAdd must return the new value of the
+//  variable, i.e. its value after the modification.
 
 #if wxUSE_THREADS
 
@@ -31,9 +30,9 @@
 //     http://bugs.mysql.com/bug.php?id=28456
 //     http://golubenco.org/blog/atomic-operations/
 
-inline void wxAtomicInc (wxUint32 &value)
+inline wxUint32 wxAtomicInc (wxUint32 &value)
 {
-    __sync_fetch_and_add(&value, 1);
+    return __sync_add_and_fetch(&value, 1);
 }
 
 inline wxUint32 wxAtomicDec (wxUint32 &value)
@@ -41,15 +40,20 @@ inline wxUint32 wxAtomicDec (wxUint32 &value)
     return __sync_sub_and_fetch(&value, 1);
 }
 
+inline wxUint32 wxAtomicAdd (wxUint32 &value, wxInt32 delta)
+{
+    return __sync_add_and_fetch(&value, delta);
+}
+
 
 #elif defined(__WINDOWS__)
 
 // include standard Windows headers
 #include "wx/msw/wrapwin.h"
 
-inline void wxAtomicInc (wxUint32 &value)
+inline wxUint32 wxAtomicInc (wxUint32 &value)
 {
-    InterlockedIncrement ((LONG*)&value);
+    return InterlockedIncrement ((LONG*)&value);
 }
 
 inline wxUint32 wxAtomicDec (wxUint32 &value)
@@ -57,12 +61,18 @@ inline wxUint32 wxAtomicDec (wxUint32 &value)
     return InterlockedDecrement ((LONG*)&value);
 }
 
+inline wxUint32 wxAtomicAdd (wxUint32 &value, wxInt32 delta)
+{
+    // InterlockedExchangeAdd() returns the initial value
+    return InterlockedExchangeAdd ((LONG*)&value, delta) + delta;
+}
+
 #elif defined(__WXMAC__) || defined(__DARWIN__)
 
 #include "libkern/OSAtomic.h"
-inline void wxAtomicInc (wxUint32 &value)
+inline wxUint32 wxAtomicInc (wxUint32 &value)
 {
-    OSAtomicIncrement32 ((int32_t*)&value);
+    return OSAtomicIncrement32 ((int32_t*)&value);
 }
 
 inline wxUint32 wxAtomicDec (wxUint32 &value)
@@ -70,13 +80,18 @@ inline wxUint32 wxAtomicDec (wxUint32 &value)
     return OSAtomicDecrement32 ((int32_t*)&value);
 }
 
+inline wxUint32 wxAtomicAdd (wxUint32 &value, wxInt32 delta)
+{
+    return OSAtomicAdd32 (delta, (int32_t*)&value);
+}
+
 #elif defined (__SOLARIS__)
 
 #include <atomic.h>
 
-inline void wxAtomicInc (wxUint32 &value)
+inline wxUint32 wxAtomicInc (wxUint32 &value)
 {
-    atomic_add_32 ((uint32_t*)&value, 1);
+    return atomic_add_32_nv ((uint32_t*)&value, 1);
 }
 
 inline wxUint32 wxAtomicDec (wxUint32 &value)
@@ -84,6 +99,11 @@ inline wxUint32 wxAtomicDec (wxUint32 &value)
     return atomic_add_32_nv ((uint32_t*)&value, (uint32_t)-1);
 }
 
+inline wxUint32 wxAtomicAdd (wxUint32 &value, wxInt32 delta)
+{
+    return atomic_add_32_nv ((uint32_t*)&value, delta);
+}
+
 #else // unknown platform
 
 // it will result in inclusion if the generic implementation code a bit later in this page
@@ -94,8 +114,9 @@ inline wxUint32 wxAtomicDec (wxUint32 &value)
 #else // else of wxUSE_THREADS
 // if no threads are used we can safely use simple ++/--
 
-inline void wxAtomicInc (wxUint32 &value) { ++value; }
+inline wxUint32 wxAtomicInc (wxUint32 &value) { return ++value; }
 inline wxUint32 wxAtomicDec (wxUint32 &value) { return --value; }
+inline wxUint32 wxAtomicAdd (wxUint32 &value, wxInt32 delta) { return value += delta; }
 
 #endif // !wxUSE_THREADS
 
@@ -120,10 +141,10 @@ public:
 
     wxAtomicInt32& operator=(wxInt32 v) { m_value = v; return *this; }
 
-    void Inc()
+    wxInt32 Inc()
     {
         wxCriticalSectionLocker lock(m_locker);
-        ++m_value;
+        return ++m_value;
     }
 
     wxInt32 Dec()
@@ -132,20 +153,28 @@ public:
         return --m_value;
     }
 
+    wxInt32 Add(wxInt32 delta)
+    {
+        wxCriticalSectionLocker lock(m_locker);
+        return m_value += delta;
+    }
+
 private:
     volatile wxInt32  m_value;
     wxCriticalSection m_locker;
 };
 
-inline void wxAtomicInc(wxAtomicInt32 &value) { value.Inc(); }
+inline wxInt32 wxAtomicInc(wxAtomicInt32 &value) { return value.Inc(); }
 inline wxInt32 wxAtomicDec(wxAtomicInt32 &value) { return value.Dec(); }
+inline wxInt32 wxAtomicAdd(wxAtomicInt32 &value, wxInt32 delta) { return value.Add(delta); }
 
 #else // !wxNEEDS_GENERIC_ATOMIC_OPS
 
 #define wxHAS_ATOMIC_OPS
 
-inline void wxAtomicInc(wxInt32 &value) { wxAtomicInc((wxUint32&)value); }
+inline wxInt32 wxAtomicInc(wxInt32 &value) { return wxAtomicInc((wxUint32&)value); }
 inline wxInt32 wxAtomicDec(wxInt32 &value) { return wxAtomicDec((wxUint32&)value); }
+inline wxInt32 wxAtomicAdd(wxInt32 &value, wxInt32 delta) { return wxAtomicAdd((wxUint32&)value, delta); }
 
 typedef wxInt32 wxAtomicInt32;
 
@@ -3305,6 +3305,26 @@ protected:
     wxDECLARE_NO_COPY_CLASS(wxEventHashTable);
 };
 
+// ----------------------------------------------------------------------------
+// wxPendingEventsStats: counters of the events queued for later processing
+// ----------------------------------------------------------------------------
+
+struct wxPendingEventsStats
+{
+    wxPendingEventsStats() : queued(0), coalesced(0), dropped(0) { }
+
+    // number of events passed to QueueEvent() or QueueOrReplaceEvent()
+    unsigned long queued;
+
+    // number of events replaced by QueueOrReplaceEvent() before they could
+    // be processed
+    unsigned long coalesced;
+
+    // number of events deleted without being processed, e.g. because their
+    // handler was destroyed
+    unsigned long dropped;
+};
+
 // ----------------------------------------------------------------------------
 // wxEvtHandler: the base class for all objects handling wxWidgets events
 // ----------------------------------------------------------------------------
@@ -3382,6 +3402,16 @@ public:
     // buffer as other wxString objects in this thread.
     virtual void QueueEvent(wxEvent *event);
 
+    // Same as QueueEvent() but if an event with the same type and id is
+    // still pending, replace it with the new one instead of appending it.
+    // This is useful for the events such as progress notifications for which
+    // only the latest one matters.
+    void QueueOrReplaceEvent(wxEvent *event);
+
+    // Get or reset the counters of the events queued by all handlers.
+    static wxPendingEventsStats GetPendingEventsStats();
+    static void ResetPendingEventsStats();
+
     // Add an event to be processed later: notice that this function is not
     // safe to call from threads other than main, use QueueEvent()
     virtual void AddPendingEvent(const wxEvent& event)
@@ -3602,7 +3632,12 @@ public:
     }
 #endif // wxHAS_EVENT_BIND
 
-    wxList* GetDynamicEventTable() const { return m_dynamicEvents ; }
+    // Iterate over all the dynamic event table entries, i.e. the handlers
+    // added by Bind() or Connect(), in an unspecified order. The cookie is
+    // used by these functions internally and must not be modified, NULL is
+    // returned once there are no more entries.
+    wxDynamicEventTableEntry* GetFirstDynamicEntry(size_t& cookie) const;
+    wxDynamicEventTableEntry* GetNextDynamicEntry(size_t& cookie) const;
 
     // User data can be associated with each wxEvtHandler
     void SetClientObject( wxClientData *data ) { DoSetClientObject(data); }
@@ -3646,9 +3681,17 @@ private:
                       const wxEventFunctor& func,
                       wxObject *userData = NULL);
 
+    // common part of QueueEvent() and QueueOrReplaceEvent()
+    void DoQueueEvent(wxEvent *event, bool replace);
+
     static const wxEventTableEntry sm_eventTableEntries[];
 
 protected:
+    // The types of m_dynamicEvents and m_pendingEvents, only defined in the
+    // implementation.
+    class DynamicEvents;
+    class PendingEvents;
+
     // hooks for wxWindow used by ProcessEvent()
     // -----------------------------------------
 
@@ -3695,8 +3738,8 @@ protected:
 
     wxEvtHandler*       m_nextHandler;
     wxEvtHandler*       m_previousHandler;
-    wxList*             m_dynamicEvents;
-    wxList*             m_pendingEvents;
+    DynamicEvents*      m_dynamicEvents;
+    PendingEvents*      m_pendingEvents;
 
 #if wxUSE_THREADS
     // critical section protecting m_pendingEvents
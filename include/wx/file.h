@@ -2,6 +2,7 @@
 // Name:        wx/file.h
 // Purpose:     wxFile - encapsulates low-level "file descriptor"
 //              wxTempFile - safely replace the old file
+//              wxMappedFile - access the file contents in memory
 // Author:      Vadim Zeitlin
 // Modified by:
 // Created:     29/01/98
@@ -185,6 +186,52 @@ private:
   wxFile    m_file;     // the temporary file
 };
 
+// ----------------------------------------------------------------------------
+// class wxMappedFile: read-only access to the entire file contents in memory,
+// mapping the file into the process address space if possible or reading it
+// otherwise
+// ----------------------------------------------------------------------------
+
+class WXDLLIMPEXP_BASE wxMappedFile
+{
+public:
+  // ctors
+  wxMappedFile() { Init(); }
+  wxMappedFile(const wxString& filename) { Init(); Open(filename); }
+  wxMappedFile(wxFile& file) { Init(); Open(file); }
+
+  // make the contents of the file with the given name or of an already opened
+  // file available in memory, the whole file is always used independently of
+  // its current position (which may be changed by this function)
+  bool Open(const wxString& filename);
+  bool Open(wxFile& file);
+
+  // unmap the file and release the memory
+  void Close();
+
+  // dtor calls Close()
+ ~wxMappedFile() { Close(); }
+
+  // accessors
+  bool IsOpened() const { return m_opened; }
+    // true if the file is really mapped, false if it was read in memory
+  bool IsMapped() const { return m_mapped; }
+    // the file contents, NULL if the file is empty
+  const void *GetData() const { return m_data; }
+  size_t GetLength() const { return m_length; }
+
+private:
+  void Init();
+
+  void     *m_data;     // start of the file contents
+  size_t    m_length;   // and its length
+  bool      m_opened,   // true after successful Open()
+            m_mapped;   // true if m_data was mmap()-ed
+  wxMemoryBuffer m_buffer; // the file contents if it couldn't be mapped
+
+  wxDECLARE_NO_COPY_CLASS(wxMappedFile);
+};
+
 #endif // wxUSE_FILE
 
 #endif // _WX_FILEH__
@@ -245,6 +245,8 @@ private:
 
   wxMBConv    *m_conv;
 
+  wxMemoryBuffer m_linesCache;          // lines encoded by the last Flush()
+
 #ifdef __UNIX__
   int m_umask;                          // the umask to use for file creation
 #endif // __UNIX__
@@ -417,9 +417,17 @@ public:
     void UpdateAttrCols( size_t pos, int numCols );
 
 private:
-    // searches for the attr for given cell, returns wxNOT_FOUND if not found
-    int FindIndex(int row, int col) const;
+    // returns the index of the first element of m_attrs which is not less
+    // than the given cell in (row, col) order, i.e. the position at which an
+    // attribute for this cell should be inserted
+    size_t LowerBound(int row, int col) const;
 
+    // searches for the attr for given cell, returns wxNOT_FOUND if not found;
+    // if pos is non-NULL, it's filled with the insertion position in any case
+    int FindIndex(int row, int col, size_t *pos = NULL) const;
+
+    // the attributes sorted by their coordinates, row first, to allow binary
+    // searching in them
     wxGridCellWithAttrArray m_attrs;
 };
 
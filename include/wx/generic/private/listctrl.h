@@ -18,6 +18,7 @@
 #include "wx/selstore.h"
 #include "wx/timer.h"
 #include "wx/settings.h"
+#include "wx/vector.h"
 
 // ============================================================================
 // private classes
@@ -258,6 +259,9 @@ public:
     wxString GetText(int index) const;
     void SetText( int index, const wxString& s );
 
+    // get the text of the first column without copying it
+    const wxString& GetLabel() const;
+
     wxListItemAttr *GetAttr() const;
     void SetAttr(wxListItemAttr *attr);
 
@@ -819,6 +823,14 @@ protected:
     // find the first item starting with the given prefix after the given item
     size_t PrefixFindItem(size_t item, const wxString& prefix) const;
 
+    // find the first item at or after start, or, if wrap is true and there is
+    // none, before it, whose label is equal to (or starts with, if partial is
+    // true) the given string ignoring case and return -1 if there is none
+    size_t FindLabel(const wxString& str,
+                     size_t start,
+                     bool partial,
+                     bool wrap) const;
+
     // get the colour to be used for drawing the rules
     wxColour GetRuleColour() const
     {
@@ -835,6 +847,28 @@ private:
     // Compute the minimal width needed to fully display the column header.
     int ComputeMinHeaderWidth(const wxListHeaderData* header) const;
 
+    // build m_findIndex if it's empty
+    void BuildFindIndex();
+
+    // discard m_findIndex, it will be rebuilt when it's needed again
+    void ResetFindIndex() { wxVector<size_t>().swap(m_findIndex); }
+
+    // return the position of the first entry of m_findIndex which is not
+    // less than the given label and line
+    size_t FindIndexLowerBound(const wxString& label, size_t line) const;
+
+    // return the position of the first entry of m_findIndex which is greater
+    // than all the labels starting with the given prefix
+    size_t FindIndexPrefixEnd(const wxString& prefix) const;
+
+    // update m_findIndex, if it's used, after the label of the given line was
+    // set or the line was inserted (isNew is true then)
+    void AddToFindIndex(size_t line, bool isNew);
+
+    // update m_findIndex, if it's used, before the label of the given line is
+    // changed or the line is deleted (isDeleted is true then)
+    void RemoveFromFindIndex(size_t line, bool isDeleted);
+
 
     // the height of one line using the current font
     wxCoord m_lineHeight;
@@ -856,6 +890,13 @@ private:
     // NULL if no item is being edited
     wxListTextCtrlWrapper *m_textctrlWrapper;
 
+    // the indices of the lines of a non virtual control sorted by their case
+    // insensitive labels and then by the indices themselves: this allows to
+    // find items by their labels quickly, but as maintaining it makes
+    // inserting and deleting items slower, it is only built when searching
+    // for an item for the first time and is empty until then
+    wxVector<size_t> m_findIndex;
+
 
     DECLARE_EVENT_TABLE()
 
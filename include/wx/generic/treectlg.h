@@ -15,6 +15,7 @@
 
 #include "wx/scrolwin.h"
 #include "wx/pen.h"
+#include "wx/vector.h"
 
 // -----------------------------------------------------------------------------
 // forward declaration
@@ -282,6 +283,16 @@ protected:
 
     bool                 m_dropEffectAboveItem;
 
+    // all the shown items, i.e. those without any collapsed ancestors, in the
+    // order of their lines, the positions of all of them before
+    // m_firstDirtyLine are up to date while the lines starting from it must
+    // be recalculated ((size_t)-1 if there are no such lines)
+    wxVector<wxGenericTreeItem *> m_lines;
+    size_t               m_firstDirtyLine;
+
+    // the value of m_lineHeight used for calculating the lines positions
+    int                  m_linesLineHeight;
+
     // the common part of all ctors
     void Init();
 
@@ -325,12 +336,37 @@ protected:
 
     void CalculateLineHeight();
     int  GetLineHeight(wxGenericTreeItem *item) const;
-    void PaintLevel( wxGenericTreeItem *item, wxDC& dc, int level, int &y );
+    void PaintLine( wxGenericTreeItem *item, wxDC& dc );
+    void PaintChildrenLine( wxGenericTreeItem *item, wxDC& dc );
     void PaintItem( wxGenericTreeItem *item, wxDC& dc);
 
     void CalculateLevel( wxGenericTreeItem *item, wxDC &dc, int level, int &y );
     void CalculatePositions();
 
+    // mark the lines starting from the given one, the one showing the given
+    // item or the one after it as needing to be recalculated, nothing is done
+    // if the item is not shown
+    void InvalidateLines(size_t line = 0);
+    void InvalidateLinesFrom(wxGenericTreeItem *item);
+    void InvalidateLinesAfter(wxGenericTreeItem *item);
+
+    // recalculate the size of the item after it changed
+    void RecalculateItemSize(wxGenericTreeItem *item);
+
+    // is the item shown, i.e. are all of its parents expanded?
+    bool IsItemShown(wxGenericTreeItem *item) const;
+
+    // return the index of the line showing the given item in m_lines or
+    // wxNOT_FOUND if it's not shown or its position is not up to date
+    int FindLine(wxGenericTreeItem *item) const;
+
+    // return the index of the last line starting above the given position or
+    // wxNOT_FOUND, the lines positions must be up to date
+    int FindLineAbove(int y) const;
+
+    // return the item at the given unscrolled position, see HitTest()
+    wxGenericTreeItem *HitTestLines(const wxPoint& point, int& flags) const;
+
     void RefreshSubtree( wxGenericTreeItem *item );
     void RefreshLine( wxGenericTreeItem *item );
 
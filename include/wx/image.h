@@ -333,6 +333,9 @@ public:
     wxImage BlurHorizontal(int radius) const;
     wxImage BlurVertical(int radius) const;
 
+    // approximate the Gaussian blur with the given standard deviation
+    wxImage BlurGaussian(double sigma) const;
+
     wxImage ShrinkBy( int xFactor , int yFactor ) const ;
 
     // rescales the image in place
@@ -501,6 +504,11 @@ public:
     // -1.0..1.0 where -1.0 is -360 degrees and 1.0 is 360 degrees
     void RotateHue(double angle);
 
+    // Set the maximal number of threads used by the image processing
+    // functions, 0 means to use as many threads as there are CPUs
+    static void SetThreadCount(int count);
+    static int GetThreadCount();
+
     static wxList& GetHandlers() { return sm_handlers; }
     static void AddHandler( wxImageHandler *handler );
     static void InsertHandler( wxImageHandler *handler );
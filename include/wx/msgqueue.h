@@ -18,6 +18,7 @@
 
 #if wxUSE_THREADS
 
+#include "wx/atomic.h"
 #include "wx/stopwatch.h"
 
 #include "wx/beforestd.h"
@@ -163,6 +164,270 @@ private:
     std::queue<T>   m_messages;
 };
 
+namespace wxPrivate
+{
+
+// A simple semaphore used by wxLockFreeMessageQueue when it needs to block.
+// This is similar to wxSemaphore but avoids its overhead (mostly due to the
+// trace messages it logs) in the performance-sensitive code.
+class wxMessageQueueSemaphore
+{
+public:
+    wxMessageQueueSemaphore() : m_cond(m_mutex), m_count(0) { }
+
+    bool IsOk() const { return m_cond.IsOk(); }
+
+    bool Wait()
+    {
+        wxMutexLocker locker(m_mutex);
+
+        while ( !m_count )
+        {
+            if ( m_cond.Wait() != wxCOND_NO_ERROR )
+                return false;
+        }
+
+        m_count--;
+
+        return true;
+    }
+
+    wxSemaError WaitTimeout(long timeout)
+    {
+        wxMutexLocker locker(m_mutex);
+
+        const wxMilliClock_t waitUntil = wxGetLocalTimeMillis() + timeout;
+        while ( !m_count )
+        {
+            const wxMilliClock_t now = wxGetLocalTimeMillis();
+            if ( now >= waitUntil )
+                return wxSEMA_TIMEOUT;
+
+            const wxCondError
+                result = m_cond.WaitTimeout((waitUntil - now).ToLong());
+            if ( result != wxCOND_NO_ERROR && result != wxCOND_TIMEOUT )
+                return wxSEMA_MISC_ERROR;
+        }
+
+        m_count--;
+
+        return wxSEMA_NO_ERROR;
+    }
+
+    void Post()
+    {
+        wxMutexLocker locker(m_mutex);
+
+        m_count++;
+        m_cond.Signal();
+    }
+
+private:
+    wxMutex     m_mutex;
+    wxCondition m_cond;
+    size_t      m_count;
+
+    wxDECLARE_NO_COPY_CLASS(wxMessageQueueSemaphore);
+};
+
+} // namespace wxPrivate
+
+// ---------------------------------------------------------------------------
+// Bounded message queue for a single producer and a single consumer thread.
+//
+// This class has the same Post(), Receive() and ReceiveTimeout() methods as
+// wxMessageQueue but doesn't use any locks as long as the queue is neither
+// empty nor full, only blocking in Receive() if there are no messages and in
+// Post() if the queue already contains the maximal number of messages
+// specified in the ctor.
+//
+// Unlike with wxMessageQueue, Post() must be only called by one thread and
+// Receive() and ReceiveTimeout() by one (other) thread at any given moment.
+// The messages type T must be default constructible.
+// ---------------------------------------------------------------------------
+template <typename T>
+class wxLockFreeMessageQueue
+{
+public:
+    // The type of the messages transported by this queue
+    typedef T Message;
+
+    // Create a queue which can hold up to the given number of messages.
+    explicit wxLockFreeMessageQueue(size_t capacity = 1024)
+    {
+        m_capacity = capacity ? capacity : 1;
+        m_messages = new Message[m_capacity];
+
+        m_numFree = (wxInt32)m_capacity;
+        m_numMessages = 0;
+
+        m_tail = 0;
+        m_numReservedFree = 0;
+
+        m_head = 0;
+        m_numReservedMessages = 0;
+    }
+
+    ~wxLockFreeMessageQueue()
+    {
+        delete [] m_messages;
+    }
+
+    // Add a message to this queue, waiting until there is space for it if
+    // the queue is full, and wake up the thread waiting for messages if any.
+    wxMessageQueueError Post(const Message& msg)
+    {
+        wxCHECK( IsOk(), wxMSGQUEUE_MISC_ERROR );
+
+        if ( m_numReservedFree )
+        {
+            m_numReservedFree--;
+        }
+        else
+        {
+            const wxInt32 numFree = wxAtomicDec(m_numFree);
+            if ( numFree < 0 )
+            {
+                // the consumer will wake us up when it frees a slot
+                wxCHECK( m_semFree.Wait(), wxMSGQUEUE_MISC_ERROR );
+            }
+            else if ( numFree > 0 )
+            {
+                // reserve all the currently free slots at once, only we can
+                // decrement m_numFree so it can't become negative
+                wxAtomicAdd(m_numFree, -numFree);
+                m_numReservedFree = numFree;
+            }
+        }
+
+        m_messages[m_tail] = msg;
+        if ( ++m_tail == m_capacity )
+            m_tail = 0;
+
+        // this also ensures that the consumer sees the message
+        if ( wxAtomicInc(m_numMessages) <= 0 )
+            m_semMessages.Post();
+
+        return wxMSGQUEUE_NO_ERROR;
+    }
+
+    // Wait no more than timeout milliseconds until a message becomes available.
+    wxMessageQueueError ReceiveTimeout(long timeout, T& msg)
+    {
+        wxCHECK( IsOk(), wxMSGQUEUE_MISC_ERROR );
+
+        if ( !m_numReservedMessages && !ReserveMessages() )
+        {
+            wxSemaError result = m_semMessages.WaitTimeout(timeout);
+
+            if ( result == wxSEMA_TIMEOUT )
+            {
+                // give up on waiting unless a message was posted after the
+                // timeout expired, in which case the semaphore is going to be
+                // signalled for us and we need to consume this signal
+                if ( wxAtomicInc(m_numMessages) <= 0 )
+                    return wxMSGQUEUE_TIMEOUT;
+
+                wxAtomicDec(m_numMessages);
+                result = m_semMessages.Wait() ? wxSEMA_NO_ERROR
+                                              : wxSEMA_MISC_ERROR;
+            }
+
+            wxCHECK( result == wxSEMA_NO_ERROR, wxMSGQUEUE_MISC_ERROR );
+        }
+
+        Pop(msg);
+
+        return wxMSGQUEUE_NO_ERROR;
+    }
+
+    // Same as ReceiveTimeout() but waits for as long as it takes for a message
+    // to become available (so it can't return wxMSGQUEUE_TIMEOUT)
+    wxMessageQueueError Receive(T& msg)
+    {
+        wxCHECK( IsOk(), wxMSGQUEUE_MISC_ERROR );
+
+        if ( !m_numReservedMessages && !ReserveMessages() )
+        {
+            wxCHECK( m_semMessages.Wait(), wxMSGQUEUE_MISC_ERROR );
+        }
+
+        Pop(msg);
+
+        return wxMSGQUEUE_NO_ERROR;
+    }
+
+    // Return false only if there was a fatal error in ctor
+    bool IsOk() const
+    {
+        return m_semMessages.IsOk() && m_semFree.IsOk();
+    }
+
+private:
+    // Reserve one message for the next Pop() and also all the other ones
+    // currently in the queue for the subsequent calls. Returns false if there
+    // are no messages, the caller must wait on m_semMessages then.
+    bool ReserveMessages()
+    {
+        const wxInt32 numMessages = wxAtomicDec(m_numMessages);
+        if ( numMessages < 0 )
+            return false;
+
+        if ( numMessages > 0 )
+        {
+            wxAtomicAdd(m_numMessages, -numMessages);
+            m_numReservedMessages = numMessages;
+        }
+
+        // count the message for the current call too, Pop() consumes it
+        m_numReservedMessages++;
+
+        return true;
+    }
+
+    // Retrieve the oldest message and free its slot.
+    void Pop(T& msg)
+    {
+        if ( m_numReservedMessages )
+            m_numReservedMessages--;
+
+        msg = m_messages[m_head];
+        m_messages[m_head] = Message();
+        if ( ++m_head == m_capacity )
+            m_head = 0;
+
+        // wake up the producer if it's waiting for this slot
+        if ( wxAtomicInc(m_numFree) <= 0 )
+            m_semFree.Post();
+    }
+
+    // Disable copy ctor and assignment operator
+    wxLockFreeMessageQueue(const wxLockFreeMessageQueue<T>& rhs);
+    wxLockFreeMessageQueue<T>& operator=(const wxLockFreeMessageQueue<T>& rhs);
+
+    // circular buffer of messages
+    Message     *m_messages;
+    size_t       m_capacity;
+
+    // the number of free slots and the number of posted messages not reserved
+    // by the other side yet: these counters become negative when the producer
+    // or the consumer, respectively, is waiting on the corresponding semaphore
+    wxAtomicInt  m_numFree,
+                 m_numMessages;
+    wxPrivate::wxMessageQueueSemaphore m_semFree,
+                                       m_semMessages;
+
+    // only used by the producer: the position of the next message and the
+    // number of the slots already reserved by it
+    size_t       m_tail;
+    wxInt32      m_numReservedFree;
+
+    // only used by the consumer: the position of the next message and the
+    // number of the messages already reserved by it
+    size_t       m_head;
+    wxInt32      m_numReservedMessages;
+};
+
 #endif // wxUSE_THREADS
 
 #endif // _WX_MSGQUEUE_H_
@@ -86,6 +86,16 @@
     #define SOCKET_ERROR (-1)
 #endif
 
+// sendfile() is only used under Linux as its signature and semantics differ
+// between the systems providing it
+#if defined(__LINUX__) && wxUSE_FILE
+    #define wxHAS_SOCKET_SENDFILE
+#endif
+
+#ifdef wxHAS_SOCKET_SENDFILE
+    #include "wx/filefn.h"      // for wxFileOffset
+#endif
+
 typedef int wxSocketEventFlags;
 
 class wxSocketImpl;
@@ -251,6 +261,17 @@ public:
     int Read(void *buffer, int size);
     int Write(const void *buffer, int size);
 
+    // scatter/gather versions of the functions above using all the given
+    // buffers except for the first skip bytes of the first one
+    int ReadV(const wxSocketIOVec *vec, int count, wxUint32 skip);
+    int WriteV(const wxSocketIOVec *vec, int count, wxUint32 skip);
+
+#ifdef wxHAS_SOCKET_SENDFILE
+    // send up to size bytes from the given file descriptor starting at the
+    // given offset, which is updated to the offset of the first byte not sent
+    int SendFile(int fd, wxFileOffset *offset, int size);
+#endif // wxHAS_SOCKET_SENDFILE
+
     // basically a wrapper for select(): returns the condition of the socket,
     // blocking for not longer than timeout if it is specified (otherwise just
     // poll without blocking at all)
@@ -354,6 +375,10 @@ private:
     int SendStream(const void *buffer, int size);
     int SendDgram(const void *buffer, int size);
 
+    // functions used to implement ReadV/WriteV()
+    int RecvMsg(const wxSocketIOVec *vec, int count, wxUint32 skip);
+    int SendMsg(const wxSocketIOVec *vec, int count, wxUint32 skip);
+
 
     // set in ctor and never changed except that it's reset to NULL when the
     // socket is shut down
@@ -24,6 +24,7 @@
 #include "wx/list.h"
 
 class wxSocketImpl;
+class WXDLLIMPEXP_FWD_BASE wxFile;
 
 // ------------------------------------------------------------------------
 // Types and constants
@@ -95,6 +96,13 @@ enum
 
 typedef int wxSocketFlags;
 
+// one of the buffers used by wxSocketBase::ReadV() and WriteV()
+struct wxSocketIOVec
+{
+    void *buffer;
+    wxUint32 nbytes;
+};
+
 // socket kind values (badly defined, don't use)
 enum wxSocketType
 {
@@ -158,6 +166,16 @@ public:
     wxSocketBase& Write(const void *buffer, wxUint32 nbytes);
     wxSocketBase& WriteMsg(const void *buffer, wxUint32 nbytes);
 
+    // scatter/gather IO using all the given buffers in a single operation
+    wxSocketBase& ReadV(const wxSocketIOVec *vec, size_t count);
+    wxSocketBase& WriteV(const wxSocketIOVec *vec, size_t count);
+
+#if wxUSE_FILE
+    // send the data from the current position in the given file, without
+    // copying it to the user space if possible
+    wxSocketBase& SendFile(wxFile& file, wxUint32 nbytes);
+#endif // wxUSE_FILE
+
     // all Wait() functions wait until their condition is satisfied or the
     // timeout expires; if seconds == -1 (default) then m_timeout value is used
     //
@@ -233,6 +251,11 @@ private:
     // low level IO
     wxUint32 DoRead(void* buffer, wxUint32 nbytes);
     wxUint32 DoWrite(const void *buffer, wxUint32 nbytes);
+    wxUint32 DoReadV(const wxSocketIOVec *vec, size_t count);
+    wxUint32 DoWriteV(const wxSocketIOVec *vec, size_t count);
+#if wxUSE_FILE
+    wxUint32 DoSendFile(wxFile& file, wxUint32 nbytes);
+#endif // wxUSE_FILE
 
     // wait until the given flags are set for this socket or the given timeout
     // (or m_timeout) expires
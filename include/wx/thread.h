@@ -115,13 +115,19 @@ enum wxMutexType
     wxMUTEX_DEFAULT,
 
     // recursive mutex: don't use these ones with wxCondition
-    wxMUTEX_RECURSIVE
+    wxMUTEX_RECURSIVE,
+
+    // non-recursive mutex spinning for a short time before blocking when it
+    // is already locked, which is faster for short, often contended critical
+    // sections; it doesn't detect deadlocks, unlike wxMUTEX_DEFAULT
+    wxMUTEX_ADAPTIVE
 };
 
 // forward declarations
 class WXDLLIMPEXP_FWD_BASE wxThreadHelper;
 class WXDLLIMPEXP_FWD_BASE wxConditionInternal;
 class WXDLLIMPEXP_FWD_BASE wxMutexInternal;
+class WXDLLIMPEXP_FWD_BASE wxRWLockInternal;
 class WXDLLIMPEXP_FWD_BASE wxSemaphoreInternal;
 class WXDLLIMPEXP_FWD_BASE wxThreadInternal;
 
@@ -206,6 +212,79 @@ private:
     wxMutex& m_mutex;
 };
 
+// ----------------------------------------------------------------------------
+// A reader/writer lock can be locked either by any number of readers or by a
+// single writer at any given moment. It is useful for protecting the data
+// which is read much more often than it is modified.
+// ----------------------------------------------------------------------------
+
+class WXDLLIMPEXP_BASE wxRWLock
+{
+public:
+    wxRWLock();
+    ~wxRWLock();
+
+    // test if the lock has been created successfully
+    bool IsOk() const;
+
+    // lock for reading, blocking while a writer holds the lock, return
+    // wxMUTEX_BUSY from TryReadLock() instead of blocking
+    wxMutexError ReadLock();
+    wxMutexError TryReadLock();
+    wxMutexError ReadUnlock();
+
+    // lock for writing, blocking while any readers or another writer hold the
+    // lock, return wxMUTEX_BUSY from TryWriteLock() instead of blocking
+    wxMutexError WriteLock();
+    wxMutexError TryWriteLock();
+    wxMutexError WriteUnlock();
+
+private:
+    wxRWLockInternal *m_internal;
+
+    wxDECLARE_NO_COPY_CLASS(wxRWLock);
+};
+
+// helper classes locking wxRWLock for reading or writing in their ctor and
+// unlocking it in their dtor, similar to wxMutexLocker
+class WXDLLIMPEXP_BASE wxReadLocker
+{
+public:
+    wxReadLocker(wxRWLock& lock)
+        : m_lock(lock)
+        { m_isOk = m_lock.ReadLock() == wxMUTEX_NO_ERROR; }
+
+    bool IsOk() const { return m_isOk; }
+
+    ~wxReadLocker()
+        { if ( IsOk() ) m_lock.ReadUnlock(); }
+
+private:
+    bool      m_isOk;
+    wxRWLock& m_lock;
+
+    wxDECLARE_NO_COPY_CLASS(wxReadLocker);
+};
+
+class WXDLLIMPEXP_BASE wxWriteLocker
+{
+public:
+    wxWriteLocker(wxRWLock& lock)
+        : m_lock(lock)
+        { m_isOk = m_lock.WriteLock() == wxMUTEX_NO_ERROR; }
+
+    bool IsOk() const { return m_isOk; }
+
+    ~wxWriteLocker()
+        { if ( IsOk() ) m_lock.WriteUnlock(); }
+
+private:
+    bool      m_isOk;
+    wxRWLock& m_lock;
+
+    wxDECLARE_NO_COPY_CLASS(wxWriteLocker);
+};
+
 // ----------------------------------------------------------------------------
 // Critical section: this is the same as mutex but is only visible to the
 // threads of the same process. For the platforms which don't have native
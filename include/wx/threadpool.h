@@ -0,0 +1,232 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        wx/threadpool.h
+// Purpose:     wxThreadPool and wxTask: executing tasks in worker threads
+// Author:      wxWidgets team
+// Created:     2026-10-18
+// Copyright:   (c) 2026 wxWidgets team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WX_THREADPOOL_H_
+#define _WX_THREADPOOL_H_
+
+#include "wx/defs.h"
+
+#if wxUSE_THREADS
+
+#include "wx/atomic.h"
+#include "wx/object.h"
+#include "wx/thread.h"
+#include "wx/vector.h"
+
+class WXDLLIMPEXP_FWD_BASE wxEvtHandler;
+class WXDLLIMPEXP_FWD_BASE wxThreadPool;
+class wxTaskCompletedEvent;
+class wxTaskQueue;
+class wxThreadPoolWorker;
+
+template <class T> class wxWeakRef;
+
+// ----------------------------------------------------------------------------
+// wxTask: a unit of work executed by wxThreadPool
+// ----------------------------------------------------------------------------
+
+// Tasks are reference counted and are normally used via wxObjectDataPtr<> as
+// returned by wxThreadPool::Submit(), which acts as a future for the task
+// result.
+class WXDLLIMPEXP_BASE wxTask
+{
+public:
+    wxTask();
+
+    // reference counting: the object is deleted when the last reference to it
+    // is released, this can be done from any thread
+    void IncRef() { wxAtomicInc(m_refCount); }
+    void DecRef();
+
+    // request the cancellation of the task: if it hasn't started running yet,
+    // it never will, otherwise Run() should check IsCancelled() periodically
+    // and return as soon as possible if it returns true
+    void Cancel();
+
+    // return true if Cancel() had been called
+    bool IsCancelled() const;
+
+    // return true if the task has either finished running or was cancelled
+    // before starting to run
+    bool IsDone() const;
+
+    // wait until IsDone() becomes true, if this is called from one of the
+    // worker threads of the same pool, the other tasks are executed while
+    // waiting
+    void Wait();
+
+protected:
+    // the dtor is protected as the tasks must be only deleted by DecRef()
+    virtual ~wxTask();
+
+    // this function is called in a worker thread to perform the work
+    virtual void Run() = 0;
+
+    // if an event handler was specified when submitting the task, this
+    // function is called in the main thread when the task is done, i.e. after
+    // it finishes running or if it is cancelled before starting to run
+    virtual void OnCompleted() { }
+
+private:
+    // the task states, see m_state
+    enum State
+    {
+        State_New,          // not submitted yet
+        State_Queued,       // waiting to be executed
+        State_Running,      // being executed
+        State_Done          // finished running or cancelled
+    };
+
+    // switch to the running state if the task is still queued and return
+    // true or return false if it was cancelled
+    bool Start();
+
+    // switch to the done state and notify about it
+    void Finish();
+
+    // called by Finish() and Cancel() when the task is done
+    void NotifyDone();
+
+    // accessed atomically
+    wxAtomicInt m_refCount;
+
+    // protects m_state and m_cancelled
+    mutable wxCriticalSection m_cs;
+    State m_state;
+    bool m_cancelled;
+
+    // the pool the task was submitted to
+    wxThreadPool *m_pool;
+
+    // weak reference to the handler to notify about the task completion, if
+    // any: it is only created, checked and destroyed in the main thread, as
+    // the handler itself can be destroyed there at any moment
+    wxWeakRef<wxEvtHandler> *m_handler;
+
+    friend class wxThreadPool;
+    friend class wxTaskCompletedEvent;
+
+    wxDECLARE_NO_COPY_CLASS(wxTask);
+};
+
+// ----------------------------------------------------------------------------
+// wxThreadPool: a fixed set of worker threads executing the submitted tasks
+// ----------------------------------------------------------------------------
+
+class WXDLLIMPEXP_BASE wxThreadPool
+{
+public:
+    // create a pool with the given number of threads or with one thread per
+    // CPU by default, the threads are only started when the first task is
+    // submitted
+    wxThreadPool(int numThreads = -1);
+
+    // cancels all the tasks not started yet and waits for the running ones
+    ~wxThreadPool();
+
+    // the default pool which can be used by any code, it is created on demand
+    // and destroyed on library shutdown
+    static wxThreadPool& Get();
+
+    int GetThreadCount() const { return m_numThreads; }
+
+    // return the number of threads used by default, i.e. the number of CPUs
+    static int GetDefaultThreadCount();
+
+    // submit the task for execution, the pool takes ownership of the initial
+    // reference to it and returns another one which can be used to wait for
+    // the task or cancel it
+    //
+    // if handler is specified, the task OnCompleted() is called in the main
+    // thread when it's done, unless the handler is destroyed before this
+    // happens, this can only be done when submitting from the main thread
+    template <class T>
+    wxObjectDataPtr<T> Submit(T *task, wxEvtHandler *handler = NULL)
+    {
+        wxObjectDataPtr<T> ptr(task);
+        DoSubmit(task, handler);
+        return ptr;
+    }
+
+    // wait until all the submitted tasks are done, this can't be called from
+    // a worker thread of this pool
+    void WaitAll();
+
+private:
+    // adds a reference to the task and queues it
+    void DoSubmit(wxTask *task, wxEvtHandler *handler);
+
+    // start the worker threads if not done yet
+    void StartThreads();
+
+    // find a task to run in the queue of the worker with the given index,
+    // then in the shared queue and then in the other workers queues, returns
+    // NULL if there are none
+    wxTask *FindTask(size_t index);
+
+    // run the task (if it wasn't cancelled) and release it
+    void RunTask(wxTask *task);
+
+    // called by the worker threads to get the next task to run, blocks until
+    // there is one and returns NULL when the pool is being destroyed
+    wxTask *GetNextTask(size_t index);
+
+    // called when a task is done to update the count of pending tasks and
+    // wake up the threads waiting for it
+    void OnTaskDone();
+
+    // wait until the given task, or all of them if it is NULL, is done,
+    // running other tasks in the meanwhile if called from a worker thread
+    void WaitUntilDone(const wxTask *task);
+
+    // return the index of the current thread if it's one of our worker
+    // threads or -1 otherwise
+    int GetCurrentWorker() const;
+
+
+    const int m_numThreads;
+
+    // the worker threads and their queues: the threads push and pop the tasks
+    // to/from the back of their own queues but steal them from the front of
+    // the other ones
+    wxVector<wxThreadPoolWorker *> m_threads;
+    wxVector<wxTaskQueue *> m_queues;
+
+    // the queue for the tasks submitted from outside of the worker threads
+    wxTaskQueue *m_sharedQueue;
+
+    // protects m_threads and m_started
+    wxCriticalSection m_csThreads;
+    bool m_started;
+
+    // the number of the tasks in all the queues, the number of the tasks not
+    // done yet and the number of threads waiting for the tasks to be done
+    wxAtomicInt m_numQueued,
+                m_numPending,
+                m_numWaiting;
+
+    // used by the idle workers to wait for the new tasks
+    wxMutex m_mutexIdle;
+    wxCondition m_condIdle;
+    int m_numIdle;
+    bool m_exiting;
+
+    // used by the threads waiting for the tasks to be done
+    wxMutex m_mutexDone;
+    wxCondition m_condDone;
+
+    friend class wxTask;
+    friend class wxThreadPoolWorker;
+
+    wxDECLARE_NO_COPY_CLASS(wxThreadPool);
+};
+
+#endif // wxUSE_THREADS
+
+#endif // _WX_THREADPOOL_H_
@@ -337,6 +337,225 @@ wxSemaError wxSemaphore::Post()
     return m_internal->Post();
 }
 
+// --------------------------------------------------------------------------
+// wxRWLockInternal
+// --------------------------------------------------------------------------
+
+// there is no native reader/writer lock under Windows XP and OS/2, so
+// implement it using a mutex and two conditions: one for the readers waiting
+// for the writer to release the lock and another one for the writers waiting
+// for everybody else to release it, the writers are preferred to avoid their
+// starvation
+#if defined(__WINDOWS__) || defined(__OS2__) || defined(__EMX__)
+
+class wxRWLockInternal
+{
+public:
+    wxRWLockInternal();
+
+    bool IsOk() const { return m_condRead.IsOk() && m_condWrite.IsOk(); }
+
+    wxMutexError ReadLock();
+    wxMutexError TryReadLock();
+    wxMutexError ReadUnlock();
+
+    wxMutexError WriteLock();
+    wxMutexError TryWriteLock();
+    wxMutexError WriteUnlock();
+
+private:
+    wxMutex m_mutex;
+    wxCondition m_condRead,
+                m_condWrite;
+
+    // the number of threads holding the lock for reading, whether a thread
+    // holds it for writing and the number of threads waiting to do it
+    int m_numReaders;
+    bool m_hasWriter;
+    int m_numWaitingWriters;
+
+    wxDECLARE_NO_COPY_CLASS(wxRWLockInternal);
+};
+
+wxRWLockInternal::wxRWLockInternal()
+                : m_condRead(m_mutex),
+                  m_condWrite(m_mutex)
+{
+    m_numReaders = 0;
+    m_hasWriter = false;
+    m_numWaitingWriters = 0;
+}
+
+wxMutexError wxRWLockInternal::ReadLock()
+{
+    wxMutexLocker lock(m_mutex);
+
+    while ( m_hasWriter || m_numWaitingWriters )
+    {
+        if ( m_condRead.Wait() != wxCOND_NO_ERROR )
+            return wxMUTEX_MISC_ERROR;
+    }
+
+    m_numReaders++;
+
+    return wxMUTEX_NO_ERROR;
+}
+
+wxMutexError wxRWLockInternal::TryReadLock()
+{
+    wxMutexLocker lock(m_mutex);
+
+    if ( m_hasWriter || m_numWaitingWriters )
+        return wxMUTEX_BUSY;
+
+    m_numReaders++;
+
+    return wxMUTEX_NO_ERROR;
+}
+
+wxMutexError wxRWLockInternal::ReadUnlock()
+{
+    wxMutexLocker lock(m_mutex);
+
+    if ( !m_numReaders )
+        return wxMUTEX_UNLOCKED;
+
+    if ( !--m_numReaders && m_numWaitingWriters )
+        m_condWrite.Signal();
+
+    return wxMUTEX_NO_ERROR;
+}
+
+wxMutexError wxRWLockInternal::WriteLock()
+{
+    wxMutexLocker lock(m_mutex);
+
+    m_numWaitingWriters++;
+
+    wxMutexError rc = wxMUTEX_NO_ERROR;
+    while ( m_hasWriter || m_numReaders )
+    {
+        if ( m_condWrite.Wait() != wxCOND_NO_ERROR )
+        {
+            rc = wxMUTEX_MISC_ERROR;
+            break;
+        }
+    }
+
+    m_numWaitingWriters--;
+
+    if ( rc == wxMUTEX_NO_ERROR )
+        m_hasWriter = true;
+    else if ( !m_numWaitingWriters )
+        m_condRead.Broadcast();
+
+    return rc;
+}
+
+wxMutexError wxRWLockInternal::TryWriteLock()
+{
+    wxMutexLocker lock(m_mutex);
+
+    if ( m_hasWriter || m_numReaders )
+        return wxMUTEX_BUSY;
+
+    m_hasWriter = true;
+
+    return wxMUTEX_NO_ERROR;
+}
+
+wxMutexError wxRWLockInternal::WriteUnlock()
+{
+    wxMutexLocker lock(m_mutex);
+
+    if ( !m_hasWriter )
+        return wxMUTEX_UNLOCKED;
+
+    m_hasWriter = false;
+
+    if ( m_numWaitingWriters )
+        m_condWrite.Signal();
+    else
+        m_condRead.Broadcast();
+
+    return wxMUTEX_NO_ERROR;
+}
+
+#endif // __WINDOWS__ || __OS2__ || __EMX__
+
+// --------------------------------------------------------------------------
+// wxRWLock
+// --------------------------------------------------------------------------
+
+wxRWLock::wxRWLock()
+{
+    m_internal = new wxRWLockInternal;
+
+    if ( !m_internal->IsOk() )
+    {
+        delete m_internal;
+        m_internal = NULL;
+    }
+}
+
+wxRWLock::~wxRWLock()
+{
+    delete m_internal;
+}
+
+bool wxRWLock::IsOk() const
+{
+    return m_internal != NULL;
+}
+
+wxMutexError wxRWLock::ReadLock()
+{
+    wxCHECK_MSG( m_internal, wxMUTEX_INVALID,
+                 wxT("wxRWLock::ReadLock(): not initialized") );
+
+    return m_internal->ReadLock();
+}
+
+wxMutexError wxRWLock::TryReadLock()
+{
+    wxCHECK_MSG( m_internal, wxMUTEX_INVALID,
+                 wxT("wxRWLock::TryReadLock(): not initialized") );
+
+    return m_internal->TryReadLock();
+}
+
+wxMutexError wxRWLock::ReadUnlock()
+{
+    wxCHECK_MSG( m_internal, wxMUTEX_INVALID,
+                 wxT("wxRWLock::ReadUnlock(): not initialized") );
+
+    return m_internal->ReadUnlock();
+}
+
+wxMutexError wxRWLock::WriteLock()
+{
+    wxCHECK_MSG( m_internal, wxMUTEX_INVALID,
+                 wxT("wxRWLock::WriteLock(): not initialized") );
+
+    return m_internal->WriteLock();
+}
+
+wxMutexError wxRWLock::TryWriteLock()
+{
+    wxCHECK_MSG( m_internal, wxMUTEX_INVALID,
+                 wxT("wxRWLock::TryWriteLock(): not initialized") );
+
+    return m_internal->TryWriteLock();
+}
+
+wxMutexError wxRWLock::WriteUnlock()
+{
+    wxCHECK_MSG( m_internal, wxMUTEX_INVALID,
+                 wxT("wxRWLock::WriteUnlock(): not initialized") );
+
+    return m_internal->WriteUnlock();
+}
+
 // ----------------------------------------------------------------------------
 // wxThread
 // ----------------------------------------------------------------------------
@@ -18,7 +18,28 @@
 
 struct epoll_event;
 
-class WXDLLIMPEXP_BASE wxEpollDispatcher : public wxFDIODispatcher
+// the state of a descriptor in the epoll set before its pending modifications
+struct wxEpollChange
+{
+    wxEpollChange() : flags(0), rearm(false) { }
+
+    int flags;      // the flags the descriptor is registered with in the kernel
+    bool rearm;     // true if an edge-triggered event was re-enabled
+};
+
+WX_DECLARE_HASH_MAP(
+  int,
+  wxEpollChange,
+  wxIntegerHash,
+  wxIntegerEqual,
+  wxEpollChangesMap
+);
+
+// notice that this class keeps the handlers in the base class map and uses
+// the descriptors, and not the handlers pointers, as epoll user data: this
+// allows to find out if the handler is still registered when dispatching the
+// events and so to handle many of them at once safely
+class WXDLLIMPEXP_BASE wxEpollDispatcher : public wxMappedFDIODispatcher
 {
 public:
     // create a new instance of this class, can return NULL if
@@ -40,12 +61,34 @@ private:
     // ctor is private, use Create()
     wxEpollDispatcher(int epollDescriptor);
 
-    // common part of HasPending() and Dispatch(): calls epoll_wait() with the
-    // given timeout
-    int DoPoll(epoll_event *events, int numEvents, int timeout) const;
+    // common part of HasPending() and Dispatch(): applies the pending changes
+    // and calls epoll_wait() with the given timeout, storing the events in
+    // m_events
+    int DoPoll(int timeout) const;
+
+    // update the epoll set with all the changes done by ModifyFD() since the
+    // last call to this function
+    void ApplyChanges() const;
+
+    // call epoll_ctl() to change the flags of the given descriptor
+    bool DoModify(int op, int fd, int flags) const;
 
 
     int m_epollDescriptor;
+
+    // the modifications not applied to the epoll set yet: they are delayed
+    // until the next poll as the sockets often disable and re-enable their
+    // events several times while handling a single one
+    mutable wxEpollChangesMap m_changes;
+
+    // the buffer for the events returned by epoll_wait(), it grows when it
+    // gets filled up completely
+    mutable epoll_event *m_events;
+    mutable int m_eventsSize;
+
+    // the number of events in m_events left by HasPending(), which must not
+    // lose them as edge-triggered events are only reported once
+    mutable int m_numPending;
 };
 
 #endif // wxUSE_EPOLL_DISPATCHER
@@ -13,6 +13,8 @@
 #if wxUSE_TIMER
 
 #include "wx/private/timer.h"
+#include "wx/hashmap.h"
+#include "wx/vector.h"
 
 // the type used for milliseconds is large enough for microseconds too but
 // introduce a synonym for it to avoid confusion
@@ -57,6 +59,8 @@ struct wxTimerSchedule
         : m_timer(timer),
           m_expiration(expiration)
     {
+        m_order = 0;
+        m_index = 0;
     }
 
     // the timer itself (we don't own this pointer)
@@ -64,10 +68,19 @@ struct wxTimerSchedule
 
     // the time of its next expiration, in usec
     wxUsecClock_t m_expiration;
+
+    // the sequence number used for ordering the timers expiring at the same
+    // time in the order in which they were added
+    unsigned long m_order;
+
+    // the position of this schedule in wxTimerScheduler::m_heap
+    size_t m_index;
 };
 
-// the linked list of all active timers, we keep it sorted by expiration time
-WX_DECLARE_LIST(wxTimerSchedule, wxTimerList);
+// the hash map allowing to find the schedule of the given timer
+WX_DECLARE_HASH_MAP(wxUnixTimerImpl *, wxTimerSchedule *,
+                    wxPointerHash, wxPointerEqual,
+                    wxTimerScheduleMap);
 
 // ----------------------------------------------------------------------------
 // wxTimerScheduler: class responsible for updating all timers
@@ -95,10 +108,12 @@ public:
         }
     }
 
-    // adds timer which should expire at the given absolute time to the list
+    // adds timer which should expire at the given absolute time, this takes
+    // O(log(N)) time
     void AddTimer(wxUnixTimerImpl *timer, wxUsecClock_t expiration);
 
-    // remove timer from the list, called automatically from timer dtor
+    // remove the timer, called automatically from timer dtor, this also takes
+    // O(log(N)) time
     void RemoveTimer(wxUnixTimerImpl *timer);
 
 
@@ -111,24 +126,56 @@ public:
     // it returns false if there are no timers
     bool GetNext(wxUsecClock_t *remaining) const;
 
-    // trigger the timer event for all timers which have expired, return true
-    // if any did
+    // trigger the timer event for all timers which have expired or are going
+    // to expire in less than the coalescing tolerance (see the comment near
+    // its definition in the implementation), return true if any did
     bool NotifyExpired();
 
 private:
     // ctor and dtor are private, this is a singleton class only created by
     // Get() and destroyed by Shutdown()
-    wxTimerScheduler() { }
+    wxTimerScheduler() { m_nextOrder = 0; }
     ~wxTimerScheduler();
 
-    // add the given timer schedule to the list in the right place
+    // add the given timer schedule to the heap
     //
     // we take ownership of the pointer "s" which must be heap-allocated
     void DoAddTimer(wxTimerSchedule *s);
 
+    // remove the given schedule from the heap without deleting it
+    void DoRemoveTimer(wxTimerSchedule *s);
+
+    // return true if the schedule "s1" expires before "s2"
+    static bool IsEarlier(const wxTimerSchedule *s1, const wxTimerSchedule *s2)
+    {
+        if ( s1->m_expiration != s2->m_expiration )
+            return s1->m_expiration < s2->m_expiration;
+
+        return s1->m_order < s2->m_order;
+    }
+
+    // put the schedule into the heap at the given position
+    void SetAt(size_t index, wxTimerSchedule *s)
+    {
+        m_heap[index] = s;
+        s->m_index = index;
+    }
+
+    // move the schedule at the given position up or down the heap until the
+    // heap property is restored
+    void SiftUp(size_t index);
+    void SiftDown(size_t index);
+
+
+    // all currently active timers organized as a binary min-heap by their
+    // expiration time, i.e. the first element always expires first
+    wxVector<wxTimerSchedule *> m_heap;
+
+    // the schedules of all timers indexed by the timers themselves
+    wxTimerScheduleMap m_schedules;
 
-    // the list of all currently active timers sorted by expiration
-    wxTimerList m_timers;
+    // the sequence number to use for the next added timer
+    unsigned long m_nextOrder;
 
     static wxTimerScheduler *ms_instance;
 };
@@ -18,6 +18,7 @@
 #include "wx/object.h"
 #include "wx/string.h"
 #include "wx/stream.h"
+#include "wx/mstream.h"
 #include "wx/file.h"
 #include "wx/ffile.h"
 
@@ -150,6 +151,35 @@ private:
     wxDECLARE_NO_COPY_CLASS(wxFileStream);
 };
 
+// ----------------------------------------------------------------------------
+// wxMappedFileInputStream: wxMemoryInputStream over a wxMappedFile
+// ----------------------------------------------------------------------------
+
+// wxMappedFile is a base class and not a member because it must be initialized
+// before wxMemoryInputStream which uses its data
+class WXDLLIMPEXP_BASE wxMappedFileInputStream : private wxMappedFile,
+                                                 public wxMemoryInputStream
+{
+public:
+    wxMappedFileInputStream(const wxString& fileName);
+    wxMappedFileInputStream(wxFile& file);
+
+    // give access to the file contents directly
+    const wxMappedFile& GetMappedFile() const { return *this; }
+
+    // resolve the ambiguity with wxMappedFile::GetLength()
+    virtual wxFileOffset GetLength() const
+    {
+        return wxMemoryInputStream::GetLength();
+    }
+
+private:
+    // common part of all ctors
+    void Init();
+
+    wxDECLARE_NO_COPY_CLASS(wxMappedFileInputStream);
+};
+
 #endif //wxUSE_FILE
 
 #if wxUSE_FFILE
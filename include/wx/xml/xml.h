@@ -35,6 +35,9 @@ class WXDLLIMPEXP_FWD_XML wxXmlIOHandler;
 class WXDLLIMPEXP_FWD_BASE wxInputStream;
 class WXDLLIMPEXP_FWD_BASE wxOutputStream;
 
+// Private class used for the nodes created with wxXMLDOC_USE_ARENA flag.
+class wxXmlArena;
+
 // Represents XML node type.
 enum wxXmlNodeType
 {
@@ -76,6 +79,13 @@ public:
     void SetValue(const wxString& value) { m_value = value; }
     void SetNext(wxXmlAttribute *next) { m_next = next; }
 
+    // Allocation operators used for creating objects in the memory arena when
+    // wxXMLDOC_USE_ARENA flag is used, objects created normally use the heap.
+    static void *operator new(size_t size);
+    static void *operator new(size_t size, wxXmlArena *arena);
+    static void operator delete(void *p);
+    static void operator delete(void *p, wxXmlArena *arena);
+
 private:
     wxString m_name;
     wxString m_value;
@@ -174,6 +184,12 @@ public:
     bool GetNoConversion() const { return m_noConversion; }
     void SetNoConversion(bool noconversion) { m_noConversion = noconversion; }
 
+    // Same allocation operators as in wxXmlAttribute.
+    static void *operator new(size_t size);
+    static void *operator new(size_t size, wxXmlArena *arena);
+    static void operator delete(void *p);
+    static void operator delete(void *p, wxXmlArena *arena);
+
 #if WXWIN_COMPATIBILITY_2_8
     wxDEPRECATED( inline wxXmlAttribute *GetProperties() const );
     wxDEPRECATED( inline bool GetPropVal(const wxString& propName,
@@ -243,7 +259,8 @@ inline void wxXmlNode::SetProperties(wxXmlAttribute *prop)
 enum wxXmlDocumentLoadFlag
 {
     wxXMLDOC_NONE = 0,
-    wxXMLDOC_KEEP_WHITESPACE_NODES = 1
+    wxXMLDOC_KEEP_WHITESPACE_NODES = 1,
+    wxXMLDOC_USE_ARENA = 2
 };
 
 
@@ -320,6 +337,95 @@ private:
     DECLARE_CLASS(wxXmlDocument)
 };
 
+
+// Read-only view of the attributes of the element being parsed by
+// wxXmlReader. The strings are in UTF-8 and point directly into the parser
+// buffer, so they are only valid during wxXmlReader::OnStartElement() call.
+
+class WXDLLIMPEXP_XML wxXmlAttributesView
+{
+public:
+    explicit wxXmlAttributesView(const char **atts);
+
+    size_t GetCount() const { return m_count; }
+
+    const char *GetNameUTF8(size_t n) const;
+    const char *GetValueUTF8(size_t n) const;
+
+    wxString GetName(size_t n) const
+        { return wxString::FromUTF8Unchecked(GetNameUTF8(n)); }
+    wxString GetValue(size_t n) const
+        { return wxString::FromUTF8Unchecked(GetValueUTF8(n)); }
+
+    // Returns the value of the attribute with the given name or NULL.
+    const char *FindUTF8(const char *name) const;
+
+    bool GetAttribute(const wxString& name, wxString *value) const;
+    bool HasAttribute(const wxString& name) const;
+
+private:
+    const char **m_atts;
+    size_t m_count;
+};
+
+
+// Streaming XML parser: instead of building the tree of wxXmlNode objects
+// as wxXmlDocument does, it calls its virtual OnXXX() methods for the parts
+// of the document as soon as they are parsed, so that documents of any size
+// can be processed using a constant amount of memory.
+//
+// All strings passed to the callbacks are in UTF-8 and are only valid during
+// the callback execution.
+
+class WXDLLIMPEXP_XML wxXmlReader
+{
+public:
+    wxXmlReader();
+    virtual ~wxXmlReader();
+
+    // Parses the document calling the callbacks below. Returns false if an
+    // error occurred, but true if the parsing was stopped by Stop().
+    bool Parse(const wxString& filename);
+    bool Parse(wxInputStream& stream);
+
+    // Can be called from the callbacks to stop parsing.
+    void Stop();
+    bool WasStopped() const { return m_stopped; }
+
+    // These functions can only be used from inside the callbacks.
+    int GetLineNumber() const;
+    int GetDepth() const { return m_depth; }
+
+
+    // The callbacks, all of them do nothing by default.
+    virtual void OnStartElement(const char *WXUNUSED(name),
+                                const wxXmlAttributesView& WXUNUSED(attrs)) { }
+    virtual void OnEndElement(const char *WXUNUSED(name)) { }
+
+    // The text of a single text node may be passed in several chunks.
+    virtual void OnText(const char *WXUNUSED(text), size_t WXUNUSED(len)) { }
+
+    // The contents of a CDATA section is passed to OnText() between these.
+    virtual void OnStartCData() { }
+    virtual void OnEndCData() { }
+
+    virtual void OnComment(const char *WXUNUSED(text)) { }
+    virtual void OnProcessingInstruction(const char *WXUNUSED(target),
+                                         const char *WXUNUSED(data)) { }
+
+private:
+    // Opaque pointer to the expat parser, only valid inside Parse().
+    void *m_parser;
+
+    int m_depth;
+    bool m_stopped;
+
+    // The class forwarding expat callbacks to our virtual functions.
+    friend class wxXmlReaderCallbacks;
+
+    wxDECLARE_NO_COPY_CLASS(wxXmlReader);
+};
+
 #endif // wxUSE_XML
 
 #endif // _WX_XML_H_
@@ -109,6 +109,17 @@ enum wxZipFlags
     wxZIP_RESERVED          = 0xF000
 };
 
+// Formats for the archives written by wxZipOutputStream
+//
+enum wxZipArchiveFormat
+{
+    // the zip64 extensions are only used if they're needed
+    wxZIP_FORMAT_DEFAULT,
+    // the zip64 extensions are used for all entries, needed for streaming
+    // entries bigger than 4GB to non-seekable streams
+    wxZIP_FORMAT_ZIP64
+};
+
 // Forward decls
 //
 class WXDLLIMPEXP_FWD_BASE wxZipEntry;
@@ -224,14 +235,17 @@ private:
     wxArchiveEntry* DoClone() const             { return ZipClone(); }
 
     size_t ReadLocal(wxInputStream& stream, wxMBConv& conv);
-    size_t WriteLocal(wxOutputStream& stream, wxMBConv& conv) const;
+    size_t WriteLocal(wxOutputStream& stream, wxMBConv& conv,
+                      bool zip64 = false) const;
 
     size_t ReadCentral(wxInputStream& stream, wxMBConv& conv);
-    size_t WriteCentral(wxOutputStream& stream, wxMBConv& conv) const;
+    size_t WriteCentral(wxOutputStream& stream, wxMBConv& conv,
+                        bool zip64 = false) const;
 
     size_t ReadDescriptor(wxInputStream& stream);
     size_t WriteDescriptor(wxOutputStream& stream, wxUint32 crc,
-                           wxFileOffset compressedSize, wxFileOffset size);
+                           wxFileOffset compressedSize, wxFileOffset size,
+                           bool zip64 = false);
 
     wxUint8      m_SystemMadeBy;       // one of enum wxZipSystem
     wxUint8      m_VersionMadeBy;      // major * 10 + minor
@@ -302,6 +316,12 @@ public:
     int  GetLevel() const                       { return m_level; }
     void WXZIPFIX SetLevel(int level);
 
+    wxZipArchiveFormat GetFormat() const        { return m_format; }
+    void SetFormat(wxZipArchiveFormat format)   { m_format = format; }
+
+    int  GetThreadCount() const                 { return m_threadCount; }
+    void WXZIPFIX SetThreadCount(int count, size_t blockSize = 0);
+
 protected:
     virtual size_t WXZIPFIX OnSysWrite(const void *buffer, size_t size);
     virtual wxFileOffset OnSysTell() const      { return m_entrySize; }
@@ -328,6 +348,7 @@ private:
     bool DoCreate(wxZipEntry *entry, bool raw = false);
     void CreatePendingEntry(const void *buffer, size_t size);
     void CreatePendingEntry();
+    void InitZip64(wxZipEntry& entry);
 
     class wxStoredOutputStream *m_store;
     class wxZlibOutputStream2 *m_deflate;
@@ -346,6 +367,10 @@ private:
     wxFileOffset m_offsetAdjustment;
     wxString m_Comment;
     bool m_endrecWritten;
+    wxZipArchiveFormat m_format;
+    bool m_zip64Local;
+    int m_threadCount;
+    size_t m_blockSize;
 
     wxDECLARE_NO_COPY_CLASS(wxZipOutputStream);
 };
@@ -374,6 +399,11 @@ public:
 
     wxZipEntry *GetNextEntry();
 
+    // find the entry with the given name in the central directory, this is
+    // much faster than iterating over all the entries in a big archive
+    wxZipEntry *FindEntry(const wxString& name,
+                          wxPathFormat format = wxPATH_NATIVE);
+
     wxString WXZIPFIX GetComment();
     int WXZIPFIX GetTotalEntries();
 
@@ -405,9 +435,13 @@ private:
     wxStreamError ReadLocal(bool readEndRec = false);
     wxStreamError ReadCentral();
 
-    wxUint32 ReadSignature();
+    wxUint32 ReadSignature() { return ReadSignature(*m_parent_i_stream); }
+    wxUint32 ReadSignature(wxInputStream& stream);
     bool FindEndRecord();
     bool LoadEndRecord();
+    void SetCentral(wxFileOffset size, wxFileOffset end);
+    bool LoadCentral();
+    wxInputStream *SeekCentral(wxFileOffset pos);
 
     bool AtHeader() const       { return m_headerSize == 0; }
     bool AfterHeader() const    { return m_headerSize > 0 && !m_decomp; }
@@ -432,6 +466,10 @@ private:
     wxFileOffset m_offsetAdjustment;
     wxFileOffset m_position;
     wxUint32 m_signature;
+    class wxMemoryInputStream *m_central;
+    wxFileOffset m_centralPos;
+    wxFileOffset m_centralSize;
+    class wxZipCentralIndex *m_index;
     size_t m_TotalEntries;
     wxString m_Comment;
 
@@ -78,6 +78,11 @@ class WXDLLIMPEXP_BASE wxZlibOutputStream: public wxFilterOutputStream {
   bool SetDictionary(const char *data, const size_t datalen);
   bool SetDictionary(const wxMemoryBuffer &buf);
 
+  // compress the data in blocks of the given size (0 for the default) using
+  // up to the given number of threads (0 for the number of CPUs), must be
+  // called before writing anything
+  bool SetThreadCount(int count, size_t blockSize = 0);
+
  protected:
   size_t OnSysWrite(const void *buffer, size_t size);
   wxFileOffset OnSysTell() const { return m_pos; }
@@ -92,6 +97,9 @@ class WXDLLIMPEXP_BASE wxZlibOutputStream: public wxFilterOutputStream {
   unsigned char *m_z_buffer;
   struct z_stream_s *m_deflate;
   wxFileOffset m_pos;
+  int m_level;
+  int m_flags;
+  class wxZlibParallelDeflate *m_parallel;
 
   wxDECLARE_NO_COPY_CLASS(wxZlibOutputStream);
 };
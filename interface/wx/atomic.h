@@ -22,15 +22,20 @@
     but is implemented in a generic way using a critical section which can be
     prohibitively expensive for use in performance-sensitive code.
 
+    Returns the value of the variable after the increment. Notice that in
+    wxWidgets versions before 3.1.0 this function didn't return anything.
+
     @header{wx/atomic.h}
 */
-void wxAtomicInc(wxAtomicInt& value);
+wxInt32 wxAtomicInc(wxAtomicInt& value);
 
 /**
     This function decrements value in an atomic manner.
 
-    Returns 0 if value is 0 after decrement or any non-zero value (not
-    necessarily equal to the value of the variable) otherwise.
+    Returns the value of the variable after the decrement. Notice that in
+    wxWidgets versions before 3.1.0 this function was only guaranteed to
+    return 0 if the value was 0 after decrement or some non-zero value
+    otherwise.
 
     @see wxAtomicInc
 
@@ -38,5 +43,19 @@ void wxAtomicInc(wxAtomicInt& value);
 */
 wxInt32 wxAtomicDec(wxAtomicInt& value);
 
+/**
+    This function adds @a delta, which may be negative, to @a value in an
+    atomic manner.
+
+    Returns the value of the variable after the addition.
+
+    @see wxAtomicInc
+
+    @since 3.1.0
+
+    @header{wx/atomic.h}
+*/
+wxInt32 wxAtomicAdd(wxAtomicInt& value, wxInt32 delta);
+
 //@}
 
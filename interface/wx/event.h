@@ -361,6 +361,38 @@ public:
 
 #if wxUSE_BASE
 
+/**
+    @struct wxPendingEventsStats
+
+    The counters of the events queued for later processing.
+
+    Objects of this type are returned by wxEvtHandler::GetPendingEventsStats().
+
+    @library{wxbase}
+    @category{events}
+
+    @since 3.1.0
+*/
+struct wxPendingEventsStats
+{
+    /**
+        Default constructor initializes all the counters to 0.
+     */
+    wxPendingEventsStats();
+
+    /// The number of events queued by wxEvtHandler::QueueEvent() or
+    /// wxEvtHandler::QueueOrReplaceEvent().
+    unsigned long queued;
+
+    /// The number of events replaced by a more recent event in
+    /// wxEvtHandler::QueueOrReplaceEvent() before being processed.
+    unsigned long coalesced;
+
+    /// The number of events deleted without being processed, e.g. by
+    /// wxEvtHandler::DeletePendingEvents().
+    unsigned long dropped;
+};
+
 /**
     @class wxEvtHandler
 
@@ -462,6 +494,58 @@ public:
      */
     virtual void QueueEvent(wxEvent *event);
 
+    /**
+        Queue event for a later processing, replacing an already pending one.
+
+        This function works like QueueEvent() except that if an event with the
+        same type (see wxEvent::GetEventType()) and the same id (see
+        wxEvent::GetId()) is already waiting to be processed by this handler,
+        the new event replaces it instead of being added to the end of the
+        queue. The replaced event is deleted and never processed.
+
+        This is useful for the events which are generated much more often than
+        they can be handled and for which only the last one matters, e.g.
+        progress notifications sent from a worker thread: using this function
+        for them prevents the queue from growing without bound if the main
+        thread can't keep up.
+
+        Notice that this function is not virtual and doesn't call QueueEvent().
+
+        @since 3.1.0
+
+        @param event
+            A heap-allocated event to be queued, this function takes ownership
+            of it. This parameter shouldn't be @c NULL.
+     */
+    void QueueOrReplaceEvent(wxEvent *event);
+
+    /**
+        Return the counters of the events queued by all event handlers.
+
+        The counters are incremented by QueueEvent(), QueueOrReplaceEvent()
+        and all the functions using them, such as AddPendingEvent() and
+        CallAfter(), and can be used to check whether the application queues
+        too many events.
+
+        The counters are global and are updated atomically by QueueEvent()
+        and QueueOrReplaceEvent(), so that all the threads posting events
+        update the same memory location. This cost is small compared to that
+        of queuing the event itself, but can become noticeable when many
+        threads post events at a very high rate.
+
+        @see ResetPendingEventsStats()
+
+        @since 3.1.0
+     */
+    static wxPendingEventsStats GetPendingEventsStats();
+
+    /**
+        Reset all the counters returned by GetPendingEventsStats() to 0.
+
+        @since 3.1.0
+     */
+    static void ResetPendingEventsStats();
+
     /**
         Post an event to be processed later.
 
@@ -1,6 +1,6 @@
 /////////////////////////////////////////////////////////////////////////////
 // Name:        file.h
-// Purpose:     interface of wxTempFile, wxFile
+// Purpose:     interface of wxTempFile, wxFile, wxMappedFile
 // Author:      wxWidgets team
 // Licence:     wxWindows licence
 /////////////////////////////////////////////////////////////////////////////
@@ -453,3 +453,121 @@ public:
     int fd() const;
 };
 
+
+
+/**
+    @class wxMappedFile
+
+    wxMappedFile provides read-only access to the entire contents of a file
+    as a contiguous block of memory.
+
+    Under Unix systems the file is mapped into the process address space
+    using @c mmap(), so its contents is read from disk only when it is
+    accessed and it is never copied into a separate buffer. If mapping the
+    file is not supported, either by the platform or by the file system, the
+    file contents is read in memory instead, so using this class always works
+    for the regular files.
+
+    Notice that if the mapped file is truncated by another process while it is
+    still mapped, accessing the part of it beyond its new end may result in a
+    crash under some systems, so this class should be only used for the files
+    which are not expected to be modified while they are being read. Also,
+    any data appended to the file after it was mapped is not accessible.
+    Because of this, wxWidgets itself never uses this class implicitly and
+    wxFile::Read() should be preferred for reading the files which can change.
+
+    Example of using this class:
+    @code
+    wxMappedFile file("data.bin");
+    if ( file.IsOpened() )
+    {
+        const char* data = static_cast<const char*>(file.GetData());
+        ... process file.GetLength() bytes of data ...
+    }
+    @endcode
+
+    @library{wxbase}
+    @category{file}
+
+    @see wxMappedFileInputStream
+
+    @since 3.1.0
+*/
+class wxMappedFile
+{
+public:
+    /**
+        Default constructor, Open() must be called later.
+    */
+    wxMappedFile();
+
+    /**
+        Constructor opening the file with the given name.
+
+        Use IsOpened() to check if it succeeded.
+    */
+    wxMappedFile(const wxString& filename);
+
+    /**
+        Constructor using an already opened file.
+
+        Use IsOpened() to check if it succeeded.
+    */
+    wxMappedFile(wxFile& file);
+
+    /**
+        Destructor calls Close().
+    */
+    ~wxMappedFile();
+
+    /**
+        Make the contents of the file with the given name available in memory.
+
+        Any previously opened file is closed first.
+
+        Returns @true on success or @false if the file couldn't be opened or
+        read, an error message is logged in this case.
+    */
+    bool Open(const wxString& filename);
+
+    /**
+        Make the contents of an already opened file available in memory.
+
+        The entire file contents is used, independently of the current
+        position in @a file which may be changed by this function. The file
+        doesn't need to remain opened after this function returns.
+    */
+    bool Open(wxFile& file);
+
+    /**
+        Unmap the file or free the memory used for its contents.
+
+        The pointer returned by GetData() becomes invalid after calling this
+        function.
+    */
+    void Close();
+
+    /**
+        Returns @true if the file contents is available.
+
+        Notice that this is the case for empty files too, but GetData()
+        returns @NULL for them.
+    */
+    bool IsOpened() const;
+
+    /**
+        Returns @true if the file is really mapped in memory or @false if its
+        contents had to be read.
+    */
+    bool IsMapped() const;
+
+    /**
+        Returns the pointer to the file contents.
+    */
+    const void* GetData() const;
+
+    /**
+        Returns the length of the file contents.
+    */
+    size_t GetLength() const;
+};
@@ -764,10 +764,31 @@ public:
         specified pixel @a blurRadius. This should not be used when using
         a single mask colour for transparency.
 
-        @see BlurHorizontal(), BlurVertical()
+        @see BlurHorizontal(), BlurVertical(), BlurGaussian()
     */
     wxImage Blur(int blurRadius) const;
 
+    /**
+        Blurs the image using an approximation of the Gaussian blur with the
+        given standard deviation.
+
+        The blur is approximated by three successive box blurs in each
+        direction, which looks much smoother than the single box blur done by
+        Blur(), while still taking the same time for any value of @a sigma.
+        As with the other blur functions, the alpha channel is blurred too
+        and this function should not be used when using a single mask colour
+        for transparency.
+
+        @param sigma
+            The standard deviation of the Gaussian, in pixels. Must be
+            non-negative, 0 returns an unchanged copy of the image.
+
+        @see Blur()
+
+        @since 3.1.0
+    */
+    wxImage BlurGaussian(double sigma) const;
+
     /**
         Blurs the image in the horizontal direction only. This should not be used
         when using a single mask colour for transparency.
@@ -1071,6 +1092,40 @@ public:
     */
     wxImage& operator=(const wxImage& image);
 
+    /**
+        Sets the number of threads used by the image processing functions.
+
+        Scale(), Blur(), BlurHorizontal(), BlurVertical(), Rotate90(),
+        ConvertToGreyscale() and ConvertToDisabled() can split sufficiently
+        large images into horizontal bands and process them in parallel.
+        By default only a single thread is used, call this function to enable
+        parallel processing.
+
+        Notice that small images are always processed in the current thread
+        as the overhead of launching the threads would exceed the gain.
+
+        @param count
+            The maximal number of threads to use. If it is @c 0, the number
+            of CPUs in the system is used.
+
+        @see GetThreadCount()
+
+        @since 3.1.0
+    */
+    static void SetThreadCount(int count);
+
+    /**
+        Returns the maximal number of threads used by the image processing
+        functions.
+
+        The returned value is always at least 1.
+
+        @see SetThreadCount()
+
+        @since 3.1.0
+    */
+    static int GetThreadCount();
+
     //@}
 
 
@@ -109,3 +109,71 @@ public:
     wxMessageQueueError ReceiveTimeout(long timeout, T& msg);
 };
 
+
+/**
+    wxLockFreeMessageQueue is a bounded message queue for passing messages
+    from one thread to another one.
+
+    This class has the same Post(), Receive() and ReceiveTimeout() methods as
+    wxMessageQueue, but, unlike it, doesn't use any locks unless the queue is
+    empty or full, making it much faster when a lot of messages are being
+    passed between the threads. However it can only be used by a single
+    producer thread, calling Post(), and a single consumer thread, calling
+    Receive() and ReceiveTimeout(). Also, as its capacity is limited, Post()
+    blocks if the queue is full until the consumer receives a message.
+
+    @tparam T
+        The type of the messages, which must be default constructible.
+
+    @since 3.1.0
+
+    @nolibrary
+    @category{threading}
+
+    @see wxMessageQueue, wxThread
+*/
+template <typename T>
+class wxLockFreeMessageQueue<T>
+{
+public:
+    /**
+        Create a queue which can hold at most @a capacity messages.
+    */
+    explicit wxLockFreeMessageQueue(size_t capacity = 1024);
+
+    /**
+        Returns @true if the object had been initialized successfully, @false
+        if an error occurred.
+    */
+    bool IsOk() const;
+
+    /**
+        Add a message to this queue and wake up the consumer thread if it's
+        waiting for it.
+
+        If the queue is full, this method blocks until there is space for the
+        new message in it.
+
+        This method must be only called by the single producer thread.
+    */
+    wxMessageQueueError Post(T const& msg);
+
+    /**
+        Block until a message becomes available in the queue.
+
+        This method must be only called by the single consumer thread.
+
+        @see wxMessageQueue::Receive()
+    */
+    wxMessageQueueError Receive(T& msg);
+
+    /**
+        Block until a message becomes available in the queue, but no more than
+        @a timeout milliseconds.
+
+        This method must be only called by the single consumer thread.
+
+        @see wxMessageQueue::ReceiveTimeout()
+    */
+    wxMessageQueueError ReceiveTimeout(long timeout, T& msg);
+};
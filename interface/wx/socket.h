@@ -695,6 +695,21 @@ enum
     wxSOCKET_WAITALL_WRITE = 512   ///< Wait for all required data to be written unless an error occurs.
 };
 
+/**
+    Describes one of the buffers used by wxSocketBase::ReadV() and
+    wxSocketBase::WriteV().
+
+    @since 3.1.0
+*/
+struct wxSocketIOVec
+{
+    /// Pointer to the buffer data.
+    void *buffer;
+
+    /// Size of the buffer in bytes.
+    wxUint32 nbytes;
+};
+
 
 /**
     @class wxSocketBase
@@ -1086,6 +1101,30 @@ public:
     */
     wxSocketBase& ReadMsg(void* buffer, wxUint32 nbytes);
 
+    /**
+        Read data into several buffers at once.
+
+        This function behaves as Read() reading the data into a single buffer
+        formed by concatenating all the given buffers, but fills all of them
+        using a single system call if possible.
+
+        Use LastReadCount() to verify the total number of bytes actually read.
+        Use Error() to determine if the operation succeeded.
+
+        @param vec
+            Array of buffers where to put read data, the buffers are filled in
+            order.
+        @param count
+            Number of elements in the @a vec array.
+
+        @return Returns a reference to the current object.
+
+        @since 3.1.0
+
+        @see Read(), WriteV(), SetFlags()
+    */
+    wxSocketBase& ReadV(const wxSocketIOVec* vec, size_t count);
+
     /**
         Use SetFlags to customize IO operation for this socket.
 
@@ -1325,6 +1364,61 @@ public:
     */
     wxSocketBase& WriteMsg(const void* buffer, wxUint32 nbytes);
 
+    /**
+        Write the data from several buffers at once.
+
+        This function behaves as Write() called with a single buffer formed by
+        concatenating all the given buffers, but avoids copying the data into
+        such buffer and writes all of them using a single system call if
+        possible. For datagram sockets, all buffers are sent in the same
+        datagram.
+
+        Use LastWriteCount() to verify the total number of bytes actually
+        written. Use Error() to determine if the operation succeeded.
+
+        @param vec
+            Array of buffers with the data to be sent, in order.
+        @param count
+            Number of elements in the @a vec array.
+
+        @return Returns a reference to the current object.
+
+        @since 3.1.0
+
+        @see Write(), ReadV(), SetFlags()
+    */
+    wxSocketBase& WriteV(const wxSocketIOVec* vec, size_t count);
+
+    /**
+        Send the contents of a file.
+
+        Sends up to @a nbytes bytes from the current position in @a file and
+        advances the file position by the number of bytes actually sent. This
+        function respects the socket flags in the same way as Write() does.
+
+        Under Linux the data is sent directly from the file by the kernel for
+        stream sockets, without being copied into the application memory,
+        otherwise it is read into a temporary buffer and sent from it.
+
+        Reaching the end of the file before sending @a nbytes is considered to
+        be an error.
+
+        Use LastWriteCount() to verify the number of bytes actually written.
+        Use Error() to determine if the operation succeeded.
+
+        @param file
+            The file opened for reading.
+        @param nbytes
+            Number of bytes to send.
+
+        @return Returns a reference to the current object.
+
+        @since 3.1.0
+
+        @see Write(), SetFlags()
+    */
+    wxSocketBase& SendFile(wxFile& file, wxUint32 nbytes);
+
     //@}
 
 
@@ -1520,7 +1520,26 @@ enum wxMutexType
     wxMUTEX_DEFAULT,
 
     /** Recursive mutex: don't use these ones with wxCondition. */
-    wxMUTEX_RECURSIVE
+    wxMUTEX_RECURSIVE,
+
+    /**
+        Non-recursive mutex which spins for a short time before blocking if
+        it is locked by another thread.
+
+        This is more efficient than wxMUTEX_DEFAULT for the mutexes protecting
+        very short critical sections and often used by several threads
+        simultaneously. The number of spinning iterations is adjusted
+        depending on how long it took to acquire the mutex previously and no
+        spinning is done on uniprocessor systems. Unlike with wxMUTEX_DEFAULT,
+        locking this mutex again from the thread already owning it is not
+        detected and results in a deadlock.
+
+        Currently this mutex type only differs from wxMUTEX_DEFAULT in the
+        Unix version.
+
+        @since 3.1.0
+     */
+    wxMUTEX_ADAPTIVE
 };
 
 
@@ -1668,6 +1687,179 @@ public:
 };
 
 
+/**
+    @class wxRWLock
+
+    A reader/writer lock can be held either by any number of readers or by a
+    single writer at the same time.
+
+    It is useful for protecting the data which is accessed by several threads
+    and read much more often than it is modified: unlike with wxMutex, the
+    threads only reading the data don't block each other.
+
+    Under Unix this class uses POSIX read-write locks and the preference given
+    to the waiting readers or writers depends on the system, elsewhere the
+    writers are always preferred. The lock is not recursive, i.e. a thread
+    already holding it must not lock it again.
+
+    Example:
+    @code
+    static wxRWLock s_lock;
+    static MyMap s_map;
+
+    wxString GetValue(const wxString& key)
+    {
+        wxReadLocker lock(s_lock);
+        return s_map[key];
+    }
+
+    void SetValue(const wxString& key, const wxString& value)
+    {
+        wxWriteLocker lock(s_lock);
+        s_map[key] = value;
+    }
+    @endcode
+
+    @since 3.1.0
+
+    @library{wxbase}
+    @category{threading}
+
+    @see wxMutex, wxReadLocker, wxWriteLocker
+*/
+class wxRWLock
+{
+public:
+    /**
+        Default constructor.
+    */
+    wxRWLock();
+
+    /**
+        Destroys the lock, which must not be held by any thread.
+    */
+    ~wxRWLock();
+
+    /**
+        Returns @true if the lock was successfully initialized.
+    */
+    bool IsOk() const;
+
+    /**
+        Locks the lock for reading, blocking while another thread holds it for
+        writing.
+
+        @return One of: @c wxMUTEX_NO_ERROR, @c wxMUTEX_DEAD_LOCK.
+    */
+    wxMutexError ReadLock();
+
+    /**
+        Tries to lock the lock for reading. If it can't, returns immediately
+        with an error.
+
+        @return One of: @c wxMUTEX_NO_ERROR, @c wxMUTEX_BUSY.
+    */
+    wxMutexError TryReadLock();
+
+    /**
+        Releases the lock acquired by ReadLock() or TryReadLock().
+
+        @return One of: @c wxMUTEX_NO_ERROR, @c wxMUTEX_UNLOCKED.
+    */
+    wxMutexError ReadUnlock();
+
+    /**
+        Locks the lock for writing, blocking while any other threads hold it
+        for reading or writing.
+
+        @return One of: @c wxMUTEX_NO_ERROR, @c wxMUTEX_DEAD_LOCK.
+    */
+    wxMutexError WriteLock();
+
+    /**
+        Tries to lock the lock for writing. If it can't, returns immediately
+        with an error.
+
+        @return One of: @c wxMUTEX_NO_ERROR, @c wxMUTEX_BUSY.
+    */
+    wxMutexError TryWriteLock();
+
+    /**
+        Releases the lock acquired by WriteLock() or TryWriteLock().
+
+        @return One of: @c wxMUTEX_NO_ERROR, @c wxMUTEX_UNLOCKED.
+    */
+    wxMutexError WriteUnlock();
+};
+
+/**
+    @class wxReadLocker
+
+    This is a small helper class locking wxRWLock for reading in its
+    constructor and unlocking it in its destructor.
+
+    @since 3.1.0
+
+    @library{wxbase}
+    @category{threading}
+
+    @see wxRWLock, wxWriteLocker
+*/
+class wxReadLocker
+{
+public:
+    /**
+        Locks the given lock for reading.
+        Call IsOk() to check if it was successfully locked.
+    */
+    wxReadLocker(wxRWLock& lock);
+
+    /**
+        Destructor releases the lock if it was successfully acquired in the
+        ctor.
+    */
+    ~wxReadLocker();
+
+    /**
+        Returns @true if the lock was acquired in the constructor.
+    */
+    bool IsOk() const;
+};
+
+/**
+    @class wxWriteLocker
+
+    This is a small helper class locking wxRWLock for writing in its
+    constructor and unlocking it in its destructor.
+
+    @since 3.1.0
+
+    @library{wxbase}
+    @category{threading}
+
+    @see wxRWLock, wxReadLocker
+*/
+class wxWriteLocker
+{
+public:
+    /**
+        Locks the given lock for writing.
+        Call IsOk() to check if it was successfully locked.
+    */
+    wxWriteLocker(wxRWLock& lock);
+
+    /**
+        Destructor releases the lock if it was successfully acquired in the
+        ctor.
+    */
+    ~wxWriteLocker();
+
+    /**
+        Returns @true if the lock was acquired in the constructor.
+    */
+    bool IsOk() const;
+};
+
 
 // ============================================================================
 // Global functions/macros
@@ -0,0 +1,230 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        wx/threadpool.h
+// Purpose:     interface of wxThreadPool and wxTask
+// Author:      wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+    wxTask represents a unit of work executed by wxThreadPool.
+
+    To use it, derive a class from wxTask, override its Run() method to
+    perform the work, storing its results in the members of the derived
+    class, and submit an object of this class to wxThreadPool::Submit(). The
+    object returned by Submit() can then be used as a future, i.e. to wait for
+    the task completion with Wait() and retrieve its results, or to cancel it.
+
+    Tasks are reference-counted and are deleted when the last reference to
+    them is released, so they must always be allocated on the heap and are
+    normally only used via wxObjectDataPtr<>.
+
+    Example:
+    @code
+    class SumTask : public wxTask
+    {
+    public:
+        SumTask(const wxVector<int>& values) : m_values(values), m_sum(0) { }
+
+        int GetSum() const { return m_sum; }
+
+    protected:
+        virtual void Run()
+        {
+            for ( size_t n = 0; n < m_values.size() && !IsCancelled(); n++ )
+                m_sum += m_values[n];
+        }
+
+    private:
+        const wxVector<int> m_values;
+        int m_sum;
+    };
+
+    wxObjectDataPtr<SumTask> task = wxThreadPool::Get().Submit(new SumTask(values));
+    ... do something else ...
+    task->Wait();
+    wxLogMessage("The sum is %d", task->GetSum());
+    @endcode
+
+    @since 3.1.0
+
+    @library{wxbase}
+    @category{threading}
+
+    @see wxThreadPool
+*/
+class wxTask
+{
+public:
+    /**
+        Default constructor.
+
+        The reference count of the new task is 1.
+    */
+    wxTask();
+
+    /**
+        Increment the reference count of the task.
+
+        This method can be called from any thread.
+    */
+    void IncRef();
+
+    /**
+        Decrement the reference count and delete the task if it drops to 0.
+
+        This method can be called from any thread.
+    */
+    void DecRef();
+
+    /**
+        Request the cancellation of the task.
+
+        If the task is still queued, it will never be run and becomes done
+        immediately. If it is already running, Run() is expected to check
+        IsCancelled() periodically and return as soon as possible when it
+        returns @true.
+    */
+    void Cancel();
+
+    /**
+        Return @true if Cancel() had been called.
+    */
+    bool IsCancelled() const;
+
+    /**
+        Return @true if the task has finished running or was cancelled before
+        starting to run.
+    */
+    bool IsDone() const;
+
+    /**
+        Wait until the task is done.
+
+        The task must have been already submitted to a pool. If this method is
+        called from a worker thread of the same pool, the other queued tasks
+        are executed while waiting, which allows the tasks to safely wait for
+        the other tasks they submitted.
+    */
+    void Wait();
+
+protected:
+    /**
+        The destructor is protected as the tasks must only be deleted by
+        DecRef().
+    */
+    virtual ~wxTask();
+
+    /**
+        Perform the work of the task.
+
+        This function is called in one of the worker threads of the pool and
+        so must not use any GUI functions.
+    */
+    virtual void Run() = 0;
+
+    /**
+        Called when the task is done if an event handler was specified when
+        submitting it.
+
+        This function is called in the main thread, from the event loop,
+        after the task finishes running or if it is cancelled before starting
+        to run, making it the right place to update the GUI with the task
+        results. The handler is tracked using a weak reference, so it can be
+        safely destroyed at any moment, even while the task is still running,
+        and this function is not called at all if the handler was destroyed
+        by the time it would be. The default implementation does nothing.
+    */
+    virtual void OnCompleted();
+};
+
+/**
+    wxThreadPool executes the submitted tasks using a fixed number of worker
+    threads.
+
+    Each worker thread has its own queue of tasks: the tasks submitted by a
+    task running in a worker thread are added to the queue of this thread,
+    while the tasks submitted from elsewhere are added to a shared queue. The
+    worker threads take the tasks from their own queues first, in LIFO order,
+    and, when it is empty, from the shared queue or from the queues of the
+    other workers, in FIFO order. This "work stealing" strategy makes
+    splitting the work recursively into smaller tasks efficient.
+
+    The worker threads are created when the first task is submitted. If they
+    can't be created, the tasks are run synchronously by Submit().
+
+    The global pool returned by Get() can be used by any code which doesn't
+    need a dedicated pool.
+
+    @since 3.1.0
+
+    @library{wxbase}
+    @category{threading}
+
+    @see wxTask, wxThread
+*/
+class wxThreadPool
+{
+public:
+    /**
+        Create a pool with the given number of threads.
+
+        @param numThreads
+            The number of the worker threads, if it is not positive, the value
+            returned by GetDefaultThreadCount() is used.
+    */
+    wxThreadPool(int numThreads = -1);
+
+    /**
+        Destructor cancels all the tasks which haven't started running yet and
+        waits until the running ones finish.
+    */
+    ~wxThreadPool();
+
+    /**
+        Return the global pool.
+
+        This pool uses the default number of threads and is created on first
+        use and destroyed when the library is shut down.
+    */
+    static wxThreadPool& Get();
+
+    /**
+        Return the number of threads of this pool.
+    */
+    int GetThreadCount() const;
+
+    /**
+        Return the default number of threads, i.e. the number of CPUs as
+        returned by wxThread::GetCPUCount() or 1 if it is unknown.
+    */
+    static int GetDefaultThreadCount();
+
+    /**
+        Submit a task for execution.
+
+        This method can be called from any thread, including the worker
+        threads of this pool, but only if @a handler is @NULL: a task with a
+        completion handler can only be submitted from the main thread.
+
+        @param task
+            The task to execute, must be non-@NULL and must not have been
+            submitted before. The pool takes ownership of the reference to
+            it, so the caller must use the returned pointer to access it later.
+        @param handler
+            If non-@NULL, wxTask::OnCompleted() is called in the main thread
+            when the task is done, unless this handler is destroyed before it.
+        @return
+            Pointer to the task which can be used to wait for it, cancel it or
+            access its results.
+    */
+    template <class T>
+    wxObjectDataPtr<T> Submit(T *task, wxEvtHandler *handler = NULL);
+
+    /**
+        Wait until all the tasks submitted to this pool are done.
+
+        This function can't be called from the worker threads of this pool,
+        use wxTask::Wait() there instead.
+    */
+    void WaitAll();
+};
@@ -217,6 +217,58 @@ public:
 
 
 
+/**
+    @class wxMappedFileInputStream
+
+    This class represents data read from a memory mapped file.
+
+    It is a wxMemoryInputStream over the contents of a wxMappedFile, so
+    reading from it doesn't involve any system calls and seeking in it is
+    cheap. This makes it a better choice than wxFileInputStream for reading
+    big files, such as images or archives, entirely and it also doesn't need
+    to be wrapped in wxBufferedInputStream. However the same restrictions as
+    for wxMappedFile apply to it, i.e. the file must not be truncated while
+    it is being read from.
+
+    For example, to load an image from a memory mapped file:
+    @code
+    wxMappedFileInputStream stream("image.png");
+    wxImage image;
+    if ( stream.IsOk() && image.LoadFile(stream) )
+        ... use the image ...
+    @endcode
+
+    @library{wxbase}
+    @category{streams}
+
+    @see wxMappedFile, wxFileInputStream
+
+    @since 3.1.0
+*/
+class wxMappedFileInputStream : public wxMemoryInputStream
+{
+public:
+    /**
+        Opens the specified file and maps it in memory.
+
+        @warning
+        You should use wxStreamBase::IsOk() to verify if the constructor succeeded.
+    */
+    wxMappedFileInputStream(const wxString& fileName);
+
+    /**
+        Maps the entire contents of an already opened file in memory.
+    */
+    wxMappedFileInputStream(wxFile& file);
+
+    /**
+        Returns the object providing direct access to the file contents.
+    */
+    const wxMappedFile& GetMappedFile() const;
+};
+
+
+
 /**
     @class wxFFileInputStream
 
@@ -440,7 +440,16 @@ public:
 enum wxXmlDocumentLoadFlag
 {
     wxXMLDOC_NONE,
-    wxXMLDOC_KEEP_WHITESPACE_NODES
+    wxXMLDOC_KEEP_WHITESPACE_NODES,
+
+    /**
+        Allocate the nodes and attributes in big memory blocks.
+
+        See wxXmlDocument::Load() for more details.
+
+        @since 3.1.0
+     */
+    wxXMLDOC_USE_ARENA
 };
 
 
@@ -650,6 +659,16 @@ public:
         less memory however makes impossible to recreate exactly the loaded text with a
         Save() call later. Read the initial description of this class for more info.
 
+        If @a flags contains wxXMLDOC_USE_ARENA, all the wxXmlNode and
+        wxXmlAttribute objects created while loading are allocated from big
+        blocks of memory instead of being allocated individually, which makes
+        loading big documents significantly faster. The loaded nodes can still
+        be used, detached and deleted as usual and can even outlive the
+        document, however the memory used by them is only freed when all the
+        nodes loaded at once are deleted. Because of this, this flag shouldn't
+        be used if the loaded document is going to be modified a lot.
+        This flag is available since wxWidgets 3.1.0.
+
         Returns true on success, false otherwise.
     */
     virtual bool Load(const wxString& filename,
@@ -727,3 +746,248 @@ public:
     static wxVersionInfo GetLibraryVersionInfo();
 };
 
+
+
+/**
+    @class wxXmlAttributesView
+
+    Read-only view of the attributes of an element parsed by wxXmlReader.
+
+    Objects of this class are passed to wxXmlReader::OnStartElement() and
+    provide access to the attributes of the element without copying them:
+    all the strings returned by the functions with @c UTF8 suffix point
+    directly into the parser buffer and are only valid until
+    OnStartElement() returns. The functions returning wxString make a copy
+    of the data and can be used if it needs to be preserved.
+
+    @since 3.1.0
+
+    @library{wxxml}
+    @category{xml}
+
+    @see wxXmlReader
+*/
+class wxXmlAttributesView
+{
+public:
+    /**
+        Creates the view for the given @NULL-terminated array of attribute
+        names and values, in the format used by expat.
+
+        This constructor is only used by wxXmlReader.
+    */
+    explicit wxXmlAttributesView(const char **atts);
+
+    /**
+        Returns the number of attributes.
+    */
+    size_t GetCount() const;
+
+    /**
+        Returns the name of the attribute with the given index in UTF-8.
+
+        @a n must be less than GetCount().
+    */
+    const char *GetNameUTF8(size_t n) const;
+
+    /**
+        Returns the value of the attribute with the given index in UTF-8.
+
+        @a n must be less than GetCount().
+    */
+    const char *GetValueUTF8(size_t n) const;
+
+    /**
+        Returns the name of the attribute with the given index.
+    */
+    wxString GetName(size_t n) const;
+
+    /**
+        Returns the value of the attribute with the given index.
+    */
+    wxString GetValue(size_t n) const;
+
+    /**
+        Returns the value of the attribute with the given UTF-8 name, or @NULL
+        if there is no such attribute.
+
+        This function doesn't allocate any memory.
+    */
+    const char *FindUTF8(const char *name) const;
+
+    /**
+        Returns @true if an attribute with the given name exists and copies
+        its value to @a value if it is non-@NULL.
+    */
+    bool GetAttribute(const wxString& name, wxString *value) const;
+
+    /**
+        Returns @true if an attribute with the given name exists.
+    */
+    bool HasAttribute(const wxString& name) const;
+};
+
+
+/**
+    @class wxXmlReader
+
+    Streaming XML parser.
+
+    Unlike wxXmlDocument, which builds the tree of wxXmlNode objects
+    representing the entire document in memory, this class calls its virtual
+    callbacks for the different parts of the document as soon as they're
+    parsed and doesn't store anything. This allows processing XML documents of
+    arbitrary size using a small, constant amount of memory.
+
+    To use it, derive a new class from wxXmlReader, override the callbacks
+    for the parts of the document you're interested in and call Parse():
+    @code
+    class ItemsCounter : public wxXmlReader
+    {
+    public:
+        ItemsCounter() : m_count(0) { }
+
+        virtual void OnStartElement(const char *name,
+                                    const wxXmlAttributesView& attrs)
+        {
+            if ( strcmp(name, "item") == 0 && attrs.FindUTF8("id") )
+                m_count++;
+        }
+
+        int m_count;
+    };
+
+    ItemsCounter counter;
+    if ( counter.Parse("huge.xml") )
+        wxLogMessage("%d items found", counter.m_count);
+    @endcode
+
+    All the strings passed to the callbacks are in UTF-8, independently of the
+    encoding of the document, and are only valid during the callback
+    execution. No conversion to wxString is done by wxXmlReader itself.
+
+    @since 3.1.0
+
+    @library{wxxml}
+    @category{xml}
+
+    @see wxXmlDocument
+*/
+class wxXmlReader
+{
+public:
+    /**
+        Default constructor.
+    */
+    wxXmlReader();
+
+    /**
+        Virtual destructor.
+
+        Notice that the reader must not be destroyed while parsing.
+    */
+    virtual ~wxXmlReader();
+
+    /**
+        Parses the file with the given name.
+
+        Returns @false if the file couldn't be opened or an error occurred
+        while parsing it.
+    */
+    bool Parse(const wxString& filename);
+
+    /**
+        Parses the data read from the given stream.
+
+        The stream is read until its end or until an error occurs.
+
+        Returns @false if an error occurred while reading or parsing the data.
+        The errors are logged using wxLogError(). If parsing was stopped by
+        calling Stop(), @true is returned.
+    */
+    bool Parse(wxInputStream& stream);
+
+    /**
+        Stops parsing.
+
+        This function can only be called from one of the callbacks and makes
+        Parse() return as soon as the callback returns, without calling any
+        other callbacks.
+    */
+    void Stop();
+
+    /**
+        Returns @true if the last call to Parse() was stopped by Stop().
+    */
+    bool WasStopped() const;
+
+    /**
+        Returns the line number of the part of the document being parsed.
+
+        This function can only be called from the callbacks.
+    */
+    int GetLineNumber() const;
+
+    /**
+        Returns the number of the currently open elements.
+
+        This is 1 inside OnStartElement() and OnEndElement() for the root
+        element, 2 for its children and so on.
+    */
+    int GetDepth() const;
+
+
+    /**
+        Called at the start of an element.
+
+        @param name
+            The name of the element.
+        @param attrs
+            The attributes of the element.
+    */
+    virtual void OnStartElement(const char *name,
+                                const wxXmlAttributesView& attrs);
+
+    /**
+        Called at the end of an element.
+
+        This is called even for the empty elements, such as @c \<x/\>.
+    */
+    virtual void OnEndElement(const char *name);
+
+    /**
+        Called with the text contents of an element or of a CDATA section.
+
+        Note that the text is not @NUL-terminated and that a single text node
+        may be passed to this function in several chunks, e.g. each line may
+        be passed separately.
+    */
+    virtual void OnText(const char *text, size_t len);
+
+    /**
+        Called at the start of a CDATA section.
+
+        The contents of the section is passed to OnText() after calling this
+        function and before calling OnEndCData().
+    */
+    virtual void OnStartCData();
+
+    /**
+        Called at the end of a CDATA section.
+    */
+    virtual void OnEndCData();
+
+    /**
+        Called for each comment in the document.
+    */
+    virtual void OnComment(const char *text);
+
+    /**
+        Called for each processing instruction in the document.
+
+        The XML declaration, i.e. the @c \<?xml ... ?\> header, is not a
+        processing instruction and is not passed to this function.
+    */
+    virtual void OnProcessingInstruction(const char *target,
+                                         const char *data);
+};
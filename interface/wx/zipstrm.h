@@ -80,6 +80,21 @@ enum wxZipFlags
     wxZIP_RESERVED          = 0xF000
 };
 
+/**
+    Formats of the zips written by wxZipOutputStream, see
+    wxZipOutputStream::SetFormat().
+
+    @since 3.1.0
+*/
+enum wxZipArchiveFormat
+{
+    /// The zip64 extensions are only used where they are needed.
+    wxZIP_FORMAT_DEFAULT,
+
+    /// The zip64 extensions are used for all the entries.
+    wxZIP_FORMAT_ZIP64
+};
+
 
 /**
     @class wxZipNotifier
@@ -361,6 +376,9 @@ public:
     Note that in general zip entries are not seekable, and
     wxZipInputStream::SeekI() always returns ::wxInvalidOffset.
 
+    Since wxWidgets 3.1.0 zips using the zip64 extensions, i.e. with entries
+    bigger than 4GB or with more than 65535 entries, are supported too.
+
     @library{wxbase}
     @category{archive,streams}
 
@@ -416,6 +434,33 @@ public:
     */
     wxZipEntry* GetNextEntry();
 
+    /**
+        Finds the entry with the given name in the zip central directory and
+        returns it in a wxZipEntry object, giving away ownership, or returns
+        @NULL if there is no such entry.
+
+        The name is compared with the internal names of the entries, see
+        wxZipEntry::GetInternalName(), so the leading and trailing path
+        separators don't matter. If the zip contains several entries with the
+        same name, the first one of them is returned.
+
+        Unlike iterating over the entries using GetNextEntry() until the
+        right one is found, this function doesn't need to read all the entries
+        preceding the one being searched for. The central directory is read
+        into memory and indexed when this function is called for the first
+        time, after which looking up the entries is done in constant time.
+
+        The entry is not opened and the position of the stream in the list of
+        entries returned by GetNextEntry() is not changed. Use OpenEntry() to
+        read the entry data.
+
+        The zip must be on a seekable stream.
+
+        @since 3.1.0
+    */
+    wxZipEntry* FindEntry(const wxString& name,
+                          wxPathFormat format = wxPATH_NATIVE);
+
     /**
         For a zip on a seekable stream returns the total number of entries in
         the zip. For zips on non-seekable streams returns the number of entries
@@ -468,6 +513,13 @@ public:
     Another call to wxZipOutputStream::PutNextEntry() closes the current
     entry and begins the next.
 
+    The zip64 extensions are used automatically for the entries and archives
+    which need them, i.e. those bigger than 4GB or with more than 65535
+    entries. The only exception is an entry whose size isn't known in advance:
+    as its header is written before its data, such entries can only be bigger
+    than 4GB if wxZIP_FORMAT_ZIP64 is set using SetFormat(), even when writing
+    to a seekable stream.
+
     @library{wxbase}
     @category{archive,streams}
 
@@ -548,6 +600,42 @@ public:
     void SetLevel(int level);
     //@}
 
+    //@{
+    /**
+        Set the format of the zip being written.
+
+        By default, the zip64 extensions are only used when they are needed.
+        If the format is set to wxZIP_FORMAT_ZIP64 they are used for all the
+        entries created afterwards and for the end of the archive, which is
+        needed to write entries bigger than 4GB whose size isn't known when
+        they are created. Note that such archives
+        can't be read by programs not supporting zip64.
+
+        @since 3.1.0
+    */
+    wxZipArchiveFormat GetFormat() const;
+    void SetFormat(wxZipArchiveFormat format);
+    //@}
+
+    //@{
+    /**
+        Set the number of threads used to compress the entries.
+
+        By default the entries are compressed in the current thread. If
+        @a count is different from 1, the data of each deflated entry is
+        compressed in blocks of @a blockSize bytes using up to @a count
+        threads (or as many as there are CPUs if it is @c 0), see
+        wxZlibOutputStream::SetThreadCount(). The resulting archive can be
+        read by any program supporting zip files.
+
+        Takes effect from the next entry created.
+
+        @since 3.1.0
+    */
+    int GetThreadCount() const;
+    void SetThreadCount(int count, size_t blockSize = 0);
+    //@}
+
     /**
         Create a new directory entry (see wxArchiveEntry::IsDir) with the given
         name and timestamp.
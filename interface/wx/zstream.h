@@ -88,6 +88,39 @@ public:
     bool SetDictionary(const char *data, const size_t datalen);
     bool SetDictionary(const wxMemoryBuffer &buf);
     //@}
+
+    /**
+        Enables compressing the data using several threads.
+
+        In this mode the data written to the stream is split into blocks of
+        the given size which are compressed independently in worker threads,
+        using the end of the preceding block as dictionary, and then written
+        out in order. The result is a normal zlib, gzip or raw deflate stream
+        which is slightly bigger than the one produced by the default serial
+        compression, but it can be created several times faster on a machine
+        with multiple CPUs. The threads are only started once at least one
+        full block has been written, so small streams are still compressed in
+        the current thread.
+
+        This function must be called before writing any data to the stream
+        and before calling SetDictionary().
+
+        @param count
+            The maximal number of worker threads to use. If it is @c 0, the
+            number of CPUs in the system is used. If it is @c 1, the data is
+            compressed serially, as by default.
+        @param blockSize
+            The size of the uncompressed data blocks, if @c 0 the default
+            size of 128KB is used. Larger blocks compress slightly better
+            but require more memory, as up to twice as many blocks as there
+            are threads may be kept in memory at once.
+        @return
+            @true if the compression mode was changed or @false if it is too
+            late to do it or wxWidgets was built without threads support.
+
+        @since 3.1.0
+    */
+    bool SetThreadCount(int count, size_t blockSize = 0);
 };
 
 
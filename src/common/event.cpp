@@ -45,7 +45,9 @@
     #endif // wxUSE_GUI
 #endif
 
+#include "wx/atomic.h"
 #include "wx/thread.h"
+#include "wx/vector.h"
 
 #if wxUSE_BASE
     #include "wx/scopedptr.h"
@@ -1100,6 +1102,314 @@ void wxEventHashTable::GrowEventTypeTable()
     delete[] oldEventTypeTable;
 }
 
+// ----------------------------------------------------------------------------
+// wxEvtHandler::DynamicEvents
+// ----------------------------------------------------------------------------
+
+// The dynamic event table entries of a wxEvtHandler are grouped by their event
+// type, so that processing an event only needs to look at the handlers for
+// this event type. The groups are kept sorted by the event type to find the
+// group for the given event using binary search.
+class wxEvtHandler::DynamicEvents
+{
+public:
+    // All entries for the same event type in the order in which they were
+    // bound, i.e. with the most recently bound one, which must be tried
+    // first, at the end.
+    //
+    // As an entry can be unbound by an event handler while an event is being
+    // dispatched to the entries of the same group, possibly by several nested
+    // calls to SearchDynamicEventTable(), the entries are not erased from it
+    // while this happens but replaced with NULL and pruned when the outermost
+    // dispatch ends.
+    typedef wxVector<wxDynamicEventTableEntry*> Entries;
+
+    struct Group
+    {
+        explicit Group(wxEventType eventType_)
+            : eventType(eventType_),
+              dispatchDepth(0),
+              needsPruning(false),
+              orphaned(false)
+        {
+        }
+
+        // Remove the entry with the given index, erasing it immediately if
+        // no events are being dispatched to this group.
+        void Remove(size_t n)
+        {
+            if ( dispatchDepth )
+            {
+                entries[n] = NULL;
+                needsPruning = true;
+            }
+            else
+            {
+                entries.erase(entries.begin() + n);
+            }
+        }
+
+        // Must be called before and after dispatching an event to the
+        // entries of this group.
+        void BeginDispatch() { dispatchDepth++; }
+
+        bool IsBeingDispatched() const { return dispatchDepth != 0; }
+
+        void EndDispatch()
+        {
+            if ( --dispatchDepth )
+                return;
+
+            if ( orphaned )
+            {
+                // The event handler was destroyed during the dispatch.
+                delete this;
+                return;
+            }
+
+            if ( needsPruning )
+            {
+                Prune();
+                needsPruning = false;
+            }
+        }
+
+        // Called instead of deleting the group while an event is being
+        // dispatched to it: it will be deleted when the dispatch ends.
+        void Orphan()
+        {
+            // The entries themselves are deleted by wxEvtHandler.
+            for ( size_t n = 0; n < entries.size(); n++ )
+                entries[n] = NULL;
+
+            orphaned = true;
+        }
+
+        wxEventType eventType;
+        Entries entries;
+
+    private:
+        // Erase all the NULL entries.
+        void Prune()
+        {
+            size_t numEntries = 0;
+            for ( size_t n = 0; n < entries.size(); n++ )
+            {
+                if ( entries[n] )
+                    entries[numEntries++] = entries[n];
+            }
+
+            entries.erase(entries.begin() + numEntries, entries.end());
+        }
+
+        // The number of the events being currently dispatched to this group.
+        int dispatchDepth;
+
+        // True if some entries were removed during the dispatch.
+        bool needsPruning;
+
+        // True if the group must be deleted when the dispatch ends.
+        bool orphaned;
+    };
+
+    // Notice that the groups are never deleted, even if they become empty,
+    // before the event handler itself, so the pointers to them remain valid
+    // even if new groups are added while an event is being dispatched.
+    typedef wxVector<Group*> Groups;
+
+    DynamicEvents() { }
+
+    ~DynamicEvents()
+    {
+        for ( size_t n = 0; n < m_groups.size(); n++ )
+        {
+            Group * const group = m_groups[n];
+            if ( group->IsBeingDispatched() )
+                group->Orphan();
+            else
+                delete group;
+        }
+    }
+
+    const Groups& GetGroups() const { return m_groups; }
+
+    // Return the group for the given event type or NULL if there is none.
+    Group* Find(wxEventType eventType) const
+    {
+        const size_t n = LowerBound(eventType);
+        if ( n == m_groups.size() || m_groups[n]->eventType != eventType )
+            return NULL;
+
+        return m_groups[n];
+    }
+
+    void Add(wxDynamicEventTableEntry* entry)
+    {
+        const size_t n = LowerBound(entry->m_eventType);
+        if ( n == m_groups.size() || m_groups[n]->eventType != entry->m_eventType )
+            m_groups.insert(m_groups.begin() + n, new Group(entry->m_eventType));
+
+        m_groups[n]->entries.push_back(entry);
+    }
+
+private:
+    // Return the index of the first group with the event type not less than
+    // the given one.
+    size_t LowerBound(wxEventType eventType) const
+    {
+        size_t lo = 0,
+               hi = m_groups.size();
+        while ( lo < hi )
+        {
+            const size_t mid = (lo + hi) / 2;
+            if ( m_groups[mid]->eventType < eventType )
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+
+        return lo;
+    }
+
+    Groups m_groups;
+
+    wxDECLARE_NO_COPY_CLASS(DynamicEvents);
+};
+
+// ----------------------------------------------------------------------------
+// wxEvtHandler::PendingEvents
+// ----------------------------------------------------------------------------
+
+// The queue of the events waiting to be processed by ProcessPendingEvents().
+//
+// It is implemented as a ring buffer to avoid allocating anything for each
+// queued event once the buffer has grown to accommodate the usual number of
+// the pending events. It is always used under m_pendingEventsLock.
+class wxEvtHandler::PendingEvents
+{
+public:
+    PendingEvents()
+    {
+        m_first = 0;
+        m_count = 0;
+    }
+
+    bool IsEmpty() const { return m_count == 0; }
+    size_t GetCount() const { return m_count; }
+
+    // Return the n-th event from the start of the queue.
+    wxEvent*& operator[](size_t n)
+    {
+        return m_events[(m_first + n) & (m_events.size() - 1)];
+    }
+
+    void Append(wxEvent* event)
+    {
+        if ( m_count == m_events.size() )
+            Grow();
+
+        (*this)[m_count++] = event;
+    }
+
+    // Remove the n-th event from the queue without deleting it.
+    void Erase(size_t n)
+    {
+        if ( n == 0 )
+        {
+            m_first = (m_first + 1) & (m_events.size() - 1);
+        }
+        else
+        {
+            // This only happens when some events are skipped while yielding
+            // and so is not worth optimizing.
+            for ( ; n < m_count - 1; n++ )
+                (*this)[n] = (*this)[n + 1];
+        }
+
+        if ( --m_count == 0 )
+        {
+            m_first = 0;
+
+            // Don't keep the memory used by a burst of events forever.
+            if ( m_events.size() > MAX_IDLE_CAPACITY )
+                m_events.clear();
+        }
+    }
+
+    // Return the index of the event with the given type and id or wxNOT_FOUND.
+    int Find(wxEventType eventType, int id)
+    {
+        // Search from the end as the event we're looking for was typically
+        // queued recently.
+        for ( size_t n = m_count; n > 0; )
+        {
+            const wxEvent* const event = (*this)[--n];
+            if ( event->GetEventType() == eventType && event->GetId() == id )
+                return static_cast<int>(n);
+        }
+
+        return wxNOT_FOUND;
+    }
+
+    // Delete all the events in the queue and return their number.
+    size_t DeleteAll()
+    {
+        const size_t count = m_count;
+        for ( size_t n = 0; n < count; n++ )
+            delete (*this)[n];
+
+        m_events.clear();
+        m_first = 0;
+        m_count = 0;
+
+        return count;
+    }
+
+private:
+    // The capacity of the buffer is always a power of 2 to make computing the
+    // index of the element in it cheap.
+    enum
+    {
+        MIN_CAPACITY = 16,
+        MAX_IDLE_CAPACITY = 1024
+    };
+
+    void Grow()
+    {
+        wxVector<wxEvent*> events(m_events.empty() ? size_t(MIN_CAPACITY)
+                                                   : 2*m_events.size());
+        for ( size_t n = 0; n < m_count; n++ )
+            events[n] = (*this)[n];
+
+        m_events.swap(events);
+        m_first = 0;
+    }
+
+    wxVector<wxEvent*> m_events;
+
+    // Index of the first event in m_events and the number of events.
+    size_t m_first,
+           m_count;
+
+    wxDECLARE_NO_COPY_CLASS(PendingEvents);
+};
+
+namespace
+{
+
+// The counters returned by wxEvtHandler::GetPendingEventsStats().
+//
+// Notice that these counters are global and so every QueueEvent() call, from
+// whichever thread, does an atomic increment of gs_numEventsQueued: threads
+// posting events concurrently contend on the same cache line. This is cheap
+// compared to the event allocation and the handler lock which QueueEvent()
+// needs anyhow, but avoid adding any more global updates to this path.
+wxUint32 gs_numEventsQueued = 0,
+         gs_numEventsCoalesced = 0,
+         gs_numEventsDropped = 0;
+
+} // anonymous namespace
+
 // ----------------------------------------------------------------------------
 // wxEvtHandler
 // ----------------------------------------------------------------------------
@@ -1123,29 +1433,33 @@ wxEvtHandler::~wxEvtHandler()
 
     if (m_dynamicEvents)
     {
-        for ( wxList::iterator it = m_dynamicEvents->begin(),
-                               end = m_dynamicEvents->end();
-              it != end;
-              ++it )
+        const DynamicEvents::Groups& groups = m_dynamicEvents->GetGroups();
+        for ( size_t n = 0; n < groups.size(); n++ )
         {
-            wxDynamicEventTableEntry *entry = (wxDynamicEventTableEntry*)*it;
-
-            // Remove ourselves from sink destructor notifications
-            // (this has usually been done, in wxTrackable destructor)
-            wxEvtHandler *eventSink = entry->m_fn->GetEvtHandler();
-            if ( eventSink )
+            const DynamicEvents::Entries& entries = groups[n]->entries;
+            for ( size_t m = 0; m < entries.size(); m++ )
             {
-                wxEventConnectionRef * const
-                    evtConnRef = FindRefInTrackerList(eventSink);
-                if ( evtConnRef )
+                wxDynamicEventTableEntry * const entry = entries[m];
+                if ( !entry )
+                    continue;
+
+                // Remove ourselves from sink destructor notifications
+                // (this has usually been done, in wxTrackable destructor)
+                wxEvtHandler *eventSink = entry->m_fn->GetEvtHandler();
+                if ( eventSink )
                 {
-                    eventSink->RemoveNode(evtConnRef);
-                    delete evtConnRef;
+                    wxEventConnectionRef * const
+                        evtConnRef = FindRefInTrackerList(eventSink);
+                    if ( evtConnRef )
+                    {
+                        eventSink->RemoveNode(evtConnRef);
+                        delete evtConnRef;
+                    }
                 }
-            }
 
-            delete entry->m_callbackUserData;
-            delete entry;
+                delete entry->m_callbackUserData;
+                delete entry;
+            }
         }
         delete m_dynamicEvents;
     }
@@ -1236,9 +1550,21 @@ bool wxEvtHandler::ProcessThreadEvent(const wxEvent& event)
 #endif // wxUSE_THREADS
 
 void wxEvtHandler::QueueEvent(wxEvent *event)
+{
+    DoQueueEvent(event, false);
+}
+
+void wxEvtHandler::QueueOrReplaceEvent(wxEvent *event)
+{
+    DoQueueEvent(event, true);
+}
+
+void wxEvtHandler::DoQueueEvent(wxEvent *event, bool replace)
 {
     wxCHECK_RET( event, "NULL event can't be posted" );
 
+    wxAtomicInc(gs_numEventsQueued);
+
     if (!wxTheApp)
     {
         // we need an event loop which manages the list of event handlers with
@@ -1248,6 +1574,8 @@ void wxEvtHandler::QueueEvent(wxEvent *event)
         // anyway delete the given event to avoid memory leaks
         delete event;
 
+        wxAtomicInc(gs_numEventsDropped);
+
         return;
     }
 
@@ -1255,7 +1583,32 @@ void wxEvtHandler::QueueEvent(wxEvent *event)
     wxENTER_CRIT_SECT( m_pendingEventsLock );
 
     if ( !m_pendingEvents )
-        m_pendingEvents = new wxList;
+        m_pendingEvents = new PendingEvents;
+
+    if ( replace )
+    {
+        const int n = m_pendingEvents->Find(event->GetEventType(),
+                                            event->GetId());
+        if ( n != wxNOT_FOUND )
+        {
+            // Just replace the existing event with the new one, this handler
+            // is already in the list of handlers with pending events, so
+            // there is nothing else to do.
+            wxEvent*& pending = (*m_pendingEvents)[n];
+            wxEvent* const old = pending;
+            pending = event;
+
+            wxLEAVE_CRIT_SECT( m_pendingEventsLock );
+
+            // Don't delete the old event while holding the lock, its dtor
+            // could do anything.
+            delete old;
+
+            wxAtomicInc(gs_numEventsCoalesced);
+
+            return;
+        }
+    }
 
     m_pendingEvents->Append(event);
 
@@ -1280,10 +1633,32 @@ void wxEvtHandler::QueueEvent(wxEvent *event)
 void wxEvtHandler::DeletePendingEvents()
 {
     if (m_pendingEvents)
-        m_pendingEvents->DeleteContents(true);
+    {
+        const size_t count = m_pendingEvents->DeleteAll();
+        if ( count )
+            wxAtomicAdd(gs_numEventsDropped, static_cast<wxInt32>(count));
+    }
     wxDELETE(m_pendingEvents);
 }
 
+/* static */
+wxPendingEventsStats wxEvtHandler::GetPendingEventsStats()
+{
+    wxPendingEventsStats stats;
+    stats.queued = gs_numEventsQueued;
+    stats.coalesced = gs_numEventsCoalesced;
+    stats.dropped = gs_numEventsDropped;
+    return stats;
+}
+
+/* static */
+void wxEvtHandler::ResetPendingEventsStats()
+{
+    gs_numEventsQueued =
+    gs_numEventsCoalesced =
+    gs_numEventsDropped = 0;
+}
+
 void wxEvtHandler::ProcessPendingEvents()
 {
     if (!wxTheApp)
@@ -1305,20 +1680,23 @@ void wxEvtHandler::ProcessPendingEvents()
     wxCHECK_RET( m_pendingEvents && !m_pendingEvents->IsEmpty(),
                  "should have pending events if called" );
 
-    wxList::compatibility_iterator node = m_pendingEvents->GetFirst();
-    wxEvent* pEvent = static_cast<wxEvent *>(node->GetData());
+    size_t n = 0;
 
     // find the first event which can be processed now:
     wxEventLoopBase* evtLoop = wxEventLoopBase::GetActive();
     if (evtLoop && evtLoop->IsYielding())
     {
-        while (node && pEvent && !evtLoop->IsEventAllowedInsideYield(pEvent->GetEventCategory()))
+        const size_t count = m_pendingEvents->GetCount();
+        while ( n < count &&
+                    !evtLoop->IsEventAllowedInsideYield
+                     (
+                        (*m_pendingEvents)[n]->GetEventCategory()
+                     ) )
         {
-            node = node->GetNext();
-            pEvent = node ? static_cast<wxEvent *>(node->GetData()) : NULL;
+            n++;
         }
 
-        if (!node)
+        if ( n == count )
         {
             // all our events are NOT processable now... signal this:
             wxTheApp->DelayPendingEventHandler(this);
@@ -1332,12 +1710,12 @@ void wxEvtHandler::ProcessPendingEvents()
         }
     }
 
-    wxEventPtr event(pEvent);
+    wxEventPtr event((*m_pendingEvents)[n]);
 
     // it's important we remove event from list before processing it, else a
     // nested event loop, for example from a modal dialog, might process the
     // same event again.
-    m_pendingEvents->Erase(node);
+    m_pendingEvents->Erase(n);
 
     if ( m_pendingEvents->IsEmpty() )
     {
@@ -1664,10 +2042,10 @@ void wxEvtHandler::DoBind(int id,
         new wxDynamicEventTableEntry(eventType, id, lastId, func, userData);
 
     if (!m_dynamicEvents)
-        m_dynamicEvents = new wxList;
+        m_dynamicEvents = new DynamicEvents;
 
-    // Insert at the front of the list so most recent additions are found first
-    m_dynamicEvents->Insert( (wxObject*) entry );
+    // Most recent additions are found first, see SearchDynamicEventTable()
+    m_dynamicEvents->Add(entry);
 
     // Make sure we get to know when a sink is destroyed
     wxEvtHandler *eventSink = func->GetEvtHandler();
@@ -1691,32 +2069,44 @@ wxEvtHandler::DoUnbind(int id,
     if (!m_dynamicEvents)
         return false;
 
-    wxList::compatibility_iterator node = m_dynamicEvents->GetFirst();
-    while (node)
+    const DynamicEvents::Groups& groups = m_dynamicEvents->GetGroups();
+    for ( size_t n = 0; n < groups.size(); n++ )
     {
-        wxDynamicEventTableEntry *entry = (wxDynamicEventTableEntry*)node->GetData();
+        if ( eventType != wxEVT_NULL && groups[n]->eventType != eventType )
+            continue;
 
-        if ((entry->m_id == id) &&
-            ((entry->m_lastId == lastId) || (lastId == wxID_ANY)) &&
-            ((entry->m_eventType == eventType) || (eventType == wxEVT_NULL)) &&
-            entry->m_fn->IsMatching(func) &&
-            ((entry->m_callbackUserData == userData) || !userData))
+        // Search the most recently added entries first
+        const DynamicEvents::Entries& entries = groups[n]->entries;
+        for ( size_t m = entries.size(); m > 0; )
         {
-            // Remove connection from tracker node (wxEventConnectionRef)
-            wxEvtHandler *eventSink = entry->m_fn->GetEvtHandler();
-            if ( eventSink && eventSink != this )
+            wxDynamicEventTableEntry * const entry = entries[--m];
+            if ( !entry )
+                continue;
+
+            if ((entry->m_id == id) &&
+                ((entry->m_lastId == lastId) || (lastId == wxID_ANY)) &&
+                entry->m_fn->IsMatching(func) &&
+                ((entry->m_callbackUserData == userData) || !userData))
             {
-                wxEventConnectionRef *evtConnRef = FindRefInTrackerList(eventSink);
-                if ( evtConnRef )
-                    evtConnRef->DecRef();
-            }
+                // Remove connection from tracker node (wxEventConnectionRef)
+                wxEvtHandler *eventSink = entry->m_fn->GetEvtHandler();
+                if ( eventSink && eventSink != this )
+                {
+                    wxEventConnectionRef *evtConnRef = FindRefInTrackerList(eventSink);
+                    if ( evtConnRef )
+                        evtConnRef->DecRef();
+                }
 
-            delete entry->m_callbackUserData;
-            m_dynamicEvents->Erase( node );
-            delete entry;
-            return true;
+                delete entry->m_callbackUserData;
+
+                // We could be called from an event handler for this event
+                // type, in which case the entry is only erased later.
+                groups[n]->Remove(m);
+
+                delete entry;
+                return true;
+            }
         }
-        node = node->GetNext();
     }
     return false;
 }
@@ -1726,26 +2116,76 @@ bool wxEvtHandler::SearchDynamicEventTable( wxEvent& event )
     wxCHECK_MSG( m_dynamicEvents, false,
                  wxT("caller should check that we have dynamic events") );
 
-    wxList::compatibility_iterator node = m_dynamicEvents->GetFirst();
-    while (node)
+    DynamicEvents::Group * const
+        group = m_dynamicEvents->Find(event.GetEventType());
+    if ( !group )
+        return false;
+
+    // Iterate by index as the event handlers can bind new handlers, which
+    // are appended to the group and so are not called for this event. The
+    // entries unbound by them are only reset to NULL while we do it, so the
+    // indices of the other ones don't change.
+    group->BeginDispatch();
+
+    bool processed = false;
+    const DynamicEvents::Entries& entries = group->entries;
+    for ( size_t n = entries.size(); n > 0; )
     {
-        wxDynamicEventTableEntry *entry = (wxDynamicEventTableEntry*)node->GetData();
+        wxDynamicEventTableEntry * const entry = entries[--n];
+        if ( !entry )
+            continue;
+
+        wxEvtHandler *handler = entry->m_fn->GetEvtHandler();
+        if ( !handler )
+           handler = this;
+        if ( ProcessEventIfMatchesId(*entry, handler, event) )
+        {
+            // Don't touch this object after the event was processed: the
+            // handler could have destroyed it, but the group remains valid
+            // until EndDispatch() in any case.
+            processed = true;
+            break;
+        }
+    }
 
-        // get next node before (maybe) calling the event handler as it could
-        // call Disconnect() invalidating the current node
-        node = node->GetNext();
+    group->EndDispatch();
+
+    return processed;
+}
+
+wxDynamicEventTableEntry*
+wxEvtHandler::GetFirstDynamicEntry(size_t& cookie) const
+{
+    cookie = 0;
+
+    return GetNextDynamicEntry(cookie);
+}
 
-        if ( event.GetEventType() == entry->m_eventType )
+wxDynamicEventTableEntry*
+wxEvtHandler::GetNextDynamicEntry(size_t& cookie) const
+{
+    if ( !m_dynamicEvents )
+        return NULL;
+
+    // The cookie is the index of the next entry to check if the entries of
+    // all the groups were concatenated together.
+    size_t index = cookie;
+    const DynamicEvents::Groups& groups = m_dynamicEvents->GetGroups();
+    for ( size_t n = 0; n < groups.size(); n++ )
+    {
+        const DynamicEvents::Entries& entries = groups[n]->entries;
+        for ( ; index < entries.size(); index++ )
         {
-            wxEvtHandler *handler = entry->m_fn->GetEvtHandler();
-            if ( !handler )
-               handler = this;
-            if ( ProcessEventIfMatchesId(*entry, handler, event) )
-                return true;
+            cookie++;
+
+            if ( entries[index] )
+                return entries[index];
         }
+
+        index -= entries.size();
     }
 
-    return false;
+    return NULL;
 }
 
 void wxEvtHandler::DoSetClientObject( wxClientData *data )
@@ -1812,19 +2252,20 @@ void wxEvtHandler::OnSinkDestroyed( wxEvtHandler *sink )
     wxASSERT(m_dynamicEvents);
 
     // remove all connections with this sink
-    wxList::compatibility_iterator node = m_dynamicEvents->GetFirst(), node_nxt;
-    while (node)
+    const DynamicEvents::Groups& groups = m_dynamicEvents->GetGroups();
+    for ( size_t n = 0; n < groups.size(); n++ )
     {
-        wxDynamicEventTableEntry *entry = (wxDynamicEventTableEntry*)node->GetData();
-        node_nxt = node->GetNext();
-
-        if ( entry->m_fn->GetEvtHandler() == sink )
+        const DynamicEvents::Entries& entries = groups[n]->entries;
+        for ( size_t m = entries.size(); m > 0; )
         {
-            delete entry->m_callbackUserData;
-            m_dynamicEvents->Erase( node );
-            delete entry;
+            wxDynamicEventTableEntry * const entry = entries[--m];
+            if ( entry && entry->m_fn->GetEvtHandler() == sink )
+            {
+                delete entry->m_callbackUserData;
+                groups[n]->Remove(m);
+                delete entry;
+            }
         }
-        node = node_nxt;
     }
 }
 
@@ -2,6 +2,7 @@
 // Name:        src/common/file.cpp
 // Purpose:     wxFile - encapsulates low-level "file descriptor"
 //              wxTempFile
+//              wxMappedFile
 // Author:      Vadim Zeitlin
 // Modified by:
 // Created:     29/01/98
@@ -122,6 +123,13 @@
     #include "wx/msw/mslu.h"
 #endif
 
+// wxMappedFile uses mmap() under all Unix systems and reads the file contents
+// in memory elsewhere
+#ifdef __UNIX__
+    #include <sys/mman.h>
+    #define wxHAS_MMAP
+#endif
+
 #ifdef __WXWINCE__
     #include "wx/msw/private.h"
 #endif
@@ -617,5 +625,121 @@ void wxTempFile::Discard()
     }
 }
 
-#endif // wxUSE_FILE
+// ============================================================================
+// class wxMappedFile
+// ============================================================================
+
+void wxMappedFile::Init()
+{
+    m_data = NULL;
+    m_length = 0;
+    m_opened =
+    m_mapped = false;
+}
+
+bool wxMappedFile::Open(const wxString& filename)
+{
+    Close();
+
+    wxFile file;
+    if ( !file.Open(filename) )
+        return false;
+
+    // notice that the mapping remains valid after the file is closed
+    return Open(file);
+}
 
+bool wxMappedFile::Open(wxFile& file)
+{
+    Close();
+
+    wxCHECK_MSG( file.IsOpened(), false, wxT("can't map closed file") );
+
+    const wxFileOffset len = file.Length();
+    if ( len == wxInvalidOffset )
+        return false;
+
+    if ( (wxULongLong_t)len > (size_t)-1 )
+    {
+        wxLogError(_("File is too big to be loaded in memory."));
+        return false;
+    }
+
+    // there is nothing to map or read for an empty file
+    if ( len == 0 )
+    {
+        m_opened = true;
+        return true;
+    }
+
+#ifdef wxHAS_MMAP
+    if ( file.GetKind() == wxFILE_KIND_DISK )
+    {
+        void * const
+            data = mmap(NULL, (size_t)len, PROT_READ, MAP_PRIVATE, file.fd(), 0);
+        if ( data != MAP_FAILED )
+        {
+            m_data = data;
+            m_length = (size_t)len;
+            m_opened =
+            m_mapped = true;
+            return true;
+        }
+
+        // some file systems don't support mapping files, fall back to reading
+        // the file contents in memory then
+        wxLogTrace(wxT("file"), wxT("mmap() failed for fd %d: %s"),
+                   file.fd(), wxSysErrorMsg());
+    }
+#endif // wxHAS_MMAP
+
+    if ( file.Seek(0) == wxInvalidOffset )
+        return false;
+
+    char * const buf = static_cast<char *>(m_buffer.GetWriteBuf((size_t)len));
+    if ( !buf )
+    {
+        wxLogError(_("File is too big to be loaded in memory."));
+        return false;
+    }
+
+    size_t lenRead = 0;
+    while ( lenRead < (size_t)len )
+    {
+        const ssize_t n = file.Read(buf + lenRead, (size_t)len - lenRead);
+        if ( n == wxInvalidOffset )
+        {
+            // the error was already reported by wxFile::Read()
+            m_buffer.UngetWriteBuf(0);
+            return false;
+        }
+
+        // the file could have been truncated since we got its length
+        if ( n == 0 )
+            break;
+
+        lenRead += n;
+    }
+
+    m_buffer.UngetWriteBuf(lenRead);
+
+    m_data = m_buffer.GetData();
+    m_length = lenRead;
+    m_opened = true;
+
+    return true;
+}
+
+void wxMappedFile::Close()
+{
+#ifdef wxHAS_MMAP
+    if ( m_mapped )
+        munmap(m_data, m_length);
+#endif // wxHAS_MMAP
+
+    m_buffer = wxMemoryBuffer();
+
+    Init();
+}
+
+#endif // wxUSE_FILE
@@ -35,6 +35,7 @@
 #endif  //WX_PRECOMP
 
 #include  "wx/file.h"
+#include  "wx/hashmap.h"
 #include  "wx/textfile.h"
 #include  "wx/memtext.h"
 #include  "wx/config.h"
@@ -102,6 +103,64 @@ static wxString GetAppName(const wxString& appname);
     WX_DEFINE_SORTED_ARRAY(wxFileConfigGroup *, ArrayGroups);
 #endif
 
+// ----------------------------------------------------------------------------
+// hash maps used for looking up entries and subgroups by name
+// ----------------------------------------------------------------------------
+
+// the keys point to the names stored in the entries and groups themselves, so
+// that we don't need to keep another copy of them
+typedef const wxString *wxFileConfigNameKey;
+
+// the hash and comparison functors must be consistent with the functions used
+// for sorting the arrays, i.e. ignore case unless wxCONFIG_CASE_SENSITIVE
+class wxFileConfigNameHash
+{
+public:
+    wxFileConfigNameHash() { }
+
+    unsigned long operator()(wxFileConfigNameKey name) const
+    {
+        unsigned long hash = 0;
+        for ( wxString::const_iterator i = name->begin(); i != name->end(); ++i )
+        {
+#if wxCONFIG_CASE_SENSITIVE
+            const unsigned long ch = (wxChar)*i;
+#else
+            const unsigned long ch = (wxChar)wxTolower(*i);
+#endif
+            hash += (hash << 3) + ch;
+        }
+
+        return hash;
+    }
+
+    wxFileConfigNameHash& operator=(const wxFileConfigNameHash&) { return *this; }
+};
+
+class wxFileConfigNameEqual
+{
+public:
+    wxFileConfigNameEqual() { }
+
+    bool operator()(wxFileConfigNameKey name1, wxFileConfigNameKey name2) const
+    {
+#if wxCONFIG_CASE_SENSITIVE
+        return *name1 == *name2;
+#else
+        return name1->length() == name2->length() && name1->CmpNoCase(*name2) == 0;
+#endif
+    }
+
+    wxFileConfigNameEqual& operator=(const wxFileConfigNameEqual&) { return *this; }
+};
+
+WX_DECLARE_HASH_MAP(wxFileConfigNameKey, wxFileConfigEntry *,
+                    wxFileConfigNameHash, wxFileConfigNameEqual,
+                    wxFileConfigEntriesMap);
+WX_DECLARE_HASH_MAP(wxFileConfigNameKey, wxFileConfigGroup *,
+                    wxFileConfigNameHash, wxFileConfigNameEqual,
+                    wxFileConfigGroupsMap);
+
 // ----------------------------------------------------------------------------
 // wxFileConfigLineList
 // ----------------------------------------------------------------------------
@@ -116,18 +175,29 @@ public:
   // ctor
   wxFileConfigLineList(const wxString& str,
                        wxFileConfigLineList *pNext = NULL) : m_strLine(str)
-    { SetNext(pNext); SetPrev(NULL); }
+    { SetNext(pNext); SetPrev(NULL); InvalidateCache(); }
 
   // next/prev nodes in the linked list
   wxFileConfigLineList *Next() const { return m_pNext;  }
   wxFileConfigLineList *Prev() const { return m_pPrev;  }
 
   // get/change lines text
-  void SetText(const wxString& str) { m_strLine = str;  }
+  void SetText(const wxString& str) { m_strLine = str; InvalidateCache(); }
   const wxString& Text() const { return m_strLine; }
 
+  // the position of this line in wxFileConfig::m_linesCache, i.e. in the
+  // encoded file contents written by the last Flush(), if it didn't change
+  bool HasCache() const { return m_cacheOffset != (size_t)-1; }
+  size_t GetCacheOffset() const { return m_cacheOffset; }
+  size_t GetCacheLength() const { return m_cacheLength; }
+  void SetCache(size_t offset, size_t length)
+    { m_cacheOffset = offset; m_cacheLength = length; }
+  void InvalidateCache() { m_cacheOffset = (size_t)-1; m_cacheLength = 0; }
+
 private:
   wxString  m_strLine;                  // line contents
+  size_t    m_cacheOffset,              // see GetCacheOffset()
+            m_cacheLength;
   wxFileConfigLineList *m_pNext,        // next node
                        *m_pPrev;        // previous one
 
@@ -186,6 +256,8 @@ private:
   wxFileConfigGroup  *m_pParent;    // parent group (NULL for root group)
   ArrayEntries  m_aEntries;         // entries in this group
   ArrayGroups   m_aSubgroups;       // subgroups
+  wxFileConfigEntriesMap m_entriesByName; // the same entries and subgroups
+  wxFileConfigGroupsMap m_subgroupsByName;// indexed by their names
   wxString      m_strName;          // group's name
   wxFileConfigLineList *m_pLine;    // pointer to our line in the linked list
   wxFileConfigEntry *m_pLastEntry;  // last entry/subgroup of this group in the
@@ -194,6 +266,10 @@ private:
   // DeleteSubgroupByName helper
   bool DeleteSubgroup(wxFileConfigGroup *pGroup);
 
+  // remove the subgroup from m_subgroupsByName, used before deleting or
+  // renaming it
+  void RemoveFromSubgroupsMap(wxFileConfigGroup *pGroup);
+
   // used by Rename()
   void UpdateGroupAndSubgroupsLines();
 
@@ -330,6 +406,7 @@ void wxFileConfig::Init()
 {
     m_pCurrentGroup =
     m_pRootGroup    = new wxFileConfigGroup(NULL, wxEmptyString, this);
+    m_strPath.clear();
 
     m_linesHead =
     m_linesTail = NULL;
@@ -514,6 +591,8 @@ void wxFileConfig::CleanUp()
         delete pCur;
         pCur = pNext;
     }
+
+    m_linesCache.Clear();
 }
 
 wxFileConfig::~wxFileConfig()
@@ -702,6 +781,11 @@ wxFileConfig::DoSetPath(const wxString& strPath, bool createMissingComponents)
         return true;
     }
 
+    // nothing to do if the path doesn't change, this happens often when
+    // reading or writing several entries using their full paths
+    if ( strPath == m_strPath )
+        return true;
+
     if ( strPath[0] == wxCONFIG_PATH_SEPARATOR ) {
         // absolute path
         wxSplitPath(aParts, strPath);
@@ -713,22 +797,26 @@ wxFileConfig::DoSetPath(const wxString& strPath, bool createMissingComponents)
         wxSplitPath(aParts, strFullPath);
     }
 
-    // change current group
+    // find the new current group, notice that we must not change
+    // m_pCurrentGroup if we fail to do it as it must stay in sync with
+    // m_strPath for the check above to work
     size_t n;
-    m_pCurrentGroup = m_pRootGroup;
+    wxFileConfigGroup *pGroup = m_pRootGroup;
     for ( n = 0; n < aParts.GetCount(); n++ ) {
-        wxFileConfigGroup *pNextGroup = m_pCurrentGroup->FindSubgroup(aParts[n]);
+        wxFileConfigGroup *pNextGroup = pGroup->FindSubgroup(aParts[n]);
         if ( pNextGroup == NULL )
         {
             if ( !createMissingComponents )
                 return false;
 
-            pNextGroup = m_pCurrentGroup->AddSubgroup(aParts[n]);
+            pNextGroup = pGroup->AddSubgroup(aParts[n]);
         }
 
-        m_pCurrentGroup = pNextGroup;
+        pGroup = pNextGroup;
     }
 
+    m_pCurrentGroup = pGroup;
+
     // recombine path parts in one variable
     m_strPath.Empty();
     for ( n = 0; n < aParts.GetCount(); n++ ) {
@@ -1018,15 +1106,38 @@ bool wxFileConfig::Flush(bool /* bCurrentOnly */)
     return false;
   }
 
-  // write all strings to file
-  wxString filetext;
-  filetext.reserve(4096);
+  // write all lines to file: only the lines which changed since the last
+  // call to this function need to be converted to the external encoding, the
+  // unchanged ones are copied from the cached contents written the last time
+  wxMemoryBuffer contents(m_linesCache.GetDataLen() + 4096);
   for ( wxFileConfigLineList *p = m_linesHead; p != NULL; p = p->Next() )
   {
-    filetext << p->Text() << wxTextFile::GetEOL();
+    const size_t offset = contents.GetDataLen();
+    if ( p->HasCache() )
+    {
+      contents.AppendData((const char *)m_linesCache.GetData()
+                            + p->GetCacheOffset(),
+                          p->GetCacheLength());
+    }
+    else
+    {
+      const wxString line = p->Text() + wxTextFile::GetEOL();
+      const wxCharBuffer buf(line.mb_str(*m_conv));
+      if ( !buf.length() )
+      {
+        wxLogError(_("can't write user configuration file."));
+        return false;
+      }
+
+      contents.AppendData(buf.data(), buf.length());
+    }
+
+    p->SetCache(offset, contents.GetDataLen() - offset);
   }
 
-  if ( !file.Write(filetext, *m_conv) )
+  m_linesCache = contents;
+
+  if ( !file.Write(contents.GetData(), contents.GetDataLen()) )
   {
     wxLogError(_("can't write user configuration file."));
     return false;
@@ -1195,14 +1306,6 @@ wxFileConfigLineList *wxFileConfig::LineListAppend(const wxString& str)
     wxLogTrace( FILECONF_TRACE_MASK,
                 wxT("    ** Adding Line '%s'"),
                 str.c_str() );
-    wxLogTrace( FILECONF_TRACE_MASK,
-                wxT("        head: %s"),
-                ((m_linesHead) ? (const wxChar*)m_linesHead->Text().c_str()
-                               : wxEmptyString) );
-    wxLogTrace( FILECONF_TRACE_MASK,
-                wxT("        tail: %s"),
-                ((m_linesTail) ? (const wxChar*)m_linesTail->Text().c_str()
-                               : wxEmptyString) );
 
     wxFileConfigLineList *pLine = new wxFileConfigLineList(str);
 
@@ -1220,15 +1323,6 @@ wxFileConfigLineList *wxFileConfig::LineListAppend(const wxString& str)
 
     m_linesTail = pLine;
 
-    wxLogTrace( FILECONF_TRACE_MASK,
-                wxT("        head: %s"),
-                ((m_linesHead) ? (const wxChar*)m_linesHead->Text().c_str()
-                               : wxEmptyString) );
-    wxLogTrace( FILECONF_TRACE_MASK,
-                wxT("        tail: %s"),
-                ((m_linesTail) ? (const wxChar*)m_linesTail->Text().c_str()
-                               : wxEmptyString) );
-
     return m_linesTail;
 }
 
@@ -1241,14 +1335,6 @@ wxFileConfigLineList *wxFileConfig::LineListInsert(const wxString& str,
                 str.c_str(),
                 ((pLine) ? (const wxChar*)pLine->Text().c_str()
                          : wxEmptyString) );
-    wxLogTrace( FILECONF_TRACE_MASK,
-                wxT("        head: %s"),
-                ((m_linesHead) ? (const wxChar*)m_linesHead->Text().c_str()
-                               : wxEmptyString) );
-    wxLogTrace( FILECONF_TRACE_MASK,
-                wxT("        tail: %s"),
-                ((m_linesTail) ? (const wxChar*)m_linesTail->Text().c_str()
-                               : wxEmptyString) );
 
     if ( pLine == m_linesTail )
         return LineListAppend(str);
@@ -1271,15 +1357,6 @@ wxFileConfigLineList *wxFileConfig::LineListInsert(const wxString& str,
         pLine->SetNext(pNewLine);
     }
 
-    wxLogTrace( FILECONF_TRACE_MASK,
-                wxT("        head: %s"),
-                ((m_linesHead) ? (const wxChar*)m_linesHead->Text().c_str()
-                               : wxEmptyString) );
-    wxLogTrace( FILECONF_TRACE_MASK,
-                wxT("        tail: %s"),
-                ((m_linesTail) ? (const wxChar*)m_linesTail->Text().c_str()
-                               : wxEmptyString) );
-
     return pNewLine;
 }
 
@@ -1288,14 +1365,6 @@ void wxFileConfig::LineListRemove(wxFileConfigLineList *pLine)
     wxLogTrace( FILECONF_TRACE_MASK,
                 wxT("    ** Removing Line '%s'"),
                 pLine->Text().c_str() );
-    wxLogTrace( FILECONF_TRACE_MASK,
-                wxT("        head: %s"),
-                ((m_linesHead) ? (const wxChar*)m_linesHead->Text().c_str()
-                               : wxEmptyString) );
-    wxLogTrace( FILECONF_TRACE_MASK,
-                wxT("        tail: %s"),
-                ((m_linesTail) ? (const wxChar*)m_linesTail->Text().c_str()
-                               : wxEmptyString) );
 
     wxFileConfigLineList    *pPrev = pLine->Prev(),
                             *pNext = pLine->Next();
@@ -1314,15 +1383,6 @@ void wxFileConfig::LineListRemove(wxFileConfigLineList *pLine)
     else
         pNext->SetPrev(pPrev);
 
-    wxLogTrace( FILECONF_TRACE_MASK,
-                wxT("        head: %s"),
-                ((m_linesHead) ? (const wxChar*)m_linesHead->Text().c_str()
-                               : wxEmptyString) );
-    wxLogTrace( FILECONF_TRACE_MASK,
-                wxT("        tail: %s"),
-                ((m_linesTail) ? (const wxChar*)m_linesTail->Text().c_str()
-                               : wxEmptyString) );
-
     delete pLine;
 }
 
@@ -1544,10 +1604,13 @@ void wxFileConfigGroup::Rename(const wxString& newName)
     // we need to remove the group from the parent and it back under the new
     // name to keep the parents array of subgroups alphabetically sorted
     m_pParent->m_aSubgroups.Remove(this);
+    m_pParent->RemoveFromSubgroupsMap(this);
 
     m_strName = newName;
 
     m_pParent->m_aSubgroups.Add(this);
+    m_pParent->m_subgroupsByName.insert(
+        wxFileConfigGroupsMap::value_type(&m_strName, this));
 
     // update the group lines recursively
     UpdateGroupAndSubgroupsLines();
@@ -1566,65 +1629,20 @@ wxString wxFileConfigGroup::GetFullName() const
 // find an item
 // ----------------------------------------------------------------------------
 
-// use binary search because the array is sorted
 wxFileConfigEntry *
 wxFileConfigGroup::FindEntry(const wxString& name) const
 {
-  size_t i,
-       lo = 0,
-       hi = m_aEntries.GetCount();
-  int res;
-  wxFileConfigEntry *pEntry;
-
-  while ( lo < hi ) {
-    i = (lo + hi)/2;
-    pEntry = m_aEntries[i];
-
-    #if wxCONFIG_CASE_SENSITIVE
-      res = pEntry->Name().compare(name);
-    #else
-      res = pEntry->Name().CmpNoCase(name);
-    #endif
-
-    if ( res > 0 )
-      hi = i;
-    else if ( res < 0 )
-      lo = i + 1;
-    else
-      return pEntry;
-  }
+  const wxFileConfigEntriesMap::const_iterator it = m_entriesByName.find(&name);
 
-  return NULL;
+  return it == m_entriesByName.end() ? NULL : it->second;
 }
 
 wxFileConfigGroup *
 wxFileConfigGroup::FindSubgroup(const wxString& name) const
 {
-  size_t i,
-       lo = 0,
-       hi = m_aSubgroups.GetCount();
-  int res;
-  wxFileConfigGroup *pGroup;
-
-  while ( lo < hi ) {
-    i = (lo + hi)/2;
-    pGroup = m_aSubgroups[i];
-
-    #if wxCONFIG_CASE_SENSITIVE
-      res = pGroup->Name().compare(name);
-    #else
-      res = pGroup->Name().CmpNoCase(name);
-    #endif
-
-    if ( res > 0 )
-      hi = i;
-    else if ( res < 0 )
-      lo = i + 1;
-    else
-      return pGroup;
-  }
+  const wxFileConfigGroupsMap::const_iterator it = m_subgroupsByName.find(&name);
 
-  return NULL;
+  return it == m_subgroupsByName.end() ? NULL : it->second;
 }
 
 // ----------------------------------------------------------------------------
@@ -1639,6 +1657,8 @@ wxFileConfigEntry *wxFileConfigGroup::AddEntry(const wxString& strName, int nLin
     wxFileConfigEntry   *pEntry = new wxFileConfigEntry(this, strName, nLine);
 
     m_aEntries.Add(pEntry);
+    m_entriesByName.insert(
+        wxFileConfigEntriesMap::value_type(&pEntry->Name(), pEntry));
     return pEntry;
 }
 
@@ -1650,6 +1670,8 @@ wxFileConfigGroup *wxFileConfigGroup::AddSubgroup(const wxString& strName)
     wxFileConfigGroup   *pGroup = new wxFileConfigGroup(this, strName, m_pConfig);
 
     m_aSubgroups.Add(pGroup);
+    m_subgroupsByName.insert(
+        wxFileConfigGroupsMap::value_type(&pGroup->Name(), pGroup));
     return pGroup;
 }
 
@@ -1657,6 +1679,14 @@ wxFileConfigGroup *wxFileConfigGroup::AddSubgroup(const wxString& strName)
 // delete an item
 // ----------------------------------------------------------------------------
 
+void wxFileConfigGroup::RemoveFromSubgroupsMap(wxFileConfigGroup *pGroup)
+{
+    const wxFileConfigGroupsMap::iterator it =
+        m_subgroupsByName.find(&pGroup->Name());
+    if ( it != m_subgroupsByName.end() && it->second == pGroup )
+        m_subgroupsByName.erase(it);
+}
+
 /*
   The delete operations are _very_ slow if we delete the last item of this
   group (see comments before GetXXXLineXXX functions for more details),
@@ -1780,6 +1810,7 @@ bool wxFileConfigGroup::DeleteSubgroup(wxFileConfigGroup *pGroup)
     }
 
     m_aSubgroups.Remove(pGroup);
+    RemoveFromSubgroupsMap(pGroup);
     delete pGroup;
 
     return true;
@@ -1828,6 +1859,14 @@ bool wxFileConfigGroup::DeleteEntry(const wxString& name)
   }
 
   m_aEntries.Remove(pEntry);
+
+  // notice that we can't just erase the element with the given name as it
+  // could have been added by another entry with the same name if the file
+  // contained duplicate entries
+  const wxFileConfigEntriesMap::iterator it = m_entriesByName.find(&pEntry->Name());
+  if ( it != m_entriesByName.end() && it->second == pEntry )
+      m_entriesByName.erase(it);
+
   delete pEntry;
 
   return true;
@@ -21,7 +21,7 @@
     #include "wx/log.h"
 #endif
 
-#if WXWIN_COMPATIBILITY_2_6 && wxUSE_ZIPSTREAM
+#if wxUSE_ZIPSTREAM
     #include "wx/zipstrm.h"
 #else
     #include "wx/archive.h"
@@ -35,6 +35,9 @@
 // Holds the catalog of an archive file, and if it is being read from a
 // non-seekable stream, a copy of its backing file.
 //
+// The entries of zip archives read from seekable streams are looked up in
+// their central directory instead of reading the catalog up to them.
+//
 // This class is actually the reference counted implementation for the
 // wxArchiveFSCacheData class below. It was done that way to allow sharing
 // between instances of wxFileSystem, though that's a feature not used in this
@@ -80,6 +83,9 @@ private:
     wxBackingFile m_backer;
     wxInputStream *m_stream;
     wxArchiveInputStream *m_archive;
+#if wxUSE_ZIPSTREAM
+    wxZipInputStream *m_zip;    // m_archive if entries can be found by name
+#endif
 };
 
 wxArchiveFSCacheDataImpl::wxArchiveFSCacheDataImpl(
@@ -92,6 +98,9 @@ wxArchiveFSCacheDataImpl::wxArchiveFSCacheDataImpl(
     m_stream(new wxBackedInputStream(backer)),
     m_archive(factory.NewStream(*m_stream))
 {
+#if wxUSE_ZIPSTREAM
+    m_zip = NULL;
+#endif
 }
 
 wxArchiveFSCacheDataImpl::wxArchiveFSCacheDataImpl(
@@ -103,6 +112,13 @@ wxArchiveFSCacheDataImpl::wxArchiveFSCacheDataImpl(
     m_stream(stream),
     m_archive(factory.NewStream(*m_stream))
 {
+#if wxUSE_ZIPSTREAM
+    if (m_archive && m_stream->IsSeekable() &&
+            wxDynamicCast(&factory, wxZipClassFactory))
+        m_zip = static_cast<wxZipInputStream*>(m_archive);
+    else
+        m_zip = NULL;
+#endif
 }
 
 wxArchiveFSCacheDataImpl::~wxArchiveFSCacheDataImpl()
@@ -123,7 +139,19 @@ wxArchiveFSCacheDataImpl::~wxArchiveFSCacheDataImpl()
 
 wxArchiveFSEntry *wxArchiveFSCacheDataImpl::AddToCache(wxArchiveEntry *entry)
 {
-    m_hash[entry->GetName(wxPATH_UNIX)] = entry;
+    wxArchiveEntry*& cached = m_hash[entry->GetName(wxPATH_UNIX)];
+
+    // reuse the entry if it was already found by name
+    if (cached)
+    {
+        delete entry;
+        entry = cached;
+    }
+    else
+    {
+        cached = entry;
+    }
+
     wxArchiveFSEntry *fse = new wxArchiveFSEntry;
     *m_endptr = fse;
     (*m_endptr)->entry = entry;
@@ -134,6 +162,9 @@ wxArchiveFSEntry *wxArchiveFSCacheDataImpl::AddToCache(wxArchiveEntry *entry)
 
 void wxArchiveFSCacheDataImpl::CloseStreams()
 {
+#if wxUSE_ZIPSTREAM
+    m_zip = NULL;
+#endif
     wxDELETE(m_archive);
     wxDELETE(m_stream);
 }
@@ -150,9 +181,28 @@ wxArchiveEntry *wxArchiveFSCacheDataImpl::Get(const wxString& name)
 
     wxArchiveEntry *entry;
 
+#if wxUSE_ZIPSTREAM
+    if (m_zip)
+    {
+        entry = m_zip->FindEntry(name, wxPATH_UNIX);
+        if (!entry)
+            return NULL;
+
+        // the names are normalized when searching, so this could be another
+        // spelling of the name, fall back to reading the catalog if it is
+        if (entry->GetName(wxPATH_UNIX) == name)
+        {
+            m_hash[name] = entry;
+            return entry;
+        }
+
+        delete entry;
+    }
+#endif // wxUSE_ZIPSTREAM
+
     while ((entry = m_archive->GetNextEntry()) != NULL)
     {
-        AddToCache(entry);
+        entry = AddToCache(entry)->entry;
 
         if (entry->GetName(wxPATH_UNIX) == name)
             return entry;
@@ -31,6 +31,10 @@
 #include "wx/wfstream.h"
 #include "wx/xpmdecod.h"
 
+#if wxUSE_THREADS
+    #include "wx/thread.h"
+#endif
+
 // For memcpy
 #include <string.h>
 
@@ -58,6 +62,129 @@ IMPLEMENT_VARIANT_OBJECT_EXPORTED_SHALLOWCMP(wxImage,WXDLLEXPORT)
 wxList wxImage::sm_handlers;
 wxImage wxNullImage;
 
+// the number of threads used by the image processing functions
+static int gs_imageThreadCount = 1;
+
+//-----------------------------------------------------------------------------
+// helpers for processing the image in several threads
+//-----------------------------------------------------------------------------
+
+namespace
+{
+
+// Base class for the image processing operations working on independent bands
+// of image lines (rows or, less commonly, columns) which can be processed in
+// parallel.
+class ImageBandOp
+{
+public:
+    // Process the lines in [start, end) range.
+    virtual void ProcessBand(int start, int end) = 0;
+
+    virtual ~ImageBandOp() { }
+};
+
+#if wxUSE_THREADS
+
+class ImageBandThread : public wxThread
+{
+public:
+    ImageBandThread(ImageBandOp& op, int start, int end)
+        : wxThread(wxTHREAD_JOINABLE),
+          m_op(op),
+          m_start(start),
+          m_end(end)
+    {
+    }
+
+    // Used if the thread couldn't be started.
+    void ProcessInCurrentThread() { m_op.ProcessBand(m_start, m_end); }
+
+protected:
+    virtual ExitCode Entry()
+    {
+        ProcessInCurrentThread();
+
+        return 0;
+    }
+
+private:
+    ImageBandOp& m_op;
+    const int m_start,
+              m_end;
+
+    wxDECLARE_NO_COPY_CLASS(ImageBandThread);
+};
+
+// Creating the threads is relatively expensive, so don't bother doing it for
+// less than this number of pixels per thread.
+const size_t MIN_PIXELS_PER_THREAD = 128*1024;
+
+#endif // wxUSE_THREADS
+
+// Process all the lines in [0, numLines) range, splitting them into bands
+// handled by separate threads if the image is big enough and more than one
+// thread is allowed by wxImage::SetThreadCount().
+void ProcessBands(ImageBandOp& op, int numLines, int pixelsPerLine)
+{
+#if wxUSE_THREADS
+    size_t numThreads = gs_imageThreadCount;
+
+    const size_t
+        maxThreads = (size_t(numLines)*pixelsPerLine) / MIN_PIXELS_PER_THREAD;
+    if ( numThreads > maxThreads )
+        numThreads = maxThreads;
+
+    if ( numThreads > 1 )
+    {
+        // The first band is processed by the current thread and each of the
+        // others by a thread of its own.
+        wxVector<ImageBandThread*> threads;
+        for ( size_t n = 1; n < numThreads; n++ )
+        {
+            ImageBandThread* const thread = new ImageBandThread
+                                                (
+                                                    op,
+                                                    (numLines*n)/numThreads,
+                                                    (numLines*(n + 1))/numThreads
+                                                );
+            if ( thread->Run() != wxTHREAD_NO_ERROR )
+            {
+                thread->ProcessInCurrentThread();
+                delete thread;
+                continue;
+            }
+
+            threads.push_back(thread);
+        }
+
+        op.ProcessBand(0, numLines/numThreads);
+
+        for ( size_t n = 0; n < threads.size(); n++ )
+        {
+            threads[n]->Wait();
+            delete threads[n];
+        }
+
+        return;
+    }
+#else // !wxUSE_THREADS
+    wxUnusedVar(pixelsPerLine);
+#endif // wxUSE_THREADS/!wxUSE_THREADS
+
+    op.ProcessBand(0, numLines);
+}
+
+// Return the approximate number of pixels processed for each destination row
+// when resampling the image of the given old size to the new one.
+inline int
+GetResampleCostPerRow(int oldWidth, int oldHeight, int newWidth, int newHeight)
+{
+    return int((double(oldWidth)*oldHeight)/newHeight) + newWidth;
+}
+
+} // anonymous namespace
+
 //-----------------------------------------------------------------------------
 // wxImageRefData
 //-----------------------------------------------------------------------------
@@ -584,6 +711,200 @@ void ResampleBoxPrecalc(wxVector<BoxPrecalc>& boxes, int oldDim)
     }
 }
 
+// Helper used by the separable resampling functions below: it caches the
+// results of resampling the rows of the source image in horizontal direction.
+//
+// As the range of the source rows used for computing the consecutive
+// destination rows only moves forward, each source row needs to be resampled
+// just once and only the rows in the current window need to be kept, so this
+// class uses a ring buffer of rows indexed by the source row number.
+template <typename T>
+class ResampledRowsCache
+{
+public:
+    // numRows is the maximal number of distinct source rows used for
+    // computing a single destination row and rowLen is the number of values
+    // in each of the resampled rows.
+    ResampledRowsCache(int numRows, int rowLen)
+        : m_rows(static_cast<size_t>(numRows), -1),
+          m_data(numRows*rowLen),
+          m_rowLen(rowLen)
+    {
+    }
+
+    // Return the horizontally resampled source row, calling the provided
+    // functor to compute it if it's not available yet.
+    template <typename F>
+    const T* Get(int row, F& resampleRow)
+    {
+        const int slot = row % m_rows.size();
+        T* const data = &m_data[slot*m_rowLen];
+        if ( m_rows[slot] != row )
+        {
+            resampleRow(row, data);
+            m_rows[slot] = row;
+        }
+
+        return data;
+    }
+
+private:
+    wxVector<int> m_rows;
+    wxVector<T> m_data;
+    const int m_rowLen;
+};
+
+// Horizontal pass of ResampleBox(): sums the pixels of the boxes.
+class BoxRowResampler
+{
+public:
+    BoxRowResampler(const wxVector<BoxPrecalc>& hPrecalcs,
+                    const unsigned char* data,
+                    const unsigned char* alpha,
+                    int width)
+        : m_hPrecalcs(hPrecalcs),
+          m_data(data),
+          m_alpha(alpha),
+          m_width(width)
+    {
+    }
+
+    void operator()(int row, double* out) const
+    {
+        const unsigned char* const data = m_data + row*m_width*3;
+        const unsigned char* const alpha = m_alpha ? m_alpha + row*m_width
+                                                   : NULL;
+
+        const size_t count = m_hPrecalcs.size();
+        for ( size_t x = 0; x < count; x++ )
+        {
+            const BoxPrecalc& hPrecalc = m_hPrecalcs[x];
+
+            // Integer sums are exact and faster to compute, the box width
+            // is bounded by the image width and so they can't overflow.
+            wxUint32 sum_r = 0, sum_g = 0, sum_b = 0, sum_a = 0;
+            for ( int i = hPrecalc.boxStart; i <= hPrecalc.boxEnd; ++i )
+            {
+                sum_r += data[i * 3 + 0];
+                sum_g += data[i * 3 + 1];
+                sum_b += data[i * 3 + 2];
+            }
+
+            if ( alpha )
+            {
+                for ( int i = hPrecalc.boxStart; i <= hPrecalc.boxEnd; ++i )
+                    sum_a += alpha[i];
+            }
+
+            *out++ = sum_r;
+            *out++ = sum_g;
+            *out++ = sum_b;
+            if ( alpha )
+                *out++ = sum_a;
+        }
+    }
+
+private:
+    const wxVector<BoxPrecalc>& m_hPrecalcs;
+    const unsigned char* const m_data;
+    const unsigned char* const m_alpha;
+    const int m_width;
+
+    wxDECLARE_NO_ASSIGN_CLASS(BoxRowResampler);
+};
+
+// Resamples a band of destination rows in ResampleBox().
+class BoxResampleOp : public ImageBandOp
+{
+public:
+    BoxResampleOp(const wxVector<BoxPrecalc>& vPrecalcs,
+                  const wxVector<BoxPrecalc>& hPrecalcs,
+                  const unsigned char* src_data,
+                  const unsigned char* src_alpha,
+                  int src_width,
+                  unsigned char* dst_data,
+                  unsigned char* dst_alpha)
+        : m_vPrecalcs(vPrecalcs),
+          m_hPrecalcs(hPrecalcs),
+          m_resampleRow(hPrecalcs, src_data, src_alpha, src_width),
+          m_src_alpha(src_alpha),
+          m_dst_data(dst_data),
+          m_dst_alpha(dst_alpha)
+    {
+        m_boxHeightMax = 1;
+        for ( size_t y = 0; y < vPrecalcs.size(); y++ )
+        {
+            const BoxPrecalc& vPrecalc = vPrecalcs[y];
+            const int boxHeight = vPrecalc.boxEnd - vPrecalc.boxStart + 1;
+            if ( boxHeight > m_boxHeightMax )
+                m_boxHeightMax = boxHeight;
+        }
+    }
+
+    virtual void ProcessBand(int start, int end)
+    {
+        const int width = m_hPrecalcs.size();
+        const int channels = m_src_alpha ? 4 : 3;
+
+        ResampledRowsCache<double> rows(m_boxHeightMax, width*channels);
+        wxVector<double> sums(width*channels);
+
+        unsigned char* dst_data = m_dst_data + start*width*3;
+        unsigned char* dst_alpha = m_dst_alpha ? m_dst_alpha + start*width
+                                               : NULL;
+
+        for ( int y = start; y < end; y++ )    // Destination image - Y direction
+        {
+            // Source pixel in the Y direction
+            const BoxPrecalc& vPrecalc = m_vPrecalcs[y];
+
+            for ( int n = 0; n < width*channels; n++ )
+                sums[n] = 0;
+
+            for ( int j = vPrecalc.boxStart; j <= vPrecalc.boxEnd; ++j )
+            {
+                const double* const row = rows.Get(j, m_resampleRow);
+                for ( int n = 0; n < width*channels; n++ )
+                    sums[n] += row[n];
+            }
+
+            const double* sum = &sums[0];
+            const int boxHeight = vPrecalc.boxEnd - vPrecalc.boxStart + 1;
+            for ( int x = 0; x < width; x++ )  // Destination image - X direction
+            {
+                // Source pixel in the X direction
+                const BoxPrecalc& hPrecalc = m_hPrecalcs[x];
+
+                // Number of pixels in the box we averaged over
+                const int averaged_pixels =
+                    (hPrecalc.boxEnd - hPrecalc.boxStart + 1)*boxHeight;
+
+                // Calculate the average from the sum and number of averaged
+                // pixels
+                dst_data[0] = (unsigned char)(sum[0] / averaged_pixels);
+                dst_data[1] = (unsigned char)(sum[1] / averaged_pixels);
+                dst_data[2] = (unsigned char)(sum[2] / averaged_pixels);
+                dst_data += 3;
+                if ( m_src_alpha )
+                    *dst_alpha++ = (unsigned char)(sum[3] / averaged_pixels);
+
+                sum += channels;
+            }
+        }
+    }
+
+private:
+    const wxVector<BoxPrecalc>& m_vPrecalcs;
+    const wxVector<BoxPrecalc>& m_hPrecalcs;
+    const BoxRowResampler m_resampleRow;
+    const unsigned char* const m_src_alpha;
+    unsigned char* const m_dst_data;
+    unsigned char* const m_dst_alpha;
+    int m_boxHeightMax;
+
+    wxDECLARE_NO_COPY_CLASS(BoxResampleOp);
+};
+
 } // anonymous namespace
 
 wxImage wxImage::ResampleBox(int width, int height) const
@@ -592,6 +913,11 @@ wxImage wxImage::ResampleBox(int width, int height) const
     // downsampling that gives reasonably smooth results To scale the image
     // down we will need to gather a grid of pixels of the size of the scale
     // factor in each direction and then do an averaging of the pixels.
+    //
+    // As averaging is separable, this is done by first summing the pixels
+    // of each source row over the horizontal extent of the boxes and then
+    // summing these partial sums over their vertical extent, so that each
+    // source pixel is only read once.
 
     wxImage ret_image(width, height, false);
 
@@ -613,49 +939,12 @@ wxImage wxImage::ResampleBox(int width, int height) const
         dst_alpha = ret_image.GetAlpha();
     }
 
-    int averaged_pixels, src_pixel_index;
-    double sum_r, sum_g, sum_b, sum_a;
-
-    for ( int y = 0; y < height; y++ )         // Destination image - Y direction
-    {
-        // Source pixel in the Y direction
-        const BoxPrecalc& vPrecalc = vPrecalcs[y];
-
-        for ( int x = 0; x < width; x++ )      // Destination image - X direction
-        {
-            // Source pixel in the X direction
-            const BoxPrecalc& hPrecalc = hPrecalcs[x];
-
-            // Box of pixels to average
-            averaged_pixels = 0;
-            sum_r = sum_g = sum_b = sum_a = 0.0;
-
-            for ( int j = vPrecalc.boxStart; j <= vPrecalc.boxEnd; ++j )
-            {
-                for ( int i = hPrecalc.boxStart; i <= hPrecalc.boxEnd; ++i )
-                {
-                    // Calculate the actual index in our source pixels
-                    src_pixel_index = j * M_IMGDATA->m_width + i;
-
-                    sum_r += src_data[src_pixel_index * 3 + 0];
-                    sum_g += src_data[src_pixel_index * 3 + 1];
-                    sum_b += src_data[src_pixel_index * 3 + 2];
-                    if ( src_alpha )
-                        sum_a += src_alpha[src_pixel_index];
-
-                    averaged_pixels++;
-                }
-            }
-
-            // Calculate the average from the sum and number of averaged pixels
-            dst_data[0] = (unsigned char)(sum_r / averaged_pixels);
-            dst_data[1] = (unsigned char)(sum_g / averaged_pixels);
-            dst_data[2] = (unsigned char)(sum_b / averaged_pixels);
-            dst_data += 3;
-            if ( src_alpha )
-                *dst_alpha++ = (unsigned char)(sum_a / averaged_pixels);
-        }
-    }
+    BoxResampleOp op(vPrecalcs, hPrecalcs,
+                     src_data, src_alpha, M_IMGDATA->m_width,
+                     dst_data, dst_alpha);
+    ProcessBands(op, height,
+                 GetResampleCostPerRow(M_IMGDATA->m_width, M_IMGDATA->m_height,
+                                       width, height));
 
     return ret_image;
 }
@@ -701,11 +990,134 @@ void ResampleBilinearPrecalc(wxVector<BilinearPrecalc>& precalcs, int oldDim)
     }
 }
 
+// Horizontal pass of ResampleBilinear(): interpolates between the two
+// neighbouring pixels of the source row.
+class BilinearRowResampler
+{
+public:
+    BilinearRowResampler(const wxVector<BilinearPrecalc>& hPrecalcs,
+                         const unsigned char* data,
+                         const unsigned char* alpha,
+                         int width)
+        : m_hPrecalcs(hPrecalcs),
+          m_data(data),
+          m_alpha(alpha),
+          m_width(width)
+    {
+    }
+
+    void operator()(int row, double* out) const
+    {
+        const unsigned char* const data = m_data + row*m_width*3;
+        const unsigned char* const alpha = m_alpha ? m_alpha + row*m_width
+                                                   : NULL;
+
+        const size_t count = m_hPrecalcs.size();
+        for ( size_t x = 0; x < count; x++ )
+        {
+            const BilinearPrecalc& hPrecalc = m_hPrecalcs[x];
+
+            const int x_offset1 = hPrecalc.offset1;
+            const int x_offset2 = hPrecalc.offset2;
+            const double dx = hPrecalc.dd;
+            const double dx1 = hPrecalc.dd1;
+
+            *out++ = data[x_offset1 * 3 + 0] * dx1 + data[x_offset2 * 3 + 0] * dx;
+            *out++ = data[x_offset1 * 3 + 1] * dx1 + data[x_offset2 * 3 + 1] * dx;
+            *out++ = data[x_offset1 * 3 + 2] * dx1 + data[x_offset2 * 3 + 2] * dx;
+            if ( alpha )
+                *out++ = alpha[x_offset1] * dx1 + alpha[x_offset2] * dx;
+        }
+    }
+
+private:
+    const wxVector<BilinearPrecalc>& m_hPrecalcs;
+    const unsigned char* const m_data;
+    const unsigned char* const m_alpha;
+    const int m_width;
+
+    wxDECLARE_NO_ASSIGN_CLASS(BilinearRowResampler);
+};
+
+// Resamples a band of destination rows in ResampleBilinear().
+class BilinearResampleOp : public ImageBandOp
+{
+public:
+    BilinearResampleOp(const wxVector<BilinearPrecalc>& vPrecalcs,
+                       const wxVector<BilinearPrecalc>& hPrecalcs,
+                       const unsigned char* src_data,
+                       const unsigned char* src_alpha,
+                       int src_width,
+                       unsigned char* dst_data,
+                       unsigned char* dst_alpha)
+        : m_vPrecalcs(vPrecalcs),
+          m_resampleRow(hPrecalcs, src_data, src_alpha, src_width),
+          m_width(hPrecalcs.size()),
+          m_src_alpha(src_alpha),
+          m_dst_data(dst_data),
+          m_dst_alpha(dst_alpha)
+    {
+    }
+
+    virtual void ProcessBand(int start, int end)
+    {
+        const int width = m_width;
+        const int channels = m_src_alpha ? 4 : 3;
+
+        ResampledRowsCache<double> rows(2, width*channels);
+
+        unsigned char* dst_data = m_dst_data + start*width*3;
+        unsigned char* dst_alpha = m_dst_alpha ? m_dst_alpha + start*width
+                                               : NULL;
+
+        for ( int dsty = start; dsty < end; dsty++ )
+        {
+            // We need to calculate the source pixel to interpolate from - Y-axis
+            const BilinearPrecalc& vPrecalc = m_vPrecalcs[dsty];
+            const double dy = vPrecalc.dd;
+            const double dy1 = vPrecalc.dd1;
+
+            // first and second lines
+            const double* line1 = rows.Get(vPrecalc.offset1, m_resampleRow);
+            const double* line2 = rows.Get(vPrecalc.offset2, m_resampleRow);
+
+            for ( int dstx = 0; dstx < width; dstx++ )
+            {
+                // result lines
+                dst_data[0] = static_cast<unsigned char>(line1[0] * dy1 + line2[0] * dy);
+                dst_data[1] = static_cast<unsigned char>(line1[1] * dy1 + line2[1] * dy);
+                dst_data[2] = static_cast<unsigned char>(line1[2] * dy1 + line2[2] * dy);
+                dst_data += 3;
+
+                if ( m_src_alpha )
+                    *dst_alpha++ = static_cast<unsigned char>(line1[3] * dy1 + line2[3] * dy);
+
+                line1 += channels;
+                line2 += channels;
+            }
+        }
+    }
+
+private:
+    const wxVector<BilinearPrecalc>& m_vPrecalcs;
+    const BilinearRowResampler m_resampleRow;
+    const int m_width;
+    const unsigned char* const m_src_alpha;
+    unsigned char* const m_dst_data;
+    unsigned char* const m_dst_alpha;
+
+    wxDECLARE_NO_COPY_CLASS(BilinearResampleOp);
+};
+
 } // anonymous namespace
 
 wxImage wxImage::ResampleBilinear(int width, int height) const
 {
     // This function implements a Bilinear algorithm for resampling.
+    //
+    // The interpolation is done in horizontal direction first, with the
+    // results for each source row computed only once, and then between the
+    // two interpolated rows in vertical direction.
     wxImage ret_image(width, height, false);
     const unsigned char* src_data = M_IMGDATA->m_data;
     const unsigned char* src_alpha = M_IMGDATA->m_alpha;
@@ -723,61 +1135,12 @@ wxImage wxImage::ResampleBilinear(int width, int height) const
     ResampleBilinearPrecalc(vPrecalcs, M_IMGDATA->m_height);
     ResampleBilinearPrecalc(hPrecalcs, M_IMGDATA->m_width);
 
-    // initialize alpha values to avoid g++ warnings about possibly
-    // uninitialized variables
-    double r1, g1, b1, a1 = 0;
-    double r2, g2, b2, a2 = 0;
-
-    for ( int dsty = 0; dsty < height; dsty++ )
-    {
-        // We need to calculate the source pixel to interpolate from - Y-axis
-        const BilinearPrecalc& vPrecalc = vPrecalcs[dsty];
-        const int y_offset1 = vPrecalc.offset1;
-        const int y_offset2 = vPrecalc.offset2;
-        const double dy = vPrecalc.dd;
-        const double dy1 = vPrecalc.dd1;
-
-
-        for ( int dstx = 0; dstx < width; dstx++ )
-        {
-            // X-axis of pixel to interpolate from
-            const BilinearPrecalc& hPrecalc = hPrecalcs[dstx];
-
-            const int x_offset1 = hPrecalc.offset1;
-            const int x_offset2 = hPrecalc.offset2;
-            const double dx = hPrecalc.dd;
-            const double dx1 = hPrecalc.dd1;
-
-            int src_pixel_index00 = y_offset1 * M_IMGDATA->m_width + x_offset1;
-            int src_pixel_index01 = y_offset1 * M_IMGDATA->m_width + x_offset2;
-            int src_pixel_index10 = y_offset2 * M_IMGDATA->m_width + x_offset1;
-            int src_pixel_index11 = y_offset2 * M_IMGDATA->m_width + x_offset2;
-
-            // first line
-            r1 = src_data[src_pixel_index00 * 3 + 0] * dx1 + src_data[src_pixel_index01 * 3 + 0] * dx;
-            g1 = src_data[src_pixel_index00 * 3 + 1] * dx1 + src_data[src_pixel_index01 * 3 + 1] * dx;
-            b1 = src_data[src_pixel_index00 * 3 + 2] * dx1 + src_data[src_pixel_index01 * 3 + 2] * dx;
-            if ( src_alpha )
-                a1 = src_alpha[src_pixel_index00] * dx1 + src_alpha[src_pixel_index01] * dx;
-
-            // second line
-            r2 = src_data[src_pixel_index10 * 3 + 0] * dx1 + src_data[src_pixel_index11 * 3 + 0] * dx;
-            g2 = src_data[src_pixel_index10 * 3 + 1] * dx1 + src_data[src_pixel_index11 * 3 + 1] * dx;
-            b2 = src_data[src_pixel_index10 * 3 + 2] * dx1 + src_data[src_pixel_index11 * 3 + 2] * dx;
-            if ( src_alpha )
-                a2 = src_alpha[src_pixel_index10] * dx1 + src_alpha[src_pixel_index11] * dx;
-
-            // result lines
-
-            dst_data[0] = static_cast<unsigned char>(r1 * dy1 + r2 * dy);
-            dst_data[1] = static_cast<unsigned char>(g1 * dy1 + g2 * dy);
-            dst_data[2] = static_cast<unsigned char>(b1 * dy1 + b2 * dy);
-            dst_data += 3;
-
-            if ( src_alpha )
-                *dst_alpha++ = static_cast<unsigned char>(a1 * dy1 + a2 * dy);
-        }
-    }
+    BilinearResampleOp op(vPrecalcs, hPrecalcs,
+                          src_data, src_alpha, M_IMGDATA->m_width,
+                          dst_data, dst_alpha);
+    ProcessBands(op, height,
+                 GetResampleCostPerRow(M_IMGDATA->m_width, M_IMGDATA->m_height,
+                                       width, height));
 
     return ret_image;
 }
@@ -826,7 +1189,109 @@ void ResampleBicubicPrecalc(wxVector<BicubicPrecalc> &aWeight, int oldDim)
                     ? oldDim - 1
                     : static_cast<int>(srcpixd + k);
 
-            precalc.weight[k + 1] = spline_weight(k - dd);
+            precalc.weight[k + 1] = spline_weight(k - dd);
+        }
+    }
+}
+
+// Resamples a band of destination rows in ResampleBicubic().
+class BicubicResampleOp : public ImageBandOp
+{
+public:
+    BicubicResampleOp(const wxVector<BicubicPrecalc>& vPrecalcs,
+                      const wxVector<BicubicPrecalc>& hPrecalcs,
+                      const unsigned char* src_data,
+                      const unsigned char* src_alpha,
+                      int src_width,
+                      unsigned char* dst_data,
+                      unsigned char* dst_alpha)
+        : m_vPrecalcs(vPrecalcs),
+          m_hPrecalcs(hPrecalcs),
+          m_src_data(src_data),
+          m_src_alpha(src_alpha),
+          m_src_width(src_width),
+          m_dst_data(dst_data),
+          m_dst_alpha(dst_alpha)
+    {
+    }
+
+    virtual void ProcessBand(int start, int end);
+
+private:
+    const wxVector<BicubicPrecalc>& m_vPrecalcs;
+    const wxVector<BicubicPrecalc>& m_hPrecalcs;
+    const unsigned char* const m_src_data;
+    const unsigned char* const m_src_alpha;
+    const int m_src_width;
+    unsigned char* const m_dst_data;
+    unsigned char* const m_dst_alpha;
+
+    wxDECLARE_NO_COPY_CLASS(BicubicResampleOp);
+};
+
+void BicubicResampleOp::ProcessBand(int start, int end)
+{
+    const int width = m_hPrecalcs.size();
+
+    const unsigned char* src_data = m_src_data;
+    const unsigned char* src_alpha = m_src_alpha;
+    unsigned char* dst_data = m_dst_data + start*width*3;
+    unsigned char* dst_alpha = m_dst_alpha ? m_dst_alpha + start*width : NULL;
+
+    for ( int dsty = start; dsty < end; dsty++ )
+    {
+        // We need to calculate the source pixel to interpolate from - Y-axis
+        const BicubicPrecalc& vPrecalc = m_vPrecalcs[dsty];
+
+        for ( int dstx = 0; dstx < width; dstx++ )
+        {
+            // X-axis of pixel to interpolate from
+            const BicubicPrecalc& hPrecalc = m_hPrecalcs[dstx];
+
+            // Sums for each color channel
+            double sum_r = 0, sum_g = 0, sum_b = 0, sum_a = 0;
+
+            // Here we actually determine the RGBA values for the destination pixel
+            for ( int k = -1; k <= 2; k++ )
+            {
+                // Y offset
+                const int y_offset = vPrecalc.offset[k + 1];
+
+                // Loop across the X axis
+                for ( int i = -1; i <= 2; i++ )
+                {
+                    // X offset
+                    const int x_offset = hPrecalc.offset[i + 1];
+
+                    // Calculate the exact position where the source data
+                    // should be pulled from based on the x_offset and y_offset
+                    int src_pixel_index = y_offset*m_src_width + x_offset;
+
+                    // Calculate the weight for the specified pixel according
+                    // to the bicubic b-spline kernel we're using for
+                    // interpolation
+                    const double
+                        pixel_weight = vPrecalc.weight[k + 1] * hPrecalc.weight[i + 1];
+
+                    // Create a sum of all velues for each color channel
+                    // adjusted for the pixel's calculated weight
+                    sum_r += src_data[src_pixel_index * 3 + 0] * pixel_weight;
+                    sum_g += src_data[src_pixel_index * 3 + 1] * pixel_weight;
+                    sum_b += src_data[src_pixel_index * 3 + 2] * pixel_weight;
+                    if ( src_alpha )
+                        sum_a += src_alpha[src_pixel_index] * pixel_weight;
+                }
+            }
+
+            // Put the data into the destination image.  The summed values are
+            // of double data type and are rounded here for accuracy
+            dst_data[0] = (unsigned char)(sum_r + 0.5);
+            dst_data[1] = (unsigned char)(sum_g + 0.5);
+            dst_data[2] = (unsigned char)(sum_b + 0.5);
+            dst_data += 3;
+
+            if ( src_alpha )
+                *dst_alpha++ = (unsigned char)sum_a;
         }
     }
 }
@@ -884,65 +1349,173 @@ wxImage wxImage::ResampleBicubic(int width, int height) const
     ResampleBicubicPrecalc(vPrecalcs, M_IMGDATA->m_height);
     ResampleBicubicPrecalc(hPrecalcs, M_IMGDATA->m_width);
 
-    for ( int dsty = 0; dsty < height; dsty++ )
+    BicubicResampleOp op(vPrecalcs, hPrecalcs,
+                         src_data, src_alpha, M_IMGDATA->m_width,
+                         dst_data, dst_alpha);
+    ProcessBands(op, height,
+                 GetResampleCostPerRow(M_IMGDATA->m_width, M_IMGDATA->m_height,
+                                       width, height));
+
+    return ret_image;
+}
+
+namespace
+{
+
+// Common base class for the blur operations.
+//
+// Both of them compute the average of the pixels in the window of
+// 2*blurRadius + 1 pixels centered on the current one, with the pixels beyond
+// the image edges taken to be equal to the edge pixels. The window is slid
+// along the line by adding the pixel entering it to the running sum and
+// subtracting the one leaving it, so the cost per pixel doesn't depend on the
+// blur radius.
+class BlurOpBase : public ImageBandOp
+{
+protected:
+    BlurOpBase(const unsigned char* src_data,
+               const unsigned char* src_alpha,
+               unsigned char* dst_data,
+               unsigned char* dst_alpha,
+               int width,
+               int height,
+               int blurRadius)
+        : m_src_data(src_data),
+          m_src_alpha(src_alpha),
+          m_dst_data(dst_data),
+          m_dst_alpha(dst_alpha),
+          m_width(width),
+          m_height(height),
+          m_blurRadius(blurRadius),
+          m_blurArea(blurRadius*2 + 1) // number of pixels we average over
+    {
+        // Dividing is relatively slow, so multiply by the reciprocal of the
+        // blur area in 0.32 fixed point format instead. This gives exactly
+        // the same result as the division as long as the product of the sum,
+        // which is at most 255*m_blurArea, and the rounding error of the
+        // reciprocal, which is at most m_blurArea, fits into 32 bits.
+        if ( m_blurArea > 1 && m_blurArea <= 4096 )
+            m_reciprocal = wxUint32((wxUint64(1) << 32) / m_blurArea) + 1;
+        else
+            m_reciprocal = 0;
+    }
+
+    // Return the average of m_blurArea values with the given sum.
+    unsigned char GetAverage(wxUint32 sum) const
     {
-        // We need to calculate the source pixel to interpolate from - Y-axis
-        const BicubicPrecalc& vPrecalc = vPrecalcs[dsty];
+        return (unsigned char)(m_reciprocal ? (wxUint64(sum)*m_reciprocal) >> 32
+                                            : sum / m_blurArea);
+    }
 
-        for ( int dstx = 0; dstx < width; dstx++ )
-        {
-            // X-axis of pixel to interpolate from
-            const BicubicPrecalc& hPrecalc = hPrecalcs[dstx];
+    const unsigned char* const m_src_data;
+    const unsigned char* const m_src_alpha;
+    unsigned char* const m_dst_data;
+    unsigned char* const m_dst_alpha;
+    const int m_width;
+    const int m_height;
+    const int m_blurRadius;
+    const int m_blurArea;
 
-            // Sums for each color channel
-            double sum_r = 0, sum_g = 0, sum_b = 0, sum_a = 0;
+private:
+    wxUint32 m_reciprocal;
 
-            // Here we actually determine the RGBA values for the destination pixel
-            for ( int k = -1; k <= 2; k++ )
-            {
-                // Y offset
-                const int y_offset = vPrecalc.offset[k + 1];
+    wxDECLARE_NO_COPY_CLASS(BlurOpBase);
+};
 
-                // Loop across the X axis
-                for ( int i = -1; i <= 2; i++ )
-                {
-                    // X offset
-                    const int x_offset = hPrecalc.offset[i + 1];
+// Blurs a band of rows in BlurHorizontal().
+class BlurHorizontalOp : public BlurOpBase
+{
+public:
+    BlurHorizontalOp(const unsigned char* src_data,
+                     const unsigned char* src_alpha,
+                     unsigned char* dst_data,
+                     unsigned char* dst_alpha,
+                     int width,
+                     int height,
+                     int blurRadius)
+        : BlurOpBase(src_data, src_alpha, dst_data, dst_alpha,
+                     width, height, blurRadius)
+    {
+    }
 
-                    // Calculate the exact position where the source data
-                    // should be pulled from based on the x_offset and y_offset
-                    int src_pixel_index = y_offset*M_IMGDATA->m_width + x_offset;
+    virtual void ProcessBand(int start, int end)
+    {
+        const int channels = m_src_alpha ? 4 : 3;
 
-                    // Calculate the weight for the specified pixel according
-                    // to the bicubic b-spline kernel we're using for
-                    // interpolation
-                    const double
-                        pixel_weight = vPrecalc.weight[k + 1] * hPrecalc.weight[i + 1];
+        // The current row extended with m_blurRadius copies of its first and
+        // last pixels on each side, so that the window can be slid along it
+        // without checking for the edges. The alpha values, if any, are
+        // interleaved with the colour ones to blur both in the same pass.
+        wxVector<unsigned char> line((m_width + 2*m_blurRadius)*channels);
 
-                    // Create a sum of all velues for each color channel
-                    // adjusted for the pixel's calculated weight
-                    sum_r += src_data[src_pixel_index * 3 + 0] * pixel_weight;
-                    sum_g += src_data[src_pixel_index * 3 + 1] * pixel_weight;
-                    sum_b += src_data[src_pixel_index * 3 + 2] * pixel_weight;
-                    if ( src_alpha )
-                        sum_a += src_alpha[src_pixel_index] * pixel_weight;
-                }
+        for ( int y = start; y < end; y++ )
+        {
+            const unsigned char* const src = m_src_data + y*m_width*3;
+            const unsigned char* const
+                alpha = m_src_alpha ? m_src_alpha + y*m_width : NULL;
+
+            unsigned char* p = &line[0];
+            for ( int n = 0; n < m_blurRadius; n++ )
+                p = CopyPixel(p, src, alpha, 0);
+            for ( int x = 0; x < m_width; x++ )
+                p = CopyPixel(p, src, alpha, x);
+            for ( int n = 0; n < m_blurRadius; n++ )
+                p = CopyPixel(p, src, alpha, m_width - 1);
+
+            // Sum of all pixels in the window for the first pixel of the row.
+            wxUint32 sums[4] = { 0, 0, 0, 0 };
+            const unsigned char* add = &line[0];
+            for ( int n = 0; n < m_blurArea; n++ )
+            {
+                for ( int c = 0; c < channels; c++ )
+                    sums[c] += add[c];
+                add += channels;
             }
 
-            // Put the data into the destination image.  The summed values are
-            // of double data type and are rounded here for accuracy
-            dst_data[0] = (unsigned char)(sum_r + 0.5);
-            dst_data[1] = (unsigned char)(sum_g + 0.5);
-            dst_data[2] = (unsigned char)(sum_b + 0.5);
-            dst_data += 3;
-
-            if ( src_alpha )
-                *dst_alpha++ = (unsigned char)sum_a;
+            // And now just move the window along the row.
+            const unsigned char* sub = &line[0];
+            unsigned char* dst = m_dst_data + y*m_width*3;
+            unsigned char* dst_alpha = alpha ? m_dst_alpha + y*m_width : NULL;
+            for ( int x = 0; ; )
+            {
+                dst[0] = GetAverage(sums[0]);
+                dst[1] = GetAverage(sums[1]);
+                dst[2] = GetAverage(sums[2]);
+                dst += 3;
+                if ( dst_alpha )
+                    *dst_alpha++ = GetAverage(sums[3]);
+
+                if ( ++x == m_width )
+                    break;
+
+                for ( int c = 0; c < channels; c++ )
+                    sums[c] += add[c] - sub[c];
+                add += channels;
+                sub += channels;
+            }
         }
     }
 
-    return ret_image;
-}
+private:
+    // Append the pixel at the given position in the source row to the
+    // extended line and return the pointer to the next pixel in it.
+    static unsigned char* CopyPixel(unsigned char* p,
+                                   const unsigned char* src,
+                                   const unsigned char* alpha,
+                                   int x)
+    {
+        src += x*3;
+        *p++ = src[0];
+        *p++ = src[1];
+        *p++ = src[2];
+        if ( alpha )
+            *p++ = alpha[x];
+
+        return p;
+    }
+};
+
+} // anonymous namespace
 
 // Blur in the horizontal direction
 wxImage wxImage::BlurHorizontal(int blurRadius) const
@@ -956,96 +1529,110 @@ wxImage wxImage::BlurHorizontal(int blurRadius) const
     const unsigned char* src_alpha = M_IMGDATA->m_alpha;
     unsigned char* dst_alpha = ret_image.GetAlpha();
 
-    // number of pixels we average over
-    const int blurArea = blurRadius*2 + 1;
+    BlurHorizontalOp op(src_data, src_alpha, dst_data, dst_alpha,
+                        M_IMGDATA->m_width, M_IMGDATA->m_height, blurRadius);
+    ProcessBands(op, M_IMGDATA->m_height, M_IMGDATA->m_width);
+
+    return ret_image;
+}
+
+namespace
+{
 
-    // Horizontal blurring algorithm - average all pixels in the specified blur
-    // radius in the X or horizontal direction
-    for ( int y = 0; y < M_IMGDATA->m_height; y++ )
+// Blurs a band of rows in BlurVertical().
+//
+// Instead of walking down each column, which would access the memory with
+// a stride of the entire row, this keeps the running sums for all the
+// columns at once and updates them a whole row at a time, so that both the
+// source and destination are accessed sequentially.
+class BlurVerticalOp : public BlurOpBase
+{
+public:
+    BlurVerticalOp(const unsigned char* src_data,
+                   const unsigned char* src_alpha,
+                   unsigned char* dst_data,
+                   unsigned char* dst_alpha,
+                   int width,
+                   int height,
+                   int blurRadius)
+        : BlurOpBase(src_data, src_alpha, dst_data, dst_alpha,
+                     width, height, blurRadius)
     {
-        // Variables used in the blurring algorithm
-        long sum_r = 0,
-             sum_g = 0,
-             sum_b = 0,
-             sum_a = 0;
+    }
 
-        long pixel_idx;
-        const unsigned char *src;
-        unsigned char *dst;
+    virtual void ProcessBand(int start, int end)
+    {
+        // Running sums of the colour and alpha values in the current window
+        // for all the columns, starting with the window of the first row.
+        wxVector<wxUint32> sums(m_width*3),
+                           alphaSums(m_src_alpha ? m_width : 0);
+        for ( int y = start - m_blurRadius; y <= start + m_blurRadius; y++ )
+            AddRow(sums, alphaSums, ClampRow(y));
 
-        // Calculate the average of all pixels in the blur radius for the first
-        // pixel of the row
-        for ( int kernel_x = -blurRadius; kernel_x <= blurRadius; kernel_x++ )
+        for ( int y = start; ; )
         {
-            // To deal with the pixels at the start of a row so it's not
-            // grabbing GOK values from memory at negative indices of the
-            // image's data or grabbing from the previous row
-            if ( kernel_x < 0 )
-                pixel_idx = y * M_IMGDATA->m_width;
-            else
-                pixel_idx = kernel_x + y * M_IMGDATA->m_width;
+            unsigned char* const dst = m_dst_data + y*m_width*3;
+            for ( int n = 0; n < m_width*3; n++ )
+                dst[n] = GetAverage(sums[n]);
 
-            src = src_data + pixel_idx*3;
-            sum_r += src[0];
-            sum_g += src[1];
-            sum_b += src[2];
-            if ( src_alpha )
-                sum_a += src_alpha[pixel_idx];
+            if ( m_src_alpha )
+            {
+                unsigned char* const dst_alpha = m_dst_alpha + y*m_width;
+                for ( int n = 0; n < m_width; n++ )
+                    dst_alpha[n] = GetAverage(alphaSums[n]);
+            }
+
+            if ( ++y == end )
+                break;
+
+            // Move the window one row down.
+            SlideRows(sums, alphaSums,
+                      ClampRow(y + m_blurRadius), ClampRow(y - m_blurRadius - 1));
         }
+    }
 
-        dst = dst_data + y * M_IMGDATA->m_width*3;
-        dst[0] = (unsigned char)(sum_r / blurArea);
-        dst[1] = (unsigned char)(sum_g / blurArea);
-        dst[2] = (unsigned char)(sum_b / blurArea);
-        if ( src_alpha )
-            dst_alpha[y * M_IMGDATA->m_width] = (unsigned char)(sum_a / blurArea);
+private:
+    // Return the row to use for the given, possibly out of range, one.
+    int ClampRow(int y) const
+    {
+        return y < 0 ? 0 : y >= m_height ? m_height - 1 : y;
+    }
 
-        // Now average the values of the rest of the pixels by just moving the
-        // blur radius box along the row
-        for ( int x = 1; x < M_IMGDATA->m_width; x++ )
-        {
-            // Take care of edge pixels on the left edge by essentially
-            // duplicating the edge pixel
-            if ( x - blurRadius - 1 < 0 )
-                pixel_idx = y * M_IMGDATA->m_width;
-            else
-                pixel_idx = (x - blurRadius - 1) + y * M_IMGDATA->m_width;
-
-            // Subtract the value of the pixel at the left side of the blur
-            // radius box
-            src = src_data + pixel_idx*3;
-            sum_r -= src[0];
-            sum_g -= src[1];
-            sum_b -= src[2];
-            if ( src_alpha )
-                sum_a -= src_alpha[pixel_idx];
+    void AddRow(wxVector<wxUint32>& sums,
+                wxVector<wxUint32>& alphaSums,
+                int y) const
+    {
+        const unsigned char* const src = m_src_data + y*m_width*3;
+        for ( int n = 0; n < m_width*3; n++ )
+            sums[n] += src[n];
 
-            // Take care of edge pixels on the right edge
-            if ( x + blurRadius > M_IMGDATA->m_width - 1 )
-                pixel_idx = M_IMGDATA->m_width - 1 + y * M_IMGDATA->m_width;
-            else
-                pixel_idx = x + blurRadius + y * M_IMGDATA->m_width;
+        if ( m_src_alpha )
+        {
+            const unsigned char* const alpha = m_src_alpha + y*m_width;
+            for ( int n = 0; n < m_width; n++ )
+                alphaSums[n] += alpha[n];
+        }
+    }
 
-            // Add the value of the pixel being added to the end of our box
-            src = src_data + pixel_idx*3;
-            sum_r += src[0];
-            sum_g += src[1];
-            sum_b += src[2];
-            if ( src_alpha )
-                sum_a += src_alpha[pixel_idx];
+    void SlideRows(wxVector<wxUint32>& sums, wxVector<wxUint32>& alphaSums,
+                   int yAdd, int ySub) const
+    {
+        const unsigned char* const add = m_src_data + yAdd*m_width*3;
+        const unsigned char* const sub = m_src_data + ySub*m_width*3;
+        for ( int n = 0; n < m_width*3; n++ )
+            sums[n] += add[n] - sub[n];
 
-            // Save off the averaged data
-            dst = dst_data + x*3 + y*M_IMGDATA->m_width*3;
-            dst[0] = (unsigned char)(sum_r / blurArea);
-            dst[1] = (unsigned char)(sum_g / blurArea);
-            dst[2] = (unsigned char)(sum_b / blurArea);
-            if ( src_alpha )
-                dst_alpha[x + y * M_IMGDATA->m_width] = (unsigned char)(sum_a / blurArea);
+        if ( m_src_alpha )
+        {
+            const unsigned char* const addAlpha = m_src_alpha + yAdd*m_width;
+            const unsigned char* const subAlpha = m_src_alpha + ySub*m_width;
+            for ( int n = 0; n < m_width; n++ )
+                alphaSums[n] += addAlpha[n] - subAlpha[n];
         }
     }
+};
 
-    return ret_image;
-}
+} // anonymous namespace
 
 // Blur in the vertical direction
 wxImage wxImage::BlurVertical(int blurRadius) const
@@ -1059,134 +1646,112 @@ wxImage wxImage::BlurVertical(int blurRadius) const
     const unsigned char* src_alpha = M_IMGDATA->m_alpha;
     unsigned char* dst_alpha = ret_image.GetAlpha();
 
-    // number of pixels we average over
-    const int blurArea = blurRadius*2 + 1;
-
-    // Vertical blurring algorithm - same as horizontal but switched the
-    // opposite direction
-    for ( int x = 0; x < M_IMGDATA->m_width; x++ )
-    {
-        // Variables used in the blurring algorithm
-        long sum_r = 0,
-             sum_g = 0,
-             sum_b = 0,
-             sum_a = 0;
-
-        long pixel_idx;
-        const unsigned char *src;
-        unsigned char *dst;
-
-        // Calculate the average of all pixels in our blur radius box for the
-        // first pixel of the column
-        for ( int kernel_y = -blurRadius; kernel_y <= blurRadius; kernel_y++ )
-        {
-            // To deal with the pixels at the start of a column so it's not
-            // grabbing GOK values from memory at negative indices of the
-            // image's data or grabbing from the previous column
-            if ( kernel_y < 0 )
-                pixel_idx = x;
-            else
-                pixel_idx = x + kernel_y * M_IMGDATA->m_width;
+    BlurVerticalOp op(src_data, src_alpha, dst_data, dst_alpha,
+                      M_IMGDATA->m_width, M_IMGDATA->m_height, blurRadius);
+    ProcessBands(op, M_IMGDATA->m_height, M_IMGDATA->m_width);
 
-            src = src_data + pixel_idx*3;
-            sum_r += src[0];
-            sum_g += src[1];
-            sum_b += src[2];
-            if ( src_alpha )
-                sum_a += src_alpha[pixel_idx];
-        }
+    return ret_image;
+}
 
-        dst = dst_data + x*3;
-        dst[0] = (unsigned char)(sum_r / blurArea);
-        dst[1] = (unsigned char)(sum_g / blurArea);
-        dst[2] = (unsigned char)(sum_b / blurArea);
-        if ( src_alpha )
-            dst_alpha[x] = (unsigned char)(sum_a / blurArea);
+// The new blur function
+wxImage wxImage::Blur(int blurRadius) const
+{
+    // Blur the image in each direction
+    return BlurHorizontal(blurRadius).BlurVertical(blurRadius);
+}
 
-        // Now average the values of the rest of the pixels by just moving the
-        // box along the column from top to bottom
-        for ( int y = 1; y < M_IMGDATA->m_height; y++ )
-        {
-            // Take care of pixels that would be beyond the top edge by
-            // duplicating the top edge pixel for the column
-            if ( y - blurRadius - 1 < 0 )
-                pixel_idx = x;
-            else
-                pixel_idx = x + (y - blurRadius - 1) * M_IMGDATA->m_width;
+namespace
+{
 
-            // Subtract the value of the pixel at the top of our blur radius box
-            src = src_data + pixel_idx*3;
-            sum_r -= src[0];
-            sum_g -= src[1];
-            sum_b -= src[2];
-            if ( src_alpha )
-                sum_a -= src_alpha[pixel_idx];
+// Compute the radii of the three box blurs whose successive application
+// approximates the Gaussian blur with the given standard deviation, see
+// "Fast Almost-Gaussian Filtering" by Peter Kovesi.
+void GetGaussianBoxRadii(double sigma, int radii[3])
+{
+    const int n = 3;
 
-            // Take care of the pixels that would be beyond the bottom edge of
-            // the image similar to the top edge
-            if ( y + blurRadius > M_IMGDATA->m_height - 1 )
-                pixel_idx = x + (M_IMGDATA->m_height - 1) * M_IMGDATA->m_width;
-            else
-                pixel_idx = x + (blurRadius + y) * M_IMGDATA->m_width;
+    // The ideal width of the boxes would be sqrt(12*sigma^2/n + 1) but they
+    // must have odd width, so use the two closest odd widths and choose the
+    // number of the narrower boxes to get the variance as close as possible.
+    int widthLow = static_cast<int>(floor(sqrt(12*sigma*sigma/n + 1)));
+    if ( widthLow % 2 == 0 )
+        widthLow--;
 
-            // Add the value of the pixel being added to the end of our box
-            src = src_data + pixel_idx*3;
-            sum_r += src[0];
-            sum_g += src[1];
-            sum_b += src[2];
-            if ( src_alpha )
-                sum_a += src_alpha[pixel_idx];
+    const int widthHigh = widthLow + 2;
 
-            // Save off the averaged data
-            dst = dst_data + (x + y * M_IMGDATA->m_width) * 3;
-            dst[0] = (unsigned char)(sum_r / blurArea);
-            dst[1] = (unsigned char)(sum_g / blurArea);
-            dst[2] = (unsigned char)(sum_b / blurArea);
-            if ( src_alpha )
-                dst_alpha[x + y * M_IMGDATA->m_width] = (unsigned char)(sum_a / blurArea);
-        }
-    }
+    const int numLow = wxRound((12*sigma*sigma - n*widthLow*widthLow
+                                - 4*n*widthLow - 3*n) / (-4.*widthLow - 4));
 
-    return ret_image;
+    for ( int i = 0; i < n; i++ )
+        radii[i] = ((i < numLow ? widthLow : widthHigh) - 1) / 2;
 }
 
-// The new blur function
-wxImage wxImage::Blur(int blurRadius) const
+} // anonymous namespace
+
+wxImage wxImage::BlurGaussian(double sigma) const
 {
-    wxImage ret_image;
-    ret_image.Create(M_IMGDATA->m_width, M_IMGDATA->m_height, false);
+    wxCHECK_MSG( sigma >= 0, wxImage(), wxT("invalid standard deviation") );
 
-    // Blur the image in each direction
-    ret_image = BlurHorizontal(blurRadius);
-    ret_image = ret_image.BlurVertical(blurRadius);
+    int radii[3];
+    GetGaussianBoxRadii(sigma, radii);
+
+    // Just as the box blur, the Gaussian one is separable, so apply all the
+    // boxes in the horizontal direction and then in the vertical one.
+    wxImage ret_image = BlurHorizontal(radii[0]);
+    ret_image = ret_image.BlurHorizontal(radii[1]);
+    ret_image = ret_image.BlurHorizontal(radii[2]);
+    ret_image = ret_image.BlurVertical(radii[0]);
+    ret_image = ret_image.BlurVertical(radii[1]);
+    ret_image = ret_image.BlurVertical(radii[2]);
 
     return ret_image;
 }
 
-wxImage wxImage::Rotate90( bool clockwise ) const
+namespace
 {
-    wxImage image(MakeEmptyClone(Clone_SwapOrientation));
-
-    wxCHECK( image.IsOk(), image );
-
-    long height = M_IMGDATA->m_height;
-    long width  = M_IMGDATA->m_width;
 
-    if ( HasOption(wxIMAGE_OPTION_CUR_HOTSPOT_X) )
-    {
-        int hot_x = GetOptionInt( wxIMAGE_OPTION_CUR_HOTSPOT_X );
-        image.SetOption(wxIMAGE_OPTION_CUR_HOTSPOT_Y,
-                        clockwise ? hot_x : width - 1 - hot_x);
-    }
+// Rotates a band of source rows in Rotate90().
+class Rotate90Op : public ImageBandOp
+{
+public:
+    Rotate90Op(const unsigned char* src_data,
+               const unsigned char* src_alpha,
+               unsigned char* dst_data,
+               unsigned char* dst_alpha,
+               long width,
+               long height,
+               bool clockwise)
+        : m_src_data(src_data),
+          m_src_alpha(src_alpha),
+          m_dst_data(dst_data),
+          m_dst_alpha(dst_alpha),
+          m_width(width),
+          m_height(height),
+          m_clockwise(clockwise)
+    {
+    }
+
+    virtual void ProcessBand(int start, int end);
+
+private:
+    const unsigned char* const m_src_data;
+    const unsigned char* const m_src_alpha;
+    unsigned char* const m_dst_data;
+    unsigned char* const m_dst_alpha;
+    const long m_width;
+    const long m_height;
+    const bool m_clockwise;
+
+    wxDECLARE_NO_COPY_CLASS(Rotate90Op);
+};
 
-    if ( HasOption(wxIMAGE_OPTION_CUR_HOTSPOT_Y) )
-    {
-        int hot_y = GetOptionInt( wxIMAGE_OPTION_CUR_HOTSPOT_Y );
-        image.SetOption(wxIMAGE_OPTION_CUR_HOTSPOT_X,
-                        clockwise ? height - 1 - hot_y : hot_y);
-    }
+void Rotate90Op::ProcessBand(int start, int end)
+{
+    const long height = m_height;
+    const long width  = m_width;
+    const bool clockwise = m_clockwise;
 
-    unsigned char *data = image.GetData();
+    unsigned char *data = m_dst_data;
     unsigned char *target_data;
 
     // we rotate the image in 21-pixel (63-byte) wide strips
@@ -1197,10 +1762,10 @@ wxImage wxImage::Rotate90( bool clockwise ) const
     {
         long next_ii = wxMin(ii + 21, width);
 
-        for (long j = 0; j < height; j++)
+        for (long j = start; j < end; j++)
         {
             const unsigned char *source_data
-                                     = M_IMGDATA->m_data + (j*width + ii)*3;
+                                     = m_src_data + (j*width + ii)*3;
 
             for (long i = ii; i < next_ii; i++)
             {
@@ -1220,20 +1785,20 @@ wxImage wxImage::Rotate90( bool clockwise ) const
         ii = next_ii;
     }
 
-    const unsigned char *source_alpha = M_IMGDATA->m_alpha;
+    const unsigned char *source_alpha = m_src_alpha;
 
     if ( source_alpha )
     {
-        unsigned char *alpha_data = image.GetAlpha();
+        unsigned char *alpha_data = m_dst_alpha;
         unsigned char *target_alpha = 0 ;
 
         for (long ii = 0; ii < width; )
         {
             long next_ii = wxMin(ii + 64, width);
 
-            for (long j = 0; j < height; j++)
+            for (long j = start; j < end; j++)
             {
-                source_alpha = M_IMGDATA->m_alpha + j*width + ii;
+                source_alpha = m_src_alpha + j*width + ii;
 
                 for (long i = ii; i < next_ii; i++)
                 {
@@ -1253,6 +1818,37 @@ wxImage wxImage::Rotate90( bool clockwise ) const
             ii = next_ii;
         }
     }
+}
+
+} // anonymous namespace
+
+wxImage wxImage::Rotate90( bool clockwise ) const
+{
+    wxImage image(MakeEmptyClone(Clone_SwapOrientation));
+
+    wxCHECK( image.IsOk(), image );
+
+    long height = M_IMGDATA->m_height;
+    long width  = M_IMGDATA->m_width;
+
+    if ( HasOption(wxIMAGE_OPTION_CUR_HOTSPOT_X) )
+    {
+        int hot_x = GetOptionInt( wxIMAGE_OPTION_CUR_HOTSPOT_X );
+        image.SetOption(wxIMAGE_OPTION_CUR_HOTSPOT_Y,
+                        clockwise ? hot_x : width - 1 - hot_x);
+    }
+
+    if ( HasOption(wxIMAGE_OPTION_CUR_HOTSPOT_Y) )
+    {
+        int hot_y = GetOptionInt( wxIMAGE_OPTION_CUR_HOTSPOT_Y );
+        image.SetOption(wxIMAGE_OPTION_CUR_HOTSPOT_X,
+                        clockwise ? height - 1 - hot_y : hot_y);
+    }
+
+    Rotate90Op op(M_IMGDATA->m_data, M_IMGDATA->m_alpha,
+                  image.GetData(), image.GetAlpha(),
+                  width, height, clockwise);
+    ProcessBands(op, height, width);
 
     return image;
 }
@@ -1618,6 +2214,105 @@ void wxImage::Replace( unsigned char r1, unsigned char g1, unsigned char b1,
         }
 }
 
+namespace
+{
+
+// Converts the colours of a band of rows in ConvertToGreyscale() and
+// ConvertToDisabled(), the actual conversion is done by the Converter class.
+template <class Converter>
+class ConvertColoursOp : public ImageBandOp
+{
+public:
+    ConvertColoursOp(const Converter& converter,
+                     const unsigned char* src,
+                     unsigned char* dst,
+                     int width,
+                     bool hasMask,
+                     unsigned char mask_r,
+                     unsigned char mask_g,
+                     unsigned char mask_b)
+        : m_converter(converter),
+          m_src(src),
+          m_dst(dst),
+          m_width(width),
+          m_hasMask(hasMask),
+          m_mask_r(mask_r),
+          m_mask_g(mask_g),
+          m_mask_b(mask_b)
+    {
+    }
+
+    virtual void ProcessBand(int start, int end)
+    {
+        const unsigned char* src = m_src + size_t(start)*m_width*3;
+        unsigned char* dst = m_dst + size_t(start)*m_width*3;
+        size_t size = size_t(end - start)*m_width;
+        while (size--)
+        {
+            unsigned char r = *src++;
+            unsigned char g = *src++;
+            unsigned char b = *src++;
+            if (!m_hasMask || r != m_mask_r || g != m_mask_g || b != m_mask_b)
+                m_converter(&r, &g, &b);
+            *dst++ = r;
+            *dst++ = g;
+            *dst++ = b;
+        }
+    }
+
+private:
+    const Converter m_converter;
+    const unsigned char* const m_src;
+    unsigned char* const m_dst;
+    const int m_width;
+    const bool m_hasMask;
+    const unsigned char m_mask_r,
+                        m_mask_g,
+                        m_mask_b;
+
+    wxDECLARE_NO_COPY_TEMPLATE_CLASS(ConvertColoursOp, Converter);
+};
+
+class GreyscaleConverter
+{
+public:
+    GreyscaleConverter(double weight_r, double weight_g, double weight_b)
+        : m_weight_r(weight_r),
+          m_weight_g(weight_g),
+          m_weight_b(weight_b)
+    {
+    }
+
+    void operator()(unsigned char* r, unsigned char* g, unsigned char* b) const
+    {
+        wxColour::MakeGrey(r, g, b, m_weight_r, m_weight_g, m_weight_b);
+    }
+
+private:
+    double m_weight_r,
+           m_weight_g,
+           m_weight_b;
+};
+
+class DisabledConverter
+{
+public:
+    explicit DisabledConverter(unsigned char brightness)
+        : m_brightness(brightness)
+    {
+    }
+
+    void operator()(unsigned char* r, unsigned char* g, unsigned char* b) const
+    {
+        wxColour::MakeDisabled(r, g, b, m_brightness);
+    }
+
+private:
+    unsigned char m_brightness;
+};
+
+} // anonymous namespace
+
 wxImage wxImage::ConvertToGreyscale(void) const
 {
     return ConvertToGreyscale(0.299, 0.587, 0.114);
@@ -1645,19 +2340,12 @@ wxImage wxImage::ConvertToGreyscale(double weight_r, double weight_g, double wei
     if (hasMask)
         image.SetMaskColour(mask_r, mask_g, mask_b);
 
-    const unsigned char* src = M_IMGDATA->m_data;
-    unsigned char* dst = image.GetData();
-    while (size--)
-    {
-        unsigned char r = *src++;
-        unsigned char g = *src++;
-        unsigned char b = *src++;
-        if (!hasMask || r != mask_r || g != mask_g || b != mask_b)
-            wxColour::MakeGrey(&r, &g, &b, weight_r, weight_g, weight_b);
-        *dst++ = r;
-        *dst++ = g;
-        *dst++ = b;
-    }
+    ConvertColoursOp<GreyscaleConverter>
+        op(GreyscaleConverter(weight_r, weight_g, weight_b),
+           M_IMGDATA->m_data, image.GetData(), w,
+           hasMask, mask_r, mask_g, mask_b);
+    ProcessBands(op, h, w);
+
     return image;
 }
 
@@ -1718,19 +2406,12 @@ wxImage wxImage::ConvertToDisabled(unsigned char brightness) const
     if (hasMask)
         image.SetMaskColour(mask_r, mask_g, mask_b);
 
-    const unsigned char* src = M_IMGDATA->m_data;
-    unsigned char* dst = image.GetData();
-    while (size--)
-    {
-        unsigned char r = *src++;
-        unsigned char g = *src++;
-        unsigned char b = *src++;
-        if (!hasMask || r != mask_r || g != mask_g || b != mask_b)
-            wxColour::MakeDisabled(&r, &g, &b, brightness);
-        *dst++ = r;
-        *dst++ = g;
-        *dst++ = b;
-    }
+    ConvertColoursOp<DisabledConverter>
+        op(DisabledConverter(brightness),
+           M_IMGDATA->m_data, image.GetData(), w,
+           hasMask, mask_r, mask_g, mask_b);
+    ProcessBands(op, h, w);
+
     return image;
 }
 
@@ -2783,6 +3464,33 @@ bool wxImage::SaveFile( wxOutputStream& stream, const wxString& mimetype ) const
 
 #endif // wxUSE_STREAMS
 
+// ----------------------------------------------------------------------------
+// multithreading support
+// ----------------------------------------------------------------------------
+
+/* static */
+void wxImage::SetThreadCount(int count)
+{
+    wxCHECK_RET( count >= 0, wxT("invalid number of threads") );
+
+#if wxUSE_THREADS
+    if ( count == 0 )
+        count = wxThread::GetCPUCount();
+
+    // GetCPUCount() returns -1 if the number of CPUs is unknown.
+    gs_imageThreadCount = count > 1 ? count : 1;
+#else // !wxUSE_THREADS
+    // We can never use more than one thread without threads support.
+    wxUnusedVar(count);
+#endif // wxUSE_THREADS/!wxUSE_THREADS
+}
+
+/* static */
+int wxImage::GetThreadCount()
+{
+    return gs_imageThreadCount;
+}
+
 // ----------------------------------------------------------------------------
 // image I/O handlers
 // ----------------------------------------------------------------------------
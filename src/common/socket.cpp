@@ -46,8 +46,17 @@
 #include "wx/private/fd.h"
 #include "wx/private/socket.h"
 
+#if wxUSE_FILE
+    #include "wx/file.h"
+#endif
+
 #ifdef __UNIX__
     #include <errno.h>
+    #include <sys/uio.h>
+#endif
+
+#ifdef wxHAS_SOCKET_SENDFILE
+    #include <sys/sendfile.h>
 #endif
 
 // we use MSG_NOSIGNAL to avoid getting SIGPIPE when sending data to a remote
@@ -65,8 +74,25 @@
     // next best possibility is to use SO_NOSIGPIPE socket option, this covers
     // BSD systems (including OS X) -- but if we don't have it neither (AIX and
     // old HP-UX do not), we have to fall back to the old way of simply
-    // disabling SIGPIPE temporarily, so define a class to do it in a safe way
+    // disabling SIGPIPE temporarily
     #if defined(__UNIX__) && !defined(SO_NOSIGPIPE)
+        #define wxNEEDS_IGNORE_SIGPIPE
+    #endif // Unix without SO_NOSIGPIPE
+
+    #define wxSOCKET_MSG_NOSIGNAL 0
+#endif
+
+// sendfile() doesn't take any flags, so we also need to disable SIGPIPE when
+// using it if SO_NOSIGPIPE is not available
+#if defined(wxHAS_SOCKET_SENDFILE) && !defined(SO_NOSIGPIPE)
+    #define wxNEEDS_IGNORE_SIGPIPE_FOR_SENDFILE
+#endif
+
+#if defined(wxNEEDS_IGNORE_SIGPIPE) || \
+        defined(wxNEEDS_IGNORE_SIGPIPE_FOR_SENDFILE)
+    #include <signal.h>
+
+    // define a class to disable a signal temporarily in a safe way
     extern "C" { typedef void (*wxSigHandler_t)(int); }
     namespace
     {
@@ -93,12 +119,7 @@
             wxDECLARE_NO_COPY_CLASS(IgnoreSignal);
         };
     } // anonymous namespace
-
-    #define wxNEEDS_IGNORE_SIGPIPE
-    #endif // Unix without SO_NOSIGPIPE
-
-    #define wxSOCKET_MSG_NOSIGNAL 0
-#endif
+#endif // need IgnoreSignal
 
 // DLL options compatibility check:
 #include "wx/build.h"
@@ -743,6 +764,236 @@ int wxSocketImpl::Write(const void *buffer, int size)
     return ret;
 }
 
+#ifdef __UNIX__
+
+namespace
+{
+
+// maximal number of buffers passed to a single recvmsg() or sendmsg() call
+// for a stream socket, the rest of them is used by the next call
+const int MAX_STREAM_IOVECS = 64;
+
+// fill in the given msghdr with the iovec array corresponding to the given
+// buffers, allocating it if the fixed size one is not big enough
+class wxSocketMsgHdr
+{
+public:
+    wxSocketMsgHdr(const wxSocketIOVec *vec, int count, wxUint32 skip,
+                   bool stream)
+    {
+        // don't send more than we can return from Read/Write() for streams,
+        // datagrams must be sent (and received) entirely however
+        if ( stream && count > MAX_STREAM_IOVECS )
+            count = MAX_STREAM_IOVECS;
+
+        m_iov = count > MAX_STREAM_IOVECS ? new iovec[count] : m_iovFixed;
+
+        int n;
+        size_t total = 0;
+        for ( n = 0; n < count; n++ )
+        {
+            m_iov[n].iov_base = static_cast<char *>(vec[n].buffer) + skip;
+            m_iov[n].iov_len = vec[n].nbytes - skip;
+            skip = 0;
+
+            total += m_iov[n].iov_len;
+            if ( stream && total > INT_MAX )
+            {
+                m_iov[n].iov_len -= total - INT_MAX;
+                n++;
+                break;
+            }
+        }
+
+        memset(&m_hdr, 0, sizeof(m_hdr));
+        m_hdr.msg_iov = m_iov;
+        m_hdr.msg_iovlen = n;
+    }
+
+    ~wxSocketMsgHdr()
+    {
+        if ( m_iov != m_iovFixed )
+            delete [] m_iov;
+    }
+
+    msghdr *Get() { return &m_hdr; }
+
+private:
+    msghdr m_hdr;
+    iovec *m_iov;
+    iovec m_iovFixed[MAX_STREAM_IOVECS];
+
+    wxDECLARE_NO_COPY_CLASS(wxSocketMsgHdr);
+};
+
+} // anonymous namespace
+
+int wxSocketImpl::RecvMsg(const wxSocketIOVec *vec, int count, wxUint32 skip)
+{
+    wxSocketMsgHdr hdr(vec, count, skip, m_stream);
+
+    wxSockAddressStorage from;
+    if ( !m_stream )
+    {
+        hdr.Get()->msg_name = &from.addr;
+        hdr.Get()->msg_namelen = sizeof(from);
+    }
+
+    int ret;
+    DO_WHILE_EINTR( ret, recvmsg(m_fd, hdr.Get(), 0) );
+
+    if ( m_stream )
+    {
+        // see RecvStream()
+        if ( !ret )
+        {
+            m_establishing = false;
+            NotifyOnStateChange(wxSOCKET_LOST);
+
+            Shutdown();
+        }
+    }
+    else if ( ret != SOCKET_ERROR )
+    {
+        m_peer = wxSockAddressImpl(from.addr, hdr.Get()->msg_namelen);
+        if ( !m_peer.IsOk() )
+            return -1;
+    }
+
+    return ret;
+}
+
+int wxSocketImpl::SendMsg(const wxSocketIOVec *vec, int count, wxUint32 skip)
+{
+    wxSocketMsgHdr hdr(vec, count, skip, m_stream);
+
+    if ( !m_stream )
+    {
+        if ( !m_peer.IsOk() )
+        {
+            m_error = wxSOCKET_INVADDR;
+            return -1;
+        }
+
+        hdr.Get()->msg_name = const_cast<sockaddr *>(m_peer.GetAddr());
+        hdr.Get()->msg_namelen = m_peer.GetLen();
+    }
+
+#ifdef wxNEEDS_IGNORE_SIGPIPE
+    IgnoreSignal ignore(SIGPIPE);
+#endif
+
+    int ret;
+    DO_WHILE_EINTR( ret, sendmsg(m_fd, hdr.Get(),
+                                 m_stream ? wxSOCKET_MSG_NOSIGNAL : 0) );
+
+    return ret;
+}
+
+#else // !__UNIX__
+
+// Winsock has WSARecv() and WSASend() but they're not used yet, so just copy
+// the data via a temporary buffer which preserves the semantics of a single
+// operation for both stream and datagram sockets
+
+int wxSocketImpl::RecvMsg(const wxSocketIOVec *vec, int count, wxUint32 skip)
+{
+    size_t total = 0;
+    for ( int n = 0; n < count; n++ )
+        total += vec[n].nbytes;
+    total -= skip;
+
+    wxCharBuffer buf(total);
+    int ret = m_stream ? RecvStream(buf.data(), total)
+                       : RecvDgram(buf.data(), total);
+
+    const char *p = buf.data();
+    for ( int n = 0, left = ret; n < count && left > 0; n++ )
+    {
+        const int len = wxMin(left, int(vec[n].nbytes - skip));
+        memcpy(static_cast<char *>(vec[n].buffer) + skip, p, len);
+        p += len;
+        left -= len;
+        skip = 0;
+    }
+
+    return ret;
+}
+
+int wxSocketImpl::SendMsg(const wxSocketIOVec *vec, int count, wxUint32 skip)
+{
+    wxMemoryBuffer buf;
+    for ( int n = 0; n < count; n++ )
+    {
+        buf.AppendData(static_cast<char *>(vec[n].buffer) + skip,
+                       vec[n].nbytes - skip);
+        skip = 0;
+    }
+
+    return m_stream ? SendStream(buf.GetData(), buf.GetDataLen())
+                    : SendDgram(buf.GetData(), buf.GetDataLen());
+}
+
+#endif // __UNIX__/!__UNIX__
+
+int wxSocketImpl::ReadV(const wxSocketIOVec *vec, int count, wxUint32 skip)
+{
+    if ( m_fd == INVALID_SOCKET || m_server )
+    {
+        m_error = wxSOCKET_INVSOCK;
+        return -1;
+    }
+
+    int ret = RecvMsg(vec, count, skip);
+
+    m_error = ret == SOCKET_ERROR ? GetLastError() : wxSOCKET_NOERROR;
+
+    return ret;
+}
+
+int wxSocketImpl::WriteV(const wxSocketIOVec *vec, int count, wxUint32 skip)
+{
+    if ( m_fd == INVALID_SOCKET || m_server )
+    {
+        m_error = wxSOCKET_INVSOCK;
+        return -1;
+    }
+
+    int ret = SendMsg(vec, count, skip);
+
+    m_error = ret == SOCKET_ERROR ? GetLastError() : wxSOCKET_NOERROR;
+
+    return ret;
+}
+
+#ifdef wxHAS_SOCKET_SENDFILE
+
+int wxSocketImpl::SendFile(int fd, wxFileOffset *offset, int size)
+{
+    if ( m_fd == INVALID_SOCKET || m_server )
+    {
+        m_error = wxSOCKET_INVSOCK;
+        return -1;
+    }
+
+#ifdef wxNEEDS_IGNORE_SIGPIPE_FOR_SENDFILE
+    IgnoreSignal ignore(SIGPIPE);
+#endif
+
+    off_t off = *offset;
+
+    int ret;
+    DO_WHILE_EINTR( ret, sendfile(m_fd, fd, &off, size) );
+
+    *offset = off;
+
+    m_error = ret == SOCKET_ERROR ? GetLastError() : wxSOCKET_NOERROR;
+
+    return ret;
+}
+
+#endif // wxHAS_SOCKET_SENDFILE
+
 // ==========================================================================
 // wxSocketBase
 // ==========================================================================
@@ -956,32 +1207,76 @@ wxSocketBase& wxSocketBase::Read(void* buffer, wxUint32 nbytes)
     return *this;
 }
 
-wxUint32 wxSocketBase::DoRead(void* buffer_, wxUint32 nbytes)
+wxSocketBase& wxSocketBase::ReadV(const wxSocketIOVec *vec, size_t count)
 {
-    wxCHECK_MSG( m_impl, 0, "socket must be valid" );
+    wxSocketReadGuard read(this);
 
-    // We use pointer arithmetic here which doesn't work with void pointers.
-    char *buffer = static_cast<char *>(buffer_);
+    m_lcount_read = DoReadV(vec, count);
+    m_lcount = m_lcount_read;
+
+    return *this;
+}
+
+wxUint32 wxSocketBase::DoRead(void* buffer, wxUint32 nbytes)
+{
     wxCHECK_MSG( buffer, 0, "NULL buffer" );
 
+    wxSocketIOVec vec;
+    vec.buffer = buffer;
+    vec.nbytes = nbytes;
+
+    return DoReadV(&vec, 1);
+}
+
+wxUint32 wxSocketBase::DoReadV(const wxSocketIOVec *vec, size_t count)
+{
+    wxCHECK_MSG( m_impl, 0, "socket must be valid" );
+    wxCHECK_MSG( vec || !count, 0, "NULL buffers" );
+
     // Try the push back buffer first, even before checking whether the socket
     // is valid to allow reading previously pushed back data from an already
     // closed socket.
-    wxUint32 total = GetPushback(buffer, nbytes, false);
-    nbytes -= total;
-    buffer += total;
+    //
+    // We use pointer arithmetic here which doesn't work with void pointers.
+    size_t n = 0;           // index of the first buffer not filled entirely
+    wxUint32 skip = 0;      // and the number of bytes already read into it
+    wxUint32 total = 0;
+    for ( ; n < count; n++ )
+    {
+        skip = GetPushback(static_cast<char *>(vec[n].buffer),
+                           vec[n].nbytes, false);
+        total += skip;
+        if ( skip < vec[n].nbytes )
+            break;
+    }
 
-    while ( nbytes )
+    for ( ;; )
     {
+        // skip the buffers which were already filled
+        while ( n < count && skip >= vec[n].nbytes )
+        {
+            skip -= vec[n].nbytes;
+            n++;
+        }
+
+        if ( n == count )
+            break;
+
         // our socket is non-blocking so Read() will return immediately if
         // there is nothing to read yet and it's more efficient to try it first
         // before entering DoWait() which is going to start dispatching GUI
         // events and, even more importantly, we must do this under Windows
         // where we're not going to get notifications about socket being ready
         // for reading before we read all the existing data from it
-        const int ret = !m_impl->m_stream || m_connected
-                            ? m_impl->Read(buffer, nbytes)
-                            : 0;
+        int ret = 0;
+        if ( !m_impl->m_stream || m_connected )
+        {
+            ret = n == count - 1
+                    ? m_impl->Read(static_cast<char *>(vec[n].buffer) + skip,
+                                   vec[n].nbytes - skip)
+                    : m_impl->ReadV(vec + n, int(count - n), skip);
+        }
+
         if ( ret == -1 )
         {
             if ( m_impl->GetLastError() == wxSOCKET_WOULDBLOCK )
@@ -1035,8 +1330,7 @@ wxUint32 wxSocketBase::DoRead(void* buffer_, wxUint32 nbytes)
         if ( !(m_flags & wxSOCKET_WAITALL_READ) )
             break;
 
-        nbytes -= ret;
-        buffer += ret;
+        skip += ret;
     }
 
     return total;
@@ -1078,12 +1372,13 @@ wxSocketBase& wxSocketBase::ReadMsg(void* buffer, wxUint32 nbytes)
             else
                 len2 = 0;
 
-            // Don't attempt to read if the msg was zero bytes long.
-            m_lcount_read = len ? DoRead(buffer, len) : 0;
-            m_lcount = m_lcount_read;
-
+            bool gotTrailer = false;
             if ( len2 )
             {
+                // Don't attempt to read if the buffer is empty.
+                m_lcount_read = len ? DoRead(buffer, len) : 0;
+                m_lcount = m_lcount_read;
+
                 char discard_buffer[MAX_DISCARD_SIZE];
                 long discard_len;
 
@@ -1097,9 +1392,27 @@ wxSocketBase& wxSocketBase::ReadMsg(void* buffer, wxUint32 nbytes)
                     len2 -= (wxUint32)discard_len;
                 }
                 while ((discard_len > 0) && len2);
+
+                if ( !len2 )
+                    gotTrailer = DoRead(&msg, sizeof(msg)) == sizeof(msg);
+            }
+            else // the entire message fits into the buffer
+            {
+                // read the message data together with the trailer following it
+                wxSocketIOVec vec[2];
+                vec[0].buffer = buffer;
+                vec[0].nbytes = len;
+                vec[1].buffer = &msg;
+                vec[1].nbytes = sizeof(msg);
+
+                const wxUint32 total = DoReadV(vec, WXSIZEOF(vec));
+                m_lcount_read = wxMin(total, len);
+                m_lcount = m_lcount_read;
+
+                gotTrailer = total == len + sizeof(msg);
             }
 
-            if ( !len2 && DoRead(&msg, sizeof(msg)) == sizeof(msg) )
+            if ( gotTrailer )
             {
                 sig = (wxUint32)msg.sig[0];
                 sig |= (wxUint32)(msg.sig[1] << 8);
@@ -1142,19 +1455,49 @@ wxSocketBase& wxSocketBase::Write(const void *buffer, wxUint32 nbytes)
     return *this;
 }
 
-// This function is a mirror image of DoRead() except that it doesn't use the
+wxSocketBase& wxSocketBase::WriteV(const wxSocketIOVec *vec, size_t count)
+{
+    wxSocketWriteGuard write(this);
+
+    m_lcount_write = DoWriteV(vec, count);
+    m_lcount = m_lcount_write;
+
+    return *this;
+}
+
+wxUint32 wxSocketBase::DoWrite(const void *buffer, wxUint32 nbytes)
+{
+    wxCHECK_MSG( buffer, 0, "NULL buffer" );
+
+    wxSocketIOVec vec;
+    vec.buffer = const_cast<void *>(buffer);
+    vec.nbytes = nbytes;
+
+    return DoWriteV(&vec, 1);
+}
+
+// This function is a mirror image of DoReadV() except that it doesn't use the
 // push back buffer and doesn't treat 0 return value specially (normally this
 // shouldn't happen at all here), so please see comments there for explanations
-wxUint32 wxSocketBase::DoWrite(const void *buffer_, wxUint32 nbytes)
+wxUint32 wxSocketBase::DoWriteV(const wxSocketIOVec *vec, size_t count)
 {
     wxCHECK_MSG( m_impl, 0, "socket must be valid" );
+    wxCHECK_MSG( vec || !count, 0, "NULL buffers" );
 
-    const char *buffer = static_cast<const char *>(buffer_);
-    wxCHECK_MSG( buffer, 0, "NULL buffer" );
-
+    size_t n = 0;
+    wxUint32 skip = 0;
     wxUint32 total = 0;
-    while ( nbytes )
+    for ( ;; )
     {
+        while ( n < count && skip >= vec[n].nbytes )
+        {
+            skip -= vec[n].nbytes;
+            n++;
+        }
+
+        if ( n == count )
+            break;
+
         if ( m_impl->m_stream && !m_connected )
         {
             if ( (m_flags & wxSOCKET_WAITALL_WRITE) || !total )
@@ -1162,7 +1505,10 @@ wxUint32 wxSocketBase::DoWrite(const void *buffer_, wxUint32 nbytes)
             break;
         }
 
-        const int ret = m_impl->Write(buffer, nbytes);
+        const int ret = n == count - 1
+            ? m_impl->Write(static_cast<char *>(vec[n].buffer) + skip,
+                            vec[n].nbytes - skip)
+            : m_impl->WriteV(vec + n, int(count - n), skip);
         if ( ret == -1 )
         {
             if ( m_impl->GetLastError() == wxSOCKET_WOULDBLOCK )
@@ -1190,13 +1536,129 @@ wxUint32 wxSocketBase::DoWrite(const void *buffer_, wxUint32 nbytes)
         if ( !(m_flags & wxSOCKET_WAITALL_WRITE) )
             break;
 
-        nbytes -= ret;
-        buffer += ret;
+        skip += ret;
     }
 
     return total;
 }
 
+#if wxUSE_FILE
+
+wxSocketBase& wxSocketBase::SendFile(wxFile& file, wxUint32 nbytes)
+{
+    wxSocketWriteGuard write(this);
+
+    m_lcount_write = DoSendFile(file, nbytes);
+    m_lcount = m_lcount_write;
+
+    return *this;
+}
+
+wxUint32 wxSocketBase::DoSendFile(wxFile& file, wxUint32 nbytes)
+{
+    wxCHECK_MSG( m_impl, 0, "socket must be valid" );
+    wxCHECK_MSG( file.IsOpened(), 0, "file must be opened" );
+
+    wxUint32 total = 0;
+
+#ifdef wxHAS_SOCKET_SENDFILE
+    // sendfile() could be used with datagram sockets too but it wouldn't
+    // preserve the message boundaries, so only use it for the streams
+    if ( m_impl->m_stream )
+    {
+        wxFileOffset offset = file.Tell();
+        if ( offset == wxInvalidOffset )
+        {
+            SetError(wxSOCKET_IOERR);
+            return 0;
+        }
+
+        // This loop is the same as in DoWriteV(), except that reaching the
+        // end of file before sending everything is considered to be an error.
+        while ( nbytes )
+        {
+            if ( !m_connected )
+            {
+                if ( (m_flags & wxSOCKET_WAITALL_WRITE) || !total )
+                    SetError(wxSOCKET_IOERR);
+                break;
+            }
+
+            const int ret = m_impl->SendFile(file.fd(), &offset,
+                                             wxMin(nbytes, INT_MAX));
+            if ( ret == -1 )
+            {
+                if ( m_impl->GetLastError() == wxSOCKET_WOULDBLOCK )
+                {
+                    if ( m_flags & wxSOCKET_NOWAIT_WRITE )
+                        break;
+
+                    if ( !DoWaitWithTimeout(wxSOCKET_OUTPUT_FLAG) )
+                    {
+                        SetError(wxSOCKET_TIMEDOUT);
+                        break;
+                    }
+
+                    continue;
+                }
+                else // "real" error
+                {
+                    SetError(wxSOCKET_IOERR);
+                    break;
+                }
+            }
+            else if ( ret == 0 )
+            {
+                SetError(wxSOCKET_IOERR);
+                break;
+            }
+
+            total += ret;
+
+            if ( !(m_flags & wxSOCKET_WAITALL_WRITE) )
+                break;
+
+            nbytes -= ret;
+        }
+
+        // sendfile() doesn't update the file position itself
+        file.Seek(offset);
+
+        return total;
+    }
+#endif // wxHAS_SOCKET_SENDFILE
+
+    // fall back to reading the file contents into a buffer
+    char buf[MAX_DISCARD_SIZE];
+    while ( nbytes )
+    {
+        const ssize_t len = file.Read(buf, wxMin(nbytes, sizeof(buf)));
+        if ( len <= 0 )
+        {
+            SetError(wxSOCKET_IOERR);
+            break;
+        }
+
+        const wxUint32 sent = DoWrite(buf, len);
+        total += sent;
+        nbytes -= sent;
+
+        if ( sent != (wxUint32)len )
+        {
+            // rewind to the first byte which wasn't sent
+            file.Seek(-(wxFileOffset)(len - sent), wxFromCurrent);
+            break;
+        }
+
+        if ( !(m_flags & wxSOCKET_WAITALL_WRITE) )
+            break;
+    }
+
+    return total;
+}
+
+#endif // wxUSE_FILE
+
 wxSocketBase& wxSocketBase::WriteMsg(const void *buffer, wxUint32 nbytes)
 {
     struct
@@ -1219,26 +1681,37 @@ wxSocketBase& wxSocketBase::WriteMsg(const void *buffer, wxUint32 nbytes)
     msg.len[2] = (unsigned char) ((nbytes >> 16) & 0xff);
     msg.len[3] = (unsigned char) ((nbytes >> 24) & 0xff);
 
-    bool ok = false;
-    if ( DoWrite(&msg, sizeof(msg)) == sizeof(msg) )
+    struct
     {
-        m_lcount_write = DoWrite(buffer, nbytes);
-        m_lcount = m_lcount_write;
-        if ( m_lcount_write == nbytes )
-        {
-            msg.sig[0] = (unsigned char) 0xed;
-            msg.sig[1] = (unsigned char) 0xfe;
-            msg.sig[2] = (unsigned char) 0xad;
-            msg.sig[3] = (unsigned char) 0xde;
-            msg.len[0] =
-            msg.len[1] =
-            msg.len[2] =
-            msg.len[3] = (char) 0;
-
-            if ( DoWrite(&msg, sizeof(msg)) == sizeof(msg))
-                ok = true;
-        }
-    }
+        unsigned char sig[4];
+        unsigned char len[4];
+    } trailer;
+
+    trailer.sig[0] = (unsigned char) 0xed;
+    trailer.sig[1] = (unsigned char) 0xfe;
+    trailer.sig[2] = (unsigned char) 0xad;
+    trailer.sig[3] = (unsigned char) 0xde;
+    trailer.len[0] =
+    trailer.len[1] =
+    trailer.len[2] =
+    trailer.len[3] = (char) 0;
+
+    // send the header, the data and the trailer at once
+    wxSocketIOVec vec[3];
+    vec[0].buffer = &msg;
+    vec[0].nbytes = sizeof(msg);
+    vec[1].buffer = const_cast<void *>(buffer);
+    vec[1].nbytes = nbytes;
+    vec[2].buffer = &trailer;
+    vec[2].nbytes = sizeof(trailer);
+
+    const wxUint32 total = DoWriteV(vec, WXSIZEOF(vec));
+
+    m_lcount_write = total > sizeof(msg) ? wxMin(total - sizeof(msg), nbytes)
+                                         : 0;
+    m_lcount = m_lcount_write;
+
+    const bool ok = total == sizeof(msg) + nbytes + sizeof(trailer);
 
     if ( !ok )
         SetError(wxSOCKET_IOERR);
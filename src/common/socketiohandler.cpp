@@ -55,9 +55,11 @@ void wxSocketFDBasedManager::Install_Callback(wxSocketImpl *socket_,
 
     const wxFDIOManager::Direction d = GetDirForEvent(socket, event);
 
+    // there is nothing to do if we're already monitoring this socket, and
+    // removing and adding it back would result in unnecessary system calls
     int& fd = FD(socket, d);
     if ( fd != -1 )
-        m_fdioManager->RemoveInput(socket, fd, d);
+        return;
 
     fd = m_fdioManager->AddInput(socket, socket->m_fd, d);
 }
@@ -981,6 +981,39 @@ const unsigned char tableUtf8Lengths[256] = {
                    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0   // F5..FF
 };
 
+// return the number of ASCII characters at the start of the given buffer
+// examining at most len bytes of it
+//
+// as the text is often mostly ASCII, we check as many bytes as fit into a
+// machine word at once here and then convert all of them without any further
+// checks
+static size_t GetASCIIPrefixLength(const char *src, size_t len)
+{
+    // the mask selecting the highest bit of every byte of a word
+    static const size_t highBits = ~(size_t)0 / 0xFF * 0x80;
+
+    const char * const start = src;
+    while ( len >= sizeof(size_t) )
+    {
+        // use memcpy() to avoid unaligned access, it is optimized away anyhow
+        size_t word;
+        memcpy(&word, src, sizeof(word));
+        if ( word & highBits )
+            break;
+
+        src += sizeof(word);
+        len -= sizeof(word);
+    }
+
+    while ( len && !(*src & 0x80) )
+    {
+        src++;
+        len--;
+    }
+
+    return src - start;
+}
+
 size_t
 wxMBConvStrictUTF8::ToWChar(wchar_t *dst, size_t dstLen,
                             const char *src, size_t srcLen) const
@@ -988,100 +1021,101 @@ wxMBConvStrictUTF8::ToWChar(wchar_t *dst, size_t dstLen,
     wchar_t *out = dstLen ? dst : NULL;
     size_t written = 0;
 
+    // notice that the trailing NUL is converted as any other character when
+    // the length is not given explicitly
     if ( srcLen == wxNO_LEN )
         srcLen = strlen(src) + 1;
 
-    for ( const char *p = src; ; p++ )
+    const char *p = src;
+    while ( srcLen )
     {
-        if ( (srcLen == wxNO_LEN ? !*p : !srcLen) )
+        // convert all ASCII characters (there are usually many of them) at
+        // once, stopping at the first non-ASCII one or at the end of the
+        // output buffer
+        if ( !(*p & 0x80) )
         {
-            // all done successfully, just add the trailing NULL if we are not
-            // using explicit length
-            if ( srcLen == wxNO_LEN )
-            {
-                if ( out )
-                {
-                    if ( !dstLen )
-                        break;
+            const size_t maxAscii = out ? wxMin(srcLen, dstLen) : srcLen;
+            const size_t ascii = GetASCIIPrefixLength(p, maxAscii);
 
-                    *out = L'\0';
-                }
+            if ( out )
+            {
+                for ( size_t n = 0; n < ascii; n++ )
+                    out[n] = static_cast<unsigned char>(p[n]);
 
-                written++;
+                out += ascii;
+                dstLen -= ascii;
             }
 
-            return written;
+            p += ascii;
+            srcLen -= ascii;
+            written += ascii;
+
+            if ( !srcLen )
+                break;
         }
 
         if ( out && !dstLen-- )
-            break;
+            return wxCONV_FAILED;
 
-        wxUint32 code;
         unsigned char c = *p;
-
-        if ( c < 0x80 )
+        unsigned len = tableUtf8Lengths[c];
+        if ( len < 2 || srcLen < len )
         {
-            if ( srcLen == 0 ) // the test works for wxNO_LEN too
-                break;
+            // invalid lead byte or incomplete sequence at the end of input
+            // (notice that ASCII characters can't get here)
+            return wxCONV_FAILED;
+        }
 
-            if ( srcLen != wxNO_LEN )
-                srcLen--;
+        srcLen -= len;
 
-            code = c;
+        //   Char. number range   |        UTF-8 octet sequence
+        //      (hexadecimal)     |              (binary)
+        //  ----------------------+----------------------------------------
+        //  0000 0000 - 0000 007F | 0xxxxxxx
+        //  0000 0080 - 0000 07FF | 110xxxxx 10xxxxxx
+        //  0000 0800 - 0000 FFFF | 1110xxxx 10xxxxxx 10xxxxxx
+        //  0001 0000 - 0010 FFFF | 11110xxx 10xxxxxx 10xxxxxx 10xxxxxx
+        //
+        //  Code point value is stored in bits marked with 'x',
+        //  lowest-order bit of the value on the right side in the diagram
+        //  above.                                         (from RFC 3629)
+
+        // decode the sequences of each length separately as it's faster than
+        // doing it in a loop, notice that tableUtf8Lengths only contains
+        // valid lead bytes, so there is no need to check the lead byte's most
+        // significant bits, but the other bytes must be of 10xxxxxx form
+        const unsigned char c1 = p[1];
+        if ( (c1 & 0xC0) != 0x80 )
+            return wxCONV_FAILED;
+
+        wxUint32 code;
+        if ( len == 2 )
+        {
+            code = ((c & 0x1F) << 6) | (c1 & 0x3F);
         }
         else
         {
-            unsigned len = tableUtf8Lengths[c];
-            if ( !len )
-                break;
-
-            if ( srcLen < len ) // the test works for wxNO_LEN too
-                break;
-
-            if ( srcLen != wxNO_LEN )
-                srcLen -= len;
-
-            //   Char. number range   |        UTF-8 octet sequence
-            //      (hexadecimal)     |              (binary)
-            //  ----------------------+----------------------------------------
-            //  0000 0000 - 0000 007F | 0xxxxxxx
-            //  0000 0080 - 0000 07FF | 110xxxxx 10xxxxxx
-            //  0000 0800 - 0000 FFFF | 1110xxxx 10xxxxxx 10xxxxxx
-            //  0001 0000 - 0010 FFFF | 11110xxx 10xxxxxx 10xxxxxx 10xxxxxx
-            //
-            //  Code point value is stored in bits marked with 'x',
-            //  lowest-order bit of the value on the right side in the diagram
-            //  above.                                         (from RFC 3629)
-
-            // mask to extract lead byte's value ('x' bits above), by sequence
-            // length:
-            static const unsigned char leadValueMask[] = { 0x7F, 0x1F, 0x0F, 0x07 };
-
-            // mask and value of lead byte's most significant bits, by length:
-            static const unsigned char leadMarkerMask[] = { 0x80, 0xE0, 0xF0, 0xF8 };
-            static const unsigned char leadMarkerVal[] = { 0x00, 0xC0, 0xE0, 0xF0 };
-
-            len--; // it's more convenient to work with 0-based length here
-
-            // extract the lead byte's value bits:
-            if ( (c & leadMarkerMask[len]) != leadMarkerVal[len] )
-                break;
-
-            code = c & leadValueMask[len];
+            const unsigned char c2 = p[2];
+            if ( (c2 & 0xC0) != 0x80 )
+                return wxCONV_FAILED;
 
-            // all remaining bytes, if any, are handled in the same way
-            // regardless of sequence's length:
-            for ( ; len; --len )
+            if ( len == 3 )
+            {
+                code = ((c & 0x0F) << 12) | ((c1 & 0x3F) << 6) | (c2 & 0x3F);
+            }
+            else // 4 byte sequence
             {
-                c = *++p;
-                if ( (c & 0xC0) != 0x80 )
+                const unsigned char c3 = p[3];
+                if ( (c3 & 0xC0) != 0x80 )
                     return wxCONV_FAILED;
 
-                code <<= 6;
-                code |= c & 0x3F;
+                code = ((c & 0x07) << 18) | ((c1 & 0x3F) << 12) |
+                            ((c2 & 0x3F) << 6) | (c3 & 0x3F);
             }
         }
 
+        p += len;
+
 #ifdef WC_UTF16
         // cast is ok because wchar_t == wxUint16 if WC_UTF16
         if ( encode_utf16(code, (wxUint16 *)out) == 2 )
@@ -1101,7 +1135,7 @@ wxMBConvStrictUTF8::ToWChar(wchar_t *dst, size_t dstLen,
         written++;
     }
 
-    return wxCONV_FAILED;
+    return written;
 }
 
 size_t
@@ -1113,6 +1147,34 @@ wxMBConvStrictUTF8::FromWChar(char *dst, size_t dstLen,
 
     for ( const wchar_t *wp = src; ; wp++ )
     {
+        // copy all ASCII characters except NUL at once, this is much faster
+        // than handling them one by one below (notice that wxNO_LEN is the
+        // biggest size_t value, so the code works for it too), but don't read
+        // past the end of the input if its length is given explicitly
+        if ( srcLen && static_cast<wxUint32>(*wp) - 1 < 0x7F )
+        {
+            const size_t maxAscii = out ? wxMin(srcLen, dstLen) : srcLen;
+
+            size_t ascii = 0;
+            while ( ascii < maxAscii &&
+                        static_cast<wxUint32>(wp[ascii]) - 1 < 0x7F )
+                ascii++;
+
+            if ( out )
+            {
+                for ( size_t n = 0; n < ascii; n++ )
+                    out[n] = static_cast<char>(wp[n]);
+
+                out += ascii;
+                dstLen -= ascii;
+            }
+
+            wp += ascii;
+            if ( srcLen != wxNO_LEN )
+                srcLen -= ascii;
+            written += ascii;
+        }
+
         if ( (srcLen == wxNO_LEN ? !*wp : !srcLen) )
         {
             // all done successfully, just add the trailing NULL if we are not
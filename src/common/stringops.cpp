@@ -94,8 +94,32 @@ bool wxStringOperationsUtf8::IsValidUtf8String(const char *str, size_t len)
     const unsigned char *c = (const unsigned char*)str;
     const unsigned char * const end = (len == wxStringImpl::npos) ? NULL : c + len;
 
+    // masks selecting the lowest and the highest bit of every byte of a word
+    static const size_t lowBits = ~(size_t)0 / 0xFF;
+    static const size_t highBits = lowBits * 0x80;
+
     for ( ; c != end && *c; ++c )
     {
+        if ( end != NULL )
+        {
+            // skip the ASCII characters, which are usually the majority, by
+            // checking as many of them as fit into a word at once: notice
+            // that subtracting 1 from every byte sets the highest bit of the
+            // result if the byte is NUL, which must stop the loop too
+            while ( end - c >= (ptrdiff_t)sizeof(size_t) )
+            {
+                size_t word;
+                memcpy(&word, c, sizeof(word));
+                if ( ((word - lowBits) | word) & highBits )
+                    break;
+
+                c += sizeof(word);
+            }
+
+            if ( c == end || !*c )
+                break;
+        }
+
         unsigned char b = *c;
 
         if ( end != NULL )
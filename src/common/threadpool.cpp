@@ -0,0 +1,635 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        src/common/threadpool.cpp
+// Purpose:     wxThreadPool and wxTask implementation
+// Author:      wxWidgets team
+// Created:     2026-10-18
+// Copyright:   (c) 2026 wxWidgets team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+// ============================================================================
+// declarations
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// headers
+// ----------------------------------------------------------------------------
+
+// for compilers that support precompilation, includes "wx.h".
+#include "wx/wxprec.h"
+
+#ifdef __BORLANDC__
+    #pragma hdrstop
+#endif
+
+#if wxUSE_THREADS
+
+#include "wx/threadpool.h"
+
+#ifndef WX_PRECOMP
+    #include "wx/app.h"
+    #include "wx/event.h"
+    #include "wx/log.h"
+    #include "wx/module.h"
+#endif
+
+#include "wx/tls.h"
+#include "wx/weakref.h"
+
+// ----------------------------------------------------------------------------
+// wxTaskQueue: a double-ended queue of tasks protected by a critical section
+// ----------------------------------------------------------------------------
+
+class wxTaskQueue
+{
+public:
+    wxTaskQueue()
+    {
+        // the size of m_tasks must always be a power of 2
+        m_tasks.resize(16);
+        m_head = 0;
+        m_count = 0;
+    }
+
+    void PushBack(wxTask *task)
+    {
+        wxCriticalSectionLocker lock(m_cs);
+
+        if ( m_count == m_tasks.size() )
+            Grow();
+
+        m_tasks[(m_head + m_count++) & (m_tasks.size() - 1)] = task;
+    }
+
+    wxTask *PopBack()
+    {
+        wxCriticalSectionLocker lock(m_cs);
+
+        if ( !m_count )
+            return NULL;
+
+        return m_tasks[(m_head + --m_count) & (m_tasks.size() - 1)];
+    }
+
+    wxTask *PopFront()
+    {
+        wxCriticalSectionLocker lock(m_cs);
+
+        if ( !m_count )
+            return NULL;
+
+        wxTask * const task = m_tasks[m_head];
+        m_head = (m_head + 1) & (m_tasks.size() - 1);
+        m_count--;
+
+        return task;
+    }
+
+private:
+    // double the buffer size, must be called when it's full
+    void Grow()
+    {
+        const size_t size = m_tasks.size();
+
+        wxVector<wxTask *> tasks(2*size);
+        for ( size_t n = 0; n < size; n++ )
+            tasks[n] = m_tasks[(m_head + n) & (size - 1)];
+
+        m_tasks.swap(tasks);
+        m_head = 0;
+    }
+
+    wxCriticalSection m_cs;
+
+    // circular buffer with m_count tasks starting at m_head
+    wxVector<wxTask *> m_tasks;
+    size_t m_head,
+           m_count;
+
+    wxDECLARE_NO_COPY_CLASS(wxTaskQueue);
+};
+
+// ----------------------------------------------------------------------------
+// wxThreadPoolWorker: one of the threads of wxThreadPool
+// ----------------------------------------------------------------------------
+
+class wxThreadPoolWorker : public wxThread
+{
+public:
+    wxThreadPoolWorker(wxThreadPool& pool, size_t index)
+        : wxThread(wxTHREAD_JOINABLE),
+          m_pool(pool),
+          m_index(index)
+    {
+    }
+
+    const wxThreadPool& GetPool() const { return m_pool; }
+    size_t GetIndex() const { return m_index; }
+
+protected:
+    virtual ExitCode Entry();
+
+private:
+    wxThreadPool& m_pool;
+    const size_t m_index;
+
+    wxDECLARE_NO_COPY_CLASS(wxThreadPoolWorker);
+};
+
+// ----------------------------------------------------------------------------
+// wxTaskCompletedEvent: used to call wxTask::OnCompleted() in the main thread
+// ----------------------------------------------------------------------------
+
+#ifdef wxHAS_CALL_AFTER
+
+// This event is queued for the application object and not for the handler
+// passed to wxThreadPool::Submit() because the latter can be destroyed at any
+// moment. Instead, the event takes ownership of the weak reference to the
+// handler, which is then only used in the main thread where the event is
+// processed or deleted.
+class wxTaskCompletedEvent : public wxAsyncMethodCallEvent
+{
+public:
+    wxTaskCompletedEvent(wxTask *task)
+        : wxAsyncMethodCallEvent(wxTheApp),
+          m_task(task),
+          m_handler(task->m_handler)
+    {
+        m_task->IncRef();
+        m_task->m_handler = NULL;
+    }
+
+    wxTaskCompletedEvent(const wxTaskCompletedEvent& other)
+        : wxAsyncMethodCallEvent(other),
+          m_task(other.m_task),
+          m_handler(new wxWeakRef<wxEvtHandler>(*other.m_handler))
+    {
+        m_task->IncRef();
+    }
+
+    virtual ~wxTaskCompletedEvent()
+    {
+        delete m_handler;
+
+        m_task->DecRef();
+    }
+
+    virtual wxEvent *Clone() const { return new wxTaskCompletedEvent(*this); }
+
+    virtual void Execute()
+    {
+        if ( *m_handler )
+            m_task->OnCompleted();
+    }
+
+private:
+    wxTask * const m_task;
+    wxWeakRef<wxEvtHandler> * const m_handler;
+
+    wxDECLARE_NO_ASSIGN_CLASS(wxTaskCompletedEvent);
+};
+
+#endif // wxHAS_CALL_AFTER
+
+// ----------------------------------------------------------------------------
+// globals
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+// the worker object of the current thread, if it is a worker thread
+wxTLS_TYPE(wxThreadPoolWorker *) gs_currentWorker;
+
+// the default pool returned by wxThreadPool::Get()
+wxThreadPool *gs_defaultPool = NULL;
+
+} // anonymous namespace
+
+// ============================================================================
+// implementation
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// wxThreadPoolWorker
+// ----------------------------------------------------------------------------
+
+wxThread::ExitCode wxThreadPoolWorker::Entry()
+{
+    wxTLS_VALUE(gs_currentWorker) = this;
+
+    while ( wxTask * const task = m_pool.GetNextTask(m_index) )
+        m_pool.RunTask(task);
+
+    wxTLS_VALUE(gs_currentWorker) = NULL;
+
+    return 0;
+}
+
+// ----------------------------------------------------------------------------
+// wxTask
+// ----------------------------------------------------------------------------
+
+wxTask::wxTask()
+{
+    m_refCount = 1;
+    m_state = State_New;
+    m_cancelled = false;
+    m_pool = NULL;
+    m_handler = NULL;
+}
+
+wxTask::~wxTask()
+{
+    // the weak reference is normally released by wxTaskCompletedEvent, it can
+    // only still be here if there was no application object to notify
+    delete m_handler;
+}
+
+void wxTask::DecRef()
+{
+    if ( !wxAtomicDec(m_refCount) )
+        delete this;
+}
+
+void wxTask::Cancel()
+{
+    bool done = false;
+    {
+        wxCriticalSectionLocker lock(m_cs);
+
+        m_cancelled = true;
+
+        // the task is still in the pool queue but it will just be released
+        // by the worker thread which finds it there now
+        if ( m_state == State_Queued )
+        {
+            m_state = State_Done;
+            done = true;
+        }
+    }
+
+    if ( done )
+        NotifyDone();
+}
+
+bool wxTask::IsCancelled() const
+{
+    wxCriticalSectionLocker lock(m_cs);
+
+    return m_cancelled;
+}
+
+bool wxTask::IsDone() const
+{
+    wxCriticalSectionLocker lock(m_cs);
+
+    return m_state == State_Done;
+}
+
+void wxTask::Wait()
+{
+    wxCHECK_RET( m_pool, "the task must be submitted to a pool first" );
+
+    m_pool->WaitUntilDone(this);
+}
+
+bool wxTask::Start()
+{
+    wxCriticalSectionLocker lock(m_cs);
+
+    if ( m_state != State_Queued )
+        return false;
+
+    m_state = State_Running;
+
+    return true;
+}
+
+void wxTask::Finish()
+{
+    {
+        wxCriticalSectionLocker lock(m_cs);
+
+        m_state = State_Done;
+    }
+
+    NotifyDone();
+}
+
+void wxTask::NotifyDone()
+{
+#ifdef wxHAS_CALL_AFTER
+    if ( m_handler && wxTheApp )
+        wxTheApp->QueueEvent(new wxTaskCompletedEvent(this));
+#endif // wxHAS_CALL_AFTER
+
+    m_pool->OnTaskDone();
+}
+
+// ----------------------------------------------------------------------------
+// wxThreadPool
+// ----------------------------------------------------------------------------
+
+/* static */
+int wxThreadPool::GetDefaultThreadCount()
+{
+    // GetCPUCount() returns -1 if the number of CPUs is unknown
+    const int numCPUs = wxThread::GetCPUCount();
+
+    return numCPUs > 0 ? numCPUs : 1;
+}
+
+wxThreadPool::wxThreadPool(int numThreads)
+    : m_numThreads(numThreads > 0 ? numThreads : GetDefaultThreadCount()),
+      m_condIdle(m_mutexIdle),
+      m_condDone(m_mutexDone)
+{
+    m_started = false;
+    m_numQueued = 0;
+    m_numPending = 0;
+    m_numWaiting = 0;
+    m_numIdle = 0;
+    m_exiting = false;
+
+    m_sharedQueue = new wxTaskQueue;
+    for ( int n = 0; n < m_numThreads; n++ )
+        m_queues.push_back(new wxTaskQueue);
+}
+
+wxThreadPool::~wxThreadPool()
+{
+    // cancel all the tasks which didn't start running yet
+    for ( size_t n = 0; n <= m_queues.size(); n++ )
+    {
+        wxTaskQueue * const queue = n < m_queues.size() ? m_queues[n]
+                                                        : m_sharedQueue;
+        while ( wxTask * const task = queue->PopFront() )
+        {
+            wxAtomicDec(m_numQueued);
+
+            task->Cancel();
+            task->DecRef();
+        }
+    }
+
+    // and wait until the running ones terminate
+    {
+        wxMutexLocker lock(m_mutexIdle);
+
+        m_exiting = true;
+        m_condIdle.Broadcast();
+    }
+
+    for ( size_t n = 0; n < m_threads.size(); n++ )
+    {
+        m_threads[n]->Wait();
+        delete m_threads[n];
+    }
+
+    for ( size_t n = 0; n < m_queues.size(); n++ )
+        delete m_queues[n];
+
+    delete m_sharedQueue;
+}
+
+/* static */
+wxThreadPool& wxThreadPool::Get()
+{
+    static wxCriticalSection s_cs;
+
+    wxCriticalSectionLocker lock(s_cs);
+
+    if ( !gs_defaultPool )
+        gs_defaultPool = new wxThreadPool;
+
+    return *gs_defaultPool;
+}
+
+void wxThreadPool::StartThreads()
+{
+    wxCriticalSectionLocker lock(m_csThreads);
+
+    if ( m_started )
+        return;
+
+    m_started = true;
+
+    for ( int n = 0; n < m_numThreads; n++ )
+    {
+        wxThreadPoolWorker * const thread = new wxThreadPoolWorker(*this, n);
+        if ( thread->Run() != wxTHREAD_NO_ERROR )
+        {
+            wxLogDebug("Failed to start thread pool worker thread.");
+            delete thread;
+            break;
+        }
+
+        m_threads.push_back(thread);
+    }
+}
+
+void wxThreadPool::DoSubmit(wxTask *task, wxEvtHandler *handler)
+{
+    wxCHECK_RET( task, "NULL task" );
+
+    // the handler is tracked using a weak reference which is not thread-safe,
+    // so this can only be done in the main thread, where it can be destroyed
+    wxCHECK_RET( !handler || wxThread::IsMain(),
+                 "handler can only be used when submitting from the main thread" );
+
+    {
+        wxCriticalSectionLocker lock(task->m_cs);
+
+        wxCHECK_RET( task->m_state == wxTask::State_New,
+                     "the task can only be submitted once" );
+
+        task->m_state = wxTask::State_Queued;
+        task->m_pool = this;
+    }
+
+    if ( handler )
+        task->m_handler = new wxWeakRef<wxEvtHandler>(handler);
+
+    // this reference is released by RunTask()
+    task->IncRef();
+
+    wxAtomicInc(m_numPending);
+
+    StartThreads();
+
+    if ( m_threads.empty() )
+    {
+        // we have no choice but to run the task synchronously if we couldn't
+        // create any threads
+        RunTask(task);
+        return;
+    }
+
+    // the tasks created by other tasks are put in the queue of the current
+    // worker thread, as they're likely to be waited for by the task creating
+    // them, while the others go to the shared queue
+    const int index = GetCurrentWorker();
+    if ( index != -1 )
+        m_queues[index]->PushBack(task);
+    else
+        m_sharedQueue->PushBack(task);
+
+    wxAtomicInc(m_numQueued);
+
+    wxMutexLocker lock(m_mutexIdle);
+    if ( m_numIdle )
+        m_condIdle.Signal();
+}
+
+int wxThreadPool::GetCurrentWorker() const
+{
+    const wxThreadPoolWorker * const worker = wxTLS_VALUE(gs_currentWorker);
+    if ( !worker || &worker->GetPool() != this )
+        return -1;
+
+    return worker->GetIndex();
+}
+
+wxTask *wxThreadPool::FindTask(size_t index)
+{
+    // prefer the most recently added tasks from our own queue as they're
+    // more likely to use the data still in the CPU caches
+    wxTask *task = m_queues[index]->PopBack();
+
+    if ( !task )
+        task = m_sharedQueue->PopFront();
+
+    // and steal the oldest tasks from the other threads, starting with the
+    // next one to avoid all of them stealing from the same one
+    const size_t count = m_queues.size();
+    for ( size_t n = 1; !task && n < count; n++ )
+        task = m_queues[(index + n) % count]->PopFront();
+
+    if ( task )
+        wxAtomicDec(m_numQueued);
+
+    return task;
+}
+
+wxTask *wxThreadPool::GetNextTask(size_t index)
+{
+    for ( ;; )
+    {
+        wxTask * const task = FindTask(index);
+        if ( task )
+            return task;
+
+        wxMutexLocker lock(m_mutexIdle);
+
+        // notice that m_numQueued can be temporarily negative if a task was
+        // taken from the queue before DoSubmit() incremented it
+        while ( m_numQueued <= 0 && !m_exiting )
+        {
+            m_numIdle++;
+            m_condIdle.Wait();
+            m_numIdle--;
+        }
+
+        // still execute the tasks queued by the running tasks when exiting
+        if ( m_numQueued <= 0 )
+            return NULL;
+    }
+}
+
+void wxThreadPool::RunTask(wxTask *task)
+{
+    if ( task->Start() )
+    {
+        task->Run();
+        task->Finish();
+    }
+
+    task->DecRef();
+}
+
+void wxThreadPool::OnTaskDone()
+{
+    wxAtomicDec(m_numPending);
+
+    // notice that both the modification of the task state and of
+    // m_numPending above happen before we check m_numWaiting, while the
+    // waiting threads increment m_numWaiting before checking for them, so
+    // either we see them waiting or they see the task as done
+    if ( m_numWaiting > 0 )
+    {
+        wxMutexLocker lock(m_mutexDone);
+        m_condDone.Broadcast();
+    }
+}
+
+void wxThreadPool::WaitUntilDone(const wxTask *task)
+{
+    const int index = GetCurrentWorker();
+
+    for ( ;; )
+    {
+        if ( task ? task->IsDone() : m_numPending <= 0 )
+            return;
+
+        // help with executing the tasks instead of just waiting if we're one
+        // of the pool threads, this is not only more efficient but is also
+        // necessary to avoid deadlocks if all threads wait for other tasks
+        if ( index != -1 )
+        {
+            wxTask * const other = FindTask(index);
+            if ( other )
+            {
+                RunTask(other);
+                continue;
+            }
+        }
+
+        wxAtomicInc(m_numWaiting);
+
+        {
+            wxMutexLocker lock(m_mutexDone);
+            while ( task ? !task->IsDone() : m_numPending > 0 )
+            {
+                // if we're a worker thread, the other threads could be waiting
+                // for the tasks which can only be executed by us, so don't
+                // block for too long without checking for them
+                if ( index != -1 )
+                {
+                    m_condDone.WaitTimeout(1);
+                    break;
+                }
+
+                m_condDone.Wait();
+            }
+        }
+
+        wxAtomicDec(m_numWaiting);
+    }
+}
+
+void wxThreadPool::WaitAll()
+{
+    wxCHECK_RET( GetCurrentWorker() == -1,
+                 "can't wait for all tasks from a pool thread" );
+
+    WaitUntilDone(NULL);
+}
+
+// ----------------------------------------------------------------------------
+// wxThreadPoolModule: destroys the default pool
+// ----------------------------------------------------------------------------
+
+class wxThreadPoolModule : public wxModule
+{
+public:
+    virtual bool OnInit() { return true; }
+    virtual void OnExit() { wxDELETE(gs_defaultPool); }
+
+private:
+    wxDECLARE_DYNAMIC_CLASS(wxThreadPoolModule);
+};
+
+wxIMPLEMENT_DYNAMIC_CLASS(wxThreadPoolModule, wxModule);
+
+#endif // wxUSE_THREADS
@@ -236,6 +236,32 @@ bool wxFileStream::IsOk() const
     return wxFileOutputStream::IsOk() && wxFileInputStream::IsOk();
 }
 
+// ----------------------------------------------------------------------------
+// wxMappedFileInputStream
+// ----------------------------------------------------------------------------
+
+wxMappedFileInputStream::wxMappedFileInputStream(const wxString& fileName)
+                       : wxMappedFile(fileName),
+                         wxMemoryInputStream(wxMappedFile::GetData(),
+                                             wxMappedFile::GetLength())
+{
+    Init();
+}
+
+wxMappedFileInputStream::wxMappedFileInputStream(wxFile& file)
+                       : wxMappedFile(file),
+                         wxMemoryInputStream(wxMappedFile::GetData(),
+                                             wxMappedFile::GetLength())
+{
+    Init();
+}
+
+void wxMappedFileInputStream::Init()
+{
+    if ( !IsOpened() )
+        m_lasterror = wxSTREAM_READ_ERROR;
+}
+
 #endif // wxUSE_FILE
 
 #if wxUSE_FFILE
@@ -33,15 +33,18 @@
 
 // value for the 'version needed to extract' field (20 means 2.0)
 enum {
-    VERSION_NEEDED_TO_EXTRACT = 20
+    VERSION_NEEDED_TO_EXTRACT = 20,
+    VERSION_NEEDED_FOR_ZIP64  = 45
 };
 
 // signatures for the various records (PKxx)
 enum {
-    CENTRAL_MAGIC = 0x02014b50,     // central directory record
-    LOCAL_MAGIC   = 0x04034b50,     // local header
-    END_MAGIC     = 0x06054b50,     // end of central directory record
-    SUMS_MAGIC    = 0x08074b50      // data descriptor (info-zip)
+    CENTRAL_MAGIC       = 0x02014b50,   // central directory record
+    LOCAL_MAGIC         = 0x04034b50,   // local header
+    END_MAGIC           = 0x06054b50,   // end of central directory record
+    ZIP64_END_MAGIC     = 0x06064b50,   // zip64 end of central directory record
+    ZIP64_LOCATOR_MAGIC = 0x07064b50,   // zip64 end of central directory locator
+    SUMS_MAGIC          = 0x08074b50    // data descriptor (info-zip)
 };
 
 // unix file attributes. zip stores them in the high 16 bits of the
@@ -54,12 +57,26 @@ enum {
 
 // minimum sizes for the various records
 enum {
-    CENTRAL_SIZE  = 46,
-    LOCAL_SIZE    = 30,
-    END_SIZE      = 22,
-    SUMS_SIZE     = 12
+    CENTRAL_SIZE        = 46,
+    LOCAL_SIZE          = 30,
+    END_SIZE            = 22,
+    ZIP64_END_SIZE      = 56,
+    ZIP64_LOCATOR_SIZE  = 20,
+    SUMS_SIZE           = 12,
+    SUMS64_SIZE         = 20
 };
 
+// The zip64 extended information extra field holds the values which don't fit
+// in the fields of the headers, these fields are then set to their maximums.
+// A local header always has both sizes in it.
+enum {
+    ZIP64_EXTRA_ID      = 0x0001,
+    ZIP64_LOCAL_SIZE    = 20
+};
+
+static const wxUint16 ZIP64_MAX_16 = 0xffff;
+static const wxUint32 ZIP64_MAX_32 = 0xffffffff;
+
 // The number of bytes that must be written to an wxZipOutputStream before
 // a zip entry is created. The purpose of this latency is so that
 // OpenCompressor() can see a little data before deciding which compressor
@@ -82,6 +99,21 @@ IMPLEMENT_DYNAMIC_CLASS(wxZipClassFactory, wxArchiveClassFactory)
 
 // read a string of a given length
 //
+static wxString MakeString(const char *data, wxUint16 len, wxMBConv& conv)
+{
+    if (len == 0)
+        return wxEmptyString;
+
+#if wxUSE_UNICODE
+    wxCharBuffer buf(len);
+    memcpy(buf.data(), data, len);
+    return wxString(buf, conv);
+#else
+    (void)conv;
+    return wxString(data, len);
+#endif
+}
+
 static wxString ReadString(wxInputStream& stream, wxUint16 len, wxMBConv& conv)
 {
     if (len == 0)
@@ -119,6 +151,119 @@ static inline wxUint16 CrackUint16(const char *m)
     return (n[1] << 8) | n[0];
 }
 
+// Decode a little endian wxUint64 number from a character array
+//
+static inline wxUint64 CrackUint64(const char *m)
+{
+    return (wxUint64(CrackUint32(m + 4)) << 32) | CrackUint32(m);
+}
+
+// True if the size or offset doesn't fit in the 32 bit field of a header
+//
+static inline bool IsZip64(wxFileOffset n)
+{
+    return n != wxInvalidOffset && n >= wxFileOffset(ZIP64_MAX_32);
+}
+
+// Find the extra field with the given header id, returns a pointer to its data
+// and its size, or NULL if not found
+//
+static const char *FindExtraField(const char *extra, size_t len,
+                                  wxUint16 id, size_t *size)
+{
+    while (len >= 4) {
+        size_t fieldLen = CrackUint16(extra + 2);
+        if (fieldLen > len - 4)
+            break;
+        if (CrackUint16(extra) == id) {
+            *size = fieldLen;
+            return extra + 4;
+        }
+        extra += 4 + fieldLen;
+        len -= 4 + fieldLen;
+    }
+
+    return NULL;
+}
+
+// Read the values which didn't fit in the header from the zip64 extra field.
+// They are stored in this order, but only those that overflowed, except that
+// the local header always has both sizes.
+//
+static bool ReadZip64Extra(const char *extra, size_t extraLen, bool local,
+                           wxFileOffset *size, wxFileOffset *compressedSize,
+                           wxFileOffset *offset = NULL)
+{
+    size_t len;
+    const char *data = FindExtraField(extra, extraLen, ZIP64_EXTRA_ID, &len);
+    if (!data)
+        return false;
+
+    wxFileOffset *fields[] = { size, compressedSize, offset };
+
+    for (size_t i = 0; i < WXSIZEOF(fields); i++) {
+        if (!fields[i])
+            continue;
+        if (*fields[i] != wxFileOffset(ZIP64_MAX_32) && !(local && i < 2))
+            continue;
+        if (len < 8)
+            return false;
+        *fields[i] = wx_truncate_cast(wxFileOffset, CrackUint64(data));
+        data += 8;
+        len -= 8;
+    }
+
+    return true;
+}
+
+// Write the extra fields except the zip64 one, which is always generated when
+// writing the headers, and return their size. Only the size is returned if
+// stream is NULL.
+//
+static size_t WriteExtraWithoutZip64(wxOutputStream *stream,
+                                     const char *extra, size_t len)
+{
+    size_t total = 0;
+
+    while (len > 0) {
+        // if the fields are malformed copy the rest as it is
+        size_t fieldLen = len;
+        bool zip64 = false;
+
+        if (len >= 4 && CrackUint16(extra + 2) <= len - 4) {
+            fieldLen = 4 + CrackUint16(extra + 2);
+            zip64 = CrackUint16(extra) == ZIP64_EXTRA_ID;
+        }
+
+        if (!zip64) {
+            if (stream)
+                stream->Write(extra, fieldLen);
+            total += fieldLen;
+        }
+
+        extra += fieldLen;
+        len -= fieldLen;
+    }
+
+    return total;
+}
+
+// Skip the given number of bytes on a possibly non-seekable stream
+//
+static bool SkipBytes(wxInputStream& stream, wxUint64 count)
+{
+    char buf[1024];
+
+    while (count > 0) {
+        size_t len = count < sizeof(buf) ? size_t(count) : sizeof(buf);
+        if (stream.Read(buf, len).LastRead() != len)
+            return false;
+        count -= len;
+    }
+
+    return true;
+}
+
 // Temporarily lower the logging level in debug mode to avoid a warning
 // from SeekI about seeking on a stream with data written back to it.
 //
@@ -175,6 +320,7 @@ public:
     inline wxUint8 Read8();
     inline wxUint16 Read16();
     inline wxUint32 Read32();
+    inline wxUint64 Read64();
 
     const char *GetData() const             { return m_data; }
     size_t GetSize() const                  { return m_size; }
@@ -226,6 +372,14 @@ inline wxUint32 wxZipHeader::Read32()
     return n;
 }
 
+inline wxUint64 wxZipHeader::Read64()
+{
+    wxASSERT(m_pos + 8 <= m_size);
+    wxUint64 n = CrackUint64(m_data + m_pos);
+    m_pos += 8;
+    return n;
+}
+
 
 /////////////////////////////////////////////////////////////////////////////
 // Stored input stream
@@ -683,6 +837,68 @@ wxZipEntry *wxZipWeakLinks::GetEntry(wxFileOffset key) const
 }
 
 
+/////////////////////////////////////////////////////////////////////////////
+// Index of the central directory
+//
+// Maps the internal names of the entries to the offsets of their records in
+// the in-memory copy of the central directory, so that an entry can be found
+// without reading all the records preceding it.
+
+WX_DECLARE_STRING_HASH_MAP(size_t, wxStringOffsetMap_);
+
+class wxZipCentralIndex
+{
+public:
+    wxZipCentralIndex(const char *data, size_t len,
+                      size_t count, wxMBConv& conv);
+
+    bool Find(const wxString& name, size_t *offset) const;
+
+private:
+    wxStringOffsetMap_ m_offsets;
+
+    wxDECLARE_NO_COPY_CLASS(wxZipCentralIndex);
+};
+
+wxZipCentralIndex::wxZipCentralIndex(const char *data, size_t len,
+                                     size_t count, wxMBConv& conv)
+    : m_offsets(count)
+{
+    size_t pos = 0;
+
+    while (len - pos >= CENTRAL_SIZE &&
+            CrackUint32(data + pos) == CENTRAL_MAGIC) {
+        const char *header = data + pos;
+        size_t nameLen = CrackUint16(header + 28);
+        size_t size = CENTRAL_SIZE + nameLen +
+                      CrackUint16(header + 30) + CrackUint16(header + 32);
+        if (size > len - pos)
+            break;
+
+        wxString name = MakeString(header + CENTRAL_SIZE,
+                                   wx_truncate_cast(wxUint16, nameLen), conv);
+        name = wxZipEntry::GetInternalName(name, wxPATH_UNIX);
+
+        // if there are duplicates then the first one is found, as it would be
+        // when searching the entries in order
+        if (m_offsets.find(name) == m_offsets.end())
+            m_offsets[name] = pos;
+
+        pos += size;
+    }
+}
+
+bool wxZipCentralIndex::Find(const wxString& name, size_t *offset) const
+{
+    wxStringOffsetMap_::const_iterator it = m_offsets.find(name);
+    if (it == m_offsets.end())
+        return false;
+
+    *offset = it->second;
+    return true;
+}
+
+
 /////////////////////////////////////////////////////////////////////////////
 // ZipEntry
 
@@ -975,15 +1191,6 @@ size_t wxZipEntry::ReadLocal(wxInputStream& stream, wxMBConv& conv)
     SetDateTime(wxDateTime().SetFromDOS(ds.Read32()));
     ds >> crc >> compressedSize >> size >> nameLen >> extraLen;
 
-    bool sumsValid = (m_Flags & wxZIP_SUMS_FOLLOW) == 0;
-
-    if (sumsValid || crc)
-        m_Crc = crc;
-    if ((sumsValid || compressedSize) || m_Method == wxZIP_METHOD_STORE)
-        m_CompressedSize = compressedSize;
-    if ((sumsValid || size) || m_Method == wxZIP_METHOD_STORE)
-        m_Size = size;
-
     SetName(ReadString(stream, nameLen, conv), wxPATH_UNIX);
     if (stream.LastRead() != nameLen + 0u)
         return 0;
@@ -997,10 +1204,35 @@ size_t wxZipEntry::ReadLocal(wxInputStream& stream, wxMBConv& conv)
         }
     }
 
+    wxFileOffset compressedSize64 = compressedSize;
+    wxFileOffset size64 = size;
+    bool sizesValid = true;
+
+    if (compressedSize == ZIP64_MAX_32 || size == ZIP64_MAX_32) {
+        // without the zip64 field only the central directory has the sizes
+        sizesValid = ReadZip64Extra(GetLocalExtra(), GetLocalExtraLen(),
+                                    true, &size64, &compressedSize64);
+    }
+
+    bool sumsValid = (m_Flags & wxZIP_SUMS_FOLLOW) == 0;
+
+    if (sumsValid || crc)
+        m_Crc = crc;
+    if (sizesValid) {
+        if ((sumsValid || compressedSize64) || m_Method == wxZIP_METHOD_STORE)
+            m_CompressedSize = compressedSize64;
+        if ((sumsValid || size64) || m_Method == wxZIP_METHOD_STORE)
+            m_Size = size64;
+    }
+
     return LOCAL_SIZE + nameLen + extraLen;
 }
 
-size_t wxZipEntry::WriteLocal(wxOutputStream& stream, wxMBConv& conv) const
+// If zip64 is true the sizes are written to a zip64 extra field, which is
+// always the last one, so that they can be updated later.
+//
+size_t wxZipEntry::WriteLocal(wxOutputStream& stream, wxMBConv& conv,
+                              bool zip64) const
 {
     wxString unixName = GetName(wxPATH_UNIX);
     const wxWX2MBbuf name_buf = unixName.mb_str(conv);
@@ -1008,24 +1240,35 @@ size_t wxZipEntry::WriteLocal(wxOutputStream& stream, wxMBConv& conv) const
     if (!name) name = "";
     wxUint16 nameLen = wx_truncate_cast(wxUint16, strlen(name));
 
+    wxFileOffset compressedSize =
+        m_CompressedSize != wxInvalidOffset ? m_CompressedSize : 0;
+    wxFileOffset size = m_Size != wxInvalidOffset ? m_Size : 0;
+
     wxDataOutputStream ds(stream);
 
     ds << m_VersionNeeded << m_Flags << m_Method;
     ds.Write32(GetDateTime().GetAsDOS());
 
     ds.Write32(m_Crc);
-    ds.Write32(m_CompressedSize != wxInvalidOffset ?
-               wx_truncate_cast(wxUint32, m_CompressedSize) : 0);
-    ds.Write32(m_Size != wxInvalidOffset ?
-               wx_truncate_cast(wxUint32, m_Size) : 0);
+    ds.Write32(zip64 ? ZIP64_MAX_32 : wx_truncate_cast(wxUint32, compressedSize));
+    ds.Write32(zip64 ? ZIP64_MAX_32 : wx_truncate_cast(wxUint32, size));
 
     ds << nameLen;
-    wxUint16 extraLen = wx_truncate_cast(wxUint16, GetLocalExtraLen());
-    ds.Write16(extraLen);
+    size_t extraLen = WriteExtraWithoutZip64(NULL, GetLocalExtra(),
+                                             GetLocalExtraLen());
+    ds.Write16(wx_truncate_cast(wxUint16,
+                                extraLen + (zip64 ? ZIP64_LOCAL_SIZE : 0)));
 
     stream.Write(name, nameLen);
-    if (extraLen)
-        stream.Write(m_LocalExtra->GetData(), extraLen);
+    WriteExtraWithoutZip64(&stream, GetLocalExtra(), GetLocalExtraLen());
+
+    if (zip64) {
+        ds.Write16(ZIP64_EXTRA_ID);
+        ds.Write16(ZIP64_LOCAL_SIZE - 4);
+        ds.Write64(wxUint64(size));
+        ds.Write64(wxUint64(compressedSize));
+        extraLen += ZIP64_LOCAL_SIZE;
+    }
 
     return LOCAL_SIZE + nameLen + extraLen;
 }
@@ -1045,12 +1288,12 @@ size_t wxZipEntry::ReadCentral(wxInputStream& stream, wxMBConv& conv)
     SetMethod(ds.Read16());
     SetDateTime(wxDateTime().SetFromDOS(ds.Read32()));
     SetCrc(ds.Read32());
-    SetCompressedSize(ds.Read32());
-    SetSize(ds.Read32());
+    wxFileOffset compressedSize = ds.Read32();
+    wxFileOffset size = ds.Read32();
 
     ds >> nameLen >> extraLen >> commentLen
        >> m_DiskStart >> m_InternalAttributes >> m_ExternalAttributes;
-    SetOffset(ds.Read32());
+    wxFileOffset offset = ds.Read32();
 
     SetName(ReadString(stream, nameLen, conv), wxPATH_UNIX);
     if (stream.LastRead() != nameLen + 0u)
@@ -1073,10 +1316,23 @@ size_t wxZipEntry::ReadCentral(wxInputStream& stream, wxMBConv& conv)
         m_Comment.clear();
     }
 
+    if (compressedSize == ZIP64_MAX_32 || size == ZIP64_MAX_32 ||
+            offset == ZIP64_MAX_32)
+        ReadZip64Extra(GetExtra(), GetExtraLen(), false,
+                       &size, &compressedSize, &offset);
+
+    SetCompressedSize(compressedSize);
+    SetSize(size);
+    SetOffset(offset);
+
     return CENTRAL_SIZE + nameLen + extraLen + commentLen;
 }
 
-size_t wxZipEntry::WriteCentral(wxOutputStream& stream, wxMBConv& conv) const
+// The values which don't fit, or all of them if zip64 is true, are written
+// to a zip64 extra field.
+//
+size_t wxZipEntry::WriteCentral(wxOutputStream& stream, wxMBConv& conv,
+                                bool zip64) const
 {
     wxString unixName = GetName(wxPATH_UNIX);
     const wxWX2MBbuf name_buf = unixName.mb_str(conv);
@@ -1089,28 +1345,50 @@ size_t wxZipEntry::WriteCentral(wxOutputStream& stream, wxMBConv& conv) const
     if (!comment) comment = "";
     wxUint16 commentLen = wx_truncate_cast(wxUint16, strlen(comment));
 
-    wxUint16 extraLen = wx_truncate_cast(wxUint16, GetExtraLen());
+    const wxFileOffset values[] = { GetSize(), GetCompressedSize(), GetOffset() };
+    bool inZip64[WXSIZEOF(values)];
+    size_t zip64Len = 0;
+    for (size_t i = 0; i < WXSIZEOF(values); i++) {
+        inZip64[i] = zip64 || IsZip64(values[i]);
+        if (inZip64[i])
+            zip64Len += 8;
+    }
+
+    size_t extraLen = WriteExtraWithoutZip64(NULL, GetExtra(), GetExtraLen());
+    if (zip64Len)
+        extraLen += 4 + zip64Len;
+
+    int versionNeeded = GetVersionNeeded();
+    if (zip64Len && versionNeeded < VERSION_NEEDED_FOR_ZIP64)
+        versionNeeded = VERSION_NEEDED_FOR_ZIP64;
 
     wxDataOutputStream ds(stream);
 
     ds << CENTRAL_MAGIC << m_VersionMadeBy << m_SystemMadeBy;
 
-    ds.Write16(wx_truncate_cast(wxUint16, GetVersionNeeded()));
+    ds.Write16(wx_truncate_cast(wxUint16, versionNeeded));
     ds.Write16(wx_truncate_cast(wxUint16, GetFlags()));
     ds.Write16(wx_truncate_cast(wxUint16, GetMethod()));
     ds.Write32(GetDateTime().GetAsDOS());
     ds.Write32(GetCrc());
-    ds.Write32(wx_truncate_cast(wxUint32, GetCompressedSize()));
-    ds.Write32(wx_truncate_cast(wxUint32, GetSize()));
+    ds.Write32(inZip64[1] ? ZIP64_MAX_32 : wx_truncate_cast(wxUint32, values[1]));
+    ds.Write32(inZip64[0] ? ZIP64_MAX_32 : wx_truncate_cast(wxUint32, values[0]));
     ds.Write16(nameLen);
-    ds.Write16(extraLen);
+    ds.Write16(wx_truncate_cast(wxUint16, extraLen));
 
     ds << commentLen << m_DiskStart << m_InternalAttributes
-       << m_ExternalAttributes << wx_truncate_cast(wxUint32, GetOffset());
+       << m_ExternalAttributes;
+    ds.Write32(inZip64[2] ? ZIP64_MAX_32 : wx_truncate_cast(wxUint32, values[2]));
 
     stream.Write(name, nameLen);
-    if (extraLen)
-        stream.Write(GetExtra(), extraLen);
+    WriteExtraWithoutZip64(&stream, GetExtra(), GetExtraLen());
+    if (zip64Len) {
+        ds.Write16(ZIP64_EXTRA_ID);
+        ds.Write16(wx_truncate_cast(wxUint16, zip64Len));
+        for (size_t i = 0; i < WXSIZEOF(values); i++)
+            if (inZip64[i])
+                ds.Write64(wxUint64(values[i]));
+    }
     stream.Write(comment, commentLen);
 
     return CENTRAL_SIZE + nameLen + extraLen + commentLen;
@@ -1121,18 +1399,25 @@ size_t wxZipEntry::WriteCentral(wxOutputStream& stream, wxMBConv& conv) const
 // though there is a small chance that it is in fact a pkzip record which
 // happens to have the signature as it's CRC.
 //
+// The sizes are 8 bytes long if the local header has a zip64 extra field.
+//
 size_t wxZipEntry::ReadDescriptor(wxInputStream& stream)
 {
-    wxZipHeader ds(stream, SUMS_SIZE);
+    size_t len;
+    const bool zip64 = FindExtraField(GetLocalExtra(), GetLocalExtraLen(),
+                                      ZIP64_EXTRA_ID, &len) != NULL;
+    const size_t sumsSize = zip64 ? SUMS64_SIZE : SUMS_SIZE;
+
+    wxZipHeader ds(stream, sumsSize);
     if (!ds)
         return 0;
 
-    m_Crc = ds.Read32();
-    m_CompressedSize = ds.Read32();
-    m_Size = ds.Read32();
+    char sums[SUMS64_SIZE];
+    memcpy(sums, ds.GetData(), sumsSize);
+    size_t size = sumsSize;
 
     // if 1st value is the signature then this is probably an info-zip record
-    if (m_Crc == SUMS_MAGIC)
+    if (CrackUint32(sums) == SUMS_MAGIC)
     {
         wxZipHeader buf(stream, 8);
         wxUint32 u1 = buf.GetSize() >= 4 ? buf.Read32() : (wxUint32)LOCAL_MAGIC;
@@ -1151,18 +1436,27 @@ size_t wxZipEntry::ReadDescriptor(wxInputStream& stream)
             // it's an info-zip record as expected
             if (buf.GetSize() > 4)
                 stream.Ungetch(buf.GetData() + 4, buf.GetSize() - 4);
-            m_Crc = wx_truncate_cast(wxUint32, m_CompressedSize);
-            m_CompressedSize = m_Size;
-            m_Size = u1;
-            return SUMS_SIZE + 4;
+            memmove(sums, sums + 4, sumsSize - 4);
+            memcpy(sums + sumsSize - 4, buf.GetData(), 4);
+            size += 4;
         }
     }
 
-    return SUMS_SIZE;
+    m_Crc = CrackUint32(sums);
+    if (zip64) {
+        m_CompressedSize = wx_truncate_cast(wxFileOffset, CrackUint64(sums + 4));
+        m_Size = wx_truncate_cast(wxFileOffset, CrackUint64(sums + 12));
+    } else {
+        m_CompressedSize = CrackUint32(sums + 4);
+        m_Size = CrackUint32(sums + 8);
+    }
+
+    return size;
 }
 
 size_t wxZipEntry::WriteDescriptor(wxOutputStream& stream, wxUint32 crc,
-                                   wxFileOffset compressedSize, wxFileOffset size)
+                                   wxFileOffset compressedSize, wxFileOffset size,
+                                   bool zip64)
 {
     m_Crc = crc;
     m_CompressedSize = compressedSize;
@@ -1171,8 +1465,17 @@ size_t wxZipEntry::WriteDescriptor(wxOutputStream& stream, wxUint32 crc,
     wxDataOutputStream ds(stream);
 
     ds.Write32(crc);
-    ds.Write32(wx_truncate_cast(wxUint32, compressedSize));
-    ds.Write32(wx_truncate_cast(wxUint32, size));
+
+    if (zip64) {
+        ds.Write64(wxUint64(compressedSize));
+        ds.Write64(wxUint64(size));
+        return SUMS64_SIZE;
+    }
+
+    ds.Write32(IsZip64(compressedSize) ? ZIP64_MAX_32
+                                       : wx_truncate_cast(wxUint32, compressedSize));
+    ds.Write32(IsZip64(size) ? ZIP64_MAX_32
+                             : wx_truncate_cast(wxUint32, size));
 
     return SUMS_SIZE;
 }
@@ -1181,6 +1484,11 @@ size_t wxZipEntry::WriteDescriptor(wxOutputStream& stream, wxUint32 crc,
 /////////////////////////////////////////////////////////////////////////////
 // wxZipEndRec - holds the end of central directory record
 
+//
+// For zip64 archives the values which don't fit in it are read from and
+// written to the zip64 end record, which is written after the central
+// directory and followed by the zip64 end locator pointing to it.
+
 class wxZipEndRec
 {
 public:
@@ -1188,37 +1496,39 @@ public:
 
     int GetDiskNumber() const                   { return m_DiskNumber; }
     int GetStartDisk() const                    { return m_StartDisk; }
-    int GetEntriesHere() const                  { return m_EntriesHere; }
-    int GetTotalEntries() const                 { return m_TotalEntries; }
-    wxFileOffset GetSize() const                { return m_Size; }
-    wxFileOffset GetOffset() const              { return m_Offset; }
+    wxUint64 GetEntriesHere() const             { return m_EntriesHere; }
+    wxUint64 GetTotalEntries() const            { return m_TotalEntries; }
+    wxFileOffset GetSize() const
+        { return wx_truncate_cast(wxFileOffset, m_Size); }
+    wxFileOffset GetOffset() const
+        { return wx_truncate_cast(wxFileOffset, m_Offset); }
     wxString GetComment() const                 { return m_Comment; }
 
-    void SetDiskNumber(int num)
-        { m_DiskNumber = wx_truncate_cast(wxUint16, num); }
-    void SetStartDisk(int num)
-        { m_StartDisk = wx_truncate_cast(wxUint16, num); }
-    void SetEntriesHere(int num)
-        { m_EntriesHere = wx_truncate_cast(wxUint16, num); }
-    void SetTotalEntries(int num)
-        { m_TotalEntries = wx_truncate_cast(wxUint16, num); }
-    void SetSize(wxFileOffset size)
-        { m_Size = wx_truncate_cast(wxUint32, size); }
-    void SetOffset(wxFileOffset offset)
-        { m_Offset = wx_truncate_cast(wxUint32, offset); }
+    void SetDiskNumber(int num)                 { m_DiskNumber = num; }
+    void SetStartDisk(int num)                  { m_StartDisk = num; }
+    void SetEntriesHere(wxUint64 num)           { m_EntriesHere = num; }
+    void SetTotalEntries(wxUint64 num)          { m_TotalEntries = num; }
+    void SetSize(wxFileOffset size)             { m_Size = size; }
+    void SetOffset(wxFileOffset offset)         { m_Offset = offset; }
     void SetComment(const wxString& comment)
         { m_Comment = comment; }
 
     bool Read(wxInputStream& stream, wxMBConv& conv);
-    bool Write(wxOutputStream& stream, wxMBConv& conv) const;
+    bool ReadZip64(wxInputStream& stream);
+
+    // the zip64 records are written if needed or if zip64 is true
+    bool Write(wxOutputStream& stream, wxMBConv& conv, bool zip64) const;
 
 private:
-    wxUint16 m_DiskNumber;
-    wxUint16 m_StartDisk;
-    wxUint16 m_EntriesHere;
-    wxUint16 m_TotalEntries;
-    wxUint32 m_Size;
-    wxUint32 m_Offset;
+    bool NeedsZip64() const;
+    void CheckDisks() const;
+
+    wxUint32 m_DiskNumber;
+    wxUint32 m_StartDisk;
+    wxUint64 m_EntriesHere;
+    wxUint64 m_TotalEntries;
+    wxUint64 m_Size;
+    wxUint64 m_Offset;
     wxString m_Comment;
 };
 
@@ -1232,7 +1542,24 @@ wxZipEndRec::wxZipEndRec()
 {
 }
 
-bool wxZipEndRec::Write(wxOutputStream& stream, wxMBConv& conv) const
+bool wxZipEndRec::NeedsZip64() const
+{
+    return m_DiskNumber >= ZIP64_MAX_16 || m_StartDisk >= ZIP64_MAX_16 ||
+           m_EntriesHere >= ZIP64_MAX_16 || m_TotalEntries >= ZIP64_MAX_16 ||
+           m_Size >= ZIP64_MAX_32 || m_Offset >= ZIP64_MAX_32;
+}
+
+void wxZipEndRec::CheckDisks() const
+{
+    if (m_DiskNumber != 0 || m_StartDisk != 0 ||
+            m_EntriesHere != m_TotalEntries)
+    {
+        wxLogWarning(_("assuming this is a multi-part zip concatenated"));
+    }
+}
+
+bool wxZipEndRec::Write(wxOutputStream& stream, wxMBConv& conv,
+                        bool zip64) const
 {
     const wxWX2MBbuf comment_buf = m_Comment.mb_str(conv);
     const char *comment = comment_buf;
@@ -1241,8 +1568,36 @@ bool wxZipEndRec::Write(wxOutputStream& stream, wxMBConv& conv) const
 
     wxDataOutputStream ds(stream);
 
-    ds << END_MAGIC << m_DiskNumber << m_StartDisk << m_EntriesHere
-       << m_TotalEntries << m_Size << m_Offset << commentLen;
+    if (zip64 || NeedsZip64()) {
+        ds.Write32(ZIP64_END_MAGIC);
+        ds.Write64(wxUint64(ZIP64_END_SIZE - 12));
+        ds.Write16(VERSION_NEEDED_FOR_ZIP64);
+        ds.Write16(VERSION_NEEDED_FOR_ZIP64);
+        ds << m_DiskNumber << m_StartDisk;
+        ds.Write64(m_EntriesHere);
+        ds.Write64(m_TotalEntries);
+        ds.Write64(m_Size);
+        ds.Write64(m_Offset);
+
+        // the zip64 end record starts right after the central directory
+        ds.Write32(ZIP64_LOCATOR_MAGIC);
+        ds.Write32(m_StartDisk);
+        ds.Write64(m_Offset + m_Size);
+        ds.Write32(m_DiskNumber + 1);
+    }
+
+    ds.Write32(END_MAGIC);
+    ds.Write16(wx_truncate_cast(wxUint16, wxMin(m_DiskNumber, ZIP64_MAX_16)));
+    ds.Write16(wx_truncate_cast(wxUint16, wxMin(m_StartDisk, ZIP64_MAX_16)));
+    ds.Write16(wx_truncate_cast(wxUint16,
+                                wxMin(m_EntriesHere, wxUint64(ZIP64_MAX_16))));
+    ds.Write16(wx_truncate_cast(wxUint16,
+                                wxMin(m_TotalEntries, wxUint64(ZIP64_MAX_16))));
+    ds.Write32(wx_truncate_cast(wxUint32,
+                                wxMin(m_Size, wxUint64(ZIP64_MAX_32))));
+    ds.Write32(wx_truncate_cast(wxUint32,
+                                wxMin(m_Offset, wxUint64(ZIP64_MAX_32))));
+    ds << commentLen;
 
     stream.Write(comment, commentLen);
 
@@ -1255,10 +1610,18 @@ bool wxZipEndRec::Read(wxInputStream& stream, wxMBConv& conv)
     if (!ds)
         return false;
 
-    wxUint16 commentLen;
+    wxUint16 diskNumber, startDisk, entriesHere, totalEntries, commentLen;
+    wxUint32 size, offset;
+
+    ds >> diskNumber >> startDisk >> entriesHere
+       >> totalEntries >> size >> offset >> commentLen;
 
-    ds >> m_DiskNumber >> m_StartDisk >> m_EntriesHere
-       >> m_TotalEntries >> m_Size >> m_Offset >> commentLen;
+    m_DiskNumber = diskNumber;
+    m_StartDisk = startDisk;
+    m_EntriesHere = entriesHere;
+    m_TotalEntries = totalEntries;
+    m_Size = size;
+    m_Offset = offset;
 
     if (commentLen) {
         m_Comment = ReadString(stream, commentLen, conv);
@@ -1266,11 +1629,38 @@ bool wxZipEndRec::Read(wxInputStream& stream, wxMBConv& conv)
             return false;
     }
 
-    if (m_DiskNumber != 0 || m_StartDisk != 0 ||
-            m_EntriesHere != m_TotalEntries)
-    {
-        wxLogWarning(_("assuming this is a multi-part zip concatenated"));
-    }
+    // if any of the values overflowed they're checked in ReadZip64()
+    if (!NeedsZip64())
+        CheckDisks();
+
+    return true;
+}
+
+// Read the zip64 end record, the stream must be positioned after its
+// signature
+//
+bool wxZipEndRec::ReadZip64(wxInputStream& stream)
+{
+    wxZipHeader ds(stream, ZIP64_END_SIZE - 4);
+    if (!ds)
+        return false;
+
+    wxUint64 size = ds.Read64();
+    ds.Skip(4); // version made by and version needed to extract
+
+    m_DiskNumber = ds.Read32();
+    m_StartDisk = ds.Read32();
+    m_EntriesHere = ds.Read64();
+    m_TotalEntries = ds.Read64();
+    m_Size = ds.Read64();
+    m_Offset = ds.Read64();
+
+    // skip the extensible data sector, which isn't used
+    if (size < ZIP64_END_SIZE - 12 ||
+            !SkipBytes(stream, size - (ZIP64_END_SIZE - 12)))
+        return false;
+
+    CheckDisks();
 
     return true;
 }
@@ -1372,6 +1762,10 @@ void wxZipInputStream::Init()
     m_streamlink = NULL;
     m_offsetAdjustment = 0;
     m_position = wxInvalidOffset;
+    m_central = NULL;
+    m_centralPos = 0;
+    m_centralSize = 0;
+    m_index = NULL;
     m_signature = 0;
     m_TotalEntries = 0;
     m_lasterror = m_parent_i_stream->GetLastError();
@@ -1387,6 +1781,8 @@ wxZipInputStream::~wxZipInputStream()
     delete m_store;
     delete m_inflate;
     delete m_rawin;
+    delete m_central;
+    delete m_index;
 
     m_weaklinks->Release(this);
 
@@ -1461,10 +1857,51 @@ bool wxZipInputStream::LoadEndRecord()
     if (!endrec.Read(*m_parent_i_stream, GetConv()))
         return false;
 
-    m_TotalEntries = endrec.GetTotalEntries();
+    // A zip64 archive has the zip64 end record locator just before the end
+    // record, and the central directory is followed by the zip64 end record.
+    wxFileOffset centralEnd = endPos;
+    bool zip64 = false;
+
+    if (endPos >= ZIP64_LOCATOR_SIZE &&
+            QuietSeek(*m_parent_i_stream, endPos - ZIP64_LOCATOR_SIZE)
+                != wxInvalidOffset &&
+            ReadSignature() == ZIP64_LOCATOR_MAGIC) {
+        wxZipHeader locator(*m_parent_i_stream, ZIP64_LOCATOR_SIZE - 4);
+        wxFileOffset pos = wxInvalidOffset;
+
+        if (locator) {
+            locator.Skip(4);
+            pos = wx_truncate_cast(wxFileOffset, locator.Read64());
+        }
+
+        // look where the locator points to first, then just before the
+        // locator in case the zip has been appended to a self extractor
+        if (pos == wxInvalidOffset ||
+                QuietSeek(*m_parent_i_stream, pos) == wxInvalidOffset ||
+                ReadSignature() != ZIP64_END_MAGIC) {
+            pos = endPos - ZIP64_LOCATOR_SIZE - ZIP64_END_SIZE;
+            if (pos < 0 ||
+                    QuietSeek(*m_parent_i_stream, pos) == wxInvalidOffset ||
+                    ReadSignature() != ZIP64_END_MAGIC)
+                pos = wxInvalidOffset;
+        }
+
+        if (pos != wxInvalidOffset) {
+            if (!endrec.ReadZip64(*m_parent_i_stream)) {
+                wxLogError(_("error reading zip64 end record"));
+                m_lasterror = wxSTREAM_READ_ERROR;
+                return false;
+            }
+            centralEnd = pos;
+            zip64 = true;
+        }
+    }
+
+    m_TotalEntries = wx_truncate_cast(size_t, endrec.GetTotalEntries());
     m_Comment = endrec.GetComment();
 
-    wxUint32 magic = m_TotalEntries ? CENTRAL_MAGIC : END_MAGIC;
+    wxUint32 magic = m_TotalEntries ? CENTRAL_MAGIC
+                   : zip64 ? ZIP64_END_MAGIC : END_MAGIC;
 
     // Now find the central-directory. we have the file offset of
     // the CD, so look there first.
@@ -1473,17 +1910,19 @@ bool wxZipInputStream::LoadEndRecord()
         m_signature = magic;
         m_position = endrec.GetOffset();
         m_offsetAdjustment = 0;
+        SetCentral(endrec.GetSize(), centralEnd);
         return true;
     }
 
     // If it's not there, then it could be that the zip has been appended
     // to a self extractor, so take the CD size (also in endrec), subtract
     // it from the file offset of the end-central-directory and look there.
-    if (m_parent_i_stream->SeekI(endPos - endrec.GetSize())
+    if (m_parent_i_stream->SeekI(centralEnd - endrec.GetSize())
             != wxInvalidOffset && ReadSignature() == magic) {
         m_signature = magic;
-        m_position = endPos - endrec.GetSize();
+        m_position = centralEnd - endrec.GetSize();
         m_offsetAdjustment = m_position - endrec.GetOffset();
+        SetCentral(endrec.GetSize(), centralEnd);
         return true;
     }
 
@@ -1492,6 +1931,60 @@ bool wxZipInputStream::LoadEndRecord()
     return false;
 }
 
+// Remember where the central directory is, it's only loaded when it's needed
+// as the entries opened using a new stream don't need it. The size from the
+// end record isn't trusted unless the directory fits before the end record.
+//
+void wxZipInputStream::SetCentral(wxFileOffset size, wxFileOffset end)
+{
+    m_centralPos = m_position;
+
+    if (m_signature == CENTRAL_MAGIC && size > 0 &&
+            size <= end - m_position &&
+            size == wxFileOffset(wx_truncate_cast(size_t, size)))
+        m_centralSize = size;
+}
+
+// Read the whole central directory into memory, so that reading the entries
+// doesn't need a seek and a few small reads of the parent stream for each of
+// them. If this fails, the central directory is read from the parent stream.
+//
+bool wxZipInputStream::LoadCentral()
+{
+    if (!m_central && m_centralSize) {
+        wxFileOffset size = m_centralSize;
+        m_centralSize = 0;
+
+        if (QuietSeek(*m_parent_i_stream, m_centralPos) == wxInvalidOffset)
+            return false;
+
+        wxScopedPtr<wxMemoryInputStream>
+            central(new wxMemoryInputStream(*m_parent_i_stream, size));
+
+        if (central->GetLength() == size)
+            m_central = central.release();
+    }
+
+    return m_central != NULL;
+}
+
+// Return the stream from which the central directory can be read, positioned
+// at the given offset in the archive, or NULL on failure.
+//
+wxInputStream *wxZipInputStream::SeekCentral(wxFileOffset pos)
+{
+    if (LoadCentral() && pos >= m_centralPos &&
+            pos - m_centralPos < m_central->GetLength()) {
+        m_central->SeekI(pos - m_centralPos);
+        return m_central;
+    }
+
+    if (QuietSeek(*m_parent_i_stream, pos) == wxInvalidOffset)
+        return NULL;
+
+    return m_parent_i_stream;
+}
+
 // Find the end-of-central-directory record.
 // If found the stream will be positioned just past the 4 signature bytes.
 //
@@ -1564,12 +2057,55 @@ wxZipEntry *wxZipInputStream::GetNextEntry()
     return entry.release();
 }
 
+wxZipEntry *wxZipInputStream::FindEntry(const wxString& name,
+                                        wxPathFormat format)
+{
+    if (m_position == wxInvalidOffset)
+        if (!LoadEndRecord())
+            return NULL;
+
+    // only the central directory of a seekable stream can be searched
+    wxCHECK(m_parentSeekable, NULL);
+
+    if (!LoadCentral())
+        return NULL;
+
+    if (!m_index) {
+        const char *data = static_cast<const char*>
+            (m_central->GetInputStreamBuffer()->GetBufferStart());
+
+        m_index = new wxZipCentralIndex(data, m_central->GetLength(),
+                                        m_TotalEntries, GetConv());
+    }
+
+    size_t offset;
+    if (!m_index->Find(wxZipEntry::GetInternalName(name, format), &offset))
+        return NULL;
+
+    wxInputStream *stream = SeekCentral(m_centralPos + offset + 4);
+    if (!stream)
+        return NULL;
+
+    wxZipEntryPtr_ entry(new wxZipEntry);
+    if (!entry->ReadCentral(*stream, GetConv())) {
+        wxLogError(_("error reading zip central directory"));
+        return NULL;
+    }
+
+    if (m_offsetAdjustment)
+        entry->SetOffset(entry->GetOffset() + m_offsetAdjustment);
+    entry->SetKey(entry->GetOffset());
+
+    entry->m_backlink = m_weaklinks->AddEntry(entry.get(), entry->GetKey());
+    return entry.release();
+}
+
 wxStreamError wxZipInputStream::ReadCentral()
 {
     if (!AtHeader())
         CloseEntry();
 
-    if (m_signature == END_MAGIC)
+    if (m_signature == END_MAGIC || m_signature == ZIP64_END_MAGIC)
         return wxSTREAM_EOF;
 
     if (m_signature != CENTRAL_MAGIC) {
@@ -1577,17 +2113,22 @@ wxStreamError wxZipInputStream::ReadCentral()
         return wxSTREAM_READ_ERROR;
     }
 
-    if (QuietSeek(*m_parent_i_stream, m_position + 4) == wxInvalidOffset)
+    wxInputStream *stream = SeekCentral(m_position + 4);
+    if (!stream)
         return wxSTREAM_READ_ERROR;
 
-    size_t size = m_entry.ReadCentral(*m_parent_i_stream, GetConv());
+    size_t size = m_entry.ReadCentral(*stream, GetConv());
     if (!size) {
         m_signature = 0;
         return wxSTREAM_READ_ERROR;
     }
 
     m_position += size;
-    m_signature = ReadSignature();
+
+    // the signature after the last record is not in the in-memory copy
+    if (stream == m_central)
+        stream = SeekCentral(m_position);
+    m_signature = stream ? ReadSignature(*stream) : 0;
 
     if (m_offsetAdjustment)
         m_entry.SetOffset(m_entry.GetOffset() + m_offsetAdjustment);
@@ -1604,7 +2145,8 @@ wxStreamError wxZipInputStream::ReadLocal(bool readEndRec /*=false*/)
     if (!m_signature)
         m_signature = ReadSignature();
 
-    if (m_signature == CENTRAL_MAGIC || m_signature == END_MAGIC) {
+    if (m_signature == CENTRAL_MAGIC || m_signature == END_MAGIC ||
+            m_signature == ZIP64_END_MAGIC) {
         if (m_streamlink && !m_streamlink->GetOutputStream()) {
             m_streamlink->Release(this);
             m_streamlink = NULL;
@@ -1637,6 +2179,26 @@ wxStreamError wxZipInputStream::ReadLocal(bool readEndRec /*=false*/)
         m_signature = ReadSignature();
     }
 
+    // skip the zip64 end record and locator, all that's needed from the end
+    // records when reading sequentially is the comment from the last one
+    if (m_signature == ZIP64_END_MAGIC) {
+        wxZipEndRec endrec;
+        if (!endrec.ReadZip64(*m_parent_i_stream)) {
+            m_signature = 0;
+            return wxSTREAM_READ_ERROR;
+        }
+        m_signature = ReadSignature();
+    }
+
+    if (m_signature == ZIP64_LOCATOR_MAGIC) {
+        wxZipHeader locator(*m_parent_i_stream, ZIP64_LOCATOR_SIZE - 4);
+        if (!locator) {
+            m_signature = 0;
+            return wxSTREAM_READ_ERROR;
+        }
+        m_signature = ReadSignature();
+    }
+
     if (m_signature == END_MAGIC) {
         if (readEndRec || m_streamlink) {
             wxZipEndRec endrec;
@@ -1668,11 +2230,11 @@ wxStreamError wxZipInputStream::ReadLocal(bool readEndRec /*=false*/)
     return wxSTREAM_READ_ERROR;
 }
 
-wxUint32 wxZipInputStream::ReadSignature()
+wxUint32 wxZipInputStream::ReadSignature(wxInputStream& stream)
 {
     char magic[4];
-    m_parent_i_stream->Read(magic, 4);
-    return m_parent_i_stream->LastRead() == 4 ? CrackUint32(magic) : 0;
+    stream.Read(magic, 4);
+    return stream.LastRead() == 4 ? CrackUint32(magic) : 0;
 }
 
 bool wxZipInputStream::OpenEntry(wxArchiveEntry& entry)
@@ -1868,6 +2430,17 @@ size_t wxZipInputStream::OnSysRead(void *buffer, size_t size)
                 entry->Notify();
             }
         }
+        else if (!m_raw && m_entry.GetSize() == wxInvalidOffset) {
+            // the sizes didn't fit in a local header with no zip64 field,
+            // which can only be read sequentially if the data is deflated
+            m_entry.SetSize(TellI());
+            wxZipEntry *entry = m_weaklinks->GetEntry(m_entry.GetKey());
+
+            if (entry) {
+                entry->SetSize(m_entry.GetSize());
+                entry->Notify();
+            }
+        }
 
         if (!m_raw) {
             m_lasterror = wxSTREAM_READ_ERROR;
@@ -1998,6 +2571,10 @@ void wxZipOutputStream::Init(int level)
     m_level = level;
     m_offsetAdjustment = wxInvalidOffset;
     m_endrecWritten = false;
+    m_format = wxZIP_FORMAT_DEFAULT;
+    m_zip64Local = false;
+    m_threadCount = 1;
+    m_blockSize = 0;
 }
 
 wxZipOutputStream::~wxZipOutputStream()
@@ -2085,6 +2662,17 @@ void wxZipOutputStream::SetLevel(int level)
     }
 }
 
+void wxZipOutputStream::SetThreadCount(int count, size_t blockSize /*=0*/)
+{
+    if (count != m_threadCount || blockSize != m_blockSize) {
+        if (m_comp != m_deflate)
+            delete m_deflate;
+        m_deflate = NULL;
+        m_threadCount = count;
+        m_blockSize = blockSize;
+    }
+}
+
 bool wxZipOutputStream::DoCreate(wxZipEntry *entry, bool raw /*=false*/)
 {
     CloseEntry();
@@ -2172,8 +2760,11 @@ wxOutputStream *wxZipOutputStream::OpenCompressor(
             entry.SetFlags((entry.GetFlags() & ~wxZIP_DEFLATE_MASK) |
                             defbits | wxZIP_SUMS_FOLLOW);
 
-            if (!m_deflate)
+            if (!m_deflate) {
                 m_deflate = new wxZlibOutputStream2(stream, GetLevel());
+                if (m_threadCount != 1)
+                    m_deflate->SetThreadCount(m_threadCount, m_blockSize);
+            }
             else
                 m_deflate->Open(stream);
 
@@ -2226,7 +2817,9 @@ void wxZipOutputStream::CreatePendingEntry(const void *buffer, size_t size)
         if (spPending->m_CompressedSize != wxInvalidOffset)
             spPending->m_Flags |= wxZIP_SUMS_FOLLOW;
 
-    m_headerSize = spPending->WriteLocal(*m_parent_o_stream, GetConv());
+    InitZip64(*spPending);
+    m_headerSize = spPending->WriteLocal(*m_parent_o_stream, GetConv(),
+                                         m_zip64Local);
     m_lasterror = m_parent_o_stream->GetLastError();
 
     if (IsOk()) {
@@ -2279,7 +2872,9 @@ void wxZipOutputStream::CreatePendingEntry()
     }
 
     spPending->m_Flags &= ~wxZIP_SUMS_FOLLOW;
-    m_headerSize = spPending->WriteLocal(*m_parent_o_stream, GetConv());
+    InitZip64(*spPending);
+    m_headerSize = spPending->WriteLocal(*m_parent_o_stream, GetConv(),
+                                         m_zip64Local);
 
     if (m_parent_o_stream->IsOk()) {
         m_entries.push_back(spPending.release());
@@ -2291,6 +2886,25 @@ void wxZipOutputStream::CreatePendingEntry()
     m_lasterror = m_parent_o_stream->GetLastError();
 }
 
+// Decide whether the local header of the entry needs the zip64 extra field.
+// When the sizes aren't known they're assumed to fit unless the zip64 format
+// was requested.
+//
+void wxZipOutputStream::InitZip64(wxZipEntry& entry)
+{
+    // the compressed size can be a little bigger than the size if the data
+    // doesn't compress
+    wxFileOffset size = entry.m_Size;
+    if (size != wxInvalidOffset)
+        size += size / 1000 + 1024;
+
+    m_zip64Local = m_format == wxZIP_FORMAT_ZIP64 ||
+                   IsZip64(size) || IsZip64(entry.m_CompressedSize);
+
+    if (m_zip64Local && entry.m_VersionNeeded < VERSION_NEEDED_FOR_ZIP64)
+        entry.m_VersionNeeded = VERSION_NEEDED_FOR_ZIP64;
+}
+
 // Write the 'central directory' and the 'end-central-directory' records.
 //
 bool wxZipOutputStream::Close()
@@ -2315,13 +2929,14 @@ bool wxZipOutputStream::Close()
     wxFileOffset size = 0;
 
     for (it = m_entries.begin(); it != m_entries.end(); ++it) {
-        size += (*it)->WriteCentral(*m_parent_o_stream, GetConv());
+        size += (*it)->WriteCentral(*m_parent_o_stream, GetConv(),
+                                    m_format == wxZIP_FORMAT_ZIP64);
         delete *it;
     }
     m_entries.clear();
 
     endrec.SetSize(size);
-    endrec.Write(*m_parent_o_stream, GetConv());
+    endrec.Write(*m_parent_o_stream, GetConv(), m_format == wxZIP_FORMAT_ZIP64);
 
     m_lasterror = m_parent_o_stream->GetLastError();
     m_endrecWritten = true;
@@ -2356,13 +2971,25 @@ bool wxZipOutputStream::CloseEntry()
         m_entrySize = entry.GetSize();
     }
 
+    bool tooBig = false;
+
     // Write the sums in the trailing 'data descriptor' if necessary
     if (entry.m_Flags & wxZIP_SUMS_FOLLOW) {
         wxASSERT(!IsParentSeekable());
-        m_headerOffset +=
-            entry.WriteDescriptor(*m_parent_o_stream, m_crcAccumulator,
-                                  compressedSize, m_entrySize);
-        m_lasterror = m_parent_o_stream->GetLastError();
+        // the descriptor only has room for 64 bit sizes if the local header
+        // had the zip64 field
+        if (!m_zip64Local && (IsZip64(compressedSize) || IsZip64(m_entrySize))) {
+            wxLogError(_("zip entry '%s' is too big, use wxZIP_FORMAT_ZIP64 to write it"),
+                       entry.GetName().c_str());
+            m_lasterror = wxSTREAM_WRITE_ERROR;
+            tooBig = true;
+        } else {
+            m_headerOffset +=
+                entry.WriteDescriptor(*m_parent_o_stream, m_crcAccumulator,
+                                      compressedSize, m_entrySize,
+                                      m_zip64Local);
+            m_lasterror = m_parent_o_stream->GetLastError();
+        }
     }
 
     // If the local header didn't have the correct crc and size written to
@@ -2371,12 +2998,32 @@ bool wxZipOutputStream::CloseEntry()
             || m_entrySize != entry.GetSize()
             || compressedSize != entry.GetCompressedSize())
     {
-        if (IsParentSeekable()) {
+        if (!m_zip64Local && (IsZip64(compressedSize) || IsZip64(m_entrySize))) {
+            // the sizes in the local header would have to be 0xffffffff, but
+            // then it must have the zip64 field which wasn't reserved for it
+            wxLogError(_("zip entry '%s' is too big, use wxZIP_FORMAT_ZIP64 to write it"),
+                       entry.GetName().c_str());
+            m_lasterror = wxSTREAM_WRITE_ERROR;
+            tooBig = true;
+        } else if (IsParentSeekable()) {
             wxFileOffset here = m_parent_o_stream->TellO();
             wxFileOffset headerOffset = m_headerOffset + m_offsetAdjustment;
             m_parent_o_stream->SeekO(headerOffset + SUMS_OFFSET);
-            entry.WriteDescriptor(*m_parent_o_stream, m_crcAccumulator,
-                                  compressedSize, m_entrySize);
+            if (m_zip64Local) {
+                // leave the sizes in the header as 0xffffffff and update the
+                // zip64 field, which is the last thing in the local header
+                wxDataOutputStream ds(*m_parent_o_stream);
+                ds.Write32(m_crcAccumulator);
+                m_parent_o_stream->SeekO(headerOffset + m_headerSize - 16);
+                ds.Write64(wxUint64(m_entrySize));
+                ds.Write64(wxUint64(compressedSize));
+                entry.SetCrc(m_crcAccumulator);
+                entry.SetCompressedSize(compressedSize);
+                entry.SetSize(m_entrySize);
+            } else {
+                entry.WriteDescriptor(*m_parent_o_stream, m_crcAccumulator,
+                                      compressedSize, m_entrySize);
+            }
             m_parent_o_stream->SeekO(here);
             m_lasterror = m_parent_o_stream->GetLastError();
         } else {
@@ -2392,7 +3039,7 @@ bool wxZipOutputStream::CloseEntry()
 
     if (IsOk())
         m_lasterror = m_parent_o_stream->GetLastError();
-    else
+    else if (!tooBig)
         wxLogError(_("error writing zip entry '%s': bad crc or length"),
                    entry.GetName().c_str());
     return IsOk();
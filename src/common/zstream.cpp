@@ -19,6 +19,8 @@
 
 #include "wx/zstream.h"
 #include "wx/versioninfo.h"
+#include "wx/thread.h"
+#include "wx/vector.h"
 
 #ifndef WX_PRECOMP
     #include "wx/intl.h"
@@ -277,6 +279,610 @@ bool wxZlibInputStream::SetDictionary(const wxMemoryBuffer &buf)
 }
 
 
+#if wxUSE_THREADS
+
+//////////////////////
+// wxZlibParallelDeflate
+//////////////////////
+
+// Compresses the data written to wxZlibOutputStream in independent blocks,
+// each one in a worker thread, and writes them out in order. The blocks are
+// raw deflate streams ended with a sync flush (except for the last one which
+// is finished normally), so their concatenation is a single valid deflate
+// stream. Every block is primed with the last 32KB of the preceding input as
+// the dictionary, which makes the compression ratio almost the same as when
+// compressing all the data at once. The zlib or gzip header and trailer are
+// written by this class itself, combining the checksums of the blocks.
+
+namespace
+{
+
+enum {
+    ZSTREAM_WINDOW_SIZE = 32768,            // size of the deflate window
+    ZSTREAM_BLOCK_SIZE  = 128 * 1024        // default parallel block size
+};
+
+struct wxZlibDeflateJob
+{
+    wxZlibDeflateJob() : last(false), claimed(false), done(false), ok(false),
+                         check(0) { }
+
+    wxMemoryBuffer in;      // uncompressed data of this block
+    wxMemoryBuffer dict;    // preceding input used as dictionary
+    wxMemoryBuffer out;     // compressed data, valid once done is set
+    bool last;              // finish the deflate stream after this block
+    bool claimed;           // taken by a worker thread
+    bool done;              // compressed (successfully if ok is set)
+    bool ok;
+    uLong check;            // crc32 or adler32 of the input of this block
+};
+
+} // anonymous namespace
+
+class wxZlibParallelDeflate
+{
+public:
+    wxZlibParallelDeflate(int level, int flags, int count, size_t blockSize);
+    ~wxZlibParallelDeflate();
+
+    // buffer the data and compress the full blocks, writing out the ones
+    // which are already compressed
+    bool Write(wxOutputStream& stream, const void *buffer, size_t size);
+
+    // compress all the buffered data and write everything out, finishing the
+    // stream if final is true
+    bool Flush(wxOutputStream& stream, bool final);
+
+    // forget all the data of the current stream to prepare for a new one
+    void Reset();
+
+    bool SetDictionary(const char *data, size_t len);
+
+private:
+    class Worker : public wxThread
+    {
+    public:
+        Worker(wxZlibParallelDeflate& owner)
+            : wxThread(wxTHREAD_JOINABLE), m_owner(owner) { }
+
+        virtual ExitCode Entry() { m_owner.DoWork(); return 0; }
+
+    private:
+        wxZlibParallelDeflate& m_owner;
+    };
+
+    // worker threads entry point
+    void DoWork();
+
+    // compress the job using the given raw deflate stream
+    bool Compress(z_stream& zs, wxZlibDeflateJob& job) const;
+
+    // queue the buffered data for compression as a new block
+    bool Submit(wxOutputStream& stream, bool last);
+
+    // write out the compressed blocks at the front of the queue, waiting
+    // until there are no more than maxPending blocks left in it
+    bool WriteDone(wxOutputStream& stream, size_t maxPending);
+
+    // combine the checksum of the job input with the total one
+    void AddCheck(const wxZlibDeflateJob& job);
+
+    bool WriteHeader(wxOutputStream& stream);
+    bool WriteTrailer(wxOutputStream& stream);
+
+    void StartThreads();
+
+    // get the deflate stream used for compressing in the main thread
+    z_stream *GetInlineStream();
+
+    const int m_level;
+    const int m_flags;
+    const int m_count;
+    const size_t m_blockSize;
+
+    wxMemoryBuffer m_pending;   // input not submitted yet
+    wxMemoryBuffer m_window;    // last ZSTREAM_WINDOW_SIZE bytes of input
+    wxMemoryBuffer m_userDict;  // dictionary given to SetDictionary()
+    bool m_started;             // header already written
+    uLong m_check;              // checksum of the input written out so far
+    wxUint32 m_total;           // length of the input modulo 2^32
+
+    // deflate stream used for compressing in the main thread
+    z_stream *m_inline;
+
+    wxMutex m_mutex;
+    wxCondition m_condWork;     // signalled when a job is queued
+    wxCondition m_condDone;     // signalled when a job is compressed
+
+    wxVector<Worker *> m_threads;
+
+    // all of the following are protected by m_mutex
+    wxVector<wxZlibDeflateJob *> m_jobs;
+    bool m_stop;
+
+    wxDECLARE_NO_COPY_CLASS(wxZlibParallelDeflate);
+};
+
+wxZlibParallelDeflate::wxZlibParallelDeflate(int level,
+                                             int flags,
+                                             int count,
+                                             size_t blockSize)
+    : m_level(level),
+      m_flags(flags),
+      m_count(count),
+      m_blockSize(blockSize),
+      m_inline(NULL),
+      m_condWork(m_mutex),
+      m_condDone(m_mutex),
+      m_stop(false)
+{
+    Reset();
+}
+
+wxZlibParallelDeflate::~wxZlibParallelDeflate()
+{
+    {
+        wxMutexLocker lock(m_mutex);
+        m_stop = true;
+        m_condWork.Broadcast();
+    }
+
+    for ( size_t n = 0; n < m_threads.size(); n++ )
+    {
+        m_threads[n]->Wait();
+        delete m_threads[n];
+    }
+
+    for ( size_t n = 0; n < m_jobs.size(); n++ )
+        delete m_jobs[n];
+
+    if ( m_inline )
+    {
+        deflateEnd(m_inline);
+        delete m_inline;
+    }
+}
+
+void wxZlibParallelDeflate::Reset()
+{
+    {
+        wxMutexLocker lock(m_mutex);
+
+        // the jobs being compressed can't be deleted from under the workers
+        for ( ;; )
+        {
+            bool busy = false;
+            for ( size_t n = 0; n < m_jobs.size(); n++ )
+            {
+                if ( m_jobs[n]->claimed && !m_jobs[n]->done )
+                    busy = true;
+            }
+
+            if ( !busy )
+                break;
+
+            m_condDone.Wait();
+        }
+
+        for ( size_t n = 0; n < m_jobs.size(); n++ )
+            delete m_jobs[n];
+        m_jobs.clear();
+    }
+
+    m_pending.SetDataLen(0);
+    m_window.SetDataLen(0);
+    m_userDict.SetDataLen(0);
+    m_started = false;
+    m_check = m_flags == wxZLIB_GZIP ? crc32(0, NULL, 0) : adler32(0, NULL, 0);
+    m_total = 0;
+}
+
+bool wxZlibParallelDeflate::SetDictionary(const char *data, size_t len)
+{
+    // as with deflateSetDictionary(), the gzip format has no way to store it
+    if ( m_started || m_total || m_pending.GetDataLen() || m_flags == wxZLIB_GZIP )
+        return false;
+
+    m_userDict.SetDataLen(0);
+    m_userDict.AppendData(data, len);
+
+    if ( len > ZSTREAM_WINDOW_SIZE )
+    {
+        data += len - ZSTREAM_WINDOW_SIZE;
+        len = ZSTREAM_WINDOW_SIZE;
+    }
+
+    m_window = wxMemoryBuffer(ZSTREAM_WINDOW_SIZE);
+    m_window.AppendData(data, len);
+
+    return true;
+}
+
+void wxZlibParallelDeflate::StartThreads()
+{
+    for ( int n = 0; n < m_count; n++ )
+    {
+        Worker * const thread = new Worker(*this);
+        if ( thread->Run() != wxTHREAD_NO_ERROR )
+        {
+            delete thread;
+            break;
+        }
+
+        m_threads.push_back(thread);
+    }
+}
+
+z_stream *wxZlibParallelDeflate::GetInlineStream()
+{
+    if ( !m_inline )
+    {
+        m_inline = new z_stream;
+        memset(m_inline, 0, sizeof(z_stream));
+        if ( deflateInit2(m_inline, m_level, Z_DEFLATED, -MAX_WBITS,
+                          8, Z_DEFAULT_STRATEGY) != Z_OK )
+        {
+            wxDELETE(m_inline);
+        }
+    }
+
+    return m_inline;
+}
+
+void wxZlibParallelDeflate::DoWork()
+{
+    z_stream zs;
+    memset(&zs, 0, sizeof(zs));
+    const bool initOk = deflateInit2(&zs, m_level, Z_DEFLATED, -MAX_WBITS,
+                                     8, Z_DEFAULT_STRATEGY) == Z_OK;
+
+    m_mutex.Lock();
+    for ( ;; )
+    {
+        wxZlibDeflateJob *job = NULL;
+        while ( !m_stop )
+        {
+            for ( size_t n = 0; n < m_jobs.size() && !job; n++ )
+            {
+                if ( !m_jobs[n]->claimed )
+                    job = m_jobs[n];
+            }
+
+            if ( job )
+                break;
+
+            m_condWork.Wait();
+        }
+
+        if ( !job )
+            break;
+
+        job->claimed = true;
+        m_mutex.Unlock();
+
+        const bool ok = initOk && Compress(zs, *job);
+
+        m_mutex.Lock();
+        job->ok = ok;
+        job->done = true;
+        m_condDone.Broadcast();
+    }
+    m_mutex.Unlock();
+
+    if ( initOk )
+        deflateEnd(&zs);
+}
+
+bool wxZlibParallelDeflate::Compress(z_stream& zs, wxZlibDeflateJob& job) const
+{
+    if ( deflateReset(&zs) != Z_OK )
+        return false;
+
+    if ( job.dict.GetDataLen() &&
+            deflateSetDictionary(&zs, (Bytef *)job.dict.GetData(),
+                                 job.dict.GetDataLen()) != Z_OK )
+        return false;
+
+    const size_t len = job.in.GetDataLen();
+    const uLong init = m_flags == wxZLIB_GZIP ? crc32(0, NULL, 0)
+                                              : adler32(0, NULL, 0);
+    job.check = m_flags == wxZLIB_GZIP
+                    ? crc32(init, (Bytef *)job.in.GetData(), len)
+                    : adler32(init, (Bytef *)job.in.GetData(), len);
+
+    // the bound doesn't account for the sync flush marker, hence the extra
+    size_t size = deflateBound(&zs, len) + 16;
+    zs.next_in = (Bytef *)job.in.GetData();
+    zs.avail_in = len;
+    zs.next_out = (Bytef *)job.out.GetWriteBuf(size);
+    zs.avail_out = size;
+
+    for ( ;; )
+    {
+        const int err = deflate(&zs, job.last ? Z_FINISH : Z_SYNC_FLUSH);
+        if ( err == Z_STREAM_END )
+            break;
+        if ( err != Z_OK && err != Z_BUF_ERROR )
+            return false;
+        if ( !job.last && zs.avail_out )
+            break;
+
+        // grow the output buffer, this is not expected to happen normally
+        const size_t used = size - zs.avail_out;
+        job.out.UngetWriteBuf(used);
+        size *= 2;
+        zs.next_out = (Bytef *)job.out.GetWriteBuf(size) + used;
+        zs.avail_out = size - used;
+    }
+
+    job.out.UngetWriteBuf(size - zs.avail_out);
+
+    return true;
+}
+
+bool wxZlibParallelDeflate::Write(wxOutputStream& stream,
+                                  const void *buffer,
+                                  size_t size)
+{
+    const char *data = static_cast<const char *>(buffer);
+
+    while ( size )
+    {
+        size_t len = m_blockSize - m_pending.GetDataLen();
+        if ( len > size )
+            len = size;
+
+        m_pending.AppendData(data, len);
+        data += len;
+        size -= len;
+
+        if ( m_pending.GetDataLen() == m_blockSize && !Submit(stream, false) )
+            return false;
+    }
+
+    return true;
+}
+
+bool wxZlibParallelDeflate::Flush(wxOutputStream& stream, bool final)
+{
+    bool ok;
+
+    if ( final && m_jobs.empty() )
+    {
+        // All the data fits into a single block: just compress it here, this
+        // avoids the overhead of using the threads for small streams.
+        wxZlibDeflateJob job;
+        job.in = m_pending;
+        job.dict = m_window;
+        job.last = true;
+        m_pending = wxMemoryBuffer(m_blockSize);
+
+        z_stream * const zs = GetInlineStream();
+        ok = zs && Compress(*zs, job) && WriteHeader(stream);
+        if ( ok )
+        {
+            stream.Write(job.out.GetData(), job.out.GetDataLen());
+            ok = stream.LastWrite() == job.out.GetDataLen();
+            AddCheck(job);
+        }
+    }
+    else
+    {
+        ok = Submit(stream, final) && WriteDone(stream, 0);
+    }
+
+    if ( final )
+    {
+        ok = ok && WriteTrailer(stream);
+        Reset();
+    }
+
+    return ok;
+}
+
+bool wxZlibParallelDeflate::Submit(wxOutputStream& stream, bool last)
+{
+    wxZlibDeflateJob * const job = new wxZlibDeflateJob;
+    job->in = m_pending;
+    job->dict = m_window;
+    job->last = last;
+
+    // update the window with the end of the data of this block
+    // (in a new buffer as the old one is shared with the job)
+    const size_t len = m_pending.GetDataLen();
+    const char * const data = static_cast<const char *>(m_pending.GetData());
+    wxMemoryBuffer window(ZSTREAM_WINDOW_SIZE);
+    if ( len < ZSTREAM_WINDOW_SIZE )
+    {
+        const size_t keep = wxMin(m_window.GetDataLen(),
+                                  ZSTREAM_WINDOW_SIZE - len);
+        window.AppendData(static_cast<const char *>(m_window.GetData())
+                            + m_window.GetDataLen() - keep, keep);
+        window.AppendData(data, len);
+    }
+    else
+    {
+        window.AppendData(data + len - ZSTREAM_WINDOW_SIZE,
+                          ZSTREAM_WINDOW_SIZE);
+    }
+    m_window = window;
+
+    // use a new buffer as the old one is shared with the job
+    m_pending = wxMemoryBuffer(m_blockSize);
+
+    if ( m_threads.empty() )
+        StartThreads();
+
+    {
+        wxMutexLocker lock(m_mutex);
+        m_jobs.push_back(job);
+        m_condWork.Signal();
+    }
+
+    if ( m_threads.empty() )
+    {
+        // couldn't start any threads, do it all in this one
+        z_stream * const zs = GetInlineStream();
+        job->claimed = true;
+        job->ok = zs && Compress(*zs, *job);
+        job->done = true;
+    }
+
+    // don't let too many blocks accumulate in memory
+    return WriteDone(stream, 2 * m_threads.size());
+}
+
+bool wxZlibParallelDeflate::WriteDone(wxOutputStream& stream, size_t maxPending)
+{
+    if ( !WriteHeader(stream) )
+        return false;
+
+    for ( ;; )
+    {
+        wxZlibDeflateJob *job = NULL;
+        {
+            wxMutexLocker lock(m_mutex);
+
+            if ( m_jobs.empty() )
+                break;
+
+            if ( !m_jobs[0]->done )
+            {
+                if ( m_jobs.size() <= maxPending )
+                    break;
+
+                m_condDone.Wait();
+                continue;
+            }
+
+            job = m_jobs[0];
+            m_jobs.erase(m_jobs.begin());
+        }
+
+        bool ok = job->ok;
+        if ( ok )
+        {
+            stream.Write(job->out.GetData(), job->out.GetDataLen());
+            ok = stream.LastWrite() == job->out.GetDataLen();
+        }
+
+        AddCheck(*job);
+        delete job;
+
+        if ( !ok )
+            return false;
+    }
+
+    return true;
+}
+
+void wxZlibParallelDeflate::AddCheck(const wxZlibDeflateJob& job)
+{
+    const size_t len = job.in.GetDataLen();
+
+    m_check = m_flags == wxZLIB_GZIP ? crc32_combine(m_check, job.check, len)
+                                     : adler32_combine(m_check, job.check, len);
+    m_total += len;
+}
+
+bool wxZlibParallelDeflate::WriteHeader(wxOutputStream& stream)
+{
+    if ( m_started )
+        return true;
+
+    m_started = true;
+
+    unsigned char header[10];
+    size_t len = 0;
+
+    switch ( m_flags )
+    {
+        case wxZLIB_ZLIB:
+            {
+                // deflate with 32KB window and the level indicator computed
+                // in the same way as zlib does it
+                int flevel;
+                if ( m_level == Z_DEFAULT_COMPRESSION || m_level == 6 )
+                    flevel = 2;
+                else if ( m_level < 2 )
+                    flevel = 0;
+                else if ( m_level < 6 )
+                    flevel = 1;
+                else
+                    flevel = 3;
+
+                unsigned value = 0x7800 | (flevel << 6);
+                if ( m_userDict.GetDataLen() )
+                    value |= 0x20;
+                value += 31 - value % 31;
+
+                header[len++] = (unsigned char)(value >> 8);
+                header[len++] = (unsigned char)value;
+
+                if ( m_userDict.GetDataLen() )
+                {
+                    const uLong id = adler32(adler32(0, NULL, 0),
+                                             (Bytef *)m_userDict.GetData(),
+                                             m_userDict.GetDataLen());
+                    for ( int shift = 24; shift >= 0; shift -= 8 )
+                        header[len++] = (unsigned char)(id >> shift);
+
+                    stream.Write(header, len);
+                    return stream.LastWrite() == len;
+                }
+            }
+            break;
+
+        case wxZLIB_GZIP:
+            header[len++] = 0x1f;
+            header[len++] = 0x8b;
+            header[len++] = Z_DEFLATED;
+            header[len++] = 0;          // no flags
+            header[len++] = 0;          // no modification time
+            header[len++] = 0;
+            header[len++] = 0;
+            header[len++] = 0;
+            header[len++] = m_level == 9 ? 2 : m_level == 1 ? 4 : 0;
+            header[len++] = 255;        // unknown OS
+            break;
+    }
+
+    if ( !len )
+        return true;
+
+    stream.Write(header, len);
+    return stream.LastWrite() == len;
+}
+
+bool wxZlibParallelDeflate::WriteTrailer(wxOutputStream& stream)
+{
+    unsigned char trailer[8];
+    size_t len = 0;
+
+    switch ( m_flags )
+    {
+        case wxZLIB_ZLIB:
+            for ( int shift = 24; shift >= 0; shift -= 8 )
+                trailer[len++] = (unsigned char)(m_check >> shift);
+            break;
+
+        case wxZLIB_GZIP:
+            for ( int shift = 0; shift < 32; shift += 8 )
+                trailer[len++] = (unsigned char)(m_check >> shift);
+            for ( int shift = 0; shift < 32; shift += 8 )
+                trailer[len++] = (unsigned char)(m_total >> shift);
+            break;
+    }
+
+    if ( !len )
+        return true;
+
+    stream.Write(trailer, len);
+    return stream.LastWrite() == len;
+}
+
+#endif // wxUSE_THREADS
+
 //////////////////////
 // wxZlibOutputStream
 //////////////////////
@@ -303,6 +909,7 @@ void wxZlibOutputStream::Init(int level, int flags)
   m_z_buffer = new unsigned char[ZSTREAM_BUFFER_SIZE];
   m_z_size = ZSTREAM_BUFFER_SIZE;
   m_pos = 0;
+  m_parallel = NULL;
 
   if ( level == -1 )
   {
@@ -313,6 +920,9 @@ void wxZlibOutputStream::Init(int level, int flags)
     wxASSERT_MSG(level >= 0 && level <= 9, wxT("wxZlibOutputStream compression level must be between 0 and 9!"));
   }
 
+  m_level = level;
+  m_flags = flags;
+
   // if gzip is asked for but not supported...
   if (flags == wxZLIB_GZIP && !CanHandleGZip()) {
     wxLogError(_("Gzip not supported by this version of zlib"));
@@ -353,6 +963,9 @@ bool wxZlibOutputStream::Close()
    deflateEnd(m_deflate);
    wxDELETE(m_deflate);
    wxDELETEA(m_z_buffer);
+#if wxUSE_THREADS
+  wxDELETE(m_parallel);
+#endif
 
   return wxFilterOutputStream::Close() && IsOk();
  }
@@ -361,6 +974,22 @@ void wxZlibOutputStream::DoFlush(bool final)
 {
   if (!m_deflate || !m_z_buffer)
     m_lasterror = wxSTREAM_WRITE_ERROR;
+
+#if wxUSE_THREADS
+  if (m_parallel) {
+    // m_pos is invalid if the stream had been already finished and not
+    // reopened since then (this is used by wxZipOutputStream)
+    if (IsOk() && m_pos != wxInvalidOffset &&
+          !m_parallel->Flush(*m_parent_o_stream, final)) {
+      m_lasterror = wxSTREAM_WRITE_ERROR;
+      wxLogDebug(wxT("wxZlibOutputStream: Error writing to underlying stream"));
+    }
+    if (final)
+      m_parallel->Reset();
+    return;
+  }
+#endif // wxUSE_THREADS
+
   if (!IsOk())
     return;
 
@@ -399,6 +1028,19 @@ size_t wxZlibOutputStream::OnSysWrite(const void *buffer, size_t size)
   if (!IsOk() || !size)
     return 0;
 
+#if wxUSE_THREADS
+  if (m_parallel) {
+    if (!m_parallel->Write(*m_parent_o_stream, buffer, size)) {
+      m_lasterror = wxSTREAM_WRITE_ERROR;
+      wxLogDebug(wxT("wxZlibOutputStream: Error writing to underlying stream"));
+      return 0;
+    }
+
+    m_pos += size;
+    return size;
+  }
+#endif // wxUSE_THREADS
+
   int err = Z_OK;
   m_deflate->next_in = (unsigned char *)buffer;
   m_deflate->avail_in = size;
@@ -439,6 +1081,11 @@ size_t wxZlibOutputStream::OnSysWrite(const void *buffer, size_t size)
 
 bool wxZlibOutputStream::SetDictionary(const char *data, const size_t datalen)
 {
+#if wxUSE_THREADS
+    if ( m_parallel )
+        return m_parallel->SetDictionary(data, datalen);
+#endif // wxUSE_THREADS
+
     return (deflateSetDictionary(m_deflate, (Bytef*)data, datalen) == Z_OK);
 }
 
@@ -447,5 +1094,31 @@ bool wxZlibOutputStream::SetDictionary(const wxMemoryBuffer &buf)
     return SetDictionary((char*)buf.GetData(), buf.GetDataLen());
 }
 
+bool wxZlibOutputStream::SetThreadCount(int count, size_t blockSize)
+{
+#if wxUSE_THREADS
+    // the stream can't be switched to the parallel mode in the middle
+    if ( !m_deflate || !IsOk() || m_pos || m_deflate->total_in )
+        return false;
+
+    if ( count <= 0 )
+        count = wxThread::GetCPUCount();
+
+    if ( !blockSize )
+        blockSize = ZSTREAM_BLOCK_SIZE;
+
+    wxDELETE(m_parallel);
+
+    if ( count > 1 )
+        m_parallel = new wxZlibParallelDeflate(m_level, m_flags, count, blockSize);
+
+    return true;
+#else // !wxUSE_THREADS
+    wxUnusedVar(blockSize);
+
+    return count == 1;
+#endif // wxUSE_THREADS/!wxUSE_THREADS
+}
+
 #endif
   // wxUSE_ZLIB && wxUSE_STREAMS
@@ -48,6 +48,7 @@
 #include "wx/dnd.h"
 #include "wx/stopwatch.h"
 #include "wx/weakref.h"
+#include "wx/hashmap.h"
 
 //-----------------------------------------------------------------------------
 // classes
@@ -375,6 +376,100 @@ public:
 class wxDataViewTreeNode;
 WX_DEFINE_ARRAY( wxDataViewTreeNode *, wxDataViewTreeNodes );
 
+// There may be millions of tree nodes, so they are carved out of big chunks of
+// memory instead of being allocated from the heap one by one. The chunks are
+// only freed when there are no more nodes at all, i.e. when all the trees are
+// destroyed, and otherwise the freed nodes are simply reused.
+class wxDataViewTreeNodePool
+{
+public:
+    static void *Alloc(size_t size);
+    static void Free(void *p);
+
+private:
+    // Header of each chunk of memory, the node slots follow it.
+    union ChunkHeader
+    {
+        ChunkHeader *next;
+
+        // this is only used to ensure that the slots are suitably aligned
+        double align;
+    };
+
+    // Free slots form a singly linked list.
+    struct FreeSlot
+    {
+        FreeSlot *next;
+    };
+
+    enum { SLOTS_PER_CHUNK = 1024 };
+
+    static ChunkHeader *ms_chunks;
+    static FreeSlot *ms_freeSlots;
+    static size_t ms_numAllocated;
+};
+
+wxDataViewTreeNodePool::ChunkHeader *wxDataViewTreeNodePool::ms_chunks = NULL;
+wxDataViewTreeNodePool::FreeSlot *wxDataViewTreeNodePool::ms_freeSlots = NULL;
+size_t wxDataViewTreeNodePool::ms_numAllocated = 0;
+
+void *wxDataViewTreeNodePool::Alloc(size_t size)
+{
+    if ( !ms_freeSlots )
+    {
+        // Round the slot size up to keep all of them aligned.
+        const size_t slotSize = ((wxMax(size, sizeof(FreeSlot)) - 1) /
+                                    sizeof(ChunkHeader) + 1) *
+                                        sizeof(ChunkHeader);
+
+        ChunkHeader * const chunk = static_cast<ChunkHeader *>
+            (
+                ::operator new(sizeof(ChunkHeader) + SLOTS_PER_CHUNK*slotSize)
+            );
+        chunk->next = ms_chunks;
+        ms_chunks = chunk;
+
+        // Link the slots in the order of their addresses, so that the nodes
+        // allocated one after another are adjacent in memory.
+        char * const slots = reinterpret_cast<char *>(chunk + 1);
+        for ( size_t n = SLOTS_PER_CHUNK; n > 0; n-- )
+        {
+            FreeSlot * const
+                slot = reinterpret_cast<FreeSlot *>(slots + (n - 1)*slotSize);
+            slot->next = ms_freeSlots;
+            ms_freeSlots = slot;
+        }
+    }
+
+    FreeSlot * const slot = ms_freeSlots;
+    ms_freeSlots = slot->next;
+    ms_numAllocated++;
+
+    return slot;
+}
+
+void wxDataViewTreeNodePool::Free(void *p)
+{
+    if ( !p )
+        return;
+
+    FreeSlot * const slot = static_cast<FreeSlot *>(p);
+    slot->next = ms_freeSlots;
+    ms_freeSlots = slot;
+
+    if ( --ms_numAllocated == 0 )
+    {
+        while ( ms_chunks )
+        {
+            ChunkHeader * const next = ms_chunks->next;
+            ::operator delete(ms_chunks);
+            ms_chunks = next;
+        }
+
+        ms_freeSlots = NULL;
+    }
+}
+
 int LINKAGEMODE wxGenericTreeModelNodeCmp( wxDataViewTreeNode ** node1,
                                            wxDataViewTreeNode ** node2);
 
@@ -384,7 +479,8 @@ public:
     wxDataViewTreeNode(wxDataViewTreeNode *parent, const wxDataViewItem& item)
         : m_parent(parent),
           m_item(item),
-          m_branchData(NULL)
+          m_branchData(NULL),
+          m_rowOffset(0)
     {
     }
 
@@ -404,6 +500,16 @@ public:
         }
     }
 
+    static void *operator new(size_t size)
+    {
+        return wxDataViewTreeNodePool::Alloc(size);
+    }
+
+    static void operator delete(void *p)
+    {
+        wxDataViewTreeNodePool::Free(p);
+    }
+
     static wxDataViewTreeNode* CreateRootNode()
     {
         wxDataViewTreeNode *n = new wxDataViewTreeNode(NULL, wxDataViewItem());
@@ -426,16 +532,51 @@ public:
             m_branchData = new BranchNodeData;
 
         m_branchData->children.Insert(node, index);
+        m_branchData->rowOffsetsValid = false;
 
         // TODO: insert into sorted array directly in O(log n) instead of resorting in O(n log n)
         if (g_column >= -1)
             m_branchData->children.Sort( &wxGenericTreeModelNodeCmp );
     }
 
+    // Appends the child without resorting the children, Resort() must be
+    // called after adding all of them if necessary.
+    void AppendChild(wxDataViewTreeNode *node)
+    {
+        if ( !m_branchData )
+            m_branchData = new BranchNodeData;
+
+        m_branchData->children.Add(node);
+        m_branchData->rowOffsetsValid = false;
+        m_branchData->childrenIndexed = false;
+    }
+
+    void ReserveChildren(size_t count)
+    {
+        if ( !m_branchData )
+            m_branchData = new BranchNodeData;
+
+        m_branchData->children.Alloc(count);
+    }
+
+    // Have all the children of this node been added to the item map of the
+    // main window already?
+    bool AreChildrenIndexed() const
+    {
+        return m_branchData && m_branchData->childrenIndexed;
+    }
+
+    void SetChildrenIndexed()
+    {
+        wxASSERT( m_branchData != NULL );
+        m_branchData->childrenIndexed = true;
+    }
+
     void RemoveChild(wxDataViewTreeNode *node)
     {
         wxCHECK_RET( m_branchData != NULL, "leaf node doesn't have children" );
         m_branchData->children.Remove(node);
+        m_branchData->rowOffsetsValid = false;
     }
 
     // returns position of child node for given item in children list or wxNOT_FOUND
@@ -457,6 +598,42 @@ public:
     const wxDataViewItem & GetItem() const { return m_item; }
     void SetItem( const wxDataViewItem & item ) { m_item = item; }
 
+    // Returns the row of this node relative to the row of its parent, i.e. 1
+    // for the first child. This is O(1) unless the children of the parent or
+    // their subtrees changed since the last call.
+    int GetRowOffset() const
+    {
+        wxASSERT( m_parent != NULL );
+
+        m_parent->UpdateRowOffsets();
+        return m_rowOffset;
+    }
+
+    // Returns the child whose subtree contains the row with the given offset
+    // relative to this node or NULL if there is no such row.
+    wxDataViewTreeNode *FindChildByRowOffset(int offset) const
+    {
+        if ( !m_branchData || offset < 1 || offset > GetSubTreeCount() )
+            return NULL;
+
+        UpdateRowOffsets();
+
+        // Find the last child starting at or before the given offset.
+        const wxDataViewTreeNodes& nodes = m_branchData->children;
+        size_t lo = 0,
+               hi = nodes.size();
+        while ( hi - lo > 1 )
+        {
+            const size_t mid = lo + (hi - lo) / 2;
+            if ( nodes[mid]->m_rowOffset <= offset )
+                lo = mid;
+            else
+                hi = mid;
+        }
+
+        return nodes.empty() ? NULL : nodes[lo];
+    }
+
     int GetIndentLevel() const
     {
         int ret = 0;
@@ -542,7 +719,11 @@ public:
         wxASSERT( m_branchData->subTreeCount >= 0 );
 
         if( m_parent )
+        {
+            // The rows of all our next siblings have changed.
+            m_parent->m_branchData->rowOffsetsValid = false;
             m_parent->ChangeSubTreeCount(num);
+        }
     }
 
     void Resort()
@@ -555,6 +736,7 @@ public:
             wxDataViewTreeNodes& nodes = m_branchData->children;
 
             nodes.Sort( &wxGenericTreeModelNodeCmp );
+            m_branchData->rowOffsetsValid = false;
             int len = nodes.GetCount();
             for (int i = 0; i < len; i ++)
             {
@@ -566,6 +748,28 @@ public:
 
 
 private:
+    // Updates the row offsets of all children if necessary.
+    void UpdateRowOffsets() const
+    {
+        wxASSERT( m_branchData != NULL );
+
+        if ( m_branchData->rowOffsetsValid )
+            return;
+
+        int offset = 1;
+
+        const wxDataViewTreeNodes& nodes = m_branchData->children;
+        for ( wxDataViewTreeNodes::const_iterator i = nodes.begin();
+              i != nodes.end();
+              ++i )
+        {
+            (*i)->m_rowOffset = offset;
+            offset += 1 + (*i)->GetSubTreeCount();
+        }
+
+        m_branchData->rowOffsetsValid = true;
+    }
+
     wxDataViewTreeNode  *m_parent;
 
     // Corresponding model item.
@@ -577,7 +781,9 @@ private:
     {
         BranchNodeData()
             : open(false),
-              subTreeCount(0)
+              subTreeCount(0),
+              rowOffsetsValid(false),
+              childrenIndexed(false)
         {
         }
 
@@ -593,9 +799,20 @@ private:
         // 0 for leaves and is the number of rows the subtree occupies for
         // branch nodes.
         int                  subTreeCount;
+
+        // Are the m_rowOffset values of the child nodes up to date?
+        bool                 rowOffsetsValid;
+
+        // Were the children added to the item map? This is only done when
+        // they're looked up for the first time and not when they are created.
+        bool                 childrenIndexed;
     };
 
     BranchNodeData *m_branchData;
+
+    // The row of this node relative to its parent, only valid if the parent
+    // rowOffsetsValid is true.
+    int                  m_rowOffset;
 };
 
 
@@ -605,6 +822,191 @@ int LINKAGEMODE wxGenericTreeModelNodeCmp( wxDataViewTreeNode ** node1,
     return g_model->Compare( (*node1)->GetItem(), (*node2)->GetItem(), g_column, g_asending );
 }
 
+//-----------------------------------------------------------------------------
+// wxDataViewRowHeightCache
+//-----------------------------------------------------------------------------
+
+// This class stores the heights of all rows when wxDV_VARIABLE_LINE_HEIGHT is
+// used, as computing them requires querying all the renderers and is too slow
+// to be done for all rows on every repaint. It also allows finding the
+// position of a row and the row at the given position in O(log N) time by
+// using a Fenwick tree (a.k.a. binary indexed tree) of the heights.
+class wxDataViewRowHeightCache
+{
+public:
+    wxDataViewRowHeightCache()
+        : m_valid(false),
+          m_treeValid(false)
+    {
+    }
+
+    // The cache is initially invalid and needs to be filled using SetHeights()
+    // before it can be used. All the other modifying methods do nothing for
+    // an invalid cache.
+    bool IsValid() const { return m_valid; }
+
+    void Invalidate()
+    {
+        m_valid = false;
+        m_heights.clear();
+        m_tree.clear();
+    }
+
+    void SetHeights(const wxVector<int>& heights)
+    {
+        m_heights = heights;
+        m_valid = true;
+        m_treeValid = false;
+    }
+
+    unsigned GetRowCount() const { return m_heights.size(); }
+
+    int GetHeight(unsigned row) const { return m_heights[row]; }
+
+    // Change the height of the given row in O(log N) time.
+    void SetHeight(unsigned row, int height)
+    {
+        if ( !m_valid )
+            return;
+
+        if ( row >= m_heights.size() )
+        {
+            Invalidate();
+            return;
+        }
+
+        const int delta = height - m_heights[row];
+        m_heights[row] = height;
+
+        if ( m_treeValid )
+        {
+            for ( unsigned n = row + 1; n <= m_heights.size(); n += LowestBit(n) )
+                m_tree[n] += delta;
+        }
+    }
+
+    // Insert rows with the given heights before the given row or remove the
+    // given number of rows starting at it. These operations are O(N), but
+    // only need to move integers around, which is still much faster than
+    // recomputing the heights of all rows.
+    void InsertRows(unsigned row, const wxVector<int>& heights)
+    {
+        if ( !m_valid || heights.empty() )
+            return;
+
+        if ( row > m_heights.size() )
+        {
+            Invalidate();
+            return;
+        }
+
+        wxVector<int> all;
+        all.reserve(m_heights.size() + heights.size());
+        for ( unsigned n = 0; n < row; n++ )
+            all.push_back(m_heights[n]);
+        for ( unsigned n = 0; n < heights.size(); n++ )
+            all.push_back(heights[n]);
+        for ( unsigned n = row; n < m_heights.size(); n++ )
+            all.push_back(m_heights[n]);
+
+        m_heights.swap(all);
+        m_treeValid = false;
+    }
+
+    void RemoveRows(unsigned row, unsigned count)
+    {
+        if ( !m_valid || !count )
+            return;
+
+        if ( row + count > m_heights.size() )
+        {
+            Invalidate();
+            return;
+        }
+
+        m_heights.erase(m_heights.begin() + row,
+                        m_heights.begin() + row + count);
+        m_treeValid = false;
+    }
+
+    // Return the total height of all rows before the given one, which may be
+    // equal to the number of rows to get the height of all of them.
+    int GetRowStart(unsigned row) const
+    {
+        UpdateTree();
+
+        int start = 0;
+        for ( unsigned n = row; n > 0; n -= LowestBit(n) )
+            start += m_tree[n];
+
+        return start;
+    }
+
+    // Return the row containing the given position or the number of rows if
+    // it is beyond the last one.
+    unsigned GetRowAt(unsigned y) const
+    {
+        UpdateTree();
+
+        const unsigned count = m_heights.size();
+        if ( !count )
+            return 0;
+
+        unsigned step = 1;
+        while ( step <= count / 2 )
+            step *= 2;
+
+        // Find the greatest number of rows whose total height is less than or
+        // equal to y by descending the tree.
+        unsigned row = 0;
+        for ( ; step > 0; step /= 2 )
+        {
+            const unsigned next = row + step;
+            if ( next <= count && (unsigned)m_tree[next] <= y )
+            {
+                row = next;
+                y -= m_tree[next];
+            }
+        }
+
+        return row;
+    }
+
+private:
+    static unsigned LowestBit(unsigned n) { return n & (~n + 1); }
+
+    // (Re)build the tree from the heights in O(N) time if necessary.
+    void UpdateTree() const
+    {
+        if ( m_treeValid )
+            return;
+
+        const unsigned count = m_heights.size();
+        m_tree.assign(count + 1, 0);
+        for ( unsigned n = 1; n <= count; n++ )
+        {
+            m_tree[n] += m_heights[n - 1];
+
+            const unsigned parent = n + LowestBit(n);
+            if ( parent <= count )
+                m_tree[parent] += m_tree[n];
+        }
+
+        m_treeValid = true;
+    }
+
+    // The height of each row.
+    wxVector<int> m_heights;
+
+    // The tree using 1-based indices: its element n contains the total height
+    // of the rows in [n - LowestBit(n), n) range. It is rebuilt on demand
+    // after inserting or removing rows.
+    mutable wxVector<int> m_tree;
+
+    bool m_valid;
+    mutable bool m_treeValid;
+};
+
 
 //-----------------------------------------------------------------------------
 // wxDataViewMainWindow
@@ -612,6 +1014,9 @@ int LINKAGEMODE wxGenericTreeModelNodeCmp( wxDataViewTreeNode ** node1,
 
 WX_DEFINE_SORTED_ARRAY_SIZE_T(unsigned int, wxDataViewSelection);
 
+WX_DECLARE_HASH_MAP(void *, wxDataViewTreeNode *, wxPointerHash, wxPointerEqual,
+                    wxDataViewItemNodeMap);
+
 class wxDataViewMainWindow: public wxWindow
 {
 public:
@@ -629,6 +1034,7 @@ public:
     bool ItemAdded( const wxDataViewItem &parent, const wxDataViewItem &item );
     bool ItemDeleted( const wxDataViewItem &parent, const wxDataViewItem &item );
     bool ItemChanged( const wxDataViewItem &item );
+    bool ItemsChanged( const wxDataViewItemArray &items );
     bool ValueChanged( const wxDataViewItem &item, unsigned int model_column );
     bool Cleared();
     void Resort()
@@ -637,6 +1043,10 @@ public:
         {
             SortPrepare();
             m_root->Resort();
+
+            // The rows order changes if they're really sorted.
+            if ( g_column >= SortColumn_Default )
+                m_rowHeights.Invalidate();
         }
         UpdateDisplay();
     }
@@ -766,7 +1176,11 @@ public:
     int GetLineHeight( unsigned int row ) const; // m_lineHeight in fixed mode
     int GetLineAt( unsigned int y ) const;       // y / m_lineHeight in fixed mode
 
-    void SetRowHeight( int lineHeight ) { m_lineHeight = lineHeight; }
+    void SetRowHeight( int lineHeight )
+    {
+        m_lineHeight = lineHeight;
+        m_rowHeights.Invalidate();
+    }
     int GetRowHeight() const { return m_lineHeight; }
     int GetDefaultRowHeight() const;
 
@@ -775,8 +1189,10 @@ public:
     int GetRowByItem( const wxDataViewItem & item ) const;
 
     wxDataViewTreeNode * GetTreeNodeByRow( unsigned int row ) const;
-    // We did not need this temporarily
-    // wxDataViewTreeNode * GetTreeNodeByItem( const wxDataViewItem & item );
+
+    // Unlike FindNode(), this never realizes any nodes and just returns NULL
+    // if the item is not in the tree yet.
+    wxDataViewTreeNode * GetTreeNodeByItem( const wxDataViewItem & item ) const;
 
     // Methods for building the mapping tree
     void BuildTree( wxDataViewModel  * model );
@@ -810,6 +1226,52 @@ public:
 private:
     int RecalculateCount() const;
 
+    // Returns the row of the given node or -1 if it is not shown because one
+    // of its parents is collapsed.
+    int GetRowByTreeNode( const wxDataViewTreeNode * node ) const;
+
+    // Adds the nodes for the children of the given item to the tree.
+    void BuildTreeHelper( const wxDataViewModel * model,
+                          const wxDataViewItem & item,
+                          wxDataViewTreeNode * node );
+
+    // Adds the node to the item map or removes it and all of its children
+    // from it before deleting it.
+    void RegisterTreeNode( wxDataViewTreeNode * node );
+    void UnregisterTreeNode( wxDataViewTreeNode * node );
+
+    // Adds all the children of the given node to the item map if they're not
+    // there yet and returns false if nothing was done.
+    bool IndexChildNodes( wxDataViewTreeNode * node ) const;
+
+    // Returns the node from the item map without indexing any new nodes.
+    wxDataViewTreeNode * FindIndexedTreeNode( const wxDataViewItem & item ) const;
+
+    // Resorts the items after they changed if needed, otherwise just updates
+    // the heights of their rows and refreshes them.
+    void RefreshChangedItems( const wxDataViewItemArray & items );
+
+    // Return the height of the row showing the given item, this is slow as it
+    // needs to ask all the renderers for their size.
+    int CalculateItemHeight(const wxDataViewItem& item) const;
+
+    // Append the heights of all the visible rows under the given node to the
+    // provided vector.
+    void CalculateSubTreeHeights(const wxDataViewTreeNode *node,
+                                 wxVector<int>& heights) const;
+
+    // Return the row heights cache, filling it first if necessary. This is
+    // only used with wxDV_VARIABLE_LINE_HEIGHT style.
+    const wxDataViewRowHeightCache& GetRowHeights() const;
+
+    // Update the height of the row showing the given item after it changed,
+    // return true if it's different from the old one.
+    bool UpdateRowHeight(unsigned int row, const wxDataViewItem& item);
+
+    // Update the height of the row of the given node, if it's shown, after
+    // its children changed: the height depends on whether it's a container.
+    void UpdateParentRowHeight(const wxDataViewTreeNode *node);
+
     // Return false only if the event was vetoed by its handler.
     bool SendExpanderEvent(wxEventType type, const wxDataViewItem& item);
 
@@ -865,6 +1327,15 @@ private:
     wxDataViewTreeNode * m_root;
     int m_count;
 
+    // The nodes of all items in the tree, except for the root, indexed by the
+    // item IDs.
+    wxDataViewItemNodeMap m_itemNodes;
+
+    // The heights of all rows when using wxDV_VARIABLE_LINE_HEIGHT and the
+    // columns which were shown when they were computed.
+    wxDataViewRowHeightCache m_rowHeights;
+    wxVector<const wxDataViewColumn *> m_rowHeightsColumns;
+
     // This is the tree node under the cursor
     wxDataViewTreeNode * m_underMouse;
 
@@ -895,6 +1366,8 @@ public:
         { return m_mainWindow->ItemDeleted( parent, item ); }
     virtual bool ItemChanged( const wxDataViewItem & item )
         { return m_mainWindow->ItemChanged(item);  }
+    virtual bool ItemsChanged( const wxDataViewItemArray & items )
+        { return m_mainWindow->ItemsChanged(items); }
     virtual bool ValueChanged( const wxDataViewItem & item , unsigned int col )
         { return m_mainWindow->ValueChanged( item, col ); }
     virtual bool Cleared()
@@ -1433,10 +1906,6 @@ void wxDataViewRenameTimer::Notify()
 // wxDataViewMainWindow
 //-----------------------------------------------------------------------------
 
-// The tree building helper, declared firstly
-static void BuildTreeHelper( const wxDataViewModel * model,  const wxDataViewItem & item,
-                             wxDataViewTreeNode * node);
-
 int LINKAGEMODE wxDataViewSelectionCmp( unsigned int row1, unsigned int row2 )
 {
     if (row1 > row2) return 1;
@@ -2227,56 +2696,6 @@ void wxDataViewHeaderWindow::FinishEditing()
     win->FinishEditing();
 }
 
-//-----------------------------------------------------------------------------
-// Helper class for do operation on the tree node
-//-----------------------------------------------------------------------------
-class DoJob
-{
-public:
-    DoJob() { }
-    virtual ~DoJob() { }
-
-    // The return value control how the tree-walker tranverse the tree
-    enum
-    {
-        DONE,          // Job done, stop traversing and return
-        SKIP_SUBTREE,  // Ignore the current node's subtree and continue
-        CONTINUE       // Job not done, continue
-    };
-
-    virtual int operator() ( wxDataViewTreeNode * node ) = 0;
-};
-
-bool Walker( wxDataViewTreeNode * node, DoJob & func )
-{
-    wxCHECK_MSG( node, false, "can't walk NULL node" );
-
-    switch( func( node ) )
-    {
-        case DoJob::DONE:
-            return true;
-        case DoJob::SKIP_SUBTREE:
-            return false;
-        case DoJob::CONTINUE:
-            break;
-    }
-
-    if ( node->HasChildren() )
-    {
-        const wxDataViewTreeNodes& nodes = node->GetChildNodes();
-
-        for ( wxDataViewTreeNodes::const_iterator i = nodes.begin();
-              i != nodes.end();
-              ++i )
-        {
-            if ( Walker(*i, func) )
-                return true;
-        }
-    }
-
-    return false;
-}
-
 bool wxDataViewMainWindow::ItemAdded(const wxDataViewItem & parent, const wxDataViewItem & item)
 {
     if (IsVirtualList())
@@ -2284,6 +2703,13 @@ bool wxDataViewMainWindow::ItemAdded(const wxDataViewItem & parent, const wxData
         wxDataViewVirtualListModel *list_model =
             (wxDataViewVirtualListModel*) GetModel();
         m_count = list_model->GetCount();
+
+        if ( m_rowHeights.IsValid() )
+        {
+            wxVector<int> heights;
+            heights.push_back(CalculateItemHeight(item));
+            m_rowHeights.InsertRows(GetRowByItem(item), heights);
+        }
     }
     else
     {
@@ -2303,6 +2729,7 @@ bool wxDataViewMainWindow::ItemAdded(const wxDataViewItem & parent, const wxData
 
         wxDataViewTreeNode *itemNode = new wxDataViewTreeNode(parentNode, item);
         itemNode->SetHasChildren(GetModel()->IsContainer(item));
+        RegisterTreeNode(itemNode);
 
         parentNode->SetHasChildren(true);
 
@@ -2349,6 +2776,21 @@ bool wxDataViewMainWindow::ItemAdded(const wxDataViewItem & parent, const wxData
         parentNode->InsertChild(itemNode, nodePos);
 
         m_count = -1;
+
+        if ( m_rowHeights.IsValid() )
+        {
+            // Only add the new row height if the item is visible, i.e. if all
+            // of its parents are expanded.
+            const int row = GetRowByTreeNode(itemNode);
+            if ( row != -1 )
+            {
+                wxVector<int> heights;
+                heights.push_back(CalculateItemHeight(item));
+                m_rowHeights.InsertRows(row, heights);
+            }
+
+            UpdateParentRowHeight(parentNode);
+        }
     }
 
     GetOwner()->InvalidateColBestWidths();
@@ -2366,6 +2808,8 @@ bool wxDataViewMainWindow::ItemDeleted(const wxDataViewItem& parent,
             (wxDataViewVirtualListModel*) GetModel();
         m_count = list_model->GetCount();
 
+        m_rowHeights.RemoveRows(GetRowByItem(item), 1);
+
         if ( !m_selection.empty() )
         {
             const int row = GetRowByItem(item);
@@ -2398,41 +2842,37 @@ bool wxDataViewMainWindow::ItemDeleted(const wxDataViewItem& parent,
             return true;
 
         wxCHECK_MSG( parentNode->HasChildren(), false, "parent node doesn't have children?" );
-        const wxDataViewTreeNodes& parentsChildren = parentNode->GetChildNodes();
-
-        // We can't use FindNode() to find 'item', because it was already
-        // removed from the model by the time ItemDeleted() is called, so we
-        // have to do it manually. We keep track of its position as well for
-        // later use.
-        int itemPosInNode = 0;
-        wxDataViewTreeNode *itemNode = NULL;
-        for ( wxDataViewTreeNodes::const_iterator i = parentsChildren.begin();
-              i != parentsChildren.end();
-              ++i, ++itemPosInNode )
-        {
-            if( (*i)->GetItem() == item )
-            {
-                itemNode = *i;
-                break;
-            }
-        }
+
+        // We can't use FindNode() nor GetTreeNodeByItem() to find 'item',
+        // because it was already removed from the model by the time
+        // ItemDeleted() is called, but we can still look up its node among the
+        // children of its parent, if we have any.
+        IndexChildNodes(parentNode);
+        wxDataViewTreeNode *itemNode = FindIndexedTreeNode(item);
 
         // If the parent wasn't expanded, it's possible that we didn't have a
         // node corresponding to 'item' and so there's nothing left to do.
-        if ( !itemNode )
+        if ( !itemNode || itemNode->GetParent() != parentNode )
         {
             // If this was the last child to be removed, it's possible the parent
             // node became a leaf. Let's ask the model about it.
             if ( parentNode->GetChildNodes().empty() )
+            {
                 parentNode->SetHasChildren(GetModel()->IsContainer(parent));
+                UpdateParentRowHeight(parentNode);
+            }
 
             return true;
         }
 
+        // Remember the row of the item, if it's shown, before deleting it.
+        const int itemRow = GetRowByTreeNode(itemNode);
+
         // Delete the item from wxDataViewTreeNode representation:
         const int itemsDeleted = 1 + itemNode->GetSubTreeCount();
 
         parentNode->RemoveChild(itemNode);
+        UnregisterTreeNode(itemNode);
         delete itemNode;
         parentNode->ChangeSubTreeCount(-itemsDeleted);
 
@@ -2454,27 +2894,14 @@ bool wxDataViewMainWindow::ItemDeleted(const wxDataViewItem& parent,
             }
         }
 
-        // Update selection by removing 'item' and its entire children tree from the selection.
-        if ( !m_selection.empty() )
-        {
-            // we can't call GetRowByItem() on 'item', as it's already deleted, so compute it from
-            // the parent ('parentNode') and position in its list of children
-            int itemRow;
-            if ( itemPosInNode == 0 )
-            {
-                // 1st child, row number is that of the parent parentNode + 1
-                itemRow = GetRowByItem(parentNode->GetItem()) + 1;
-            }
-            else
-            {
-                // row number is that of the sibling above 'item' + its subtree if any + 1
-                const wxDataViewTreeNode *siblingNode = parentNode->GetChildNodes()[itemPosInNode - 1];
+        if ( itemRow != -1 )
+            m_rowHeights.RemoveRows(itemRow, itemsDeleted);
 
-                itemRow = GetRowByItem(siblingNode->GetItem()) +
-                          siblingNode->GetSubTreeCount() +
-                          1;
-            }
+        UpdateParentRowHeight(parentNode);
 
+        // Update selection by removing 'item' and its entire children tree from the selection.
+        if ( itemRow != -1 && !m_selection.empty() )
+        {
             wxDataViewSelection newsel(wxDataViewSelectionCmp);
 
             const size_t numSelections = m_selection.size();
@@ -2504,18 +2931,29 @@ bool wxDataViewMainWindow::ItemDeleted(const wxDataViewItem& parent,
 
 bool wxDataViewMainWindow::ItemChanged(const wxDataViewItem & item)
 {
-    SortPrepare();
-    g_model->Resort();
+    wxDataViewItemArray items;
+    items.Add(item);
+
+    return ItemsChanged(items);
+}
+
+bool wxDataViewMainWindow::ItemsChanged(const wxDataViewItemArray & items)
+{
+    RefreshChangedItems(items);
 
     GetOwner()->InvalidateColBestWidths();
 
-    // Send event
+    // Send events
     wxWindow *parent = GetParent();
-    wxDataViewEvent le(wxEVT_DATAVIEW_ITEM_VALUE_CHANGED, parent->GetId());
-    le.SetEventObject(parent);
-    le.SetModel(GetModel());
-    le.SetItem(item);
-    parent->ProcessWindowEvent(le);
+    const size_t count = items.size();
+    for ( size_t n = 0; n < count; n++ )
+    {
+        wxDataViewEvent le(wxEVT_DATAVIEW_ITEM_VALUE_CHANGED, parent->GetId());
+        le.SetEventObject(parent);
+        le.SetModel(GetModel());
+        le.SetItem(items[n]);
+        parent->ProcessWindowEvent(le);
+    }
 
     return true;
 }
@@ -2526,17 +2964,9 @@ bool wxDataViewMainWindow::ValueChanged( const wxDataViewItem & item, unsigned i
     if ( view_column == wxNOT_FOUND )
         return false;
 
-    // NOTE: to be valid, we cannot use e.g. INT_MAX - 1
-/*#define MAX_VIRTUAL_WIDTH       100000
-
-    wxRect rect( 0, row*m_lineHeight, MAX_VIRTUAL_WIDTH, m_lineHeight );
-    m_owner->CalcScrolledPosition( rect.x, rect.y, &rect.x, &rect.y );
-    Refresh( true, &rect );
-
-    return true;
-*/
-    SortPrepare();
-    g_model->Resort();
+    wxDataViewItemArray items;
+    items.Add(item);
+    RefreshChangedItems(items);
 
     GetOwner()->InvalidateColBestWidth(view_column);
 
@@ -2553,6 +2983,47 @@ bool wxDataViewMainWindow::ValueChanged( const wxDataViewItem & item, unsigned i
     return true;
 }
 
+void wxDataViewMainWindow::RefreshChangedItems(const wxDataViewItemArray & items)
+{
+    const size_t count = items.size();
+
+    SortPrepare();
+    if ( g_column != SortColumn_None )
+    {
+        // The items may have moved, so resort them and refresh everything.
+        g_model->Resort();
+
+        for ( size_t n = 0; n < count; n++ )
+        {
+            const int row = GetRowByItem(items[n]);
+            if ( row != -1 )
+                UpdateRowHeight(row, items[n]);
+        }
+
+        return;
+    }
+
+    const unsigned int firstVisible = GetFirstVisibleRow();
+    const unsigned int lastVisible = GetLastVisibleRow();
+
+    bool heightChanged = false;
+    for ( size_t n = 0; n < count; n++ )
+    {
+        const int row = GetRowByItem(items[n]);
+        if ( row == -1 )
+            continue;
+
+        if ( UpdateRowHeight(row, items[n]) )
+            heightChanged = true;
+        else if ( (unsigned)row >= firstVisible && (unsigned)row <= lastVisible )
+            RefreshRow(row);
+    }
+
+    // All the rows below the ones whose height changed have moved.
+    if ( heightChanged )
+        UpdateDisplay();
+}
+
 bool wxDataViewMainWindow::Cleared()
 {
     DestroyTree();
@@ -2884,205 +3355,178 @@ wxRect wxDataViewMainWindow::GetLineRect( unsigned int row ) const
     return rect;
 }
 
-int wxDataViewMainWindow::GetLineStart( unsigned int row ) const
+int wxDataViewMainWindow::CalculateItemHeight(const wxDataViewItem& item) const
 {
     const wxDataViewModel *model = GetModel();
 
-    if (GetOwner()->GetWindowStyle() & wxDV_VARIABLE_LINE_HEIGHT)
-    {
-        // TODO make more efficient
-
-        int start = 0;
-
-        unsigned int r;
-        for (r = 0; r < row; r++)
-        {
-            const wxDataViewTreeNode* node = GetTreeNodeByRow(r);
-            if (!node) return start;
+    int height = m_lineHeight;
 
-            wxDataViewItem item = node->GetItem();
+    unsigned int cols = GetOwner()->GetColumnCount();
+    unsigned int col;
+    for (col = 0; col < cols; col++)
+    {
+        const wxDataViewColumn *column = GetOwner()->GetColumn(col);
+        if (column->IsHidden())
+            continue;      // skip it!
 
-            unsigned int cols = GetOwner()->GetColumnCount();
-            unsigned int col;
-            int height = m_lineHeight;
-            for (col = 0; col < cols; col++)
-            {
-                const wxDataViewColumn *column = GetOwner()->GetColumn(col);
-                if (column->IsHidden())
-                    continue;      // skip it!
+        if ((col != 0) &&
+            model->IsContainer(item) &&
+            !model->HasContainerColumns(item))
+            continue;      // skip it!
 
-                if ((col != 0) &&
-                    model->IsContainer(item) &&
-                    !model->HasContainerColumns(item))
-                    continue;      // skip it!
+        wxDataViewRenderer *renderer =
+            const_cast<wxDataViewRenderer*>(column->GetRenderer());
+        renderer->PrepareForItem(model, item, column->GetModelColumn());
 
-                wxDataViewRenderer *renderer =
-                    const_cast<wxDataViewRenderer*>(column->GetRenderer());
-                renderer->PrepareForItem(model, item, column->GetModelColumn());
+        height = wxMax( height, renderer->GetSize().y );
+    }
 
-                height = wxMax( height, renderer->GetSize().y );
-            }
+    return height;
+}
 
-            start += height;
-        }
+void
+wxDataViewMainWindow::CalculateSubTreeHeights(const wxDataViewTreeNode *node,
+                                              wxVector<int>& heights) const
+{
+    if ( !node->IsOpen() )
+        return;
 
-        return start;
-    }
-    else
+    const wxDataViewTreeNodes& nodes = node->GetChildNodes();
+    for ( wxDataViewTreeNodes::const_iterator i = nodes.begin();
+          i != nodes.end();
+          ++i )
     {
-        return row * m_lineHeight;
+        heights.push_back(CalculateItemHeight((*i)->GetItem()));
+        CalculateSubTreeHeights(*i, heights);
     }
 }
 
-int wxDataViewMainWindow::GetLineAt( unsigned int y ) const
+const wxDataViewRowHeightCache& wxDataViewMainWindow::GetRowHeights() const
 {
-    const wxDataViewModel *model = GetModel();
+    const unsigned int count = GetRowCount();
 
-    // check for the easy case first
-    if ( !GetOwner()->HasFlag(wxDV_VARIABLE_LINE_HEIGHT) )
-        return y / m_lineHeight;
+    bool upToDate = m_rowHeights.IsValid() &&
+                        m_rowHeights.GetRowCount() == count;
 
-    // TODO make more efficient
-    unsigned int row = 0;
-    unsigned int yy = 0;
-    for (;;)
+    // The heights depend on the columns being shown, so check that they
+    // didn't change since the heights were computed.
+    const unsigned int cols = GetOwner()->GetColumnCount();
+    unsigned int shown = 0;
+    for ( unsigned int col = 0; col < cols && upToDate; col++ )
     {
-        const wxDataViewTreeNode* node = GetTreeNodeByRow(row);
-        if (!node)
-        {
-            // not really correct...
-            return row + ((y-yy) / m_lineHeight);
-        }
-
-        wxDataViewItem item = node->GetItem();
+        const wxDataViewColumn * const column = GetOwner()->GetColumn(col);
+        if ( column->IsHidden() )
+            continue;
 
-        unsigned int cols = GetOwner()->GetColumnCount();
-        unsigned int col;
-        int height = m_lineHeight;
-        for (col = 0; col < cols; col++)
-        {
-            const wxDataViewColumn *column = GetOwner()->GetColumn(col);
-            if (column->IsHidden())
-                continue;      // skip it!
+        if ( shown == m_rowHeightsColumns.size() ||
+                m_rowHeightsColumns[shown] != column )
+            upToDate = false;
 
-            if ((col != 0) &&
-                model->IsContainer(item) &&
-                !model->HasContainerColumns(item))
-                continue;      // skip it!
+        shown++;
+    }
 
-            wxDataViewRenderer *renderer =
-                const_cast<wxDataViewRenderer*>(column->GetRenderer());
-            renderer->PrepareForItem(model, item, column->GetModelColumn());
+    if ( upToDate && shown == m_rowHeightsColumns.size() )
+        return m_rowHeights;
 
-            height = wxMax( height, renderer->GetSize().y );
-        }
+    wxDataViewMainWindow* const
+        self = const_cast<wxDataViewMainWindow*>(this);
 
-        yy += height;
-        if (y < yy)
-            return row;
+    self->m_rowHeightsColumns.clear();
+    for ( unsigned int col = 0; col < cols; col++ )
+    {
+        const wxDataViewColumn * const column = GetOwner()->GetColumn(col);
+        if ( !column->IsHidden() )
+            self->m_rowHeightsColumns.push_back(column);
+    }
 
-        row++;
+    wxVector<int> heights;
+    heights.reserve(count);
+    if ( IsVirtualList() )
+    {
+        for ( unsigned int row = 0; row < count; row++ )
+            heights.push_back(CalculateItemHeight(GetItemByRow(row)));
+    }
+    else
+    {
+        CalculateSubTreeHeights(m_root, heights);
     }
-}
 
-int wxDataViewMainWindow::GetLineHeight( unsigned int row ) const
-{
-    const wxDataViewModel *model = GetModel();
+    self->m_rowHeights.SetHeights(heights);
 
-    if (GetOwner()->GetWindowStyle() & wxDV_VARIABLE_LINE_HEIGHT)
-    {
-        wxASSERT( !IsVirtualList() );
+    return m_rowHeights;
+}
 
-        const wxDataViewTreeNode* node = GetTreeNodeByRow(row);
-        // wxASSERT( node );
-        if (!node) return m_lineHeight;
+bool wxDataViewMainWindow::UpdateRowHeight(unsigned int row,
+                                           const wxDataViewItem& item)
+{
+    if ( !m_rowHeights.IsValid() || row >= m_rowHeights.GetRowCount() )
+        return false;
 
-        wxDataViewItem item = node->GetItem();
+    const int height = CalculateItemHeight(item);
+    if ( height == m_rowHeights.GetHeight(row) )
+        return false;
 
-        int height = m_lineHeight;
+    m_rowHeights.SetHeight(row, height);
 
-        unsigned int cols = GetOwner()->GetColumnCount();
-        unsigned int col;
-        for (col = 0; col < cols; col++)
-        {
-            const wxDataViewColumn *column = GetOwner()->GetColumn(col);
-            if (column->IsHidden())
-                continue;      // skip it!
+    return true;
+}
 
-            if ((col != 0) &&
-                model->IsContainer(item) &&
-                !model->HasContainerColumns(item))
-                continue;      // skip it!
+void wxDataViewMainWindow::UpdateParentRowHeight(const wxDataViewTreeNode *node)
+{
+    if ( !m_rowHeights.IsValid() )
+        return;
 
-            wxDataViewRenderer *renderer =
-                const_cast<wxDataViewRenderer*>(column->GetRenderer());
-            renderer->PrepareForItem(model, item, column->GetModelColumn());
+    const int row = GetRowByTreeNode(node);
+    if ( row != -1 )
+        UpdateRowHeight(row, node->GetItem());
+}
 
-            height = wxMax( height, renderer->GetSize().y );
-        }
+int wxDataViewMainWindow::GetLineStart( unsigned int row ) const
+{
+    if (GetOwner()->GetWindowStyle() & wxDV_VARIABLE_LINE_HEIGHT)
+    {
+        const wxDataViewRowHeightCache& heights = GetRowHeights();
 
-        return height;
+        return heights.GetRowStart(wxMin(row, heights.GetRowCount()));
     }
     else
     {
-        return m_lineHeight;
+        return row * m_lineHeight;
     }
 }
 
-
-class RowToTreeNodeJob: public DoJob
+int wxDataViewMainWindow::GetLineAt( unsigned int y ) const
 {
-public:
-    RowToTreeNodeJob( unsigned int row , int current, wxDataViewTreeNode * node )
-    {
-        this->row = row;
-        this->current = current;
-        ret = NULL;
-        parent = node;
-    }
+    // check for the easy case first
+    if ( !GetOwner()->HasFlag(wxDV_VARIABLE_LINE_HEIGHT) )
+        return y / m_lineHeight;
 
-    virtual int operator() ( wxDataViewTreeNode * node )
-    {
-        current ++;
-        if( current == static_cast<int>(row))
-        {
-            ret = node;
-            return DoJob::DONE;
-        }
+    const wxDataViewRowHeightCache& heights = GetRowHeights();
 
-        if( node->GetSubTreeCount() + current < static_cast<int>(row) )
-        {
-            current += node->GetSubTreeCount();
-            return  DoJob::SKIP_SUBTREE;
-        }
-        else
-        {
-            parent = node;
+    const unsigned int row = heights.GetRowAt(y);
+    if ( row < heights.GetRowCount() )
+        return row;
 
-            // If the current node has only leaf children, we can find the
-            // desired node directly. This can speed up finding the node
-            // in some cases, and will have a very good effect for list views.
-            if ( node->HasChildren() &&
-                 (int)node->GetChildNodes().size() == node->GetSubTreeCount() )
-            {
-                const int index = static_cast<int>(row) - current - 1;
-                ret = node->GetChildNodes()[index];
-                return DoJob::DONE;
-            }
+    // not really correct...
+    return row + ((y - heights.GetRowStart(row)) / m_lineHeight);
+}
 
-            return DoJob::CONTINUE;
-        }
-    }
+int wxDataViewMainWindow::GetLineHeight( unsigned int row ) const
+{
+    if (GetOwner()->GetWindowStyle() & wxDV_VARIABLE_LINE_HEIGHT)
+    {
+        const wxDataViewRowHeightCache& heights = GetRowHeights();
+        if (row >= heights.GetRowCount())
+            return m_lineHeight;
 
-    wxDataViewTreeNode * GetResult() const
-        { return ret; }
+        return heights.GetHeight(row);
+    }
+    else
+    {
+        return m_lineHeight;
+    }
+}
 
-private:
-    unsigned int row;
-    int current;
-    wxDataViewTreeNode * ret;
-    wxDataViewTreeNode * parent;
-};
 
 wxDataViewTreeNode * wxDataViewMainWindow::GetTreeNodeByRow(unsigned int row) const
 {
@@ -3091,9 +3535,22 @@ wxDataViewTreeNode * wxDataViewMainWindow::GetTreeNodeByRow(unsigned int row) co
     if ( row == (unsigned)-1 )
         return NULL;
 
-    RowToTreeNodeJob job( row , -2, m_root );
-    Walker( m_root , job );
-    return job.GetResult();
+    // The (invisible) root node is at row -1, so its first child row offset
+    // is 1 and corresponds to row 0.
+    wxDataViewTreeNode *node = m_root;
+    int offset = static_cast<int>(row) + 1;
+    for ( ;; )
+    {
+        wxDataViewTreeNode * const child = node->FindChildByRowOffset(offset);
+        if ( !child )
+            return NULL;
+
+        offset -= child->GetRowOffset();
+        if ( !offset )
+            return child;
+
+        node = child;
+    }
 }
 
 wxDataViewItem wxDataViewMainWindow::GetItemByRow(unsigned int row) const
@@ -3184,7 +3641,14 @@ void wxDataViewMainWindow::Expand( unsigned int row )
         if( node->GetChildNodes().empty() )
         {
             SortPrepare();
-            ::BuildTreeHelper(GetModel(), node->GetItem(), node);
+            BuildTreeHelper(GetModel(), node->GetItem(), node);
+        }
+
+        if ( m_rowHeights.IsValid() )
+        {
+            wxVector<int> heights;
+            CalculateSubTreeHeights(node, heights);
+            m_rowHeights.InsertRows(row + 1, heights);
         }
 
         // By expanding the node all row indices that are currently in the selection list
@@ -3247,6 +3711,8 @@ void wxDataViewMainWindow::Collapse(unsigned int row)
 
             node->ToggleOpen();
 
+            m_rowHeights.RemoveRows(row + 1, rowAdjustment);
+
             // If the node to be closed has selected items the user won't see those any longer.
             // We select the collapsing node in this case.
             if(selectCollapsingRow)
@@ -3293,57 +3759,46 @@ wxDataViewTreeNode * wxDataViewMainWindow::FindNode( const wxDataViewItem & item
     if (!item.IsOk())
         return m_root;
 
-    // Compose the parent-chain for the item we are looking for
+    // Compose the parent-chain for the item we are looking for, stopping at
+    // the first item which is already in the tree.
     wxVector<wxDataViewItem> parentChain;
-    wxDataViewItem it( item );
-    while( it.IsOk() )
-    {
-        parentChain.push_back(it);
-        it = model->GetParent(it);
-    }
-
-    // Find the item along the parent-chain.
-    // This algorithm is designed to speed up the node-finding method
     wxDataViewTreeNode* node = m_root;
-    for( unsigned iter = parentChain.size()-1; ; --iter )
+    for ( wxDataViewItem it( item ); it.IsOk(); it = model->GetParent(it) )
     {
-        if( node->HasChildren() )
+        wxDataViewTreeNode * const itNode = FindIndexedTreeNode(it);
+        if ( itNode )
         {
-            if( node->GetChildNodes().empty() )
-            {
-                // Even though the item is a container, it doesn't have any
-                // child nodes in the control's representation yet. We have
-                // to realize its subtree now.
-                SortPrepare();
-                ::BuildTreeHelper(model, node->GetItem(), node);
-            }
+            node = itNode;
+            break;
+        }
 
-            const wxDataViewTreeNodes& nodes = node->GetChildNodes();
-            bool found = false;
+        parentChain.push_back(it);
+    }
 
-            for (unsigned i = 0; i < nodes.GetCount(); ++i)
-            {
-                wxDataViewTreeNode* currentNode = nodes[i];
-                if (currentNode->GetItem() == parentChain[iter])
-                {
-                    if (currentNode->GetItem() == item)
-                        return currentNode;
+    // Realize the missing part of the chain, if any.
+    for ( size_t iter = parentChain.size(); iter > 0; --iter )
+    {
+        if ( !node->HasChildren() )
+            return NULL;
 
-                    node = currentNode;
-                    found = true;
-                    break;
-                }
-            }
-            if (!found)
-                return NULL;
+        if ( node->GetChildNodes().empty() )
+        {
+            // Even though the item is a container, it doesn't have any
+            // child nodes in the control's representation yet. We have
+            // to realize its subtree now.
+            SortPrepare();
+            BuildTreeHelper(model, node->GetItem(), node);
         }
-        else
-            return NULL;
 
-        if ( !iter )
-            break;
+        // The children may be already in the tree, but not in the item map,
+        // and if they're in it, but without this item, this returns NULL.
+        IndexChildNodes(node);
+        node = FindIndexedTreeNode(parentChain[iter - 1]);
+        if ( !node )
+            return NULL;
     }
-    return NULL;
+
+    return node;
 }
 
 void wxDataViewMainWindow::HitTest( const wxPoint & point, wxDataViewItem & item,
@@ -3447,86 +3902,121 @@ int wxDataViewMainWindow::RecalculateCount() const
     }
 }
 
-class ItemToRowJob : public DoJob
+int wxDataViewMainWindow::GetRowByItem(const wxDataViewItem & item) const
 {
-public:
-    ItemToRowJob(const wxDataViewItem& item_, wxVector<wxDataViewItem>::reverse_iterator iter)
-        : m_iter(iter),
-        item(item_)
+    const wxDataViewModel * model = GetModel();
+    if( model == NULL )
+        return -1;
+
+    if (IsVirtualList())
     {
-        ret = -1;
+        return wxPtrToUInt( item.GetID() ) -1;
     }
-
-    // Maybe binary search will help to speed up this process
-    virtual int operator() ( wxDataViewTreeNode * node)
+    else
     {
-        ret ++;
-        if( node->GetItem() == item )
-        {
-            return DoJob::DONE;
-        }
+        if( !item.IsOk() )
+            return -1;
 
-        if( node->GetItem() == *m_iter )
-        {
-            m_iter++;
-            return DoJob::CONTINUE;
-        }
-        else
-        {
-            ret += node->GetSubTreeCount();
-            return DoJob::SKIP_SUBTREE;
-        }
+        const wxDataViewTreeNode * const node = GetTreeNodeByItem(item);
+        if ( !node )
+            return -1;
 
+        return GetRowByTreeNode(node);
     }
+}
 
-    // the row number is begin from zero
-    int GetResult() const
-        { return ret -1; }
+int wxDataViewMainWindow::GetRowByTreeNode(const wxDataViewTreeNode * node) const
+{
+    // Sum the offsets of the node and all its parents relative to their own
+    // parents, this only takes O(depth) time.
+    int row = -1;
+    for ( ; node != m_root; node = node->GetParent() )
+    {
+        if ( !node->GetParent()->IsOpen() )
+            return -1;
 
-private:
-    wxVector<wxDataViewItem>::reverse_iterator m_iter;
-    wxDataViewItem item;
-    int ret;
+        row += node->GetRowOffset();
+    }
 
-};
+    return row;
+}
 
-int wxDataViewMainWindow::GetRowByItem(const wxDataViewItem & item) const
+wxDataViewTreeNode *
+wxDataViewMainWindow::GetTreeNodeByItem(const wxDataViewItem & item) const
 {
-    const wxDataViewModel * model = GetModel();
-    if( model == NULL )
-        return -1;
+    if ( !item.IsOk() )
+        return m_root;
 
-    if (IsVirtualList())
+    wxDataViewTreeNode * const node = FindIndexedTreeNode(item);
+    if ( node || !GetModel() )
+        return node;
+
+    // The node may exist but not be indexed yet, look for it among the
+    // children of its parent node, if the parent itself is in the tree.
+    wxDataViewTreeNode * const
+        parentNode = GetTreeNodeByItem(GetModel()->GetParent(item));
+    if ( !parentNode || !IndexChildNodes(parentNode) )
+        return NULL;
+
+    return FindIndexedTreeNode(item);
+}
+
+wxDataViewTreeNode *
+wxDataViewMainWindow::FindIndexedTreeNode(const wxDataViewItem & item) const
+{
+    if ( !item.IsOk() )
+        return m_root;
+
+    wxDataViewItemNodeMap::const_iterator it = m_itemNodes.find(item.GetID());
+    return it == m_itemNodes.end() ? NULL : it->second;
+}
+
+bool wxDataViewMainWindow::IndexChildNodes(wxDataViewTreeNode * node) const
+{
+    if ( !node->HasChildren() || node->AreChildrenIndexed() )
+        return false;
+
+    // This only updates the cache used for finding the nodes, so it's fine to
+    // do it even in a const method.
+    wxDataViewMainWindow * const self = const_cast<wxDataViewMainWindow *>(this);
+
+    const wxDataViewTreeNodes& nodes = node->GetChildNodes();
+    for ( wxDataViewTreeNodes::const_iterator i = nodes.begin();
+          i != nodes.end();
+          ++i )
     {
-        return wxPtrToUInt( item.GetID() ) -1;
+        self->RegisterTreeNode(*i);
     }
-    else
-    {
-        if( !item.IsOk() )
-            return -1;
 
-        // Compose the parent-chain of the item we are looking for
-        wxVector<wxDataViewItem> parentChain;
-        wxDataViewItem it( item );
-        while( it.IsOk() )
-        {
-            parentChain.push_back(it);
-            it = model->GetParent(it);
-        }
+    node->SetChildrenIndexed();
 
-        // add an 'invalid' item to represent our 'invisible' root node
-        parentChain.push_back(wxDataViewItem());
+    return true;
+}
 
-        // the parent chain was created by adding the deepest parent first.
-        // so if we want to start at the root node, we have to iterate backwards through the vector
-        ItemToRowJob job( item, parentChain.rbegin() );
-        Walker( m_root, job );
-        return job.GetResult();
+void wxDataViewMainWindow::RegisterTreeNode(wxDataViewTreeNode * node)
+{
+    m_itemNodes[node->GetItem().GetID()] = node;
+}
+
+void wxDataViewMainWindow::UnregisterTreeNode(wxDataViewTreeNode * node)
+{
+    m_itemNodes.erase(node->GetItem().GetID());
+
+    if ( node->HasChildren() )
+    {
+        const wxDataViewTreeNodes& nodes = node->GetChildNodes();
+        for ( wxDataViewTreeNodes::const_iterator i = nodes.begin();
+              i != nodes.end();
+              ++i )
+        {
+            UnregisterTreeNode(*i);
+        }
     }
 }
 
-static void BuildTreeHelper( const wxDataViewModel * model,  const wxDataViewItem & item,
-                             wxDataViewTreeNode * node)
+void wxDataViewMainWindow::BuildTreeHelper( const wxDataViewModel * model,
+                                            const wxDataViewItem & item,
+                                            wxDataViewTreeNode * node )
 {
     if( !model->IsContainer( item ) )
         return;
@@ -3534,6 +4024,11 @@ static void BuildTreeHelper( const wxDataViewModel * model,  const wxDataViewIte
     wxDataViewItemArray children;
     unsigned int num = model->GetChildren( item, children);
 
+    // Don't use InsertChild() as it would resort the children after adding
+    // each of them. Also note that the new nodes are only added to the item
+    // map by IndexChildNodes() when one of them is looked up, as creating a
+    // lot of them, e.g. when the model is cleared, must be as fast as possible.
+    node->ReserveChildren(num);
     for ( unsigned int index = 0; index < num; index++ )
     {
         wxDataViewTreeNode *n = new wxDataViewTreeNode(node, children[index]);
@@ -3541,9 +4036,11 @@ static void BuildTreeHelper( const wxDataViewModel * model,  const wxDataViewIte
         if( model->IsContainer(children[index]) )
             n->SetHasChildren( true );
 
-        node->InsertChild(n, index);
+        node->AppendChild(n);
     }
 
+    node->Resort();
+
     wxASSERT( node->IsOpen() );
     node->ChangeSubTreeCount(+num);
 }
@@ -3563,12 +4060,15 @@ void wxDataViewMainWindow::BuildTree(wxDataViewModel * model)
     // First we define a invalid item to fetch the top-level elements
     wxDataViewItem item;
     SortPrepare();
-    BuildTreeHelper( model, item, m_root);
+    BuildTreeHelper(model, item, m_root);
     m_count = -1;
 }
 
 void wxDataViewMainWindow::DestroyTree()
 {
+    m_rowHeights.Invalidate();
+    m_itemNodes.clear();
+
     if (!IsVirtualList())
     {
         wxDELETE(m_root);
@@ -616,13 +616,14 @@ void wxGridCellAttrData::SetAttr(wxGridCellAttr *attr, int row, int col)
     // Note: contrary to wxGridRowOrColAttrData::SetAttr, we must not
     //       touch attribute's reference counting explicitly, since this
     //       is managed by class wxGridCellWithAttr
-    int n = FindIndex(row, col);
+    size_t pos;
+    int n = FindIndex(row, col, &pos);
     if ( n == wxNOT_FOUND )
     {
         if ( attr )
         {
-            // add the attribute
-            m_attrs.Add(new wxGridCellWithAttr(row, col, attr));
+            // add the attribute at the position keeping the array sorted
+            m_attrs.Insert(new wxGridCellWithAttr(row, col, attr), pos);
         }
         //else: nothing to do
     }
@@ -657,76 +658,91 @@ wxGridCellAttr *wxGridCellAttrData::GetAttr(int row, int col) const
 
 void wxGridCellAttrData::UpdateAttrRows( size_t pos, int numRows )
 {
+    // As the array is sorted by rows first, all the attributes affected by
+    // this change are in its tail starting at the first row >= pos.
+    size_t n = LowerBound((int)pos, 0);
     size_t count = m_attrs.GetCount();
-    for ( size_t n = 0; n < count; n++ )
+
+    if ( numRows < 0 )
     {
-        wxGridCellCoords& coords = m_attrs[n].coords;
-        wxCoord row = coords.GetRow();
-        if ((size_t)row >= pos)
+        // Remove the attributes of the deleted rows in one go: they also
+        // form a contiguous range.
+        const size_t end = LowerBound((int)pos - numRows, 0);
+        if ( end > n )
         {
-            if (numRows > 0)
-            {
-                // If rows inserted, include row counter where necessary
-                coords.SetRow(row + numRows);
-            }
-            else if (numRows < 0)
-            {
-                // If rows deleted ...
-                if ((size_t)row >= pos - numRows)
-                {
-                    // ...either decrement row counter (if row still exists)...
-                    coords.SetRow(row + numRows);
-                }
-                else
-                {
-                    // ...or remove the attribute
-                    m_attrs.RemoveAt(n);
-                    n--;
-                    count--;
-                }
-            }
+            m_attrs.RemoveAt(n, end - n);
+            count -= end - n;
         }
     }
+
+    // Shifting all rows by the same offset preserves the sort order.
+    for ( ; n < count; n++ )
+    {
+        wxGridCellCoords& coords = m_attrs[n].coords;
+        coords.SetRow(coords.GetRow() + numRows);
+    }
 }
 
 void wxGridCellAttrData::UpdateAttrCols( size_t pos, int numCols )
 {
-    size_t count = m_attrs.GetCount();
+    // Notice that neither shifting the columns >= pos by the same offset nor
+    // removing some of them changes the relative order of the remaining
+    // attributes, so the array stays sorted.
+    //
+    // The attributes of the deleted columns are scattered over the entire
+    // array, so compact it in a single pass instead of removing them one by
+    // one: "n" is the index of the attribute being examined and "kept" is the
+    // number of the attributes we keep.
+    const size_t count = m_attrs.GetCount();
+    size_t kept = 0;
     for ( size_t n = 0; n < count; n++ )
     {
         wxGridCellCoords& coords = m_attrs[n].coords;
         wxCoord col = coords.GetCol();
         if ( (size_t)col >= pos )
         {
-            if ( numCols > 0 )
-            {
-                // If rows inserted, include row counter where necessary
-                coords.SetCol(col + numCols);
-            }
-            else if (numCols < 0)
-            {
-                // If rows deleted ...
-                if ((size_t)col >= pos - numCols)
-                {
-                    // ...either decrement row counter (if row still exists)...
-                    coords.SetCol(col + numCols);
-                }
-                else
-                {
-                    // ...or remove the attribute
-                    m_attrs.RemoveAt(n);
-                    n--;
-                    count--;
-                }
-            }
+            // Remove the attribute if its column was deleted.
+            if ( numCols < 0 && (size_t)col < pos - numCols )
+                continue;
+
+            coords.SetCol(col + numCols);
         }
+
+        if ( kept != n )
+            m_attrs[kept] = m_attrs[n];
+
+        kept++;
     }
+
+    if ( kept < count )
+        m_attrs.RemoveAt(kept, count - kept);
 }
 
-int wxGridCellAttrData::FindIndex(int row, int col) const
+size_t wxGridCellAttrData::LowerBound(int row, int col) const
 {
-    size_t count = m_attrs.GetCount();
-    for ( size_t n = 0; n < count; n++ )
+    size_t lo = 0,
+           hi = m_attrs.GetCount();
+    while ( lo < hi )
+    {
+        const size_t mid = lo + (hi - lo) / 2;
+        const wxGridCellCoords& coords = m_attrs[mid].coords;
+        if ( coords.GetRow() < row ||
+                (coords.GetRow() == row && coords.GetCol() < col) )
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+int wxGridCellAttrData::FindIndex(int row, int col, size_t *pos) const
+{
+    const size_t n = LowerBound(row, col);
+    if ( pos )
+        *pos = n;
+
+    if ( n < m_attrs.GetCount() )
     {
         const wxGridCellCoords& coords = m_attrs[n].coords;
         if ( (coords.GetRow() == row) && (coords.GetCol() == col) )
@@ -34,6 +34,7 @@
     #include "wx/math.h"
     #include "wx/settings.h"
     #include "wx/sizer.h"
+    #include "wx/utils.h"
 #endif
 
 #include "wx/imaglist.h"
@@ -632,6 +633,15 @@ void wxListLineData::SetText( int index, const wxString& s )
     }
 }
 
+const wxString& wxListLineData::GetLabel() const
+{
+    static const wxString s_emptyLabel;
+
+    wxListItemDataList::compatibility_iterator node = m_items.GetFirst();
+
+    return node ? node->GetData()->GetText() : s_emptyLabel;
+}
+
 void wxListLineData::SetImage( int index, int image )
 {
     wxListItemDataList::compatibility_iterator node = m_items.Item( index );
@@ -3284,9 +3294,17 @@ void wxListMainWindow::SetItem( wxListItem &item )
 
     if ( !IsVirtual() )
     {
+        const bool labelChanged = item.m_col == 0 &&
+                                    (item.m_mask & wxLIST_MASK_TEXT);
+        if ( labelChanged )
+            RemoveFromFindIndex((size_t)id, false);
+
         wxListLineData *line = GetLine((size_t)id);
         line->SetItem( item.m_col, item );
 
+        if ( labelChanged )
+            AddToFindIndex((size_t)id, false);
+
         // Set item state if user wants
         if ( item.m_mask & wxLIST_MASK_STATE )
             SetItemState( item.m_itemId, item.m_state, item.m_state );
@@ -3956,6 +3974,7 @@ void wxListMainWindow::DeleteItem( long lindex )
     }
     else
     {
+        RemoveFromFindIndex(index, true);
         m_lines.RemoveAt( index );
     }
 
@@ -3975,6 +3994,10 @@ void wxListMainWindow::DeleteColumn( int col )
     delete node->GetData();
     m_columns.Erase( node );
 
+    // the labels of the items are their values in the first column
+    if ( col == 0 )
+        ResetFindIndex();
+
     if ( !IsVirtual() )
     {
         // update all the items
@@ -4044,6 +4067,7 @@ void wxListMainWindow::DoDeleteAllItems()
         }
     }
 
+    ResetFindIndex();
     m_lines.Clear();
 }
 
@@ -4066,6 +4090,54 @@ void wxListMainWindow::DeleteEverything()
 // scanning for an item
 // ----------------------------------------------------------------------------
 
+// Compare the labels ignoring case in the same way as comparing their Lower()
+// versions would do it but without allocating any memory. If prefix is true,
+// return 0 if the first label starts with the second one.
+static int CompareLabelsNoCase(const wxString& label1,
+                               const wxString& label2,
+                               bool prefix = false)
+{
+    wxString::const_iterator it1 = label1.begin();
+    const wxString::const_iterator end1 = label1.end();
+    for ( wxString::const_iterator it2 = label2.begin();
+          it2 != label2.end();
+          ++it1, ++it2 )
+    {
+        if ( it1 == end1 )
+            return -1;
+
+        // avoid the relatively expensive case conversion if possible
+        if ( *it1 == *it2 )
+            continue;
+
+        const wxUniChar::value_type ch1 = wxTolower(*it1).GetValue(),
+                                    ch2 = wxTolower(*it2).GetValue();
+        if ( ch1 != ch2 )
+            return ch1 < ch2 ? -1 : 1;
+    }
+
+    return prefix || it1 == end1 ? 0 : 1;
+}
+
+// Compare two entries of wxListMainWindow::m_findIndex, i.e. indices in the
+// array of lines passed as the user data.
+static int CompareFindIndexEntries(const void *entry1,
+                                   const void *entry2,
+                                   const void *data)
+{
+    const wxListLineDataArray&
+        lines = *static_cast<const wxListLineDataArray *>(data);
+    const size_t line1 = *static_cast<const size_t *>(entry1),
+                 line2 = *static_cast<const size_t *>(entry2);
+
+    const int rc = CompareLabelsNoCase(lines[line1].GetLabel(),
+                                       lines[line2].GetLabel());
+    if ( rc )
+        return rc;
+
+    return line1 < line2 ? -1 : line1 > line2;
+}
+
 void wxListMainWindow::EnsureVisible( long index )
 {
     wxCHECK_RET( index >= 0 && (size_t)index < GetItemCount(),
@@ -4085,28 +4157,208 @@ long wxListMainWindow::FindItem(long start, const wxString& str, bool partial )
         return wxNOT_FOUND;
 
     long pos = start;
-    wxString str_upper = str.Upper();
     if (pos < 0)
         pos = 0;
 
-    size_t count = GetItemCount();
-    for ( size_t i = (size_t)pos; i < count; i++ )
+    const size_t line = FindLabel(str, (size_t)pos, partial, false);
+    if ( line == (size_t)-1 )
+        return wxNOT_FOUND;
+
+    return line;
+}
+
+size_t wxListMainWindow::FindLabel(const wxString& str,
+                                   size_t start,
+                                   bool partial,
+                                   bool wrap) const
+{
+    const size_t count = GetItemCount();
+
+    if ( IsVirtual() )
     {
-        wxListLineData *line = GetLine(i);
-        wxString line_upper = line->GetText(0).Upper();
-        if (!partial)
+        // we can't index the items we don't have, so just check all of them
+        for ( size_t i = start; i < count; i++ )
         {
-            if (line_upper == str_upper )
+            if ( !CompareLabelsNoCase(GetLine(i)->GetLabel(), str, partial) )
                 return i;
         }
+
+        if ( wrap )
+        {
+            for ( size_t i = 0; i < start && i < count; i++ )
+            {
+                if ( !CompareLabelsNoCase(GetLine(i)->GetLabel(), str, partial) )
+                    return i;
+            }
+        }
+
+        return (size_t)-1;
+    }
+
+    wxConstCast(this, wxListMainWindow)->BuildFindIndex();
+
+    // all the matching lines are consecutive in the index, starting with the
+    // ones with the label equal to str, if any, in the increasing order
+    const size_t size = m_findIndex.size();
+    if ( !partial )
+    {
+        size_t pos = FindIndexLowerBound(str, start);
+        if ( pos == size ||
+                CompareLabelsNoCase(m_lines[m_findIndex[pos]].GetLabel(), str) )
+        {
+            if ( !wrap )
+                return (size_t)-1;
+
+            pos = FindIndexLowerBound(str, 0);
+            if ( pos == size ||
+                    CompareLabelsNoCase(m_lines[m_findIndex[pos]].GetLabel(), str) )
+                return (size_t)-1;
+        }
+
+        return m_findIndex[pos];
+    }
+
+    // the lines starting with str are not ordered by their indices, so we'd
+    // need to check all of them to find the first one after start, which is
+    // slow if there are many of them, as is typically the case for the short
+    // prefixes used by the incremental search
+    const size_t begin = FindIndexLowerBound(str, 0),
+                 end = FindIndexPrefixEnd(str);
+    if ( begin == end )
+        return (size_t)-1;
+
+    if ( start >= count )
+    {
+        if ( !wrap )
+            return (size_t)-1;
+
+        start = 0;
+    }
+
+    // but in this case one of them is also likely to be found soon after
+    // start, so try checking the lines themselves first, but not more of them
+    // than there are matching lines in the index
+    const size_t numMatches = end - begin,
+                 numLines = wrap ? count : count - start;
+    for ( size_t n = 0; n < numMatches && n < numLines; n++ )
+    {
+        const size_t line = (start + n) % count;
+        if ( !CompareLabelsNoCase(m_lines[line].GetLabel(), str, true) )
+            return line;
+    }
+
+    if ( numMatches >= numLines )
+    {
+        // we've checked all the lines which could match already
+        return (size_t)-1;
+    }
+
+    size_t found = (size_t)-1,
+           first = (size_t)-1;
+    for ( size_t pos = begin; pos < end; pos++ )
+    {
+        const size_t line = m_findIndex[pos];
+        if ( line >= start && line < found )
+            found = line;
+
+        if ( line < first )
+            first = line;
+    }
+
+    return found == (size_t)-1 && wrap ? first : found;
+}
+
+void wxListMainWindow::BuildFindIndex()
+{
+    const size_t count = m_lines.GetCount();
+    if ( !m_findIndex.empty() || !count )
+        return;
+
+    m_findIndex.reserve(count);
+    for ( size_t i = 0; i < count; i++ )
+        m_findIndex.push_back(i);
+
+    wxQsort(&m_findIndex[0], count, sizeof(size_t),
+            CompareFindIndexEntries, &m_lines);
+}
+
+size_t
+wxListMainWindow::FindIndexLowerBound(const wxString& label, size_t line) const
+{
+    size_t lo = 0,
+           hi = m_findIndex.size();
+    while ( lo < hi )
+    {
+        const size_t mid = lo + (hi - lo) / 2;
+        const size_t lineMid = m_findIndex[mid];
+
+        const int rc = CompareLabelsNoCase(m_lines[lineMid].GetLabel(), label);
+        if ( rc < 0 || (rc == 0 && lineMid < line) )
+            lo = mid + 1;
         else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+size_t wxListMainWindow::FindIndexPrefixEnd(const wxString& prefix) const
+{
+    size_t lo = 0,
+           hi = m_findIndex.size();
+    while ( lo < hi )
+    {
+        const size_t mid = lo + (hi - lo) / 2;
+        if ( CompareLabelsNoCase(m_lines[m_findIndex[mid]].GetLabel(),
+                                 prefix, true) <= 0 )
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+void wxListMainWindow::AddToFindIndex(size_t line, bool isNew)
+{
+    if ( m_findIndex.empty() )
+        return;
+
+    // there is nothing to update when appending
+    if ( isNew && line + 1 < m_lines.GetCount() )
+    {
+        // the lines after the inserted one have been shifted
+        for ( size_t i = 0; i < m_findIndex.size(); i++ )
         {
-            if (line_upper.find(str_upper) == 0)
-                return i;
+            if ( m_findIndex[i] >= line )
+                m_findIndex[i]++;
         }
     }
 
-    return wxNOT_FOUND;
+    const size_t pos = FindIndexLowerBound(m_lines[line].GetLabel(), line);
+    m_findIndex.insert(m_findIndex.begin() + pos, line);
+}
+
+void wxListMainWindow::RemoveFromFindIndex(size_t line, bool isDeleted)
+{
+    if ( m_findIndex.empty() )
+        return;
+
+    const size_t pos = FindIndexLowerBound(m_lines[line].GetLabel(), line);
+    wxCHECK_RET( pos < m_findIndex.size() && m_findIndex[pos] == line,
+                 wxT("line not found in the index") );
+
+    m_findIndex.erase(m_findIndex.begin() + pos);
+
+    if ( isDeleted )
+    {
+        // the lines after the deleted one are going to be shifted
+        for ( size_t i = 0; i < m_findIndex.size(); i++ )
+        {
+            if ( m_findIndex[i] > line )
+                m_findIndex[i]--;
+        }
+    }
 }
 
 long wxListMainWindow::FindItem(long start, wxUIntPtr data)
@@ -4227,6 +4479,7 @@ void wxListMainWindow::InsertItem( wxListItem &item )
     }
 
     m_lines.Insert( line, id );
+    AddToFindIndex(id, true);
 
     m_dirty = true;
 
@@ -4262,6 +4515,10 @@ long wxListMainWindow::InsertColumn( long col, const wxListItem &item )
             m_columns.Insert( node, column );
             m_aColWidths.Insert( colWidthInfo, col );
             idx = col;
+
+            // the labels of the items are their values in the first column
+            if ( col == 0 )
+                ResetFindIndex();
         }
         else
         {
@@ -4343,6 +4600,7 @@ void wxListMainWindow::SortItems( wxListCtrlCompare fn, wxIntPtr data )
     list_ctrl_compare_func_2 = fn;
     list_ctrl_compare_data = data;
     m_lines.Sort( list_ctrl_compare_func_1 );
+    ResetFindIndex();
     m_dirty = true;
 }
 
@@ -4426,51 +4684,24 @@ wxListMainWindow::PrefixFindItem(size_t idParent,
     if ( idParent == (size_t)-1 )
         return idParent;
 
-    // match is case insensitive as this is more convenient to the user: having
-    // to press Shift-letter to go to the item starting with a capital letter
-    // would be too bothersome
-    wxString prefix = prefixOrig.Lower();
-
     // determine the starting point: we shouldn't take the current item (this
     // allows to switch between two items starting with the same letter just by
     // pressing it) but we shouldn't jump to the next one if the user is
     // continuing to type as otherwise he might easily skip the item he wanted
     size_t itemid = idParent;
-    if ( prefix.length() == 1 )
+    if ( prefixOrig.length() == 1 )
     {
         itemid += 1;
     }
 
-    // look for the item starting with the given prefix after it
-    while ( ( itemid < (size_t)GetItemCount() ) &&
-            !GetLine(itemid)->GetText(0).Lower().StartsWith(prefix) )
-    {
-        itemid += 1;
-    }
-
-    // if we haven't found anything...
-    if ( !( itemid < (size_t)GetItemCount() ) )
-    {
-        // ... wrap to the beginning
-        itemid = 0;
-
-        // and try all the items (stop when we get to the one we started from)
-        while ( ( itemid < (size_t)GetItemCount() ) && itemid != idParent &&
-                    !GetLine(itemid)->GetText(0).Lower().StartsWith(prefix) )
-        {
-            itemid += 1;
-        }
-        // If we haven't found the item, id will be (size_t)-1, as per
-        // documentation
-        if ( !( itemid < (size_t)GetItemCount() ) ||
-             ( ( itemid == idParent ) &&
-               !GetLine(itemid)->GetText(0).Lower().StartsWith(prefix) ) )
-        {
-            itemid = (size_t)-1;
-        }
-    }
-
-    return itemid;
+    // look for the item starting with the given prefix after it and wrap to
+    // the beginning if we don't find anything, the result will be (size_t)-1,
+    // as per documentation, if there is no such item at all
+    //
+    // notice that the match is case insensitive as this is more convenient to
+    // the user: having to press Shift-letter to go to the item starting with a
+    // capital letter would be too bothersome
+    return FindLabel(prefixOrig, itemid, true /* partial */, true /* wrap */);
 }
 
 // -------------------------------------------------------------------------------------
@@ -253,20 +253,16 @@ public:
         { DoCalculateSize(control, dc, true /* dc uses normal font */); }
     void CalculateSize(wxGenericTreeCtrl *control);
 
-    void GetSize( int &x, int &y, const wxGenericTreeCtrl* );
-
     void ResetSize() { m_width = 0; }
     void ResetTextSize() { m_width = 0; m_widthText = -1; }
     void RecursiveResetSize();
     void RecursiveResetTextSize();
 
-        // return the item at given position (or NULL if no item), onButton is
-        // true if the point belongs to the item's button, otherwise it lies
-        // on the item's label
+        // return this item if it is at the given position (or NULL if it
+        // isn't) and set the flags indicating which part of it is there
     wxGenericTreeItem *HitTest( const wxPoint& point,
                                 const wxGenericTreeCtrl *,
-                                int &flags,
-                                int level );
+                                int &flags );
 
     void Expand() { m_isCollapsed = false; }
     void Collapse() { m_isCollapsed = true; }
@@ -644,119 +640,81 @@ size_t wxGenericTreeItem::GetChildrenCount(bool recursively) const
     return total;
 }
 
-void wxGenericTreeItem::GetSize( int &x, int &y,
-                                 const wxGenericTreeCtrl *theButton )
-{
-    int bottomY=m_y+theButton->GetLineHeight(this);
-    if ( y < bottomY ) y = bottomY;
-    int width = m_x +  m_width;
-    if ( x < width ) x = width;
-
-    if (IsExpanded())
-    {
-        size_t count = m_children.GetCount();
-        for ( size_t n = 0; n < count; ++n )
-        {
-            m_children[n]->GetSize( x, y, theButton );
-        }
-    }
-}
-
 wxGenericTreeItem *wxGenericTreeItem::HitTest(const wxPoint& point,
                                               const wxGenericTreeCtrl *theCtrl,
-                                              int &flags,
-                                              int level)
+                                              int &flags)
 {
-    // for a hidden root node, don't evaluate it, but do evaluate children
-    if ( !(level == 0 && theCtrl->HasFlag(wxTR_HIDE_ROOT)) )
+    // evaluate the item
+    int h = theCtrl->GetLineHeight(this);
+    if ((point.y > m_y) && (point.y < m_y + h))
     {
-        // evaluate the item
-        int h = theCtrl->GetLineHeight(this);
-        if ((point.y > m_y) && (point.y < m_y + h))
-        {
-            int y_mid = m_y + h/2;
-            if (point.y < y_mid )
-                flags |= wxTREE_HITTEST_ONITEMUPPERPART;
-            else
-                flags |= wxTREE_HITTEST_ONITEMLOWERPART;
+        int y_mid = m_y + h/2;
+        if (point.y < y_mid )
+            flags |= wxTREE_HITTEST_ONITEMUPPERPART;
+        else
+            flags |= wxTREE_HITTEST_ONITEMLOWERPART;
 
-            int xCross = m_x - theCtrl->GetSpacing();
+        int xCross = m_x - theCtrl->GetSpacing();
 #ifdef __WXMAC__
-            // according to the drawing code the triangels are drawn
-            // at -4 , -4  from the position up to +10/+10 max
-            if ((point.x > xCross-4) && (point.x < xCross+10) &&
-                (point.y > y_mid-4) && (point.y < y_mid+10) &&
-                HasPlus() && theCtrl->HasButtons() )
+        // according to the drawing code the triangels are drawn
+        // at -4 , -4  from the position up to +10/+10 max
+        if ((point.x > xCross-4) && (point.x < xCross+10) &&
+            (point.y > y_mid-4) && (point.y < y_mid+10) &&
+            HasPlus() && theCtrl->HasButtons() )
 #else
-            // 5 is the size of the plus sign
-            if ((point.x > xCross-6) && (point.x < xCross+6) &&
-                (point.y > y_mid-6) && (point.y < y_mid+6) &&
-                HasPlus() && theCtrl->HasButtons() )
+        // 5 is the size of the plus sign
+        if ((point.x > xCross-6) && (point.x < xCross+6) &&
+            (point.y > y_mid-6) && (point.y < y_mid+6) &&
+            HasPlus() && theCtrl->HasButtons() )
 #endif
-            {
-                flags |= wxTREE_HITTEST_ONITEMBUTTON;
-                return this;
-            }
-
-            if ((point.x >= m_x) && (point.x <= m_x+m_width))
-            {
-                int image_w = -1;
-                int image_h;
-
-                // assuming every image (normal and selected) has the same size!
-                if ( (GetImage() != NO_IMAGE) && theCtrl->m_imageListNormal )
-                {
-                    theCtrl->m_imageListNormal->GetSize(GetImage(),
-                                                        image_w, image_h);
-                }
+        {
+            flags |= wxTREE_HITTEST_ONITEMBUTTON;
+            return this;
+        }
 
-                int state_w = -1;
-                int state_h;
+        if ((point.x >= m_x) && (point.x <= m_x+m_width))
+        {
+            int image_w = -1;
+            int image_h;
 
-                if ( (GetState() != wxTREE_ITEMSTATE_NONE) &&
-                        theCtrl->m_imageListState )
-                {
-                    theCtrl->m_imageListState->GetSize(GetState(),
-                                                       state_w, state_h);
-                }
+            // assuming every image (normal and selected) has the same size!
+            if ( (GetImage() != NO_IMAGE) && theCtrl->m_imageListNormal )
+            {
+                theCtrl->m_imageListNormal->GetSize(GetImage(),
+                                                    image_w, image_h);
+            }
 
-                if ((state_w != -1) && (point.x <= m_x + state_w + 1))
-                    flags |= wxTREE_HITTEST_ONITEMSTATEICON;
-                else if ((image_w != -1) &&
-                         (point.x <= m_x +
-                            (state_w != -1 ? state_w +
-                                                MARGIN_BETWEEN_STATE_AND_IMAGE
-                                           : 0)
-                                            + image_w + 1))
-                    flags |= wxTREE_HITTEST_ONITEMICON;
-                else
-                    flags |= wxTREE_HITTEST_ONITEMLABEL;
+            int state_w = -1;
+            int state_h;
 
-                return this;
+            if ( (GetState() != wxTREE_ITEMSTATE_NONE) &&
+                    theCtrl->m_imageListState )
+            {
+                theCtrl->m_imageListState->GetSize(GetState(),
+                                                   state_w, state_h);
             }
 
-            if (point.x < m_x)
-                flags |= wxTREE_HITTEST_ONITEMINDENT;
-            if (point.x > m_x+m_width)
-                flags |= wxTREE_HITTEST_ONITEMRIGHT;
+            if ((state_w != -1) && (point.x <= m_x + state_w + 1))
+                flags |= wxTREE_HITTEST_ONITEMSTATEICON;
+            else if ((image_w != -1) &&
+                     (point.x <= m_x +
+                        (state_w != -1 ? state_w +
+                                            MARGIN_BETWEEN_STATE_AND_IMAGE
+                                       : 0)
+                                        + image_w + 1))
+                flags |= wxTREE_HITTEST_ONITEMICON;
+            else
+                flags |= wxTREE_HITTEST_ONITEMLABEL;
 
             return this;
         }
 
-        // if children are expanded, fall through to evaluate them
-        if (m_isCollapsed) return NULL;
-    }
+        if (point.x < m_x)
+            flags |= wxTREE_HITTEST_ONITEMINDENT;
+        if (point.x > m_x+m_width)
+            flags |= wxTREE_HITTEST_ONITEMRIGHT;
 
-    // evaluate children
-    size_t count = m_children.GetCount();
-    for ( size_t n = 0; n < count; n++ )
-    {
-        wxGenericTreeItem *res = m_children[n]->HitTest( point,
-                                                         theCtrl,
-                                                         flags,
-                                                         level + 1 );
-        if ( res != NULL )
-            return res;
+        return this;
     }
 
     return NULL;
@@ -925,6 +883,9 @@ void wxGenericTreeCtrl::Init()
     m_indent = 15;
     m_spacing = 18;
 
+    m_firstDirtyLine = (size_t)-1;
+    m_linesLineHeight = 0;
+
     m_hilightBrush = new wxBrush
                          (
                             wxSystemSettings::GetColour
@@ -1076,6 +1037,7 @@ void wxGenericTreeCtrl::SetIndent(unsigned int indent)
 {
     m_indent = (unsigned short) indent;
     m_dirty = true;
+    InvalidateLines();
 }
 
 size_t
@@ -1103,6 +1065,7 @@ void wxGenericTreeCtrl::SetWindowStyle(const long styles)
     // none of the parents has updatable styles
     m_windowStyle = styles;
     m_dirty = true;
+    InvalidateLines();
 }
 
 // -----------------------------------------------------------------------------
@@ -1171,7 +1134,7 @@ wxGenericTreeCtrl::SetItemText(const wxTreeItemId& item, const wxString& text)
 
     wxGenericTreeItem *pItem = (wxGenericTreeItem*) item.m_pItem;
     pItem->SetText(text);
-    pItem->CalculateSize(this);
+    RecalculateItemSize(pItem);
     RefreshLine(pItem);
 }
 
@@ -1183,7 +1146,7 @@ void wxGenericTreeCtrl::SetItemImage(const wxTreeItemId& item,
 
     wxGenericTreeItem *pItem = (wxGenericTreeItem*) item.m_pItem;
     pItem->SetImage(image, which);
-    pItem->CalculateSize(this);
+    RecalculateItemSize(pItem);
     RefreshLine(pItem);
 }
 
@@ -1204,7 +1167,7 @@ void wxGenericTreeCtrl::DoSetItemState(const wxTreeItemId& item, int state)
 
     wxGenericTreeItem *pItem = (wxGenericTreeItem*) item.m_pItem;
     pItem->SetState(state);
-    pItem->CalculateSize(this);
+    RecalculateItemSize(pItem);
     RefreshLine(pItem);
 }
 
@@ -1229,7 +1192,7 @@ void wxGenericTreeCtrl::SetItemBold(const wxTreeItemId& item, bool bold)
 
         // recalculate the item size as bold and non bold fonts have different
         // widths
-        pItem->CalculateSize(this);
+        RecalculateItemSize(pItem);
         RefreshLine(pItem);
     }
 }
@@ -1281,7 +1244,7 @@ wxGenericTreeCtrl::SetItemFont(const wxTreeItemId& item, const wxFont& font)
     wxGenericTreeItem *pItem = (wxGenericTreeItem*) item.m_pItem;
     pItem->Attr().SetFont(font);
     pItem->ResetTextSize();
-    pItem->CalculateSize(this);
+    RecalculateItemSize(pItem);
     RefreshLine(pItem);
 }
 
@@ -1295,6 +1258,8 @@ bool wxGenericTreeCtrl::SetFont( const wxFont &font )
     if (m_anchor)
         m_anchor->RecursiveResetTextSize();
 
+    InvalidateLines();
+
     return true;
 }
 
@@ -1650,8 +1615,24 @@ wxTreeItemId wxGenericTreeCtrl::DoInsertItem(const wxTreeItemId& parentId,
         data->m_pItem = item;
     }
 
-    parent->Insert( item, previous == (size_t)-1 ? parent->GetChildren().size()
-                                                 : previous );
+    const size_t index = previous == (size_t)-1 ? parent->GetChildren().size()
+                                                : previous;
+    parent->Insert( item, index );
+
+    // the new item is shown after the last shown descendant of its previous
+    // sibling or just after the parent if it's the first child
+    if ( IsItemShown(item) )
+    {
+        wxGenericTreeItem *itemBefore = parent;
+        if ( index > 0 )
+        {
+            itemBefore = parent->GetChildren()[index - 1];
+            while ( itemBefore->IsExpanded() && itemBefore->HasChildren() )
+                itemBefore = itemBefore->GetChildren().Last();
+        }
+
+        InvalidateLinesAfter(itemBefore);
+    }
 
     InvalidateBestSize();
     return item;
@@ -1668,6 +1649,8 @@ wxTreeItemId wxGenericTreeCtrl::AddRoot(const wxString& text,
 
     m_anchor = new wxGenericTreeItem(NULL, text,
                                    image, selImage, data);
+    InvalidateLines();
+
     if ( data != NULL )
     {
         data->m_pItem = m_anchor;
@@ -1758,6 +1741,8 @@ void wxGenericTreeCtrl::DeleteChildren(const wxTreeItemId& itemId)
 
     wxGenericTreeItem *item = (wxGenericTreeItem*) itemId.m_pItem;
     ChildrenClosing(item);
+    if ( item->IsExpanded() )
+        InvalidateLinesAfter(item);
     item->DeleteChildren(this);
     InvalidateBestSize();
 }
@@ -1816,6 +1801,7 @@ void wxGenericTreeCtrl::Delete(const wxTreeItemId& itemId)
     }
 
     // remove the item from the tree
+    InvalidateLinesFrom(item);
     if ( parent )
     {
         parent->GetChildren().Remove( item );  // remove by value
@@ -1824,6 +1810,8 @@ void wxGenericTreeCtrl::Delete(const wxTreeItemId& itemId)
     {
         // nothing will be left in the tree
         m_anchor = NULL;
+        m_lines.clear();
+        InvalidateLines();
     }
 
     // and delete all of its children and the item itself now
@@ -1869,6 +1857,7 @@ void wxGenericTreeCtrl::Expand(const wxTreeItemId& itemId)
     }
 
     item->Expand();
+    InvalidateLinesAfter(item);
     if ( !IsFrozen() )
     {
         CalculatePositions();
@@ -1903,6 +1892,7 @@ void wxGenericTreeCtrl::Collapse(const wxTreeItemId& itemId)
 
     ChildrenClosing(item);
     item->Collapse();
+    InvalidateLinesAfter(item);
 
 #if 0  // TODO why should items be collapsed recursively?
     wxArrayGenericTreeItems& children = item->GetChildren();
@@ -2352,6 +2342,8 @@ void wxGenericTreeCtrl::SortChildren(const wxTreeItemId& itemId)
     if ( children.GetCount() > 1 )
     {
         m_dirty = true;
+        if ( item->IsExpanded() )
+            InvalidateLinesAfter(item);
 
         s_treeBeingSorted = this;
         children.Sort(tree_ctrl_compare_func);
@@ -2419,6 +2411,7 @@ void wxGenericTreeCtrl::SetImageList(wxImageList *imageList)
     m_imageListNormal = imageList;
     m_ownsImageListNormal = false;
     m_dirty = true;
+    InvalidateLines();
 
     if (m_anchor)
         m_anchor->RecursiveResetSize();
@@ -2435,6 +2428,7 @@ void wxGenericTreeCtrl::SetStateImageList(wxImageList *imageList)
     m_imageListState = imageList;
     m_ownsImageListState = false;
     m_dirty = true;
+    InvalidateLines();
 
     if (m_anchor)
         m_anchor->RecursiveResetSize();
@@ -2451,6 +2445,7 @@ void wxGenericTreeCtrl::SetButtonsImageList(wxImageList *imageList)
     m_imageListButtons = imageList;
     m_ownsImageListButtons = false;
     m_dirty = true;
+    InvalidateLines();
 
     if (m_anchor)
         m_anchor->RecursiveResetSize();
@@ -2472,8 +2467,22 @@ void wxGenericTreeCtrl::AdjustMyScrollbars()
 {
     if (m_anchor)
     {
+        CalculatePositions();
+
         int x = 0, y = 0;
-        m_anchor->GetSize( x, y, this );
+        if ( !m_lines.empty() )
+        {
+            wxGenericTreeItem * const last = m_lines.back();
+            y = last->GetY() + GetLineHeight(last);
+
+            for ( size_t n = 0; n < m_lines.size(); n++ )
+            {
+                const int width = m_lines[n]->GetX() + m_lines[n]->GetWidth();
+                if ( x < width )
+                    x = width;
+            }
+        }
+
         y += PIXELS_PER_UNIT+2; // one more scrollbar unit + 2 pixels
         x += PIXELS_PER_UNIT+2; // one more scrollbar unit + 2 pixels
         int x_pos = GetScrollPos( wxHORIZONTAL );
@@ -2715,50 +2724,14 @@ void wxGenericTreeCtrl::PaintItem(wxGenericTreeItem *item, wxDC& dc)
     }
 }
 
-void
-wxGenericTreeCtrl::PaintLevel(wxGenericTreeItem *item,
-                              wxDC &dc,
-                              int level,
-                              int &y)
+void wxGenericTreeCtrl::PaintLine(wxGenericTreeItem *item, wxDC &dc)
 {
-    int x = level*m_indent;
-    if (!HasFlag(wxTR_HIDE_ROOT))
-    {
-        x += m_indent;
-    }
-    else if (level == 0)
-    {
-        // always expand hidden root
-        int origY = y;
-        wxArrayGenericTreeItems& children = item->GetChildren();
-        int count = children.GetCount();
-        if (count > 0)
-        {
-            int n = 0, oldY;
-            do {
-                oldY = y;
-                PaintLevel(children[n], dc, 1, y);
-            } while (++n < count);
-
-            if ( !HasFlag(wxTR_NO_LINES) && HasFlag(wxTR_LINES_AT_ROOT)
-                    && count > 0 )
-            {
-                // draw line down to last child
-                origY += GetLineHeight(children[0])>>1;
-                oldY += GetLineHeight(children[n-1])>>1;
-                dc.DrawLine(3, origY, 3, oldY);
-            }
-        }
-        return;
-    }
-
-    item->SetX(x+m_spacing);
-    item->SetY(y);
+    int x = item->GetX() - m_spacing;
 
     int h = GetLineHeight(item);
-    int y_top = y;
+    int y_top = item->GetY();
     int y_mid = y_top + (h>>1);
-    y += h;
+    int y = y_top + h;
 
     int exposed_x = dc.LogicalToDeviceX(0);
     int exposed_y = dc.LogicalToDeviceY(y_top);
@@ -2879,46 +2852,55 @@ wxGenericTreeCtrl::PaintLevel(wxGenericTreeItem *item,
             }
         }
     }
+}
 
-    if (item->IsExpanded())
+void wxGenericTreeCtrl::PaintChildrenLine(wxGenericTreeItem *item, wxDC &dc)
+{
+    if ( HasFlag(wxTR_NO_LINES) )
+        return;
+
+    const wxArrayGenericTreeItems& children = item->GetChildren();
+    if ( children.IsEmpty() )
+        return;
+
+    wxGenericTreeItem * const last = children.Last();
+    int y_end = last->GetY() + (GetLineHeight(last)>>1);
+
+    int x,
+        y_start;
+    if ( item == m_anchor && HasFlag(wxTR_HIDE_ROOT) )
     {
-        wxArrayGenericTreeItems& children = item->GetChildren();
-        int count = children.GetCount();
-        if (count > 0)
-        {
-            int n = 0, oldY;
-            ++level;
-            do {
-                oldY = y;
-                PaintLevel(children[n], dc, level, y);
-            } while (++n < count);
-
-            if (!HasFlag(wxTR_NO_LINES) && count > 0)
-            {
-                // draw line down to last child
-                oldY += GetLineHeight(children[n-1])>>1;
-                if (HasButtons()) y_mid += 5;
-
-                // Only draw the portion of the line that is visible, in case
-                // it is huge
-                wxCoord xOrigin=0, yOrigin=0, width, height;
-                dc.GetDeviceOrigin(&xOrigin, &yOrigin);
-                yOrigin = abs(yOrigin);
-                GetClientSize(&width, &height);
-
-                // Move end points to the beginning/end of the view?
-                if (y_mid < yOrigin)
-                    y_mid = yOrigin;
-                if (oldY > yOrigin + height)
-                    oldY = yOrigin + height;
-
-                // after the adjustments if y_mid is larger than oldY then the
-                // line isn't visible at all so don't draw anything
-                if (y_mid < oldY)
-                    dc.DrawLine(x, y_mid, x, oldY);
-            }
-        }
+        if ( !HasFlag(wxTR_LINES_AT_ROOT) )
+            return;
+
+        // draw line from the first top level item down to the last one
+        x = 3;
+        y_start = children[0]->GetY() + (GetLineHeight(children[0])>>1);
+    }
+    else
+    {
+        // draw line down to last child
+        x = item->GetX() - m_spacing;
+        y_start = item->GetY() + (GetLineHeight(item)>>1);
+        if (HasButtons()) y_start += 5;
     }
+
+    // Only draw the portion of the line that is visible, in case it is huge
+    wxCoord xOrigin=0, yOrigin=0, width, height;
+    dc.GetDeviceOrigin(&xOrigin, &yOrigin);
+    yOrigin = abs(yOrigin);
+    GetClientSize(&width, &height);
+
+    // Move end points to the beginning/end of the view?
+    if (y_start < yOrigin)
+        y_start = yOrigin;
+    if (y_end > yOrigin + height)
+        y_end = yOrigin + height;
+
+    // after the adjustments if y_start is larger than y_end then the line
+    // isn't visible at all so don't draw anything
+    if (y_start < y_end)
+        dc.DrawLine(x, y_start, x, y_end);
 }
 
 void wxGenericTreeCtrl::DrawDropEffect(wxGenericTreeItem *item)
@@ -3022,8 +3004,42 @@ void wxGenericTreeCtrl::OnPaint( wxPaintEvent &WXUNUSED(event) )
     //if(GetImageList() == NULL)
     // m_lineHeight = (int)(dc.GetCharHeight() + 4);
 
-    int y = 2;
-    PaintLevel( m_anchor, dc, 0, y );
+    CalculatePositions();
+    if ( m_lines.empty() )
+        return;
+
+    // only paint the lines intersecting the update region
+    wxRect rectUpdate = GetUpdateClientRect();
+    rectUpdate.SetPosition(CalcUnscrolledPosition(rectUpdate.GetPosition()));
+
+    int first = FindLineAbove(rectUpdate.GetTop() + 1);
+    if ( first == wxNOT_FOUND )
+        first = 0;
+
+    size_t n;
+    for ( n = first; n < m_lines.size(); n++ )
+    {
+        if ( m_lines[n]->GetY() > rectUpdate.GetBottom() )
+            break;
+
+        PaintLine(m_lines[n], dc);
+    }
+
+    // paint the vertical lines of all the items whose children are shown
+    // here: these are all the items painted above and also the parents of the
+    // first of them, even if they're themselves above the update region
+    for ( wxGenericTreeItem *parent = m_lines[first]->GetParent();
+          parent;
+          parent = parent->GetParent() )
+    {
+        PaintChildrenLine(parent, dc);
+    }
+
+    while ( n-- > (size_t)first )
+    {
+        if ( m_lines[n]->IsExpanded() )
+            PaintChildrenLine(m_lines[n], dc);
+    }
 }
 
 void wxGenericTreeCtrl::OnSetFocus( wxFocusEvent &event )
@@ -3404,8 +3420,7 @@ wxGenericTreeCtrl::DoTreeHitTest(const wxPoint& point, int& flags) const
         return wxTreeItemId();
     }
 
-    wxGenericTreeItem *hit =  m_anchor->HitTest(CalcUnscrolledPosition(point),
-                                                this, flags, 0);
+    wxGenericTreeItem *hit = HitTestLines(CalcUnscrolledPosition(point), flags);
     if (hit == NULL)
     {
         flags = wxTREE_HITTEST_NOWHERE;
@@ -3541,7 +3556,7 @@ void wxGenericTreeCtrl::OnMouse( wxMouseEvent &event )
 
     // Is the mouse over a tree item button?
     int flags = 0;
-    wxGenericTreeItem *thisItem = m_anchor->HitTest(pt, this, flags, 0);
+    wxGenericTreeItem *thisItem = HitTestLines(pt, flags);
     wxGenericTreeItem *underMouse = thisItem;
 #if wxUSE_TOOLTIPS
     bool underMouseChanged = (underMouse != m_underMouse) ;
@@ -3626,7 +3641,7 @@ void wxGenericTreeCtrl::OnMouse( wxMouseEvent &event )
 
 
     flags = 0;
-    wxGenericTreeItem *item = m_anchor->HitTest(pt, this, flags, 0);
+    wxGenericTreeItem *item = HitTestLines(pt, flags);
 
     if ( event.Dragging() && !m_isDragging )
     {
@@ -3950,6 +3965,8 @@ wxGenericTreeCtrl::CalculateLevel(wxGenericTreeItem *item,
     item->SetY( y );
     y += GetLineHeight(item);
 
+    m_lines.push_back(item);
+
     if ( !item->IsExpanded() )
     {
         // we don't need to calculate collapsed branches
@@ -3966,7 +3983,19 @@ wxGenericTreeCtrl::CalculateLevel(wxGenericTreeItem *item,
 
 void wxGenericTreeCtrl::CalculatePositions()
 {
-    if ( !m_anchor ) return;
+    if ( !m_anchor )
+    {
+        m_lines.clear();
+        m_firstDirtyLine = (size_t)-1;
+        return;
+    }
+
+    // if the height of all lines changed, all their positions did too
+    if ( m_linesLineHeight != m_lineHeight )
+        InvalidateLines();
+
+    if ( m_firstDirtyLine == (size_t)-1 )
+        return;
 
     wxClientDC dc(this);
     PrepareDC( dc );
@@ -3977,8 +4006,176 @@ void wxGenericTreeCtrl::CalculatePositions()
     //if(GetImageList() == NULL)
     // m_lineHeight = (int)(dc.GetCharHeight() + 4);
 
-    int y = 2;
-    CalculateLevel( m_anchor, dc, 0, y ); // start recursion
+    // calculating the item sizes may increase the line height, in which case
+    // we need to start again from the beginning
+    while ( m_firstDirtyLine != (size_t)-1 )
+    {
+        m_linesLineHeight = m_lineHeight;
+
+        // the lines before the first dirty one don't change
+        const size_t first = wxMin(m_firstDirtyLine, m_lines.size());
+        m_lines.erase(m_lines.begin() + first, m_lines.end());
+        m_firstDirtyLine = (size_t)-1;
+
+        if ( !first )
+        {
+            int y = 2;
+            CalculateLevel( m_anchor, dc, 0, y ); // start recursion
+        }
+        else
+        {
+            // continue with the children of the last remaining line, if it's
+            // expanded, then with its next siblings and the next siblings of
+            // all its parents
+            wxGenericTreeItem *item = m_lines[first - 1];
+            int y = item->GetY() + GetLineHeight(item);
+
+            int level = 0;
+            for ( wxGenericTreeItem *parent = item->GetParent();
+                  parent;
+                  parent = parent->GetParent() )
+            {
+                level++;
+            }
+
+            if ( item->IsExpanded() )
+            {
+                const wxArrayGenericTreeItems& children = item->GetChildren();
+                for ( size_t n = 0; n < children.GetCount(); n++ )
+                    CalculateLevel( children[n], dc, level + 1, y );
+            }
+
+            for ( ; item != m_anchor; item = item->GetParent(), level-- )
+            {
+                const wxArrayGenericTreeItems&
+                    siblings = item->GetParent()->GetChildren();
+                for ( size_t n = siblings.Index(item) + 1;
+                      n < siblings.GetCount();
+                      n++ )
+                {
+                    CalculateLevel( siblings[n], dc, level, y );
+                }
+            }
+        }
+
+        if ( !HasFlag(wxTR_HAS_VARIABLE_ROW_HEIGHT) &&
+                m_lineHeight != m_linesLineHeight )
+            InvalidateLines();
+    }
+}
+
+void wxGenericTreeCtrl::InvalidateLines(size_t line)
+{
+    if ( line < m_firstDirtyLine )
+        m_firstDirtyLine = line;
+}
+
+void wxGenericTreeCtrl::InvalidateLinesFrom(wxGenericTreeItem *item)
+{
+    const int line = FindLine(item);
+    if ( line != wxNOT_FOUND )
+        InvalidateLines(line);
+}
+
+void wxGenericTreeCtrl::InvalidateLinesAfter(wxGenericTreeItem *item)
+{
+    if ( item == m_anchor && HasFlag(wxTR_HIDE_ROOT) )
+    {
+        InvalidateLines();
+        return;
+    }
+
+    const int line = FindLine(item);
+    if ( line != wxNOT_FOUND )
+        InvalidateLines(line + 1);
+}
+
+void wxGenericTreeCtrl::RecalculateItemSize(wxGenericTreeItem *item)
+{
+    item->CalculateSize(this);
+
+    // the positions of all the lines below this one change if its height
+    // does, while a change of m_lineHeight is detected by CalculatePositions()
+    if ( HasFlag(wxTR_HAS_VARIABLE_ROW_HEIGHT) )
+        InvalidateLinesAfter(item);
+}
+
+bool wxGenericTreeCtrl::IsItemShown(wxGenericTreeItem *item) const
+{
+    if ( item == m_anchor && HasFlag(wxTR_HIDE_ROOT) )
+        return false;
+
+    for ( wxGenericTreeItem *parent = item->GetParent();
+          parent;
+          parent = parent->GetParent() )
+    {
+        // the hidden root is always expanded
+        if ( !parent->IsExpanded() &&
+                !(parent == m_anchor && HasFlag(wxTR_HIDE_ROOT)) )
+            return false;
+    }
+
+    return true;
+}
+
+int wxGenericTreeCtrl::FindLine(wxGenericTreeItem *item) const
+{
+    if ( !IsItemShown(item) )
+        return wxNOT_FOUND;
+
+    // the item position is valid if its line is before the first dirty one,
+    // so find the line at this position and check if it's really this item
+    const size_t count = wxMin(m_firstDirtyLine, m_lines.size());
+
+    size_t lo = 0,
+           hi = count;
+    while ( lo < hi )
+    {
+        const size_t mid = lo + (hi - lo) / 2;
+        if ( m_lines[mid]->GetY() < item->GetY() )
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    for ( ; lo < count && m_lines[lo]->GetY() == item->GetY(); lo++ )
+    {
+        if ( m_lines[lo] == item )
+            return lo;
+    }
+
+    return wxNOT_FOUND;
+}
+
+int wxGenericTreeCtrl::FindLineAbove(int y) const
+{
+    wxASSERT_MSG( m_firstDirtyLine == (size_t)-1, "lines must be up to date" );
+
+    size_t lo = 0,
+           hi = m_lines.size();
+    while ( lo < hi )
+    {
+        const size_t mid = lo + (hi - lo) / 2;
+        if ( m_lines[mid]->GetY() < y )
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo ? (int)lo - 1 : wxNOT_FOUND;
+}
+
+wxGenericTreeItem *
+wxGenericTreeCtrl::HitTestLines(const wxPoint& point, int& flags) const
+{
+    // make sure the positions are up to date
+    wxConstCast(this, wxGenericTreeCtrl)->CalculatePositions();
+
+    const int line = FindLineAbove(point.y);
+    if ( line == wxNOT_FOUND )
+        return NULL;
+
+    return m_lines[line]->HitTest(point, this, flags);
 }
 
 void wxGenericTreeCtrl::Refresh(bool eraseBackground, const wxRect *rect)
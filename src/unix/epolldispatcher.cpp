@@ -39,6 +39,12 @@
 // implementation
 // ============================================================================
 
+// the initial and maximal size of the buffer for the events returned by
+// epoll_wait(): it starts small and grows as needed if many descriptors are
+// being monitored
+static const int EPOLL_EVENTS_INITIAL = 16;
+static const int EPOLL_EVENTS_MAX = 4096;
+
 // helper: return EPOLLxxx mask corresponding to the given flags (and also log
 // debugging messages about it)
 static uint32_t GetEpollMask(int flags, int fd)
@@ -68,6 +74,13 @@ static uint32_t GetEpollMask(int flags, int fd)
                    wxT("Registered fd %d for exceptional events"), fd);
     }
 
+    if ( flags & wxFDIO_EDGE_TRIGGERED )
+    {
+        ep |= EPOLLET;
+        wxLogTrace(wxEpollDispatcher_Trace,
+                   wxT("Registered fd %d for edge-triggered events"), fd);
+    }
+
     return ep;
 }
 
@@ -94,30 +107,44 @@ wxEpollDispatcher::wxEpollDispatcher(int epollDescriptor)
     wxASSERT_MSG( epollDescriptor != -1, wxT("invalid descriptor") );
 
     m_epollDescriptor = epollDescriptor;
+
+    m_eventsSize = EPOLL_EVENTS_INITIAL;
+    m_events = new epoll_event[m_eventsSize];
+    m_numPending = 0;
 }
 
 wxEpollDispatcher::~wxEpollDispatcher()
 {
+    delete [] m_events;
+
     if ( close(m_epollDescriptor) != 0 )
     {
         wxLogSysError(_("Error closing epoll descriptor"));
     }
 }
 
-bool wxEpollDispatcher::RegisterFD(int fd, wxFDIOHandler* handler, int flags)
+bool wxEpollDispatcher::DoModify(int op, int fd, int flags) const
 {
     epoll_event ev;
     ev.events = GetEpollMask(flags, fd);
-    ev.data.ptr = handler;
+    ev.data.u64 = 0;
+    ev.data.fd = fd;
 
-    const int ret = epoll_ctl(m_epollDescriptor, EPOLL_CTL_ADD, fd, &ev);
-    if ( ret != 0 )
+    return epoll_ctl(m_epollDescriptor, op, fd, &ev) == 0;
+}
+
+bool wxEpollDispatcher::RegisterFD(int fd, wxFDIOHandler* handler, int flags)
+{
+    if ( !DoModify(EPOLL_CTL_ADD, fd, flags) )
     {
         wxLogSysError(_("Failed to add descriptor %d to epoll descriptor %d"),
                       fd, m_epollDescriptor);
 
         return false;
     }
+
+    wxMappedFDIODispatcher::RegisterFD(fd, handler, flags);
+
     wxLogTrace(wxEpollDispatcher_Trace,
                wxT("Added fd %d (handler %p) to epoll %d"), fd, handler, m_epollDescriptor);
 
@@ -126,19 +153,26 @@ bool wxEpollDispatcher::RegisterFD(int fd, wxFDIOHandler* handler, int flags)
 
 bool wxEpollDispatcher::ModifyFD(int fd, wxFDIOHandler* handler, int flags)
 {
-    epoll_event ev;
-    ev.events = GetEpollMask(flags, fd);
-    ev.data.ptr = handler;
-
-    const int ret = epoll_ctl(m_epollDescriptor, EPOLL_CTL_MOD, fd, &ev);
-    if ( ret != 0 )
-    {
-        wxLogSysError(_("Failed to modify descriptor %d in epoll descriptor %d"),
-                      fd, m_epollDescriptor);
+    wxFDIOHandlerMap::const_iterator i = m_handlers.find(fd);
+    const int flagsOld = i == m_handlers.end() ? 0 : i->second.flags;
 
+    if ( !wxMappedFDIODispatcher::ModifyFD(fd, handler, flags) )
         return false;
+
+    // just remember the change to apply it before polling the next time
+    wxEpollChangesMap::iterator j = m_changes.find(fd);
+    if ( j == m_changes.end() )
+    {
+        j = m_changes.insert(wxEpollChangesMap::value_type(fd, wxEpollChange())).first;
+        j->second.flags = flagsOld;
     }
 
+    // edge-triggered events need to be re-armed when they're re-enabled as
+    // the kernel wouldn't report them again otherwise if the descriptor is
+    // still ready, e.g. if not all the data available was read
+    if ( (flags & wxFDIO_EDGE_TRIGGERED) && (flags & ~flagsOld & wxFDIO_ALL) )
+        j->second.rearm = true;
+
     wxLogTrace(wxEpollDispatcher_Trace,
                 wxT("Modified fd %d (handler: %p) on epoll %d"), fd, handler, m_epollDescriptor);
     return true;
@@ -146,6 +180,9 @@ bool wxEpollDispatcher::ModifyFD(int fd, wxFDIOHandler* handler, int flags)
 
 bool wxEpollDispatcher::UnregisterFD(int fd)
 {
+    wxMappedFDIODispatcher::UnregisterFD(fd);
+    m_changes.erase(fd);
+
     epoll_event ev;
     ev.events = 0;
     ev.data.ptr = NULL;
@@ -160,8 +197,41 @@ bool wxEpollDispatcher::UnregisterFD(int fd)
     return true;
 }
 
-int
-wxEpollDispatcher::DoPoll(epoll_event *events, int numEvents, int timeout) const
+void wxEpollDispatcher::ApplyChanges() const
+{
+    for ( wxEpollChangesMap::const_iterator i = m_changes.begin();
+          i != m_changes.end();
+          ++i )
+    {
+        const int fd = i->first;
+        const wxFDIOHandlerMap::const_iterator j = m_handlers.find(fd);
+        if ( j == m_handlers.end() )
+            continue;
+
+        const int flags = j->second.flags;
+        const int flagsOld = i->second.flags;
+        if ( flags == flagsOld && !i->second.rearm )
+            continue;
+
+        // there is no need to disable edge-triggered events in the kernel as
+        // they're not going to be reported again anyhow and any events which
+        // are still reported are filtered out by Dispatch()
+        if ( (flags & wxFDIO_EDGE_TRIGGERED) &&
+                (flagsOld & wxFDIO_EDGE_TRIGGERED) &&
+                    !(flags & ~flagsOld) && !i->second.rearm )
+            continue;
+
+        if ( !DoModify(EPOLL_CTL_MOD, fd, flags) )
+        {
+            wxLogSysError(_("Failed to modify descriptor %d in epoll descriptor %d"),
+                          fd, m_epollDescriptor);
+        }
+    }
+
+    m_changes.clear();
+}
+
+int wxEpollDispatcher::DoPoll(int timeout) const
 {
     // the code below relies on TIMEOUT_INFINITE being -1 so that we can pass
     // timeout value directly to epoll_wait() which interprets -1 as meaning to
@@ -169,6 +239,11 @@ wxEpollDispatcher::DoPoll(epoll_event *events, int numEvents, int timeout) const
     // TIMEOUT_INFINITE ever changes
     wxCOMPILE_TIME_ASSERT( TIMEOUT_INFINITE == -1, UpdateThisCode );
 
+    ApplyChanges();
+
+    if ( !m_events )
+        m_events = new epoll_event[m_eventsSize];
+
     wxMilliClock_t timeEnd;
     if ( timeout > 0 )
         timeEnd = wxGetLocalTimeMillis();
@@ -176,7 +251,7 @@ wxEpollDispatcher::DoPoll(epoll_event *events, int numEvents, int timeout) const
     int rc;
     for ( ;; )
     {
-        rc = epoll_wait(m_epollDescriptor, events, numEvents, timeout);
+        rc = epoll_wait(m_epollDescriptor, m_events, m_eventsSize, timeout);
         if ( rc != -1 || errno != EINTR )
             break;
 
@@ -194,51 +269,127 @@ wxEpollDispatcher::DoPoll(epoll_event *events, int numEvents, int timeout) const
 
 bool wxEpollDispatcher::HasPending() const
 {
-    epoll_event event;
+    if ( m_numPending )
+        return true;
 
-    // NB: it's not really clear if epoll_wait() can return a number greater
-    //     than the number of events passed to it but just in case it can, use
-    //     >= instead of == here, see #10397
-    return DoPoll(&event, 1, 0) >= 1;
+    // keep the events we get for the next Dispatch() call
+    const int rc = DoPoll(0);
+    if ( rc > 0 )
+        m_numPending = rc;
+
+    return m_numPending > 0;
 }
 
 int wxEpollDispatcher::Dispatch(int timeout)
 {
-    epoll_event events[16];
-
-    const int rc = DoPoll(events, WXSIZEOF(events), timeout);
-
-    if ( rc == -1 )
+    int rc = m_numPending;
+    if ( rc )
     {
-        wxLogSysError(_("Waiting for IO on epoll descriptor %d failed"),
-                      m_epollDescriptor);
-        return -1;
+        m_numPending = 0;
     }
+    else
+    {
+        rc = DoPoll(timeout);
+
+        if ( rc == -1 )
+        {
+            wxLogSysError(_("Waiting for IO on epoll descriptor %d failed"),
+                          m_epollDescriptor);
+            return -1;
+        }
+    }
+
+    // take the buffer with the events while dispatching them as the handlers
+    // could call HasPending() or even Dispatch() recursively and a new buffer
+    // would be allocated for them then
+    epoll_event * const events = m_events;
+    const int size = m_eventsSize;
+    m_events = NULL;
 
     int numEvents = 0;
-    for ( epoll_event *p = events; p < events + rc; p++ )
+    for ( int n = 0; n < rc; n++ )
     {
-        wxFDIOHandler * const handler = (wxFDIOHandler *)(p->data.ptr);
-        if ( !handler )
+        const epoll_event& ev = events[n];
+
+        // the handler could have been unregistered by another one called
+        // before it in this loop, so look it up now
+        const int fd = ev.data.fd;
+        wxFDIOHandlerMap::const_iterator i = m_handlers.find(fd);
+        if ( i == m_handlers.end() )
+            continue;
+
+        wxFDIOHandler * const handler = i->second.handler;
+        const int flags = i->second.flags;
+
+        if ( !(flags & wxFDIO_EDGE_TRIGGERED) )
         {
-            wxFAIL_MSG( wxT("NULL handler in epoll_event?") );
+            // note that for compatibility with wxSelectDispatcher we call
+            // OnReadWaiting() on EPOLLHUP as this is what epoll_wait() returns
+            // when the write end of a pipe is closed while with select() the
+            // remaining pipe end becomes ready for reading when this happens
+            if ( ev.events & (EPOLLIN | EPOLLHUP) )
+                handler->OnReadWaiting();
+            else if ( ev.events & EPOLLOUT )
+                handler->OnWriteWaiting();
+            else if ( ev.events & EPOLLERR )
+                handler->OnExceptionWaiting();
+            else
+                continue;
+
+            numEvents++;
             continue;
         }
 
-        // note that for compatibility with wxSelectDispatcher we call
-        // OnReadWaiting() on EPOLLHUP as this is what epoll_wait() returns
-        // when the write end of a pipe is closed while with select() the
-        // remaining pipe end becomes ready for reading when this happens
-        if ( p->events & (EPOLLIN | EPOLLHUP) )
+        // edge-triggered events are only reported once, so we must notify
+        // about both input and output if they're both available, but only if
+        // the handler is still interested in them as they may have been
+        // disabled without updating the epoll set
+        bool processed = false;
+        if ( (ev.events & (EPOLLIN | EPOLLHUP)) && (flags & wxFDIO_INPUT) )
+        {
             handler->OnReadWaiting();
-        else if ( p->events & EPOLLOUT )
+            processed = true;
+
+            // the handler may have been unregistered or changed by the call
+            // above
+            i = m_handlers.find(fd);
+            if ( i == m_handlers.end() || i->second.handler != handler )
+            {
+                numEvents++;
+                continue;
+            }
+        }
+
+        if ( (ev.events & EPOLLOUT) && (i->second.flags & wxFDIO_OUTPUT) )
+        {
             handler->OnWriteWaiting();
-        else if ( p->events & EPOLLERR )
+            processed = true;
+        }
+        else if ( !processed && (ev.events & EPOLLERR) )
+        {
             handler->OnExceptionWaiting();
-        else
-            continue;
+            processed = true;
+        }
+
+        if ( processed )
+            numEvents++;
+    }
 
-        numEvents++;
+    if ( m_events )
+    {
+        delete [] events;
+    }
+    else if ( rc == size && size < EPOLL_EVENTS_MAX )
+    {
+        // the buffer was filled up, so there are probably more events
+        // waiting: use a bigger one the next time
+        delete [] events;
+        m_eventsSize = 2*size;
+        m_events = new epoll_event[m_eventsSize];
+    }
+    else
+    {
+        m_events = events;
     }
 
     return numEvents;
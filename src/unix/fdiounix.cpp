@@ -44,15 +44,20 @@ int wxFDIOManagerUnix::AddInput(wxFDIOHandler *handler, int fd, Direction d)
     // we need to either register this FD with the dispatcher or update an
     // existing registration depending on whether it had been previously
     // registered for anything or not
+    //
+    // notice that the sockets disable the events when they're notified about
+    // them and only re-enable them once they're handled, so they can use
+    // edge-triggered notifications
     bool ok;
     const int regmask = handler->GetRegisteredEvents();
     if ( !regmask )
     {
-        ok = dispatcher->RegisterFD(fd, handler, flag);
+        ok = dispatcher->RegisterFD(fd, handler, flag | wxFDIO_EDGE_TRIGGERED);
     }
     else
     {
-        ok = dispatcher->ModifyFD(fd, handler, regmask | flag);
+        ok = dispatcher->ModifyFD(fd, handler,
+                                  regmask | flag | wxFDIO_EDGE_TRIGGERED);
     }
 
     if ( !ok )
@@ -82,7 +87,8 @@ void wxFDIOManagerUnix::RemoveInput(wxFDIOHandler *handler, int fd, Direction d)
     }
     else
     {
-        ok = dispatcher->ModifyFD(fd, handler, regmask & ~flag);
+        ok = dispatcher->ModifyFD(fd, handler,
+                                  (regmask & ~flag) | wxFDIO_EDGE_TRIGGERED);
     }
 
     if ( !ok )
@@ -183,12 +183,19 @@ private:
     // convert the result of pthread_mutex_[timed]lock() call to wx return code
     wxMutexError HandleLockResult(int err);
 
+    // Lock() implementation for wxMUTEX_ADAPTIVE mutexes
+    wxMutexError LockAdaptive();
+
 private:
     pthread_mutex_t m_mutex;
     bool m_isOk;
     wxMutexType m_type;
     unsigned long m_owningThread;
 
+    // the estimated number of iterations needed to acquire a wxMUTEX_ADAPTIVE
+    // mutex by spinning, updated after each Lock()
+    int m_spins;
+
     // wxConditionInternal uses our m_mutex
     friend class wxConditionInternal;
 };
@@ -204,6 +211,7 @@ wxMutexInternal::wxMutexInternal(wxMutexType mutexType)
 {
     m_type = mutexType;
     m_owningThread = 0;
+    m_spins = 0;
 
     int err;
     switch ( mutexType )
@@ -240,6 +248,7 @@ wxMutexInternal::wxMutexInternal(wxMutexType mutexType)
             // fall through
 
         case wxMUTEX_DEFAULT:
+        case wxMUTEX_ADAPTIVE:
             err = pthread_mutex_init(&m_mutex, NULL);
             break;
     }
@@ -265,6 +274,9 @@ wxMutexInternal::~wxMutexInternal()
 
 wxMutexError wxMutexInternal::Lock()
 {
+    if ( m_type == wxMUTEX_ADAPTIVE )
+        return LockAdaptive();
+
     if ((m_type == wxMUTEX_DEFAULT) && (m_owningThread != 0))
     {
         if (m_owningThread == wxThread::GetCurrentId())
@@ -274,6 +286,48 @@ wxMutexError wxMutexInternal::Lock()
     return HandleLockResult(pthread_mutex_lock(&m_mutex));
 }
 
+// the maximal number of iterations to spin for when locking wxMUTEX_ADAPTIVE
+// mutex, it is 0 on uniprocessor systems where spinning is useless
+static int GetMaxMutexSpins()
+{
+    // notice that races when initializing this variable are harmless
+    static int s_maxSpins = -1;
+    if ( s_maxSpins == -1 )
+        s_maxSpins = wxThread::GetCPUCount() > 1 ? 100 : 0;
+
+    return s_maxSpins;
+}
+
+// tell the CPU that we're spinning
+static inline void wxSpinPause()
+{
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+    __asm__ __volatile__("pause");
+#endif
+}
+
+wxMutexError wxMutexInternal::LockAdaptive()
+{
+    // spin for up to twice the number of iterations which were needed to
+    // acquire the mutex recently, like glibc adaptive mutexes do, before
+    // falling back to blocking
+    const int maxSpins = wxMin(GetMaxMutexSpins(), 2*m_spins + 10);
+    for ( int n = 0; n < maxSpins; n++ )
+    {
+        if ( pthread_mutex_trylock(&m_mutex) == 0 )
+        {
+            m_spins += (n - m_spins) / 8;
+            return wxMUTEX_NO_ERROR;
+        }
+
+        wxSpinPause();
+    }
+
+    m_spins += (maxSpins - m_spins) / 8;
+
+    return HandleLockResult(pthread_mutex_lock(&m_mutex));
+}
+
 wxMutexError wxMutexInternal::Lock(unsigned long ms)
 {
 #ifdef HAVE_PTHREAD_MUTEX_TIMEDLOCK
@@ -407,6 +461,96 @@ wxMutexError wxMutexInternal::Unlock()
     return wxMUTEX_MISC_ERROR;
 }
 
+// ===========================================================================
+// wxRWLock implementation
+// ===========================================================================
+
+// ---------------------------------------------------------------------------
+// wxRWLockInternal
+// ---------------------------------------------------------------------------
+
+// this is a wrapper around pthread_rwlock_t, we don't need to distinguish
+// between read and write unlocking with it
+class wxRWLockInternal
+{
+public:
+    wxRWLockInternal();
+    ~wxRWLockInternal();
+
+    bool IsOk() const { return m_isOk; }
+
+    wxMutexError ReadLock()
+        { return HandleResult(pthread_rwlock_rdlock(&m_rwlock)); }
+    wxMutexError TryReadLock()
+        { return HandleResult(pthread_rwlock_tryrdlock(&m_rwlock)); }
+    wxMutexError ReadUnlock()
+        { return HandleResult(pthread_rwlock_unlock(&m_rwlock)); }
+
+    wxMutexError WriteLock()
+        { return HandleResult(pthread_rwlock_wrlock(&m_rwlock)); }
+    wxMutexError TryWriteLock()
+        { return HandleResult(pthread_rwlock_trywrlock(&m_rwlock)); }
+    wxMutexError WriteUnlock()
+        { return HandleResult(pthread_rwlock_unlock(&m_rwlock)); }
+
+private:
+    // convert the result of pthread_rwlock_xxx() call to wx return code
+    static wxMutexError HandleResult(int err);
+
+    pthread_rwlock_t m_rwlock;
+    bool m_isOk;
+
+    wxDECLARE_NO_COPY_CLASS(wxRWLockInternal);
+};
+
+wxRWLockInternal::wxRWLockInternal()
+{
+    int err = pthread_rwlock_init(&m_rwlock, NULL);
+
+    m_isOk = err == 0;
+    if ( !m_isOk )
+    {
+        wxLogApiError(wxT("pthread_rwlock_init()"), err);
+    }
+}
+
+wxRWLockInternal::~wxRWLockInternal()
+{
+    if ( m_isOk )
+    {
+        int err = pthread_rwlock_destroy(&m_rwlock);
+        if ( err != 0 )
+        {
+            wxLogApiError(wxT("pthread_rwlock_destroy()"), err);
+        }
+    }
+}
+
+/* static */
+wxMutexError wxRWLockInternal::HandleResult(int err)
+{
+    switch ( err )
+    {
+        case 0:
+            return wxMUTEX_NO_ERROR;
+
+        case EBUSY:
+            return wxMUTEX_BUSY;
+
+        case EDEADLK:
+            return wxMUTEX_DEAD_LOCK;
+
+        case EPERM:
+            // we don't own the lock
+            return wxMUTEX_UNLOCKED;
+
+        default:
+            wxLogApiError(wxT("pthread_rwlock_xxx()"), err);
+    }
+
+    return wxMUTEX_MISC_ERROR;
+}
+
 // ===========================================================================
 // wxCondition implementation
 // ===========================================================================
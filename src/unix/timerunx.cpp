@@ -23,7 +23,6 @@
     #include "wx/log.h"
     #include "wx/module.h"
     #include "wx/app.h"
-    #include "wx/list.h"
     #include "wx/hashmap.h"
     #include "wx/event.h"
 #endif
@@ -38,16 +37,29 @@
 
 #include "wx/unix/private/timer.h"
 
-#include "wx/listimpl.cpp"
-WX_DEFINE_LIST(wxTimerList)
+#if wxDEBUG_LEVEL >= 2
+    // log the addition and removal of every timer: this is not done by
+    // default as checking whether the trace mask is enabled is much slower
+    // than the timer operations themselves
+    #define WXDEBUG_TIMER
+#endif // wxDEBUG_LEVEL >= 2
 
 // trace mask for the debugging messages used here
 #define wxTrace_Timer wxT("timer")
 
+// the timers expiring in less than this number of microseconds are notified
+// together with the already expired ones: this avoids waking up again just to
+// notify them a moment later and, as the event loop rounds the time remaining
+// until the next timer expiration down to milliseconds, also avoids busy
+// waiting for the timers expiring in less than a millisecond
+static const long wxTIMER_COALESCING_TOLERANCE = 1000;
+
 // ----------------------------------------------------------------------------
 // local functions
 // ----------------------------------------------------------------------------
 
+#ifdef WXDEBUG_TIMER
+
 // helper function to format wxUsecClock_t
 static inline wxString wxUsecClockAsString(wxUsecClock_t usec)
 {
@@ -58,6 +70,8 @@ static inline wxString wxUsecClockAsString(wxUsecClock_t usec)
     #endif
 }
 
+#endif // WXDEBUG_TIMER
+
 // ============================================================================
 // wxTimerScheduler implementation
 // ============================================================================
@@ -66,66 +80,119 @@ wxTimerScheduler *wxTimerScheduler::ms_instance = NULL;
 
 wxTimerScheduler::~wxTimerScheduler()
 {
-    for ( wxTimerList::iterator node = m_timers.begin();
-          node != m_timers.end();
-          ++node )
+    for ( size_t n = 0; n < m_heap.size(); n++ )
     {
-        delete *node;
+        delete m_heap[n];
     }
 }
 
-void wxTimerScheduler::AddTimer(wxUnixTimerImpl *timer, wxUsecClock_t expiration)
+void wxTimerScheduler::SiftUp(size_t index)
 {
-    DoAddTimer(new wxTimerSchedule(timer, expiration));
+    wxTimerSchedule * const s = m_heap[index];
+    while ( index > 0 )
+    {
+        const size_t parent = (index - 1) / 2;
+        if ( !IsEarlier(s, m_heap[parent]) )
+            break;
+
+        SetAt(index, m_heap[parent]);
+        index = parent;
+    }
+
+    SetAt(index, s);
 }
 
-void wxTimerScheduler::DoAddTimer(wxTimerSchedule *s)
+void wxTimerScheduler::SiftDown(size_t index)
 {
-    // do an insertion sort to keep the list sorted in expiration order
-    wxTimerList::iterator node;
-    for ( node = m_timers.begin(); node != m_timers.end(); ++node )
+    wxTimerSchedule * const s = m_heap[index];
+    const size_t count = m_heap.size();
+    for ( ;; )
     {
-        wxASSERT_MSG( (*node)->m_timer != s->m_timer,
-                      wxT("adding the same timer twice?") );
+        size_t child = 2*index + 1;
+        if ( child >= count )
+            break;
+
+        if ( child + 1 < count && IsEarlier(m_heap[child + 1], m_heap[child]) )
+            child++;
 
-        if ( (*node)->m_expiration > s->m_expiration )
+        if ( !IsEarlier(m_heap[child], s) )
             break;
+
+        SetAt(index, m_heap[child]);
+        index = child;
     }
 
-    m_timers.insert(node, s);
+    SetAt(index, s);
+}
+
+void wxTimerScheduler::AddTimer(wxUnixTimerImpl *timer, wxUsecClock_t expiration)
+{
+    DoAddTimer(new wxTimerSchedule(timer, expiration));
+}
+
+void wxTimerScheduler::DoAddTimer(wxTimerSchedule *s)
+{
+    wxASSERT_MSG( m_schedules.find(s->m_timer) == m_schedules.end(),
+                  wxT("adding the same timer twice?") );
+
+    m_schedules[s->m_timer] = s;
+
+    // timers expiring at the same time are notified in the order of addition
+    s->m_order = m_nextOrder++;
+
+    m_heap.push_back(s);
+    SiftUp(m_heap.size() - 1);
 
+#ifdef WXDEBUG_TIMER
     wxLogTrace(wxTrace_Timer, wxT("Inserted timer %d expiring at %s"),
                s->m_timer->GetId(),
                wxUsecClockAsString(s->m_expiration).c_str());
+#endif // WXDEBUG_TIMER
 }
 
-void wxTimerScheduler::RemoveTimer(wxUnixTimerImpl *timer)
+void wxTimerScheduler::DoRemoveTimer(wxTimerSchedule *s)
 {
-    wxLogTrace(wxTrace_Timer, wxT("Removing timer %d"), timer->GetId());
+    m_schedules.erase(s->m_timer);
 
-    for ( wxTimerList::iterator node = m_timers.begin();
-          node != m_timers.end();
-          ++node )
+    // replace the schedule being removed with the last one and move the
+    // latter to its correct position
+    const size_t index = s->m_index;
+    wxTimerSchedule * const last = m_heap.back();
+    m_heap.pop_back();
+
+    if ( last != s )
     {
-        if ( (*node)->m_timer == timer )
-        {
-            delete *node;
-            m_timers.erase(node);
-            return;
-        }
+        SetAt(index, last);
+
+        if ( index > 0 && IsEarlier(last, m_heap[(index - 1) / 2]) )
+            SiftUp(index);
+        else
+            SiftDown(index);
     }
+}
 
-    wxFAIL_MSG( wxT("removing inexistent timer?") );
+void wxTimerScheduler::RemoveTimer(wxUnixTimerImpl *timer)
+{
+#ifdef WXDEBUG_TIMER
+    wxLogTrace(wxTrace_Timer, wxT("Removing timer %d"), timer->GetId());
+#endif // WXDEBUG_TIMER
+
+    const wxTimerScheduleMap::iterator it = m_schedules.find(timer);
+    wxCHECK_RET( it != m_schedules.end(), wxT("removing inexistent timer?") );
+
+    wxTimerSchedule * const s = it->second;
+    DoRemoveTimer(s);
+    delete s;
 }
 
 bool wxTimerScheduler::GetNext(wxUsecClock_t *remaining) const
 {
-    if ( m_timers.empty() )
+    if ( m_heap.empty() )
       return false;
 
     wxCHECK_MSG( remaining, false, wxT("NULL pointer") );
 
-    *remaining = (*m_timers.begin())->m_expiration - wxGetUTCTimeUSec();
+    *remaining = m_heap[0]->m_expiration - wxGetUTCTimeUSec();
     if ( *remaining < 0 )
     {
         // timer already expired, don't wait at all before notifying it
@@ -137,35 +204,43 @@ bool wxTimerScheduler::GetNext(wxUsecClock_t *remaining) const
 
 bool wxTimerScheduler::NotifyExpired()
 {
-    if ( m_timers.empty() )
+    if ( m_heap.empty() )
       return false;
 
     const wxUsecClock_t now = wxGetUTCTimeUSec();
+    const wxUsecClock_t limit = now + wxTIMER_COALESCING_TOLERANCE;
+
+    // take all the expired timers out of the heap first: rescheduling the
+    // periodic ones immediately could result in notifying them more than once
+    // if their interval is shorter than the tolerance
+    typedef wxVector<wxTimerSchedule *> TimerSchedules;
+    TimerSchedules expired;
+    while ( !m_heap.empty() && m_heap[0]->m_expiration <= limit )
+    {
+        wxTimerSchedule * const s = m_heap[0];
+        DoRemoveTimer(s);
+        expired.push_back(s);
+    }
+
+    if ( expired.empty() )
+        return false;
 
     typedef wxVector<wxUnixTimerImpl *> TimerImpls;
     TimerImpls toNotify;
-    for ( wxTimerList::iterator next,
-            cur = m_timers.begin(); cur != m_timers.end(); cur = next )
+    toNotify.reserve(expired.size());
+    for ( TimerSchedules::const_iterator i = expired.begin(),
+                                         end = expired.end();
+          i != end;
+          ++i )
     {
-        wxTimerSchedule * const s = *cur;
-        if ( s->m_expiration > now )
-        {
-            // as the list is sorted by expiration time, we can skip the rest
-            break;
-        }
-
-        // remember next as we will delete the node pointed to by cur
-        next = cur;
-        ++next;
-
-        m_timers.erase(cur);
+        wxTimerSchedule * const s = *i;
 
         // check whether we need to keep this timer
         wxUnixTimerImpl * const timer = s->m_timer;
         if ( timer->IsOneShot() )
         {
             // the timer needs to be stopped but don't call its Stop() from
-            // here as it would attempt to remove the timer from our list and
+            // here as it would attempt to remove the timer from the heap and
             // we had already done it, so we just need to reset its state
             timer->MarkStopped();
 
@@ -183,15 +258,11 @@ bool wxTimerScheduler::NotifyExpired()
         }
 
         // we can't notify the timer from this loop as the timer event handler
-        // could modify m_timers (for example, but not only, by stopping this
-        // timer) which would render our iterators invalid, so do it after the
-        // loop end
+        // could modify the heap (for example, but not only, by stopping this
+        // timer), so do it after the loop end
         toNotify.push_back(timer);
     }
 
-    if ( toNotify.empty() )
-        return false;
-
     for ( TimerImpls::const_iterator i = toNotify.begin(),
                                      end = toNotify.end();
           i != end;
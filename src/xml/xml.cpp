@@ -30,6 +30,9 @@
 #include "wx/strconv.h"
 #include "wx/scopedptr.h"
 #include "wx/versioninfo.h"
+#include "wx/atomic.h"
+#include "wx/hashmap.h"
+#include "wx/vector.h"
 
 #include "expat.h" // from Expat
 
@@ -44,6 +47,140 @@ IMPLEMENT_CLASS(wxXmlDocument, wxObject)
 static bool wxIsWhiteOnly(const wxString& buf);
 
 
+//-----------------------------------------------------------------------------
+//  wxXmlArena
+//-----------------------------------------------------------------------------
+
+// All the objects allocated by wxXmlNode and wxXmlAttribute operator new are
+// preceded by this header containing the arena they were allocated from or
+// NULL if they were allocated on the heap.
+union wxXmlAllocHeader
+{
+    wxXmlArena *arena;
+
+    // this is only used to ensure that the objects are suitably aligned
+    double align;
+};
+
+// The memory used for the nodes and attributes created by Load() with
+// wxXMLDOC_USE_ARENA flag.
+//
+// The objects are allocated sequentially from big chunks and are never freed
+// individually. Instead each of them holds a reference to the arena, which
+// frees all its memory when the last object is deleted. This allows the
+// objects to be deleted, detached or outlive the document as usual.
+class wxXmlArena
+{
+public:
+    // The arena is created with a reference which must be released by the
+    // creator with DecRef() when it doesn't allocate from it any more.
+    wxXmlArena()
+    {
+        m_refCount = 1;
+        m_current = NULL;
+        m_left = 0;
+    }
+
+    void *Alloc(size_t size)
+    {
+        // keep all allocations aligned in the same way as the header
+        size = (size + sizeof(wxXmlAllocHeader) - 1) &
+                    ~(sizeof(wxXmlAllocHeader) - 1);
+
+        if ( size > m_left )
+        {
+            const size_t chunkSize = size > CHUNK_SIZE ? size : CHUNK_SIZE;
+            m_current = new char[chunkSize];
+            m_chunks.push_back(m_current);
+            m_left = chunkSize;
+        }
+
+        void * const p = m_current;
+        m_current += size;
+        m_left -= size;
+
+        wxAtomicInc(m_refCount);
+
+        return p;
+    }
+
+    void DecRef()
+    {
+        if ( !wxAtomicDec(m_refCount) )
+            delete this;
+    }
+
+private:
+    ~wxXmlArena()
+    {
+        for ( size_t n = 0; n < m_chunks.size(); n++ )
+            delete [] m_chunks[n];
+    }
+
+    enum { CHUNK_SIZE = 64*1024 };
+
+    wxVector<char *> m_chunks;
+
+    // the remaining part of the last chunk
+    char *m_current;
+    size_t m_left;
+
+    // one reference for each object allocated from the arena and one more
+    // for the creator
+    wxUint32 m_refCount;
+
+    wxDECLARE_NO_COPY_CLASS(wxXmlArena);
+};
+
+static void *wxXmlAllocate(size_t size, wxXmlArena *arena)
+{
+    size += sizeof(wxXmlAllocHeader);
+
+    wxXmlAllocHeader * const header = static_cast<wxXmlAllocHeader *>
+        (
+            arena ? arena->Alloc(size) : ::operator new(size)
+        );
+    header->arena = arena;
+
+    return header + 1;
+}
+
+static void wxXmlFree(void *p)
+{
+    if ( !p )
+        return;
+
+    wxXmlAllocHeader * const header = static_cast<wxXmlAllocHeader *>(p) - 1;
+    if ( header->arena )
+        header->arena->DecRef();
+    else
+        ::operator delete(header);
+}
+
+//-----------------------------------------------------------------------------
+//  wxXmlAttribute
+//-----------------------------------------------------------------------------
+
+void *wxXmlAttribute::operator new(size_t size)
+{
+    return wxXmlAllocate(size, NULL);
+}
+
+void *wxXmlAttribute::operator new(size_t size, wxXmlArena *arena)
+{
+    return wxXmlAllocate(size, arena);
+}
+
+void wxXmlAttribute::operator delete(void *p)
+{
+    wxXmlFree(p);
+}
+
+void wxXmlAttribute::operator delete(void *p, wxXmlArena * WXUNUSED(arena))
+{
+    wxXmlFree(p);
+}
+
 //-----------------------------------------------------------------------------
 //  wxXmlNode
 //-----------------------------------------------------------------------------
@@ -82,6 +219,26 @@ wxXmlNode::wxXmlNode(wxXmlNodeType type, const wxString& name,
     wxASSERT_MSG ( type != wxXML_ELEMENT_NODE || content.empty(), "element nodes can't have content" );
 }
 
+void *wxXmlNode::operator new(size_t size)
+{
+    return wxXmlAllocate(size, NULL);
+}
+
+void *wxXmlNode::operator new(size_t size, wxXmlArena *arena)
+{
+    return wxXmlAllocate(size, arena);
+}
+
+void wxXmlNode::operator delete(void *p)
+{
+    wxXmlFree(p);
+}
+
+void wxXmlNode::operator delete(void *p, wxXmlArena * WXUNUSED(arena))
+{
+    wxXmlFree(p);
+}
+
 wxXmlNode::wxXmlNode(const wxXmlNode& node)
 {
     m_next = NULL;
@@ -599,6 +756,24 @@ bool wxIsWhiteOnly(const wxString& buf)
     return true;
 }
 
+// same as above but for UTF-8 string produced by expat
+static bool wxIsWhiteOnly(const char *s, int len)
+{
+    for ( const char * const end = s + len; s != end; ++s )
+    {
+        const char c = *s;
+        if ( c != ' ' && c != '\t' && c != '\n' && c != '\r' )
+            return false;
+    }
+    return true;
+}
+
+
+// hash map used for interning element and attribute names, the keys point
+// to the strings stored in wxXmlParsingContext::nameKeys
+typedef const char *wxXmlNameKey;
+WX_DECLARE_HASH_MAP(wxXmlNameKey, wxString, wxStringHash, wxStringEqual,
+                    wxXmlNamesMap);
 
 struct wxXmlParsingContext
 {
@@ -607,14 +782,33 @@ struct wxXmlParsingContext
           node(NULL),
           lastChild(NULL),
           lastAsText(NULL),
+          arena(NULL),
           removeWhiteOnlyNodes(false)
     {}
 
+    // Returns the string for the given element or attribute name: as the
+    // same names are typically used many times in the same document, they're
+    // only converted once and all the nodes use copies of the same string.
+    const wxString& GetName(const char *name)
+    {
+        wxXmlNamesMap::const_iterator it = names.find(name);
+        if ( it != names.end() )
+            return it->second;
+
+        const wxCharBuffer key(name);
+        nameKeys.push_back(key);
+
+        return names[key.data()] = CharToString(conv, name);
+    }
+
     XML_Parser parser;
     wxMBConv  *conv;
     wxXmlNode *node;                    // the node being parsed
     wxXmlNode *lastChild;               // the last child of "node"
     wxXmlNode *lastAsText;              // the last _text_ child of "node"
+    wxXmlArena *arena;                  // used for all nodes if non-NULL
+    wxXmlNamesMap names;
+    wxVector<wxCharBuffer> nameKeys;
     wxString   encoding;
     wxString   version;
     bool       removeWhiteOnlyNodes;
@@ -631,17 +825,25 @@ extern "C" {
 static void StartElementHnd(void *userData, const char *name, const char **atts)
 {
     wxXmlParsingContext *ctx = (wxXmlParsingContext*)userData;
-    wxXmlNode *node = new wxXmlNode(wxXML_ELEMENT_NODE,
-                                    CharToString(ctx->conv, name),
+    wxXmlNode *node = new(ctx->arena) wxXmlNode(wxXML_ELEMENT_NODE,
+                                    ctx->GetName(name),
                                     wxEmptyString,
                                     XML_GetCurrentLineNumber(ctx->parser));
-    const char **a = atts;
 
-    // add node attributes
-    while (*a)
+    // add node attributes, appending them to the list directly is faster
+    // than using AddAttribute() which needs to find the end of the list
+    wxXmlAttribute *lastAttr = NULL;
+    for ( const char **a = atts; *a; a += 2 )
     {
-        node->AddAttribute(CharToString(ctx->conv, a[0]), CharToString(ctx->conv, a[1]));
-        a += 2;
+        wxXmlAttribute * const attr =
+            new(ctx->arena) wxXmlAttribute(ctx->GetName(a[0]),
+                                           CharToString(ctx->conv, a[1]));
+        if ( lastAttr )
+            lastAttr->SetNext(attr);
+        else
+            node->SetAttributes(attr);
+
+        lastAttr = attr;
     }
 
     ASSERT_LAST_CHILD_OK(ctx);
@@ -668,22 +870,25 @@ static void EndElementHnd(void *userData, const char* WXUNUSED(name))
 static void TextHnd(void *userData, const char *s, int len)
 {
     wxXmlParsingContext *ctx = (wxXmlParsingContext*)userData;
-    wxString str = CharToString(ctx->conv, s, len);
 
     if (ctx->lastAsText)
     {
-        ctx->lastAsText->SetContent(ctx->lastAsText->GetContent() + str);
+        ctx->lastAsText->SetContent(ctx->lastAsText->GetContent() +
+                                    CharToString(ctx->conv, s, len));
     }
     else
     {
+        // check for the white space before converting the string as there
+        // is typically a lot of it between the elements and it is discarded
         bool whiteOnly = false;
         if (ctx->removeWhiteOnlyNodes)
-            whiteOnly = wxIsWhiteOnly(str);
+            whiteOnly = wxIsWhiteOnly(s, len);
 
         if (!whiteOnly)
         {
             wxXmlNode *textnode =
-                new wxXmlNode(wxXML_TEXT_NODE, wxS("text"), str,
+                new(ctx->arena) wxXmlNode(wxXML_TEXT_NODE, ctx->GetName("text"),
+                              CharToString(ctx->conv, s, len),
                               XML_GetCurrentLineNumber(ctx->parser));
 
             ASSERT_LAST_CHILD_OK(ctx);
@@ -698,7 +903,7 @@ static void StartCdataHnd(void *userData)
     wxXmlParsingContext *ctx = (wxXmlParsingContext*)userData;
 
     wxXmlNode *textnode =
-        new wxXmlNode(wxXML_CDATA_SECTION_NODE, wxS("cdata"), wxS(""),
+        new(ctx->arena) wxXmlNode(wxXML_CDATA_SECTION_NODE, wxS("cdata"), wxS(""),
                       XML_GetCurrentLineNumber(ctx->parser));
 
     ASSERT_LAST_CHILD_OK(ctx);
@@ -722,7 +927,7 @@ static void CommentHnd(void *userData, const char *data)
     wxXmlParsingContext *ctx = (wxXmlParsingContext*)userData;
 
     wxXmlNode *commentnode =
-        new wxXmlNode(wxXML_COMMENT_NODE,
+        new(ctx->arena) wxXmlNode(wxXML_COMMENT_NODE,
                       wxS("comment"), CharToString(ctx->conv, data),
                       XML_GetCurrentLineNumber(ctx->parser));
 
@@ -737,7 +942,7 @@ static void PIHnd(void *userData, const char *target, const char *data)
     wxXmlParsingContext *ctx = (wxXmlParsingContext*)userData;
 
     wxXmlNode *pinode =
-        new wxXmlNode(wxXML_PI_NODE, CharToString(ctx->conv, target),
+        new(ctx->arena) wxXmlNode(wxXML_PI_NODE, CharToString(ctx->conv, target),
                       CharToString(ctx->conv, data),
                       XML_GetCurrentLineNumber(ctx->parser));
 
@@ -798,6 +1003,50 @@ static int UnknownEncodingHnd(void * WXUNUSED(encodingHandlerData),
 
 } // extern "C"
 
+// Feeds all the data from the stream to the parser. Returns false if reading
+// or parsing it failed, the errors are logged unless the parsing was stopped
+// by XML_StopParser().
+static bool ParseXmlStream(XML_Parser parser, wxInputStream& stream)
+{
+    // Read the data directly into expat buffer to avoid copying it.
+    const int BUFSIZE = 65536;
+
+    for ( ;; )
+    {
+        void * const buf = XML_GetBuffer(parser, BUFSIZE);
+        if ( !buf )
+        {
+            wxLogError(_("Out of memory while parsing XML."));
+            return false;
+        }
+
+        const size_t len = stream.Read(buf, BUFSIZE).LastRead();
+        if ( !len && stream.GetLastError() != wxSTREAM_EOF
+                  && stream.GetLastError() != wxSTREAM_NO_ERROR )
+        {
+            wxLogError(_("Failed to read XML data."));
+            return false;
+        }
+
+        const bool done = len == 0;
+        if ( !XML_ParseBuffer(parser, static_cast<int>(len), done) )
+        {
+            if ( XML_GetErrorCode(parser) != XML_ERROR_ABORTED )
+            {
+                wxString error(XML_ErrorString(XML_GetErrorCode(parser)),
+                               *wxConvCurrent);
+                wxLogError(_("XML parsing error: '%s' at line %d"),
+                           error.c_str(),
+                           (int)XML_GetCurrentLineNumber(parser));
+            }
+            return false;
+        }
+
+        if ( done )
+            return true;
+    }
+}
+
 bool wxXmlDocument::Load(wxInputStream& stream, const wxString& encoding, int flags)
 {
 #if wxUSE_UNICODE
@@ -806,12 +1055,13 @@ bool wxXmlDocument::Load(wxInputStream& stream, const wxString& encoding, int fl
     m_encoding = encoding;
 #endif
 
-    const size_t BUFSIZE = 1024;
-    char buf[BUFSIZE];
     wxXmlParsingContext ctx;
-    bool done;
     XML_Parser parser = XML_ParserCreate(NULL);
-    wxXmlNode *root = new wxXmlNode(wxXML_DOCUMENT_NODE, wxEmptyString);
+
+    if ( flags & wxXMLDOC_USE_ARENA )
+        ctx.arena = new wxXmlArena;
+
+    wxXmlNode *root = new(ctx.arena) wxXmlNode(wxXML_DOCUMENT_NODE, wxEmptyString);
 
     ctx.encoding = wxS("UTF-8"); // default in absence of encoding=""
     ctx.conv = NULL;
@@ -832,22 +1082,7 @@ bool wxXmlDocument::Load(wxInputStream& stream, const wxString& encoding, int fl
     XML_SetDefaultHandler(parser, DefaultHnd);
     XML_SetUnknownEncodingHandler(parser, UnknownEncodingHnd, NULL);
 
-    bool ok = true;
-    do
-    {
-        size_t len = stream.Read(buf, BUFSIZE).LastRead();
-        done = (len < BUFSIZE);
-        if (!XML_Parse(parser, buf, len, done))
-        {
-            wxString error(XML_ErrorString(XML_GetErrorCode(parser)),
-                           *wxConvCurrent);
-            wxLogError(_("XML parsing error: '%s' at line %d"),
-                       error.c_str(),
-                       (int)XML_GetCurrentLineNumber(parser));
-            ok = false;
-            break;
-        }
-    } while (!done);
+    const bool ok = ParseXmlStream(parser, stream);
 
     if (ok)
     {
@@ -862,6 +1097,10 @@ bool wxXmlDocument::Load(wxInputStream& stream, const wxString& encoding, int fl
         delete root;
     }
 
+    // the nodes keep the arena alive as long as they need it
+    if ( ctx.arena )
+        ctx.arena->DecRef();
+
     XML_ParserFree(parser);
 #if !wxUSE_UNICODE
     if ( ctx.conv )
@@ -874,6 +1113,185 @@ bool wxXmlDocument::Load(wxInputStream& stream, const wxString& encoding, int fl
 
 
 
+//-----------------------------------------------------------------------------
+//  wxXmlAttributesView
+//-----------------------------------------------------------------------------
+
+wxXmlAttributesView::wxXmlAttributesView(const char **atts)
+    : m_atts(atts)
+{
+    m_count = 0;
+    while ( atts[2*m_count] )
+        m_count++;
+}
+
+const char *wxXmlAttributesView::GetNameUTF8(size_t n) const
+{
+    wxCHECK_MSG( n < m_count, NULL, "invalid attribute index" );
+
+    return m_atts[2*n];
+}
+
+const char *wxXmlAttributesView::GetValueUTF8(size_t n) const
+{
+    wxCHECK_MSG( n < m_count, NULL, "invalid attribute index" );
+
+    return m_atts[2*n + 1];
+}
+
+const char *wxXmlAttributesView::FindUTF8(const char *name) const
+{
+    for ( const char **a = m_atts; *a; a += 2 )
+    {
+        if ( strcmp(a[0], name) == 0 )
+            return a[1];
+    }
+
+    return NULL;
+}
+
+bool wxXmlAttributesView::GetAttribute(const wxString& name,
+                                       wxString *value) const
+{
+    const char * const utf8 = FindUTF8(name.utf8_str());
+    if ( !utf8 )
+        return false;
+
+    if ( value )
+        *value = wxString::FromUTF8Unchecked(utf8);
+
+    return true;
+}
+
+bool wxXmlAttributesView::HasAttribute(const wxString& name) const
+{
+    return FindUTF8(name.utf8_str()) != NULL;
+}
+
+//-----------------------------------------------------------------------------
+//  wxXmlReader
+//-----------------------------------------------------------------------------
+
+// This class only exists to give expat callbacks access to wxXmlReader.
+class wxXmlReaderCallbacks
+{
+public:
+    static void StartElement(wxXmlReader *reader,
+                             const char *name, const char **atts)
+    {
+        reader->m_depth++;
+        reader->OnStartElement(name, wxXmlAttributesView(atts));
+    }
+
+    static void EndElement(wxXmlReader *reader, const char *name)
+    {
+        reader->OnEndElement(name);
+        reader->m_depth--;
+    }
+};
+
+extern "C" {
+static void ReaderStartElementHnd(void *userData,
+                                  const char *name, const char **atts)
+{
+    wxXmlReaderCallbacks::StartElement(static_cast<wxXmlReader *>(userData),
+                                       name, atts);
+}
+
+static void ReaderEndElementHnd(void *userData, const char *name)
+{
+    wxXmlReaderCallbacks::EndElement(static_cast<wxXmlReader *>(userData),
+                                     name);
+}
+
+static void ReaderTextHnd(void *userData, const char *s, int len)
+{
+    static_cast<wxXmlReader *>(userData)->OnText(s, len);
+}
+
+static void ReaderStartCdataHnd(void *userData)
+{
+    static_cast<wxXmlReader *>(userData)->OnStartCData();
+}
+
+static void ReaderEndCdataHnd(void *userData)
+{
+    static_cast<wxXmlReader *>(userData)->OnEndCData();
+}
+
+static void ReaderCommentHnd(void *userData, const char *data)
+{
+    static_cast<wxXmlReader *>(userData)->OnComment(data);
+}
+
+static void ReaderPIHnd(void *userData, const char *target, const char *data)
+{
+    static_cast<wxXmlReader *>(userData)->OnProcessingInstruction(target, data);
+}
+} // extern "C"
+
+wxXmlReader::wxXmlReader()
+{
+    m_parser = NULL;
+    m_depth = 0;
+    m_stopped = false;
+}
+
+wxXmlReader::~wxXmlReader()
+{
+    wxASSERT_MSG( !m_parser, "wxXmlReader destroyed while parsing" );
+}
+
+bool wxXmlReader::Parse(const wxString& filename)
+{
+    wxFileInputStream stream(filename);
+    if (!stream.IsOk())
+        return false;
+    return Parse(stream);
+}
+
+bool wxXmlReader::Parse(wxInputStream& stream)
+{
+    wxCHECK_MSG( !m_parser, false, "wxXmlReader::Parse() is not reentrant" );
+
+    XML_Parser parser = XML_ParserCreate(NULL);
+    m_parser = parser;
+    m_depth = 0;
+    m_stopped = false;
+
+    XML_SetUserData(parser, this);
+    XML_SetElementHandler(parser, ReaderStartElementHnd, ReaderEndElementHnd);
+    XML_SetCharacterDataHandler(parser, ReaderTextHnd);
+    XML_SetCdataSectionHandler(parser, ReaderStartCdataHnd, ReaderEndCdataHnd);
+    XML_SetCommentHandler(parser, ReaderCommentHnd);
+    XML_SetProcessingInstructionHandler(parser, ReaderPIHnd);
+    XML_SetUnknownEncodingHandler(parser, UnknownEncodingHnd, NULL);
+
+    const bool ok = ParseXmlStream(parser, stream) || m_stopped;
+
+    XML_ParserFree(parser);
+    m_parser = NULL;
+
+    return ok;
+}
+
+void wxXmlReader::Stop()
+{
+    wxCHECK_RET( m_parser, "can only be called while parsing" );
+
+    m_stopped = true;
+    XML_StopParser(static_cast<XML_Parser>(m_parser), XML_FALSE);
+}
+
+int wxXmlReader::GetLineNumber() const
+{
+    wxCHECK_MSG( m_parser, -1, "can only be called while parsing" );
+
+    return XML_GetCurrentLineNumber(static_cast<XML_Parser>(m_parser));
+}
+
+
+
 //-----------------------------------------------------------------------------
 //  wxXmlDocument saving routines
 //-----------------------------------------------------------------------------
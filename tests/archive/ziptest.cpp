@@ -20,6 +20,7 @@
 
 #include "archivetest.h"
 #include "wx/zipstrm.h"
+#include "wx/mstream.h"
 
 using std::string;
 using std::auto_ptr;
@@ -65,6 +66,14 @@ void ZipTestCase::OnCreateArchive(wxZipOutputStream& zip)
 {
     m_comment << wxT("Comment for test ") << m_id;
     zip.SetComment(m_comment);
+
+    if (m_id % 2)
+        zip.SetFormat(wxZIP_FORMAT_ZIP64);
+
+    // compress some of the archives in parallel, using small blocks to make
+    // sure that the entries are really split
+    if (m_id % 3 == 0)
+        zip.SetThreadCount(2, 1024);
 }
 
 void ZipTestCase::OnArchiveExtracted(wxZipInputStream& zip, int expectedTotal)
@@ -204,6 +213,171 @@ void ZipPipeTestCase::runTest()
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+// Check finding the entries by name using the central directory index
+
+class ZipFindEntryTestCase : public CppUnit::TestCase
+{
+public:
+    ZipFindEntryTestCase(string name) :
+        CppUnit::TestCase(TestId::MakeId() + name)
+    { }
+
+protected:
+    void runTest();
+};
+
+void ZipFindEntryTestCase::runTest()
+{
+    static const char *names[] =
+    {
+        "zero",
+        "dir/",
+        "dir/one",
+        "dir/sub/two",
+        "zero",     // duplicate name, the first one should be found
+    };
+
+    wxMemoryOutputStream out;
+    {
+        wxZipOutputStream zip(out);
+        for (size_t n = 0; n < WXSIZEOF(names); n++) {
+            const wxString name = names[n];
+            if (name.Last() == '/') {
+                CPPUNIT_ASSERT(zip.PutNextDirEntry(name));
+            } else {
+                CPPUNIT_ASSERT(zip.PutNextEntry(name));
+                zip.PutC(char(n));
+            }
+        }
+        CPPUNIT_ASSERT(zip.Close());
+    }
+
+    wxMemoryInputStream in(out);
+    wxZipInputStream zip(in);
+
+    // interleave the lookups with iterating over the entries, which must be
+    // unaffected by them
+    auto_ptr<wxZipEntry> first(zip.GetNextEntry());
+    CPPUNIT_ASSERT(first.get() != NULL);
+    CPPUNIT_ASSERT_EQUAL("zero", first->GetName(wxPATH_UNIX));
+
+    auto_ptr<wxZipEntry> entry(zip.FindEntry("dir/sub/two", wxPATH_UNIX));
+    CPPUNIT_ASSERT(entry.get() != NULL);
+    CPPUNIT_ASSERT_EQUAL("dir/sub/two", entry->GetName(wxPATH_UNIX));
+    CPPUNIT_ASSERT(zip.OpenEntry(*entry));
+    CPPUNIT_ASSERT_EQUAL(3, zip.GetC());
+
+    entry.reset(zip.GetNextEntry());
+    CPPUNIT_ASSERT(entry.get() != NULL);
+    CPPUNIT_ASSERT_EQUAL("dir/", entry->GetName(wxPATH_UNIX));
+
+    entry.reset(zip.FindEntry("dir", wxPATH_UNIX));
+    CPPUNIT_ASSERT(entry.get() != NULL);
+    CPPUNIT_ASSERT(entry->IsDir());
+
+    entry.reset(zip.FindEntry("/dir/one/", wxPATH_UNIX));
+    CPPUNIT_ASSERT(entry.get() != NULL);
+    CPPUNIT_ASSERT_EQUAL("dir/one", entry->GetName(wxPATH_UNIX));
+    CPPUNIT_ASSERT(zip.OpenEntry(*entry));
+    CPPUNIT_ASSERT_EQUAL(2, zip.GetC());
+
+    entry.reset(zip.FindEntry("zero", wxPATH_UNIX));
+    CPPUNIT_ASSERT(entry.get() != NULL);
+    CPPUNIT_ASSERT_EQUAL(first->GetOffset(), entry->GetOffset());
+
+    CPPUNIT_ASSERT(zip.FindEntry("dir/two", wxPATH_UNIX) == NULL);
+
+    int count = 2;
+    while ((entry.reset(zip.GetNextEntry()), entry.get()) != NULL)
+        count++;
+    CPPUNIT_ASSERT_EQUAL(int(WXSIZEOF(names)), count);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Check the zip64 records are used when there are too many entries for the
+// end record or when the zip64 format is requested
+
+class Zip64TestCase : public CppUnit::TestCase
+{
+public:
+    Zip64TestCase(string name) :
+        CppUnit::TestCase(TestId::MakeId() + name)
+    { }
+
+protected:
+    void runTest();
+};
+
+void Zip64TestCase::runTest()
+{
+    // one more than fits in the end record
+    const int count = 0x10000;
+
+    wxMemoryOutputStream out;
+    {
+        wxZipOutputStream zip(out);
+        for (int n = 0; n < count; n++) {
+            CPPUNIT_ASSERT(zip.PutNextEntry(wxString::Format("%05x", n)));
+            zip.PutC(char(n));
+        }
+        CPPUNIT_ASSERT(zip.Close());
+    }
+
+    {
+        wxMemoryInputStream in(out);
+        wxZipInputStream zip(in);
+        CPPUNIT_ASSERT_EQUAL(count, zip.GetTotalEntries());
+
+        auto_ptr<wxZipEntry> entry(zip.FindEntry("0ffff"));
+        CPPUNIT_ASSERT(entry.get() != NULL);
+        CPPUNIT_ASSERT(zip.OpenEntry(*entry));
+        CPPUNIT_ASSERT_EQUAL(0xff, zip.GetC());
+
+        int n = 0;
+        while ((entry.reset(zip.GetNextEntry()), entry.get()) != NULL)
+            n++;
+        CPPUNIT_ASSERT_EQUAL(count, n);
+    }
+
+    // an archive with the zip64 extensions used for all the entries
+    wxMemoryOutputStream out64;
+    {
+        wxZipOutputStream zip(out64);
+        zip.SetFormat(wxZIP_FORMAT_ZIP64);
+        zip.SetComment("zip64");
+        CPPUNIT_ASSERT(zip.PutNextEntry("empty"));
+        CPPUNIT_ASSERT(zip.PutNextEntry("big"));
+        for (int n = 0; n < 100000; n++)
+            zip.PutC(char(n % 7));
+        CPPUNIT_ASSERT(zip.Close());
+    }
+
+    wxMemoryInputStream in(out64);
+    wxZipInputStream zip(in);
+    CPPUNIT_ASSERT_EQUAL(2, zip.GetTotalEntries());
+    CPPUNIT_ASSERT_EQUAL("zip64", zip.GetComment());
+
+    auto_ptr<wxZipEntry> entry(zip.GetNextEntry());
+    CPPUNIT_ASSERT(entry.get() != NULL);
+    CPPUNIT_ASSERT_EQUAL(0, entry->GetSize());
+
+    entry.reset(zip.GetNextEntry());
+    CPPUNIT_ASSERT(entry.get() != NULL);
+    CPPUNIT_ASSERT_EQUAL(100000, entry->GetSize());
+
+    char buf[1000];
+    int n = 0;
+    while (zip.Read(buf, sizeof(buf)).LastRead() > 0) {
+        for (size_t i = 0; i < zip.LastRead(); i++, n++)
+            CPPUNIT_ASSERT_EQUAL(char(n % 7), buf[i]);
+    }
+    CPPUNIT_ASSERT(zip.Eof());
+    CPPUNIT_ASSERT_EQUAL(100000, n);
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 // Zip suite 
 
@@ -242,6 +416,9 @@ ArchiveTestSuite *ziptest::makeSuite()
         }
 #endif
 
+    addTest(new ZipFindEntryTestCase("ZipFindEntryTestCase"));
+    addTest(new Zip64TestCase("Zip64TestCase"));
+
     return this;
 }
 
@@ -63,6 +63,12 @@ public:
     int GetNumericParameter() const { return m_numParam; }
     const wxString& GetStringParameter() const { return m_strParam; }
 
+    void SetWorkPerRun(double amount, const char *unit)
+    {
+        m_workPerRun = amount;
+        m_workUnit = unit;
+    }
+
 private:
     // list all registered benchmarks
     void ListBenchmarks();
@@ -73,6 +79,11 @@ private:
          m_avgCount,
          m_numParam;
     wxString m_strParam;
+
+    // the amount of work done by a single run of the current benchmark and
+    // its unit, set by the benchmark itself if it wants its throughput shown
+    double m_workPerRun;
+    wxString m_workUnit;
 };
 
 IMPLEMENT_APP_CONSOLE(BenchApp)
@@ -93,6 +104,11 @@ wxString Bench::GetStringParameter()
     return wxGetApp().GetStringParameter();
 }
 
+void Bench::SetWorkPerRun(double amount, const char *unit)
+{
+    wxGetApp().SetWorkPerRun(amount, unit);
+}
+
 // ============================================================================
 // BenchApp implementation
 // ============================================================================
@@ -102,6 +118,7 @@ BenchApp::BenchApp()
     m_avgCount = 10;
     m_numRuns = 10000; // just some default (TODO: switch to time-based one)
     m_numParam = 0;
+    m_workPerRun = 0;
 }
 
 bool BenchApp::OnInit()
@@ -257,6 +274,7 @@ int BenchApp::OnRun()
         long timeMin = LONG_MAX,
              timeMax = 0,
              timeTotal = 0;
+        m_workPerRun = 0;
         bool ok = func->Init();
         for ( long a = 0; ok && a < m_avgCount; a++ )
         {
@@ -294,8 +312,18 @@ int BenchApp::OnRun()
                 times -= 2;
             }
 
-            wxPrintf("%.2f avg (min=%ld, max=%ld)\n",
-                     (float)timeTotal / times, timeMin, timeMax);
+            const float timeAvg = (float)timeTotal / times;
+            wxPrintf("%.2f avg (min=%ld, max=%ld)", timeAvg, timeMin, timeMax);
+
+            if ( m_workPerRun > 0 && timeAvg > 0 )
+            {
+                // timeAvg is the time of m_numRuns runs in milliseconds
+                wxPrintf(", %.1f M%s/s",
+                         m_workPerRun * m_numRuns / timeAvg / 1000,
+                         m_workUnit);
+            }
+
+            wxPrintf("\n");
         }
 
         fflush(stdout);
@@ -92,6 +92,15 @@ long GetNumericParameter();
  */
 wxString GetStringParameter();
 
+/**
+    Set the amount of work done by each call of the current benchmark function.
+
+    If this is called, either from the benchmark function itself or from its
+    initialization function, the throughput in millions of the given units per
+    second is shown in addition to the time taken by the benchmark.
+ */
+void SetWorkPerRun(double amount, const char *unit);
+
 } // namespace Bench
 
 /**
@@ -0,0 +1,133 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/config.cpp
+// Purpose:     wxFileConfig benchmarks
+// Author:      wxWidgets team
+// Created:     2026-10-18
+// Copyright:   (c) 2026 wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "wx/fileconf.h"
+#include "wx/filename.h"
+#include "wx/sstream.h"
+#include "wx/wfstream.h"
+
+#include "bench.h"
+
+#if wxUSE_CONFIG
+
+// number of groups in the test config file
+static const int NUM_GROUPS = 100;
+
+// default number of entries in each of them, can be changed with "-p"
+static const int NUM_ENTRIES = 500;
+
+// number of entries accessed by each call of the benchmark functions
+static const int NUM_ACCESSED = 1000;
+
+static int gs_numEntries = NUM_ENTRIES;
+static wxString gs_configText;
+static wxString gs_configFile;
+static wxFileConfig *gs_config = NULL;
+
+// return the path of the n-th entry, the entries are spread over all groups
+static wxString GetEntryPath(int n)
+{
+    return wxString::Format("/Group%03d/Key%05d",
+                            n % NUM_GROUPS, (n / NUM_GROUPS) % gs_numEntries);
+}
+
+static bool ConfigInit()
+{
+    gs_numEntries = Bench::GetNumericParameter();
+    if ( gs_numEntries <= 0 )
+        gs_numEntries = NUM_ENTRIES;
+
+    // Generate the config file with the keys in an order different from the
+    // sorted one as it happens for the real files which are edited manually
+    // or written by different versions of the program.
+    gs_configText.clear();
+    for ( int g = 0; g < NUM_GROUPS; g++ )
+    {
+        gs_configText += wxString::Format("[Group%03d]\n", g);
+        for ( int n = 0; n < gs_numEntries; n++ )
+        {
+            const int key = (n * 7919) % gs_numEntries;
+            gs_configText += wxString::Format("Key%05d=Value of key %d\n",
+                                              key, key);
+        }
+    }
+
+    gs_configFile = wxFileName::CreateTempFileName("benchcfg");
+    if ( gs_configFile.empty() )
+        return false;
+
+    {
+        wxFileOutputStream out(gs_configFile);
+        const wxScopedCharBuffer buf = gs_configText.utf8_str();
+        if ( !out.WriteAll(buf.data(), buf.length()) )
+            return false;
+    }
+
+    gs_config = new wxFileConfig(wxString(), wxString(),
+                                 gs_configFile, wxString(),
+                                 wxCONFIG_USE_LOCAL_FILE);
+
+    return true;
+}
+
+static void ConfigDone()
+{
+    delete gs_config;
+    gs_config = NULL;
+
+    wxRemoveFile(gs_configFile);
+    gs_configFile.clear();
+    gs_configText.clear();
+}
+
+BENCHMARK_FUNC_WITH_INIT(FileConfigLoad, ConfigInit, ConfigDone)
+{
+    wxStringInputStream stream(gs_configText);
+    wxFileConfig config(stream);
+
+    return config.GetNumberOfGroups() == NUM_GROUPS;
+}
+
+BENCHMARK_FUNC_WITH_INIT(FileConfigRead, ConfigInit, ConfigDone)
+{
+    const int start = Bench::GetNumericParameter();
+
+    wxString value;
+    for ( int n = 0; n < NUM_ACCESSED; n++ )
+    {
+        if ( !gs_config->Read(GetEntryPath(start + n), &value) )
+            return false;
+    }
+
+    return true;
+}
+
+BENCHMARK_FUNC_WITH_INIT(FileConfigWrite, ConfigInit, ConfigDone)
+{
+    static int s_counter = 0;
+
+    for ( int n = 0; n < NUM_ACCESSED; n++ )
+    {
+        if ( !gs_config->Write(GetEntryPath(n), s_counter++) )
+            return false;
+    }
+
+    return true;
+}
+
+BENCHMARK_FUNC_WITH_INIT(FileConfigFlush, ConfigInit, ConfigDone)
+{
+    static int s_counter = 0;
+
+    // Change a single entry, as it typically happens, and save the file.
+    return gs_config->Write(GetEntryPath(0), s_counter++) &&
+            gs_config->Flush();
+}
+
+#endif // wxUSE_CONFIG
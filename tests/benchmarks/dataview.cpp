@@ -0,0 +1,280 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/dataview.cpp
+// Purpose:     wxDataViewCtrl benchmarks
+// Author:      wxWidgets team
+// Created:     2026-10-18
+// Copyright:   (c) 2026 wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "wx/app.h"
+#include "wx/dataview.h"
+#include "wx/vector.h"
+
+#include "bench.h"
+
+#if wxUSE_DATAVIEWCTRL
+
+// number of rows in the test control
+static const unsigned NUM_ROWS = 100000;
+
+// number of positions visited by each scrolling benchmark function call
+static const unsigned NUM_SCROLL_STEPS = 100;
+
+// the tree used by the tree benchmarks has this many top level containers,
+// each of which has the given number of subcontainers with the given number
+// of leaf items
+static const int NUM_TREE_CONTAINERS = 100;
+static const int NUM_TREE_SUBCONTAINERS = 10;
+static const int NUM_TREE_LEAVES = 100;
+
+// number of items selected and changed by each tree benchmark function call
+static const unsigned NUM_TREE_ITEMS_CHANGED = 100;
+
+// number of items in the model used by the clearing benchmark
+static const unsigned NUM_CLEARED_ITEMS = 1000000;
+
+namespace
+{
+
+// simple list model with two text columns
+class BenchListModel : public wxDataViewIndexListModel
+{
+public:
+    BenchListModel() : wxDataViewIndexListModel(NUM_ROWS) { }
+
+    virtual unsigned int GetColumnCount() const { return 2; }
+
+    virtual wxString GetColumnType(unsigned int WXUNUSED(col)) const
+    {
+        return "string";
+    }
+
+    virtual void GetValueByRow(wxVariant& variant,
+                               unsigned row, unsigned col) const
+    {
+        if ( col == 0 )
+            variant = wxString::Format("Row %u", row);
+        else
+            variant = wxString('x', row % 50);
+    }
+
+    virtual bool SetValueByRow(const wxVariant& WXUNUSED(variant),
+                               unsigned WXUNUSED(row),
+                               unsigned WXUNUSED(col))
+    {
+        return false;
+    }
+};
+
+wxDataViewCtrl *gs_dvc = NULL;
+BenchListModel *gs_model = NULL;
+
+bool DataViewInit(int style)
+{
+    gs_dvc = new wxDataViewCtrl(wxTheApp->GetTopWindow(), wxID_ANY,
+                                wxDefaultPosition, wxSize(400, 300),
+                                style);
+    gs_dvc->AppendTextColumn("Name", 0);
+    gs_dvc->AppendTextColumn("Value", 1);
+
+    gs_model = new BenchListModel;
+    gs_dvc->AssociateModel(gs_model);
+    gs_model->DecRef();
+
+    return true;
+}
+
+bool DataViewInitFixed() { return DataViewInit(0); }
+
+bool DataViewInitVariable() { return DataViewInit(wxDV_VARIABLE_LINE_HEIGHT); }
+
+void DataViewDone()
+{
+    delete gs_dvc;
+    gs_dvc = NULL;
+    gs_model = NULL;
+}
+
+// scroll the control to the rows spread over all the model and find the item
+// shown in the middle of it after each scroll
+bool ScrollAll()
+{
+    bool ok = true;
+    for ( unsigned n = 0; n < NUM_SCROLL_STEPS; n++ )
+    {
+        const unsigned row = (n * 7919L) % NUM_ROWS;
+        gs_dvc->EnsureVisible(gs_model->GetItem(row));
+
+        wxDataViewItem item;
+        wxDataViewColumn *column;
+        gs_dvc->HitTest(wxPoint(10, 150), item, column);
+        if ( !item.IsOk() )
+            ok = false;
+    }
+
+    return ok;
+}
+
+wxDataViewTreeCtrl *gs_tree = NULL;
+wxVector<wxDataViewItem> gs_treeLeaves;
+
+bool DataViewTreeInit()
+{
+    gs_tree = new wxDataViewTreeCtrl(wxTheApp->GetTopWindow(), wxID_ANY,
+                                     wxDefaultPosition, wxSize(400, 300));
+
+    for ( int n = 0; n < NUM_TREE_CONTAINERS; n++ )
+    {
+        const wxDataViewItem
+            container = gs_tree->AppendContainer(wxDataViewItem(),
+                                                 wxString::Format("%d", n));
+        for ( int m = 0; m < NUM_TREE_SUBCONTAINERS; m++ )
+        {
+            const wxDataViewItem
+                sub = gs_tree->AppendContainer(container,
+                                               wxString::Format("%d.%d", n, m));
+            for ( int k = 0; k < NUM_TREE_LEAVES; k++ )
+            {
+                gs_treeLeaves.push_back(
+                    gs_tree->AppendItem(sub,
+                                        wxString::Format("%d.%d.%d", n, m, k)));
+            }
+        }
+    }
+
+    return true;
+}
+
+void DataViewTreeDone()
+{
+    delete gs_tree;
+    gs_tree = NULL;
+    gs_treeLeaves.clear();
+}
+
+// flat tree model with the items identified by their 1-based indices
+class BenchFlatModel : public wxDataViewModel
+{
+public:
+    BenchFlatModel() { }
+
+    virtual unsigned int GetColumnCount() const { return 1; }
+
+    virtual wxString GetColumnType(unsigned int WXUNUSED(col)) const
+    {
+        return "string";
+    }
+
+    virtual void GetValue(wxVariant& variant,
+                          const wxDataViewItem& item,
+                          unsigned int WXUNUSED(col)) const
+    {
+        variant = wxString::Format("Item %u", wxPtrToUInt(item.GetID()));
+    }
+
+    virtual bool SetValue(const wxVariant& WXUNUSED(variant),
+                          const wxDataViewItem& WXUNUSED(item),
+                          unsigned int WXUNUSED(col))
+    {
+        return false;
+    }
+
+    virtual wxDataViewItem GetParent(const wxDataViewItem& WXUNUSED(item)) const
+    {
+        return wxDataViewItem();
+    }
+
+    virtual bool IsContainer(const wxDataViewItem& item) const
+    {
+        return !item.IsOk();
+    }
+
+    virtual unsigned int GetChildren(const wxDataViewItem& item,
+                                     wxDataViewItemArray& children) const
+    {
+        if ( item.IsOk() )
+            return 0;
+
+        children.Alloc(NUM_CLEARED_ITEMS);
+        for ( unsigned n = 1; n <= NUM_CLEARED_ITEMS; n++ )
+            children.Add(wxDataViewItem(wxUIntToPtr(n)));
+
+        return NUM_CLEARED_ITEMS;
+    }
+};
+
+wxDataViewCtrl *gs_flat = NULL;
+BenchFlatModel *gs_flatModel = NULL;
+
+bool DataViewFlatInit()
+{
+    gs_flat = new wxDataViewCtrl(wxTheApp->GetTopWindow(), wxID_ANY,
+                                 wxDefaultPosition, wxSize(400, 300));
+    gs_flat->AppendTextColumn("Name", 0);
+
+    gs_flatModel = new BenchFlatModel;
+    gs_flat->AssociateModel(gs_flatModel);
+    gs_flatModel->DecRef();
+
+    return true;
+}
+
+void DataViewFlatDone()
+{
+    delete gs_flat;
+    gs_flat = NULL;
+    gs_flatModel = NULL;
+}
+
+} // anonymous namespace
+
+BENCHMARK_FUNC_WITH_INIT(DataViewScroll, DataViewInitFixed, DataViewDone)
+{
+    return ScrollAll();
+}
+
+BENCHMARK_FUNC_WITH_INIT(DataViewScrollVariableHeight,
+                         DataViewInitVariable, DataViewDone)
+{
+    return ScrollAll();
+}
+
+// Select and change the items spread over all the tree, expanding more and
+// more of it.
+BENCHMARK_FUNC_WITH_INIT(DataViewTreeSelectChange,
+                         DataViewTreeInit, DataViewTreeDone)
+{
+    bool ok = true;
+    for ( unsigned n = 0; n < NUM_TREE_ITEMS_CHANGED; n++ )
+    {
+        const wxDataViewItem&
+            item = gs_treeLeaves[(n * 7919L) % gs_treeLeaves.size()];
+
+        gs_tree->Select(item);
+        gs_tree->SetItemText(item, gs_tree->GetItemText(item));
+
+        if ( !gs_tree->IsSelected(item) )
+            ok = false;
+    }
+
+    return ok;
+}
+
+// Rebuild the entire tree after the model was reset and show it again.
+BENCHMARK_FUNC_WITH_INIT(DataViewClearedPaint,
+                         DataViewFlatInit, DataViewFlatDone)
+{
+    gs_flatModel->Cleared();
+
+    gs_flat->Refresh();
+    gs_flat->Update();
+
+    wxDataViewItem item;
+    wxDataViewColumn *column;
+    gs_flat->HitTest(wxPoint(10, 150), item, column);
+
+    return item.IsOk();
+}
+
+#endif // wxUSE_DATAVIEWCTRL
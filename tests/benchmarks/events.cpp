@@ -0,0 +1,148 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/events.cpp
+// Purpose:     Event dispatching benchmarks
+// Author:      wxWidgets team
+// Created:     2026-10-18
+// Copyright:   (c) 2026 wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "wx/event.h"
+#include "wx/vector.h"
+
+#include "bench.h"
+
+// number of events dispatched by each benchmark function call
+static const int NUM_EVENTS = 100;
+
+// default number of dynamic event handlers, can be changed with "-n" option
+static const int NUM_BINDINGS = 200;
+
+namespace
+{
+
+class BenchEventHandler : public wxEvtHandler
+{
+public:
+    BenchEventHandler() : m_count(0) { }
+
+    void OnEvent(wxThreadEvent& WXUNUSED(event)) { m_count++; }
+
+    int m_count;
+};
+
+BenchEventHandler *gs_handler = NULL;
+
+// the event type which has a handler and the one which doesn't
+wxEventType gs_eventTypeHandled = wxEVT_NULL;
+wxEventType gs_eventTypeUnhandled = wxEVT_NULL;
+
+} // anonymous namespace
+
+static bool EventsInit()
+{
+    int numBindings = Bench::GetNumericParameter();
+    if ( numBindings <= 0 )
+        numBindings = NUM_BINDINGS;
+
+    gs_handler = new BenchEventHandler;
+
+    // Bind the handler for the event we're going to send first, so that it
+    // is the last one to be found if the handlers are searched linearly,
+    // this is similar to a window having a mouse move handler and many other
+    // handlers bound later.
+    gs_eventTypeHandled = wxNewEventType();
+    gs_handler->Bind(wxEventTypeTag<wxThreadEvent>(gs_eventTypeHandled),
+                     &BenchEventHandler::OnEvent, gs_handler);
+
+    for ( int n = 1; n < numBindings; n++ )
+    {
+        gs_handler->Bind(wxEventTypeTag<wxThreadEvent>(wxNewEventType()),
+                         &BenchEventHandler::OnEvent, gs_handler);
+    }
+
+    gs_eventTypeUnhandled = wxNewEventType();
+
+    return true;
+}
+
+static void EventsDone()
+{
+    delete gs_handler;
+    gs_handler = NULL;
+}
+
+BENCHMARK_FUNC_WITH_INIT(DispatchBoundEvent, EventsInit, EventsDone)
+{
+    wxThreadEvent event(gs_eventTypeHandled);
+
+    const int countBefore = gs_handler->m_count;
+    for ( int n = 0; n < NUM_EVENTS; n++ )
+        gs_handler->ProcessEvent(event);
+
+    return gs_handler->m_count == countBefore + NUM_EVENTS;
+}
+
+BENCHMARK_FUNC_WITH_INIT(DispatchUnboundEvent, EventsInit, EventsDone)
+{
+    wxThreadEvent event(gs_eventTypeUnhandled);
+
+    bool processed = false;
+    for ( int n = 0; n < NUM_EVENTS; n++ )
+        processed |= gs_handler->ProcessEvent(event);
+
+    return !processed;
+}
+
+BENCHMARK_FUNC(BindUnbind)
+{
+    BenchEventHandler handler;
+
+    wxVector<wxEventType> eventTypes;
+    for ( int n = 0; n < NUM_BINDINGS; n++ )
+    {
+        const wxEventType eventType = wxNewEventType();
+        eventTypes.push_back(eventType);
+        handler.Bind(wxEventTypeTag<wxThreadEvent>(eventType),
+                     &BenchEventHandler::OnEvent, &handler);
+    }
+
+    bool ok = true;
+    for ( int n = 0; n < NUM_BINDINGS; n++ )
+    {
+        if ( !handler.Unbind(wxEventTypeTag<wxThreadEvent>(eventTypes[n]),
+                             &BenchEventHandler::OnEvent, &handler) )
+            ok = false;
+    }
+
+    return ok;
+}
+
+BENCHMARK_FUNC(QueueEvents)
+{
+    BenchEventHandler handler;
+    handler.Bind(wxEVT_THREAD, &BenchEventHandler::OnEvent, &handler);
+
+    for ( int n = 0; n < NUM_EVENTS; n++ )
+        handler.QueueEvent(new wxThreadEvent);
+
+    for ( int n = 0; n < NUM_EVENTS; n++ )
+        handler.ProcessPendingEvents();
+
+    return handler.m_count == NUM_EVENTS;
+}
+
+BENCHMARK_FUNC(QueueCoalescedEvents)
+{
+    BenchEventHandler handler;
+    handler.Bind(wxEVT_THREAD, &BenchEventHandler::OnEvent, &handler);
+
+    // Simulate a worker thread sending progress notifications faster than
+    // they can be processed: only the last one of them should remain.
+    for ( int n = 0; n < NUM_EVENTS; n++ )
+        handler.QueueOrReplaceEvent(new wxThreadEvent);
+
+    handler.ProcessPendingEvents();
+
+    return handler.m_count == 1;
+}
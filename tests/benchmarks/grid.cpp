@@ -0,0 +1,106 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/grid.cpp
+// Purpose:     wxGrid benchmarks
+// Author:      wxWidgets team
+// Created:     2026-10-18
+// Copyright:   (c) 2026 wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "wx/app.h"
+#include "wx/bitmap.h"
+#include "wx/dcmemory.h"
+#include "wx/grid.h"
+
+#include "bench.h"
+
+#if wxUSE_GRID
+
+// number of rows and columns in the test grid
+static const int NUM_ROWS = 200000;
+static const int NUM_COLS = 20;
+
+// every N-th row has some cells with custom attributes
+static const int ATTR_ROW_STEP = 50;
+
+// size of the area rendered by GridRender benchmark
+static const int RENDER_WIDTH = 1024;
+static const int RENDER_HEIGHT = 768;
+
+static wxGrid *gs_grid = NULL;
+
+static bool GridInit()
+{
+    gs_grid = new wxGrid(wxTheApp->GetTopWindow(), wxID_ANY);
+    gs_grid->CreateGrid(NUM_ROWS, NUM_COLS);
+
+    // Colour a few thousands of cells spread over the whole grid, this is
+    // what makes GetAttr() for the other cells expensive if the attributes
+    // lookup is linear in their number.
+    for ( int row = 0; row < NUM_ROWS; row += ATTR_ROW_STEP )
+    {
+        for ( int col = 0; col < NUM_COLS; col += 5 )
+        {
+            gs_grid->SetCellBackgroundColour(row, col, *wxYELLOW);
+        }
+    }
+
+    return true;
+}
+
+static void GridDone()
+{
+    delete gs_grid;
+    gs_grid = NULL;
+}
+
+BENCHMARK_FUNC_WITH_INIT(GridGetAttr, GridInit, GridDone)
+{
+    // Simulate painting of a screenful of cells somewhere in the middle of
+    // the grid by querying the attributes for all of them.
+    const int rowStart = Bench::GetNumericParameter() % (NUM_ROWS - 50);
+
+    bool ok = true;
+    for ( int row = rowStart; row < rowStart + 50; row++ )
+    {
+        for ( int col = 0; col < NUM_COLS; col++ )
+        {
+            wxGridCellAttr * const attr = gs_grid->GetTable()->GetAttr
+                                          (
+                                            row,
+                                            col,
+                                            wxGridCellAttr::Any
+                                          );
+            if ( attr )
+                attr->DecRef();
+            else
+                ok = false;
+        }
+    }
+
+    return ok;
+}
+
+BENCHMARK_FUNC_WITH_INIT(GridRender, GridInit, GridDone)
+{
+    wxBitmap bmp(RENDER_WIDTH, RENDER_HEIGHT);
+    wxMemoryDC dc(bmp);
+
+    const int rowStart = Bench::GetNumericParameter() % (NUM_ROWS - 50);
+
+    gs_grid->Render(dc,
+                    wxPoint(0, 0),
+                    wxSize(RENDER_WIDTH, RENDER_HEIGHT),
+                    wxGridCellCoords(rowStart, 0),
+                    wxGridCellCoords(rowStart + 50, NUM_COLS - 1));
+
+    return true;
+}
+
+BENCHMARK_FUNC_WITH_INIT(GridInsertRows, GridInit, GridDone)
+{
+    // Inserting and deleting rows at the top shifts all the attributes.
+    return gs_grid->InsertRows(0, 10) && gs_grid->DeleteRows(0, 10);
+}
+
+#endif // wxUSE_GRID
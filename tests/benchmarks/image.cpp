@@ -69,22 +69,117 @@ static const wxImage& GetTestImage()
     return s_image;
 }
 
+// Scale the image to the given size and report the resampling throughput in
+// the pixels of the bigger of the source and the destination images, as this
+// is what the time taken by the resampling is proportional to.
+static bool ScaleImage(const wxImage& image,
+                       int width,
+                       int height,
+                       wxImageResizeQuality quality)
+{
+    const double srcPixels = (double)image.GetWidth() * image.GetHeight(),
+                 dstPixels = (double)width * height;
+    Bench::SetWorkPerRun(srcPixels > dstPixels ? srcPixels : dstPixels,
+                         "Pixel");
+
+    return image.Scale(width, height, quality).IsOk();
+}
+
 BENCHMARK_FUNC(EnlargeNormal)
 {
-    return GetTestImage().Scale(300, 300, wxIMAGE_QUALITY_NORMAL).IsOk();
+    return ScaleImage(GetTestImage(), 300, 300, wxIMAGE_QUALITY_NORMAL);
 }
 
 BENCHMARK_FUNC(EnlargeHighQuality)
 {
-    return GetTestImage().Scale(300, 300, wxIMAGE_QUALITY_HIGH).IsOk();
+    return ScaleImage(GetTestImage(), 300, 300, wxIMAGE_QUALITY_HIGH);
 }
 
 BENCHMARK_FUNC(ShrinkNormal)
 {
-    return GetTestImage().Scale(50, 50, wxIMAGE_QUALITY_NORMAL).IsOk();
+    return ScaleImage(GetTestImage(), 50, 50, wxIMAGE_QUALITY_NORMAL);
 }
 
 BENCHMARK_FUNC(ShrinkHighQuality)
 {
-    return GetTestImage().Scale(50, 50, wxIMAGE_QUALITY_HIGH).IsOk();
+    return ScaleImage(GetTestImage(), 50, 50, wxIMAGE_QUALITY_HIGH);
+}
+
+// Bigger synthetic image used for measuring the resampling speed.
+static const wxImage& GetLargeTestImage()
+{
+    static wxImage s_image;
+    if ( !s_image.IsOk() )
+    {
+        s_image = GetTestImage().Scale(2000, 2000, wxIMAGE_QUALITY_NORMAL);
+        s_image.InitAlpha();
+    }
+
+    return s_image;
+}
+
+BENCHMARK_FUNC(ThumbnailBoxAverage)
+{
+    return ScaleImage(GetLargeTestImage(), 128, 128,
+                      wxIMAGE_QUALITY_BOX_AVERAGE);
+}
+
+BENCHMARK_FUNC(ThumbnailBilinear)
+{
+    return ScaleImage(GetLargeTestImage(), 128, 128, wxIMAGE_QUALITY_BILINEAR);
+}
+
+BENCHMARK_FUNC(ThumbnailBicubic)
+{
+    return ScaleImage(GetLargeTestImage(), 128, 128, wxIMAGE_QUALITY_BICUBIC);
+}
+
+BENCHMARK_FUNC(BlurSmall)
+{
+    return GetLargeTestImage().Blur(2).IsOk();
+}
+
+BENCHMARK_FUNC(BlurLarge)
+{
+    return GetLargeTestImage().Blur(50).IsOk();
+}
+
+BENCHMARK_FUNC(BlurGaussian)
+{
+    return GetLargeTestImage().BlurGaussian(20).IsOk();
+}
+
+// The benchmarks below use the number of threads given by the numeric
+// parameter, with the default value of 0 meaning to use all the CPUs, so run
+// them with "-p 1", "-p 2", "-p 4" and so on to check how they scale.
+static bool ImageThreadsInit()
+{
+    wxImage::SetThreadCount(Bench::GetNumericParameter());
+
+    return GetLargeTestImage().IsOk();
+}
+
+static void ImageThreadsDone()
+{
+    wxImage::SetThreadCount(1);
+}
+
+BENCHMARK_FUNC_WITH_INIT(ThreadedScale, ImageThreadsInit, ImageThreadsDone)
+{
+    return GetLargeTestImage().Scale(1500, 1500, wxIMAGE_QUALITY_BICUBIC).IsOk();
+}
+
+BENCHMARK_FUNC_WITH_INIT(ThreadedBlur, ImageThreadsInit, ImageThreadsDone)
+{
+    return GetLargeTestImage().Blur(10).IsOk();
+}
+
+BENCHMARK_FUNC_WITH_INIT(ThreadedRotate90, ImageThreadsInit, ImageThreadsDone)
+{
+    return GetLargeTestImage().Rotate90().IsOk();
+}
+
+BENCHMARK_FUNC_WITH_INIT(ThreadedGreyscale, ImageThreadsInit, ImageThreadsDone)
+{
+    return GetLargeTestImage().ConvertToGreyscale().IsOk();
 }
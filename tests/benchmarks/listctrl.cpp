@@ -0,0 +1,106 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/listctrl.cpp
+// Purpose:     wxGenericListCtrl benchmarks
+// Author:      wxWidgets team
+// Created:     2026-10-18
+// Copyright:   (c) 2026 wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "wx/app.h"
+#include "wx/listctrl.h"
+#include "wx/generic/listctrl.h"
+
+#include "bench.h"
+
+#if wxUSE_LISTCTRL
+
+// number of items in the test control
+static const long NUM_ITEMS = 100000;
+
+// number of items searched for or changed by each benchmark function call
+static const long NUM_STEPS = 1000;
+
+namespace
+{
+
+wxGenericListCtrl *gs_list = NULL;
+
+// return the label of the item with the given index, the labels are not in
+// the same order as the items
+wxString GetLabel(long n)
+{
+    return wxString::Format("Item %ld", (n * 7919) % NUM_ITEMS);
+}
+
+bool ListCtrlInit()
+{
+    gs_list = new wxGenericListCtrl(wxTheApp->GetTopWindow(), wxID_ANY,
+                                    wxDefaultPosition, wxSize(400, 300),
+                                    wxLC_REPORT);
+    gs_list->InsertColumn(0, "Name");
+
+    for ( long n = 0; n < NUM_ITEMS; n++ )
+        gs_list->InsertItem(n, GetLabel(n));
+
+    return true;
+}
+
+void ListCtrlDone()
+{
+    delete gs_list;
+    gs_list = NULL;
+}
+
+} // anonymous namespace
+
+// Find the items by their full labels and by their prefixes.
+BENCHMARK_FUNC_WITH_INIT(ListCtrlFindItem, ListCtrlInit, ListCtrlDone)
+{
+    bool ok = true;
+    for ( long n = 0; n < NUM_STEPS; n++ )
+    {
+        const long item = (n * 97) % NUM_ITEMS;
+        if ( gs_list->FindItem(-1, GetLabel(item).Upper()) != item )
+            ok = false;
+
+        if ( gs_list->FindItem(item, GetLabel(item), true) != item )
+            ok = false;
+    }
+
+    return ok;
+}
+
+// Find the next item starting with a single letter, as the incremental search
+// does, when almost all items match it.
+BENCHMARK_FUNC_WITH_INIT(ListCtrlFindItemTypeAhead, ListCtrlInit, ListCtrlDone)
+{
+    bool ok = true;
+    for ( long n = 0; n < NUM_STEPS; n++ )
+    {
+        const long item = (n * 97) % NUM_ITEMS;
+        if ( gs_list->FindItem(item, "i", true) != item )
+            ok = false;
+    }
+
+    return ok;
+}
+
+// Change the items labels while searching for them.
+BENCHMARK_FUNC_WITH_INIT(ListCtrlFindChangedItem, ListCtrlInit, ListCtrlDone)
+{
+    bool ok = true;
+    for ( long n = 0; n < NUM_STEPS; n++ )
+    {
+        const long item = (n * 97) % NUM_ITEMS;
+        gs_list->SetItemText(item, "Changed " + GetLabel(item));
+        if ( gs_list->FindItem(-1, "changed " + GetLabel(item)) != item )
+            ok = false;
+
+        gs_list->SetItemText(item, GetLabel(item));
+    }
+
+    return ok;
+}
+
+#endif // wxUSE_LISTCTRL
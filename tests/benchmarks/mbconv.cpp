@@ -42,6 +42,65 @@ bool ConvertToMB(const wxMBConv& conv)
     return conv.FromWChar(buf.data(), outlen, TEST_STRING) == outlen;
 }
 
+// size of the texts used by UTF-8 benchmarks, in characters
+const size_t UTF8_TEXT_LENGTH = 100000;
+
+// return a long text consisting mostly of ASCII characters
+const wxString& GetASCIIText()
+{
+    static wxString s_text;
+    if ( s_text.empty() )
+    {
+        while ( s_text.length() < UTF8_TEXT_LENGTH )
+        {
+            s_text += TEST_STRING;
+            s_text += L"\u00e9t\u00e9 \u00fcber na\u00efve.\n";
+        }
+    }
+
+    return s_text;
+}
+
+// return a long text consisting mostly of CJK characters
+const wxString& GetCJKText()
+{
+    static wxString s_text;
+    if ( s_text.empty() )
+    {
+        while ( s_text.length() < UTF8_TEXT_LENGTH )
+        {
+            // "Unicode is a character encoding standard" in Chinese and
+            // Japanese with some punctuation
+            s_text += L"\u7edf\u4e00\u7801\u662f\u4e00\u79cd\u5b57\u7b26"
+                      L"\u7f16\u7801\u6807\u51c6\u3002"
+                      L"\u30e6\u30cb\u30b3\u30fc\u30c9\u306f\u6587\u5b57"
+                      L"\u30b3\u30fc\u30c9\u306e\u898f\u683c\u3067\u3059"
+                      L"\u3002 (Unicode)\n";
+        }
+    }
+
+    return s_text;
+}
+
+bool ConvertFromUTF8(const wxString& text)
+{
+    static wxCharBuffer s_utf8;
+    static const wxString *s_text = NULL;
+    if ( s_text != &text )
+    {
+        s_utf8 = text.utf8_str();
+        s_text = &text;
+    }
+
+    return wxString::FromUTF8(s_utf8.data(), s_utf8.length()).length()
+            == text.length();
+}
+
+bool ConvertToUTF8(const wxString& text)
+{
+    return text.utf8_str().length() >= text.length();
+}
+
 } // anonymous namespace
 
 BENCHMARK_FUNC(UTF16InitWX)
@@ -76,3 +135,23 @@ BENCHMARK_FUNC(UTF16Sys)
     return ConvertToMB(wxCSConv("UTF-16LE"));
 }
 
+
+BENCHMARK_FUNC(FromUTF8ASCII)
+{
+    return ConvertFromUTF8(GetASCIIText());
+}
+
+BENCHMARK_FUNC(FromUTF8CJK)
+{
+    return ConvertFromUTF8(GetCJKText());
+}
+
+BENCHMARK_FUNC(ToUTF8ASCII)
+{
+    return ConvertToUTF8(GetASCIIText());
+}
+
+BENCHMARK_FUNC(ToUTF8CJK)
+{
+    return ConvertToUTF8(GetCJKText());
+}
@@ -0,0 +1,157 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/msgqueue.cpp
+// Purpose:     wxMessageQueue and wxLockFreeMessageQueue benchmarks
+// Author:      wxWidgets team
+// Created:     2026-10-18
+// Copyright:   (c) 2026 wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "wx/msgqueue.h"
+#include "wx/thread.h"
+
+#include "bench.h"
+
+#if wxUSE_THREADS
+
+// number of messages sent by each throughput benchmark function call
+static const int NUM_MESSAGES = 100000;
+
+// number of round trips done by each latency benchmark function call
+static const int NUM_ROUND_TRIPS = 1000;
+
+namespace
+{
+
+// thread posting the given number of messages to the queue
+template <class Queue>
+class ProducerThread : public wxThread
+{
+public:
+    ProducerThread(Queue& queue, int count)
+        : wxThread(wxTHREAD_JOINABLE),
+          m_queue(queue),
+          m_count(count)
+    {
+    }
+
+protected:
+    virtual void *Entry()
+    {
+        for ( int n = 0; n < m_count; n++ )
+            m_queue.Post(n);
+
+        return NULL;
+    }
+
+private:
+    Queue& m_queue;
+    const int m_count;
+};
+
+// thread sending back all the messages it receives until it gets -1
+template <class Queue>
+class EchoThread : public wxThread
+{
+public:
+    EchoThread(Queue& in, Queue& out)
+        : wxThread(wxTHREAD_JOINABLE),
+          m_in(in),
+          m_out(out)
+    {
+    }
+
+protected:
+    virtual void *Entry()
+    {
+        for ( ;; )
+        {
+            int msg;
+            if ( m_in.Receive(msg) != wxMSGQUEUE_NO_ERROR || msg == -1 )
+                break;
+
+            m_out.Post(msg);
+        }
+
+        return NULL;
+    }
+
+private:
+    Queue& m_in;
+    Queue& m_out;
+};
+
+// receive NUM_MESSAGES posted by another thread
+template <class Queue>
+bool Throughput()
+{
+    Queue queue;
+
+    ProducerThread<Queue> thread(queue, NUM_MESSAGES);
+    if ( thread.Run() != wxTHREAD_NO_ERROR )
+        return false;
+
+    bool ok = true;
+    for ( int n = 0; n < NUM_MESSAGES; n++ )
+    {
+        int msg;
+        if ( queue.Receive(msg) != wxMSGQUEUE_NO_ERROR || msg != n )
+            ok = false;
+    }
+
+    thread.Wait();
+
+    return ok;
+}
+
+// send a message to another thread and wait for the reply NUM_ROUND_TRIPS
+// times
+template <class Queue>
+bool Latency()
+{
+    Queue in,
+          out;
+
+    EchoThread<Queue> thread(out, in);
+    if ( thread.Run() != wxTHREAD_NO_ERROR )
+        return false;
+
+    bool ok = true;
+    for ( int n = 0; n < NUM_ROUND_TRIPS; n++ )
+    {
+        out.Post(n);
+
+        int msg;
+        if ( in.Receive(msg) != wxMSGQUEUE_NO_ERROR || msg != n )
+            ok = false;
+    }
+
+    out.Post(-1);
+    thread.Wait();
+
+    return ok;
+}
+
+} // anonymous namespace
+
+BENCHMARK_FUNC(MsgQueueThroughput)
+{
+    return Throughput< wxMessageQueue<int> >();
+}
+
+BENCHMARK_FUNC(LockFreeMsgQueueThroughput)
+{
+    return Throughput< wxLockFreeMessageQueue<int> >();
+}
+
+BENCHMARK_FUNC(MsgQueueLatency)
+{
+    return Latency< wxMessageQueue<int> >();
+}
+
+BENCHMARK_FUNC(LockFreeMsgQueueLatency)
+{
+    return Latency< wxLockFreeMessageQueue<int> >();
+}
+
+#endif // wxUSE_THREADS
@@ -0,0 +1,199 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/mutex.cpp
+// Purpose:     wxMutex and wxRWLock benchmarks
+// Author:      wxWidgets team
+// Created:     2026-10-18
+// Copyright:   (c) 2026 wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "wx/thread.h"
+#include "wx/vector.h"
+
+#include "bench.h"
+
+#if wxUSE_THREADS
+
+// default number of threads used by the contention benchmarks, can be
+// changed with "-p"
+static const int NUM_THREADS = 4;
+
+// number of times the lock is acquired by each thread
+static const int NUM_ITER = 10000;
+
+// the readers/writers benchmarks modify the data once per this many accesses
+static const int WRITE_FREQUENCY = 100;
+
+namespace
+{
+
+wxMutex gs_mutex;
+wxMutex gs_mutexAdaptive(wxMUTEX_ADAPTIVE);
+wxRWLock gs_rwlock;
+
+// the data protected by the locks above
+int gs_counter = 0;
+int gs_data[16];
+
+// lock the given mutex NUM_ITER times, incrementing the counter each time
+void IncrementCounter(wxMutex& mutex)
+{
+    for ( int n = 0; n < NUM_ITER; n++ )
+    {
+        wxMutexLocker lock(mutex);
+        gs_counter++;
+    }
+}
+
+void IncrementWithMutex() { IncrementCounter(gs_mutex); }
+void IncrementWithAdaptiveMutex() { IncrementCounter(gs_mutexAdaptive); }
+
+// read the data most of the time, modifying it only rarely
+int SumData()
+{
+    int sum = 0;
+    for ( size_t n = 0; n < WXSIZEOF(gs_data); n++ )
+        sum += gs_data[n];
+
+    return sum;
+}
+
+void ModifyData(int value)
+{
+    for ( size_t n = 0; n < WXSIZEOF(gs_data); n++ )
+        gs_data[n] = value;
+}
+
+void AccessWithMutex()
+{
+    for ( int n = 0; n < NUM_ITER; n++ )
+    {
+        wxMutexLocker lock(gs_mutex);
+        if ( n % WRITE_FREQUENCY )
+            gs_counter += SumData();
+        else
+            ModifyData(n);
+    }
+}
+
+void AccessWithRWLock()
+{
+    int sum = 0;
+    for ( int n = 0; n < NUM_ITER; n++ )
+    {
+        if ( n % WRITE_FREQUENCY )
+        {
+            wxReadLocker lock(gs_rwlock);
+            sum += SumData();
+        }
+        else
+        {
+            wxWriteLocker lock(gs_rwlock);
+            ModifyData(n);
+        }
+    }
+
+    wxMutexLocker lock(gs_mutex);
+    gs_counter += sum;
+}
+
+// thread calling the given function once
+class BenchThread : public wxThread
+{
+public:
+    BenchThread(void (*func)())
+        : wxThread(wxTHREAD_JOINABLE),
+          m_func(func)
+    {
+    }
+
+protected:
+    virtual void *Entry()
+    {
+        m_func();
+        return NULL;
+    }
+
+private:
+    void (* const m_func)();
+};
+
+// run the given function in the given number of threads simultaneously
+bool RunInThreads(void (*func)())
+{
+    int numThreads = Bench::GetNumericParameter();
+    if ( numThreads <= 0 )
+        numThreads = NUM_THREADS;
+
+    wxVector<BenchThread *> threads;
+    for ( int n = 0; n < numThreads; n++ )
+    {
+        BenchThread * const thread = new BenchThread(func);
+        if ( thread->Run() != wxTHREAD_NO_ERROR )
+        {
+            delete thread;
+            break;
+        }
+
+        threads.push_back(thread);
+    }
+
+    for ( size_t n = 0; n < threads.size(); n++ )
+    {
+        threads[n]->Wait();
+        delete threads[n];
+    }
+
+    return threads.size() == (size_t)numThreads;
+}
+
+} // anonymous namespace
+
+// Uncontended locking from a single thread.
+BENCHMARK_FUNC(MutexLock)
+{
+    IncrementWithMutex();
+    return true;
+}
+
+BENCHMARK_FUNC(AdaptiveMutexLock)
+{
+    IncrementWithAdaptiveMutex();
+    return true;
+}
+
+BENCHMARK_FUNC(RWLockReadLock)
+{
+    int sum = 0;
+    for ( int n = 0; n < NUM_ITER; n++ )
+    {
+        wxReadLocker lock(gs_rwlock);
+        sum += gs_counter;
+    }
+
+    return sum >= 0;
+}
+
+// Several threads incrementing the same counter.
+BENCHMARK_FUNC(MutexContention)
+{
+    return RunInThreads(IncrementWithMutex);
+}
+
+BENCHMARK_FUNC(AdaptiveMutexContention)
+{
+    return RunInThreads(IncrementWithAdaptiveMutex);
+}
+
+// Several threads mostly reading the same data.
+BENCHMARK_FUNC(MutexReaders)
+{
+    return RunInThreads(AccessWithMutex);
+}
+
+BENCHMARK_FUNC(RWLockReaders)
+{
+    return RunInThreads(AccessWithRWLock);
+}
+
+#endif // wxUSE_THREADS
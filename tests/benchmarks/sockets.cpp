@@ -0,0 +1,419 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/sockets.cpp
+// Purpose:     wxSocketBase benchmarks using the loopback interface
+// Author:      wxWidgets team
+// Created:     2026-10-18
+// Copyright:   (c) 2026 wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "wx/app.h"
+#include "wx/evtloop.h"
+#include "wx/file.h"
+#include "wx/filename.h"
+#include "wx/socket.h"
+#include "wx/vector.h"
+
+#include "bench.h"
+
+#if wxUSE_SOCKETS
+
+// default number of simultaneous connections, can be changed with "-p" but
+// notice that wxSocketBase uses select() for waiting, so the total number of
+// descriptors must remain below FD_SETSIZE
+static const int NUM_CONNECTIONS = 100;
+
+// size of the messages exchanged over each connection
+static const size_t MSG_SIZE = 64;
+
+// number of messages sent by each call of the single connection benchmarks
+static const int NUM_MESSAGES = 100;
+
+// number of buffers written by each WriteV() call
+static const int NUM_BUFFERS = 16;
+
+// size of the file sent by the file benchmarks
+static const size_t FILE_SIZE = 4*1024*1024;
+
+namespace
+{
+
+// echoes the data received by the server side sockets back and counts the
+// data received by the client side ones
+class EchoHandler : public wxEvtHandler
+{
+public:
+    EchoHandler() : m_received(0) { }
+
+    void OnSocketEvent(wxSocketEvent& event)
+    {
+        if ( event.GetSocketEvent() != wxSOCKET_INPUT )
+            return;
+
+        wxSocketBase * const sock = event.GetSocket();
+
+        char buf[MSG_SIZE];
+        const size_t len = sock->Read(buf, sizeof(buf)).LastCount();
+
+        if ( event.GetClientData() )
+            sock->Write(buf, len);
+        else
+            m_received += len;
+    }
+
+    size_t m_received;
+};
+
+int gs_numConnections = NUM_CONNECTIONS;
+unsigned short gs_port = 0;
+wxSocketServer *gs_server = NULL;
+EchoHandler *gs_handler = NULL;
+
+// the client and server sides of all connections used by SocketMessages
+wxVector<wxSocketBase *> gs_clients;
+wxVector<wxSocketBase *> gs_servers;
+
+void SetupForEvents(wxSocketBase *sock, bool server)
+{
+    sock->SetFlags(wxSOCKET_NOWAIT);
+    sock->SetEventHandler(*gs_handler);
+    sock->SetClientData(server ? gs_handler : NULL);
+    sock->SetNotify(wxSOCKET_INPUT_FLAG | wxSOCKET_LOST_FLAG);
+    sock->Notify(true);
+}
+
+// return the address the server is listening on
+wxIPV4address GetServerAddress()
+{
+    wxIPV4address addr;
+    addr.LocalHost();
+    addr.Service(gs_port);
+    return addr;
+}
+
+} // anonymous namespace
+
+static bool SocketsInit()
+{
+    gs_numConnections = Bench::GetNumericParameter();
+    if ( gs_numConnections <= 0 )
+        gs_numConnections = NUM_CONNECTIONS;
+
+    if ( !wxSocketBase::Initialize() )
+        return false;
+
+    wxIPV4address addr;
+    addr.LocalHost();
+    addr.Service(0);
+
+    gs_server = new wxSocketServer(addr, wxSOCKET_REUSEADDR);
+    if ( !gs_server->IsOk() || !gs_server->GetLocal(addr) )
+        return false;
+
+    gs_port = addr.Service();
+
+    gs_handler = new EchoHandler;
+    gs_handler->Bind(wxEVT_SOCKET, &EchoHandler::OnSocketEvent, gs_handler);
+
+    for ( int n = 0; n < gs_numConnections; n++ )
+    {
+        wxSocketClient * const client = new wxSocketClient;
+        gs_clients.push_back(client);
+        if ( !client->Connect(GetServerAddress()) )
+            return false;
+
+        wxSocketBase * const server = gs_server->Accept();
+        if ( !server )
+            return false;
+        gs_servers.push_back(server);
+
+        SetupForEvents(client, false);
+        SetupForEvents(server, true);
+    }
+
+    return true;
+}
+
+static void SocketsDone()
+{
+    for ( size_t n = 0; n < gs_clients.size(); n++ )
+        gs_clients[n]->Destroy();
+    gs_clients.clear();
+
+    for ( size_t n = 0; n < gs_servers.size(); n++ )
+        gs_servers[n]->Destroy();
+    gs_servers.clear();
+
+    wxDELETE(gs_server);
+
+    // actually delete the sockets destroyed above
+    wxTheApp->ProcessIdle();
+
+    wxDELETE(gs_handler);
+}
+
+// Send a message over each connection and wait until they're all echoed back.
+BENCHMARK_FUNC_WITH_INIT(SocketMessages, SocketsInit, SocketsDone)
+{
+    wxEventLoop loop;
+    wxEventLoopActivator activate(&loop);
+
+    gs_handler->m_received = 0;
+
+    const char msg[MSG_SIZE] = { 0 };
+    for ( size_t n = 0; n < gs_clients.size(); n++ )
+    {
+        if ( gs_clients[n]->Write(msg, sizeof(msg)).LastCount() != sizeof(msg) )
+            return false;
+    }
+
+    // dispatch the socket events until everything is received back, giving
+    // up if nothing happens for too long
+    while ( gs_handler->m_received != gs_clients.size() * MSG_SIZE )
+    {
+        if ( loop.DispatchTimeout(1000) < 0 )
+            return false;
+
+        wxTheApp->ProcessPendingEvents();
+    }
+
+    return true;
+}
+
+// Open the given number of connections to the server and accept all of them.
+BENCHMARK_FUNC_WITH_INIT(SocketConnections, SocketsInit, SocketsDone)
+{
+    wxEventLoop loop;
+    wxEventLoopActivator activate(&loop);
+
+    wxVector<wxSocketBase *> sockets;
+
+    // Notice that we need to accept the connections as they come as the
+    // server backlog is small and the connections not fitting into it would
+    // be delayed by the TCP retransmission timeout.
+    bool ok = true;
+    for ( int n = 0; n < gs_numConnections && ok; n++ )
+    {
+        wxSocketClient * const client = new wxSocketClient(wxSOCKET_NOWAIT);
+        sockets.push_back(client);
+
+        // this is expected to return false as the connection is not
+        // established yet
+        client->Connect(GetServerAddress(), false);
+
+        wxSocketBase * const server = gs_server->Accept(true);
+        if ( server )
+            sockets.push_back(server);
+        else
+            ok = false;
+    }
+
+    for ( size_t n = 0; n < sockets.size(); n++ )
+        sockets[n]->Destroy();
+
+    wxTheApp->ProcessIdle();
+
+    return ok;
+}
+
+// ----------------------------------------------------------------------------
+// single connection benchmarks
+// ----------------------------------------------------------------------------
+
+static wxSocketClient *gs_client = NULL;
+static wxSocketBase *gs_peer = NULL;
+static wxString gs_filename;
+
+static bool StreamInit()
+{
+    if ( !wxSocketBase::Initialize() )
+        return false;
+
+    wxIPV4address addr;
+    addr.LocalHost();
+    addr.Service(0);
+
+    gs_server = new wxSocketServer(addr, wxSOCKET_REUSEADDR);
+    if ( !gs_server->IsOk() || !gs_server->GetLocal(addr) )
+        return false;
+
+    gs_port = addr.Service();
+
+    gs_client = new wxSocketClient(wxSOCKET_WAITALL);
+    if ( !gs_client->Connect(GetServerAddress()) )
+        return false;
+
+    gs_peer = gs_server->Accept();
+    if ( !gs_peer )
+        return false;
+
+    gs_peer->SetFlags(wxSOCKET_WAITALL);
+
+    return true;
+}
+
+static void StreamDone()
+{
+    if ( gs_peer )
+    {
+        gs_peer->Destroy();
+        gs_peer = NULL;
+    }
+
+    if ( gs_client )
+    {
+        gs_client->Destroy();
+        gs_client = NULL;
+    }
+
+    wxDELETE(gs_server);
+
+    wxTheApp->ProcessIdle();
+}
+
+BENCHMARK_FUNC_WITH_INIT(SocketWriteMsg, StreamInit, StreamDone)
+{
+    char buf[MSG_SIZE] = { 0 };
+    for ( int n = 0; n < NUM_MESSAGES; n++ )
+    {
+        gs_client->WriteMsg(buf, sizeof(buf));
+        gs_peer->ReadMsg(buf, sizeof(buf));
+        if ( gs_peer->LastReadCount() != sizeof(buf) )
+            return false;
+    }
+
+    return true;
+}
+
+// Write the data from NUM_BUFFERS separate buffers.
+static bool WriteBuffers(bool vectored)
+{
+    static char bufs[NUM_BUFFERS][MSG_SIZE];
+
+    wxSocketIOVec vec[NUM_BUFFERS];
+    for ( int n = 0; n < NUM_BUFFERS; n++ )
+    {
+        vec[n].buffer = bufs[n];
+        vec[n].nbytes = MSG_SIZE;
+    }
+
+    char in[NUM_BUFFERS*MSG_SIZE];
+    for ( int n = 0; n < NUM_MESSAGES; n++ )
+    {
+        if ( vectored )
+        {
+            gs_client->WriteV(vec, NUM_BUFFERS);
+        }
+        else
+        {
+            for ( int i = 0; i < NUM_BUFFERS; i++ )
+                gs_client->Write(vec[i].buffer, vec[i].nbytes);
+        }
+
+        if ( gs_peer->Read(in, sizeof(in)).LastReadCount() != sizeof(in) )
+            return false;
+    }
+
+    return true;
+}
+
+BENCHMARK_FUNC_WITH_INIT(SocketWrite, StreamInit, StreamDone)
+{
+    return WriteBuffers(false);
+}
+
+BENCHMARK_FUNC_WITH_INIT(SocketWriteV, StreamInit, StreamDone)
+{
+    return WriteBuffers(true);
+}
+
+static bool FileInit()
+{
+    gs_filename = wxFileName::CreateTempFileName("benchsock");
+    if ( gs_filename.empty() )
+        return false;
+
+    {
+        wxFile file(gs_filename, wxFile::write);
+
+        char buf[4096];
+        for ( size_t n = 0; n < sizeof(buf); n++ )
+            buf[n] = (char)n;
+
+        for ( size_t n = 0; n < FILE_SIZE; n += sizeof(buf) )
+        {
+            if ( file.Write(buf, sizeof(buf)) != sizeof(buf) )
+                return false;
+        }
+    }
+
+    if ( !StreamInit() )
+        return false;
+
+    // the sender must not block as we read the data in the same thread
+    gs_client->SetFlags(wxSOCKET_NOWAIT);
+    gs_peer->SetFlags(wxSOCKET_NOWAIT);
+
+    return true;
+}
+
+static void FileDone()
+{
+    StreamDone();
+
+    wxRemoveFile(gs_filename);
+    gs_filename.clear();
+}
+
+// Send the entire file over the socket, either using SendFile() or by reading
+// it into a buffer and writing it.
+static bool SendFile(bool useSendFile)
+{
+    wxFile file(gs_filename);
+
+    static char buf[64*1024];
+    size_t sent = 0,
+           received = 0,
+           bufLen = 0,
+           bufPos = 0;
+    while ( received < FILE_SIZE )
+    {
+        if ( sent < FILE_SIZE )
+        {
+            if ( useSendFile )
+            {
+                gs_client->SendFile(file, FILE_SIZE - sent);
+            }
+            else
+            {
+                if ( bufPos == bufLen )
+                {
+                    bufLen = file.Read(buf, sizeof(buf));
+                    bufPos = 0;
+                }
+
+                gs_client->Write(buf + bufPos, bufLen - bufPos);
+                bufPos += gs_client->LastWriteCount();
+            }
+
+            sent += gs_client->LastWriteCount();
+        }
+
+        char in[64*1024];
+        received += gs_peer->Read(in, sizeof(in)).LastReadCount();
+    }
+
+    return true;
+}
+
+BENCHMARK_FUNC_WITH_INIT(SocketWriteFile, FileInit, FileDone)
+{
+    return SendFile(false);
+}
+
+BENCHMARK_FUNC_WITH_INIT(SocketSendFile, FileInit, FileDone)
+{
+    return SendFile(true);
+}
+
+#endif // wxUSE_SOCKETS
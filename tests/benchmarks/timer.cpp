@@ -0,0 +1,128 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/timer.cpp
+// Purpose:     wxTimer benchmarks
+// Author:      wxWidgets team
+// Created:     2026-10-18
+// Copyright:   (c) 2026 wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "wx/evtloop.h"
+#include "wx/time.h"
+#include "wx/timer.h"
+#include "wx/vector.h"
+
+#include "bench.h"
+
+#if wxUSE_TIMER
+
+// default number of timers used by the benchmarks, can be changed with "-p"
+static const int NUM_TIMERS = 100000;
+
+namespace
+{
+
+// timer counting its notifications
+class CountingTimer : public wxTimer
+{
+public:
+    CountingTimer(int& count) : m_count(count) { }
+
+    virtual void Notify() { m_count++; }
+
+private:
+    int& m_count;
+};
+
+// a set of timers which are all destroyed together
+class Timers
+{
+public:
+    Timers(int& count)
+    {
+        m_numTimers = Bench::GetNumericParameter();
+        if ( m_numTimers <= 0 )
+            m_numTimers = NUM_TIMERS;
+
+        m_timers.reserve(m_numTimers);
+        for ( int n = 0; n < m_numTimers; n++ )
+            m_timers.push_back(new CountingTimer(count));
+    }
+
+    ~Timers()
+    {
+        for ( int n = 0; n < m_numTimers; n++ )
+            delete m_timers[n];
+    }
+
+    int GetCount() const { return m_numTimers; }
+
+    // return the timer with the given index, the indices are scattered to
+    // avoid always accessing the timers in the order of their expiration
+    wxTimer& operator[](int n) const
+    {
+        return *m_timers[(n * 7919L) % m_numTimers];
+    }
+
+    // start all the timers with different intervals in the given range
+    void StartAll(int minInterval, int range)
+    {
+        for ( int n = 0; n < m_numTimers; n++ )
+            (*this)[n].Start(minInterval + n % range, true);
+    }
+
+private:
+    int m_numTimers;
+    wxVector<CountingTimer *> m_timers;
+};
+
+} // anonymous namespace
+
+// Start many timers and stop them before they expire.
+BENCHMARK_FUNC(TimerStartStop)
+{
+    int count = 0;
+    Timers timers(count);
+
+    timers.StartAll(10000, 1000);
+
+    for ( int n = 0; n < timers.GetCount(); n++ )
+        timers[timers.GetCount() - n - 1].Stop();
+
+    return count == 0;
+}
+
+// Restart many timers, as done for the timeouts postponed by activity.
+BENCHMARK_FUNC(TimerRestart)
+{
+    int count = 0;
+    Timers timers(count);
+
+    timers.StartAll(10000, 1000);
+
+    for ( int n = 0; n < timers.GetCount(); n++ )
+        timers[n].Start(20000 + n % 1000, true);
+
+    for ( int n = 0; n < timers.GetCount(); n++ )
+        timers[n].Stop();
+
+    return count == 0;
+}
+
+// Start many short timers and wait until all of them expire.
+BENCHMARK_FUNC(TimerExpire)
+{
+    int count = 0;
+    Timers timers(count);
+
+    timers.StartAll(1, 10);
+
+    wxEventLoop loop;
+    const wxMilliClock_t end = wxGetLocalTimeMillis() + 1000;
+    while ( count < timers.GetCount() && wxGetLocalTimeMillis() < end )
+        loop.DispatchTimeout(100);
+
+    return count == timers.GetCount();
+}
+
+#endif // wxUSE_TIMER
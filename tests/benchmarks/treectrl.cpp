@@ -0,0 +1,114 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/treectrl.cpp
+// Purpose:     wxGenericTreeCtrl benchmarks
+// Author:      wxWidgets team
+// Created:     2026-10-18
+// Copyright:   (c) 2026 wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "wx/app.h"
+#include "wx/treectrl.h"
+#include "wx/generic/treectlg.h"
+#include "wx/vector.h"
+
+#include "bench.h"
+
+#if wxUSE_TREECTRL
+
+// the tree used by the benchmarks has this many top level containers (under
+// the hidden root), each of which has the given number of leaf items, i.e.
+// it has 200 thousands items in total
+static const int NUM_CONTAINERS = 2000;
+static const int NUM_LEAVES = 100;
+
+// number of items scrolled to or toggled by each benchmark function call
+static const unsigned NUM_STEPS = 100;
+
+namespace
+{
+
+wxGenericTreeCtrl *gs_tree = NULL;
+wxVector<wxTreeItemId> gs_containers;
+
+bool TreeCtrlInit()
+{
+    gs_tree = new wxGenericTreeCtrl(wxTheApp->GetTopWindow(), wxID_ANY,
+                                    wxDefaultPosition, wxSize(400, 300),
+                                    wxTR_DEFAULT_STYLE | wxTR_HIDE_ROOT);
+
+    const wxTreeItemId root = gs_tree->AddRoot("root");
+    for ( int n = 0; n < NUM_CONTAINERS; n++ )
+    {
+        const wxTreeItemId
+            container = gs_tree->AppendItem(root, wxString::Format("%d", n));
+        for ( int m = 0; m < NUM_LEAVES; m++ )
+            gs_tree->AppendItem(container, wxString::Format("%d.%d", n, m));
+
+        gs_tree->Expand(container);
+        gs_containers.push_back(container);
+    }
+
+    gs_tree->Update();
+
+    return true;
+}
+
+void TreeCtrlDone()
+{
+    delete gs_tree;
+    gs_tree = NULL;
+    gs_containers.clear();
+}
+
+// check that there is an item in the middle of the control
+bool HasItemInTheMiddle()
+{
+    int flags;
+    return gs_tree->HitTest(wxPoint(30, 150), flags).IsOk();
+}
+
+} // anonymous namespace
+
+// Scroll to the items spread over all the tree and repaint it.
+BENCHMARK_FUNC_WITH_INIT(TreeCtrlScrollPaint, TreeCtrlInit, TreeCtrlDone)
+{
+    bool ok = true;
+    for ( unsigned n = 0; n < NUM_STEPS; n++ )
+    {
+        const wxTreeItemId&
+            item = gs_containers[(n * 7919L) % gs_containers.size()];
+
+        gs_tree->ScrollTo(item);
+        gs_tree->Refresh();
+        gs_tree->Update();
+
+        if ( !HasItemInTheMiddle() )
+            ok = false;
+    }
+
+    return ok;
+}
+
+// Collapse and expand the items spread over all the tree.
+BENCHMARK_FUNC_WITH_INIT(TreeCtrlToggle, TreeCtrlInit, TreeCtrlDone)
+{
+    bool ok = true;
+    for ( unsigned n = 0; n < NUM_STEPS; n++ )
+    {
+        const wxTreeItemId&
+            item = gs_containers[(n * 7919L) % gs_containers.size()];
+
+        gs_tree->Collapse(item);
+        if ( !HasItemInTheMiddle() )
+            ok = false;
+
+        gs_tree->Expand(item);
+        if ( !HasItemInTheMiddle() )
+            ok = false;
+    }
+
+    return ok;
+}
+
+#endif // wxUSE_TREECTRL
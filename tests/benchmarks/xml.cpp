@@ -0,0 +1,102 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/xml.cpp
+// Purpose:     XML parsing benchmarks
+// Author:      wxWidgets team
+// Created:     2026-10-18
+// Copyright:   (c) 2026 wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "wx/mstream.h"
+#include "wx/xml/xml.h"
+
+#include "bench.h"
+
+#if wxUSE_XML
+
+// default number of records in the test document, can be changed with "-p"
+static const int NUM_RECORDS = 10000;
+
+// the test document in UTF-8
+static wxCharBuffer gs_xmlData;
+
+static bool XmlInit()
+{
+    int numRecords = Bench::GetNumericParameter();
+    if ( numRecords <= 0 )
+        numRecords = NUM_RECORDS;
+
+    // Generate a document looking like a typical data export: many records
+    // using the same few element and attribute names.
+    wxString xml("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<export>\n");
+    for ( int n = 0; n < numRecords; n++ )
+    {
+        xml += wxString::Format
+               (
+                "  <record id=\"%d\" type=\"item\" state=\"active\">\n"
+                "    <name>Record number %d</name>\n"
+                "    <value unit=\"m\" precision=\"2\">%d.%02d</value>\n"
+                "    <flags><flag name=\"a\"/><flag name=\"b\"/></flags>\n"
+                "  </record>\n",
+                n, n, n / 100, n % 100
+               );
+    }
+    xml += "</export>\n";
+
+    gs_xmlData = xml.utf8_str();
+
+    return true;
+}
+
+static void XmlDone()
+{
+    gs_xmlData.reset();
+}
+
+static bool DoLoadXml(int flags)
+{
+    wxMemoryInputStream stream(gs_xmlData.data(), gs_xmlData.length());
+
+    wxXmlDocument doc;
+    return doc.Load(stream, "UTF-8", flags) && doc.GetRoot()->GetChildren();
+}
+
+BENCHMARK_FUNC_WITH_INIT(LoadXml, XmlInit, XmlDone)
+{
+    return DoLoadXml(wxXMLDOC_NONE);
+}
+
+BENCHMARK_FUNC_WITH_INIT(LoadXmlArena, XmlInit, XmlDone)
+{
+    return DoLoadXml(wxXMLDOC_USE_ARENA);
+}
+
+namespace
+{
+
+class RecordsCounter : public wxXmlReader
+{
+public:
+    RecordsCounter() : m_count(0) { }
+
+    virtual void OnStartElement(const char *name,
+                                const wxXmlAttributesView& attrs)
+    {
+        if ( strcmp(name, "record") == 0 && attrs.FindUTF8("id") )
+            m_count++;
+    }
+
+    int m_count;
+};
+
+} // anonymous namespace
+
+BENCHMARK_FUNC_WITH_INIT(ReadXml, XmlInit, XmlDone)
+{
+    wxMemoryInputStream stream(gs_xmlData.data(), gs_xmlData.length());
+
+    RecordsCounter counter;
+    return counter.Parse(stream) && counter.m_count > 0;
+}
+
+#endif // wxUSE_XML
@@ -0,0 +1,148 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/zip.cpp
+// Purpose:     wxZipInputStream and wxArchiveFSHandler benchmarks
+// Author:      wxWidgets team
+// Created:     2026-10-18
+// Copyright:   (c) 2026 wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "wx/filename.h"
+#include "wx/filesys.h"
+#include "wx/fs_arc.h"
+#include "wx/wfstream.h"
+#include "wx/zipstrm.h"
+
+#include "bench.h"
+
+#if wxUSE_ZIPSTREAM && wxUSE_FS_ARCHIVE
+
+// default number of entries in the test archive, can be changed with "-p"
+static const int NUM_ENTRIES = 40000;
+
+// number of entries opened by each call of the cached benchmark
+static const int NUM_OPENED = 100;
+
+static int gs_numEntries = NUM_ENTRIES;
+static wxString gs_zipFile;
+static wxString gs_zipURL;
+static wxArchiveFSHandler *gs_handler = NULL;
+
+static wxString GetEntryName(int n)
+{
+    return wxString::Format("dir%03d/file%05d.txt", n % 100, n);
+}
+
+static bool ZipInit()
+{
+    gs_numEntries = Bench::GetNumericParameter();
+    if ( gs_numEntries <= 0 )
+        gs_numEntries = NUM_ENTRIES;
+
+    gs_zipFile = wxFileName::CreateTempFileName("benchzip");
+    if ( gs_zipFile.empty() )
+        return false;
+
+    {
+        wxFileOutputStream out(gs_zipFile);
+        wxZipOutputStream zip(out);
+        for ( int n = 0; n < gs_numEntries; n++ )
+        {
+            const wxString name = GetEntryName(n);
+            zip.PutNextEntry(name);
+
+            const wxScopedCharBuffer buf = name.utf8_str();
+            zip.Write(buf.data(), buf.length());
+        }
+
+        if ( !zip.Close() || !out.Close() )
+            return false;
+    }
+
+    gs_zipURL = wxFileSystem::FileNameToURL(gs_zipFile) + "#zip:";
+
+    gs_handler = new wxArchiveFSHandler;
+
+    return true;
+}
+
+static void ZipDone()
+{
+    delete gs_handler;
+    gs_handler = NULL;
+
+    wxRemoveFile(gs_zipFile);
+    gs_zipFile.clear();
+}
+
+// open the entry using the given handler and check its contents
+static bool OpenWithHandler(wxArchiveFSHandler& handler, int n)
+{
+    wxFileSystem fs;
+    wxFSFile * const file = handler.OpenFile(fs, gs_zipURL + GetEntryName(n));
+    if ( !file )
+        return false;
+
+    char buf[64];
+    const size_t len = file->GetStream()->Read(buf, sizeof(buf)).LastRead();
+    delete file;
+
+    return wxString::FromUTF8(buf, len) == GetEntryName(n);
+}
+
+BENCHMARK_FUNC_WITH_INIT(ZipGetNextEntry, ZipInit, ZipDone)
+{
+    wxFileInputStream in(gs_zipFile);
+    wxZipInputStream zip(in);
+
+    int count = 0;
+    for ( ;; )
+    {
+        wxZipEntry * const entry = zip.GetNextEntry();
+        if ( !entry )
+            break;
+
+        delete entry;
+        count++;
+    }
+
+    return count == gs_numEntries;
+}
+
+BENCHMARK_FUNC_WITH_INIT(ZipFindEntry, ZipInit, ZipDone)
+{
+    wxFileInputStream in(gs_zipFile);
+    wxZipInputStream zip(in);
+
+    // look for the last entry as it's the worst case for a linear search
+    wxZipEntry * const entry = zip.FindEntry(GetEntryName(gs_numEntries - 1));
+    if ( !entry )
+        return false;
+
+    const bool ok = zip.OpenEntry(*entry);
+    delete entry;
+
+    return ok;
+}
+
+BENCHMARK_FUNC_WITH_INIT(ArchiveFSOpenFile, ZipInit, ZipDone)
+{
+    // use a new handler every time to avoid reusing its cached catalog
+    wxArchiveFSHandler handler;
+
+    return OpenWithHandler(handler, gs_numEntries - 1);
+}
+
+BENCHMARK_FUNC_WITH_INIT(ArchiveFSOpenFileCached, ZipInit, ZipDone)
+{
+    bool ok = true;
+    for ( int n = 0; n < NUM_OPENED; n++ )
+    {
+        if ( !OpenWithHandler(*gs_handler, (n * 7919) % gs_numEntries) )
+            ok = false;
+    }
+
+    return ok;
+}
+
+#endif // wxUSE_ZIPSTREAM && wxUSE_FS_ARCHIVE
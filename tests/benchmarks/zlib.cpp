@@ -0,0 +1,64 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/zlib.cpp
+// Purpose:     wxZlibOutputStream benchmarks
+// Author:      wxWidgets team
+// Created:     2026-10-18
+// Copyright:   (c) 2026 wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "wx/mstream.h"
+#include "wx/zstream.h"
+
+#include "bench.h"
+
+#if wxUSE_ZLIB
+
+// size of the data compressed by each benchmark function call
+static const size_t DATA_SIZE = 4*1024*1024;
+
+static wxMemoryBuffer gs_data;
+
+static bool ZlibInit()
+{
+    // generate some moderately compressible text-like data
+    unsigned long seed = 1;
+    for ( size_t n = 0; n < DATA_SIZE; n++ )
+    {
+        seed = seed * 1103515245 + 12345;
+        gs_data.AppendByte((char)('a' + (seed >> 16) % ((n >> 10) % 26 + 1)));
+    }
+
+    return true;
+}
+
+static void ZlibDone()
+{
+    gs_data.Clear();
+}
+
+// compress the data using the given number of threads
+static bool Compress(int numThreads)
+{
+    wxMemoryOutputStream out;
+    wxZlibOutputStream zout(out);
+    if ( numThreads != 1 && !zout.SetThreadCount(numThreads) )
+        return false;
+
+    zout.Write(gs_data.GetData(), gs_data.GetDataLen());
+
+    return zout.Close();
+}
+
+BENCHMARK_FUNC_WITH_INIT(ZlibCompress, ZlibInit, ZlibDone)
+{
+    return Compress(1);
+}
+
+BENCHMARK_FUNC_WITH_INIT(ZlibCompressParallel, ZlibInit, ZlibDone)
+{
+    // use as many threads as there are CPUs unless specified with "-p"
+    return Compress(Bench::GetNumericParameter());
+}
+
+#endif // wxUSE_ZLIB
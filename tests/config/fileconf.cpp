@@ -24,6 +24,8 @@
 #include "wx/fileconf.h"
 #include "wx/sstream.h"
 #include "wx/log.h"
+#include "wx/file.h"
+#include "wx/filename.h"
 
 static const wxChar *testconfig =
 wxT("[root]\n")
@@ -83,6 +85,8 @@ private:
         CPPUNIT_TEST( ReadNonExistent );
         CPPUNIT_TEST( ReadEmpty );
         CPPUNIT_TEST( ReadFloat );
+        CPPUNIT_TEST( Lookup );
+        CPPUNIT_TEST( Flush );
     CPPUNIT_TEST_SUITE_END();
 
     void Path();
@@ -108,6 +112,8 @@ private:
     void ReadNonExistent();
     void ReadEmpty();
     void ReadFloat();
+    void Lookup();
+    void Flush();
 
 
     static wxString ChangePath(wxFileConfig& fc, const wxChar *path)
@@ -699,5 +705,89 @@ void FileConfigTestCase::ReadFloat()
     CPPUNIT_ASSERT_EQUAL( -9876.5432f, f );
 }
 
+void FileConfigTestCase::Lookup()
+{
+    wxStringInputStream sis(testconfig);
+    wxFileConfig fc(sis);
+
+    // entries and groups names are case-insensitive
+    wxString value;
+    CPPUNIT_ASSERT( fc.Read("/ROOT/Entry", &value) );
+    CPPUNIT_ASSERT_EQUAL( "value", value );
+    CPPUNIT_ASSERT( fc.HasGroup("Root/Group1/SUBGROUP") );
+    CPPUNIT_ASSERT( fc.HasEntry("root/group1/subgroup/SubEntry2") );
+
+    // failing to find a group must not change the current one
+    fc.SetPath("/root/group1");
+    CPPUNIT_ASSERT( !fc.HasEntry("/root/no_such_group/entry") );
+    CPPUNIT_ASSERT( !fc.HasGroup("/root/no_such_group") );
+    CPPUNIT_ASSERT_EQUAL( "/root/group1", fc.GetPath() );
+    CPPUNIT_ASSERT( fc.Read("subgroup/subentry", &value) );
+    CPPUNIT_ASSERT_EQUAL( "subvalue", value );
+
+    // check that renamed and deleted items can't be found any more
+    fc.SetPath("/");
+    CPPUNIT_ASSERT( fc.RenameGroup("root", "foot") );
+    CPPUNIT_ASSERT( !fc.HasGroup("root") );
+    CPPUNIT_ASSERT( fc.HasGroup("FOOT/group2") );
+    CPPUNIT_ASSERT( fc.DeleteEntry("foot/group1/subgroup/subentry", false) );
+    CPPUNIT_ASSERT( !fc.HasEntry("foot/group1/subgroup/subentry") );
+    CPPUNIT_ASSERT( fc.DeleteGroup("foot/GROUP2") );
+    CPPUNIT_ASSERT( !fc.HasGroup("foot/group2") );
+
+    // and that many of them work as expected
+    for ( int n = 0; n < 1000; n++ )
+        fc.Write(wxString::Format("/many/entry%d", n), n);
+
+    for ( int n = 999; n >= 0; n -= 3 )
+    {
+        long l;
+        CPPUNIT_ASSERT( fc.Read(wxString::Format("/Many/Entry%d", n), &l) );
+        CPPUNIT_ASSERT_EQUAL( n, l );
+    }
+
+    CPPUNIT_ASSERT( fc.DeleteEntry("/many/entry500") );
+    CPPUNIT_ASSERT( !fc.HasEntry("/many/entry500") );
+    CPPUNIT_ASSERT( fc.HasEntry("/many/entry501") );
+}
+
+void FileConfigTestCase::Flush()
+{
+    const wxString filename = wxFileName::CreateTempFileName("fileconf");
+    CPPUNIT_ASSERT( !filename.empty() );
+
+    {
+        wxFileConfig fc(wxString(), wxString(), filename, wxString(),
+                        wxCONFIG_USE_LOCAL_FILE);
+        fc.Write("/root/entry", "value");
+        fc.Write("/root/other", "other");
+        CPPUNIT_ASSERT( fc.Flush() );
+
+        // only the modified lines are converted again when flushing, check
+        // that the unchanged ones are still written correctly
+        fc.Write("/root/entry", "changed");
+        fc.Write("/group/entry", "new");
+        CPPUNIT_ASSERT( fc.Flush() );
+
+        CPPUNIT_ASSERT( fc.DeleteEntry("/root/other") );
+        CPPUNIT_ASSERT( fc.Flush() );
+    }
+
+    wxFile file(filename);
+    CPPUNIT_ASSERT( file.IsOpened() );
+
+    wxString contents;
+    CPPUNIT_ASSERT( file.ReadAll(&contents) );
+    file.Close();
+    wxRemoveFile(filename);
+
+    contents.Replace(wxTextFile::GetEOL(), "\n");
+    CPPUNIT_ASSERT_EQUAL( "[root]\n"
+                          "entry=changed\n"
+                          "[group]\n"
+                          "entry=new\n",
+                          contents );
+}
+
 #endif // wxUSE_FILECONFIG
 
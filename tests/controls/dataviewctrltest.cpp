@@ -22,6 +22,76 @@
 #include "wx/dataview.h"
 
 #include "testableframe.h"
+#include "asserthelper.h"
+
+// ----------------------------------------------------------------------------
+// helper classes
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+// renderer whose height depends on the length of the item label, to test the
+// controls with wxDV_VARIABLE_LINE_HEIGHT style
+class LabelHeightRenderer : public wxDataViewCustomRenderer
+{
+public:
+    LabelHeightRenderer(int extraHeight = 0)
+        : wxDataViewCustomRenderer("wxDataViewIconText"),
+          m_extraHeight(extraHeight)
+    {
+    }
+
+    virtual bool SetValue(const wxVariant& value)
+    {
+        wxDataViewIconText iconText;
+        iconText << value;
+        m_label = iconText.GetText();
+        return true;
+    }
+
+    virtual bool GetValue(wxVariant& WXUNUSED(value)) const { return false; }
+
+    virtual wxSize GetSize() const
+    {
+        return wxSize(100, 10 + 3*m_label.length() + m_extraHeight);
+    }
+
+    virtual bool Render(wxRect rect, wxDC *dc, int state)
+    {
+        RenderText(m_label, 0, rect, dc, state);
+        return true;
+    }
+
+private:
+    const int m_extraHeight;
+    wxString m_label;
+};
+
+// tree store with two columns showing the same label, in which only the
+// container nodes with children are considered to be containers: as the
+// second column is not shown for the containers, the height of an item
+// depends on whether it has any children
+class TwoColumnTreeStore : public wxDataViewTreeStore
+{
+public:
+    virtual unsigned int GetColumnCount() const { return 2; }
+
+    virtual void GetValue(wxVariant& variant,
+                          const wxDataViewItem& item,
+                          unsigned int WXUNUSED(col)) const
+    {
+        wxDataViewTreeStore::GetValue(variant, item, 0);
+    }
+
+    virtual bool IsContainer(const wxDataViewItem& item) const
+    {
+        return wxDataViewTreeStore::IsContainer(item) &&
+                    GetChildCount(item) != 0;
+    }
+};
+
+} // anonymous namespace
 
 // ----------------------------------------------------------------------------
 // test class
@@ -41,6 +111,9 @@ private:
         CPPUNIT_TEST( DeleteNotSelected );
         CPPUNIT_TEST( GetSelectionForMulti );
         CPPUNIT_TEST( GetSelectionForSingle );
+        CPPUNIT_TEST( ExpandCollapse );
+        CPPUNIT_TEST( Cleared );
+        CPPUNIT_TEST( VariableHeight );
     CPPUNIT_TEST_SUITE_END();
 
     // Create wxDataViewTreeCtrl with the given style.
@@ -50,9 +123,26 @@ private:
     void DeleteNotSelected();
     void GetSelectionForMulti();
     void GetSelectionForSingle();
+    void ExpandCollapse();
+    void Cleared();
+    void VariableHeight();
 
     void TestSelectionFor0and1();
 
+    // Create wxDataViewCtrl with wxDV_VARIABLE_LINE_HEIGHT style showing the
+    // given model.
+    wxDataViewCtrl *CreateVariableHeight(wxDataViewTreeStore *store);
+
+    // Expand the same items of dvc as are expanded in the other control,
+    // starting with the children of the given parent.
+    void ExpandAsIn(wxDataViewCtrl *dvc,
+                    const wxDataViewCtrl *other,
+                    const wxDataViewItem& parent);
+
+    // Check that all rows of the given control are at the same positions as
+    // in a new control showing the same model with the same expanded items.
+    void CheckSameAsRecreated(wxDataViewCtrl *dvc, wxDataViewTreeStore *store);
+
     // the dataview control itself
     wxDataViewTreeCtrl *m_dvc;
 
@@ -94,6 +184,96 @@ void DataViewCtrlTestCase::Create(long style)
     m_dvc->Update();
 }
 
+wxDataViewCtrl *
+DataViewCtrlTestCase::CreateVariableHeight(wxDataViewTreeStore *store)
+{
+    wxDataViewCtrl * const dvc = new wxDataViewCtrl(wxTheApp->GetTopWindow(),
+                                                    wxID_ANY,
+                                                    wxDefaultPosition,
+                                                    wxSize(400, 200),
+                                                    wxDV_VARIABLE_LINE_HEIGHT);
+    dvc->AppendColumn(new wxDataViewColumn("Label",
+                                           new LabelHeightRenderer,
+                                           0));
+    if ( store->GetColumnCount() > 1 )
+    {
+        dvc->AppendColumn(new wxDataViewColumn("Taller",
+                                               new LabelHeightRenderer(20),
+                                               1));
+    }
+    dvc->AssociateModel(store);
+
+    return dvc;
+}
+
+void DataViewCtrlTestCase::ExpandAsIn(wxDataViewCtrl *dvc,
+                                      const wxDataViewCtrl *other,
+                                      const wxDataViewItem& parent)
+{
+    wxDataViewItemArray children;
+    dvc->GetModel()->GetChildren(parent, children);
+    for ( size_t n = 0; n < children.size(); n++ )
+    {
+        if ( other->IsExpanded(children[n]) )
+        {
+            dvc->Expand(children[n]);
+            ExpandAsIn(dvc, other, children[n]);
+        }
+    }
+}
+
+void DataViewCtrlTestCase::CheckSameAsRecreated(wxDataViewCtrl *dvc,
+                                                wxDataViewTreeStore *store)
+{
+    wxDataViewCtrl * const recreated = CreateVariableHeight(store);
+    ExpandAsIn(recreated, dvc, wxDataViewItem());
+
+    // Collect all the shown items in order.
+    wxDataViewItemArray items,
+                        parents;
+    parents.push_back(wxDataViewItem());
+    while ( !parents.empty() )
+    {
+        const wxDataViewItem parent = parents.back();
+        parents.pop_back();
+
+        if ( parent.IsOk() )
+            items.push_back(parent);
+
+        if ( parent.IsOk() && !dvc->IsExpanded(parent) )
+            continue;
+
+        wxDataViewItemArray children;
+        store->GetChildren(parent, children);
+        for ( size_t n = children.size(); n > 0; n-- )
+            parents.push_back(children[n - 1]);
+    }
+
+    int bottom = 0;
+    for ( size_t n = 0; n < items.size(); n++ )
+    {
+        const wxRect rect = dvc->GetItemRect(items[n]);
+        const wxRect rectRecreated = recreated->GetItemRect(items[n]);
+        CPPUNIT_ASSERT_EQUAL( rectRecreated.GetPosition(), rect.GetPosition() );
+        CPPUNIT_ASSERT_EQUAL( rectRecreated.GetSize(), rect.GetSize() );
+
+        // The rows must follow each other without gaps.
+        CPPUNIT_ASSERT_EQUAL( bottom, rect.y );
+        bottom = rect.GetBottom() + 1;
+
+        const wxPoint pt(rect.x + 1, rect.y + rect.height / 2);
+        wxDataViewItem item;
+        wxDataViewColumn *column;
+        dvc->HitTest(pt, item, column);
+        CPPUNIT_ASSERT( item == items[n] );
+
+        recreated->HitTest(pt, item, column);
+        CPPUNIT_ASSERT( item == items[n] );
+    }
+
+    delete recreated;
+}
+
 void DataViewCtrlTestCase::setUp()
 {
     Create(wxDV_MULTIPLE);
@@ -198,4 +378,123 @@ void DataViewCtrlTestCase::GetSelectionForSingle()
     TestSelectionFor0and1();
 }
 
+void DataViewCtrlTestCase::ExpandCollapse()
+{
+    wxDataViewItemArray selections;
+
+    m_dvc->Expand(m_child1);
+    CPPUNIT_ASSERT( m_dvc->IsExpanded(m_root) );
+    CPPUNIT_ASSERT( m_dvc->IsExpanded(m_child1) );
+
+    m_dvc->Select(m_child2);
+    m_dvc->Select(m_grandchild);
+    CPPUNIT_ASSERT_EQUAL( 2, m_dvc->GetSelections(selections) );
+    CPPUNIT_ASSERT( selections[0] == m_grandchild );
+    CPPUNIT_ASSERT( selections[1] == m_child2 );
+
+    m_dvc->Unselect(m_grandchild);
+    m_dvc->Collapse(m_child1);
+    CPPUNIT_ASSERT( !m_dvc->IsExpanded(m_child1) );
+    CPPUNIT_ASSERT( !m_dvc->IsSelected(m_grandchild) );
+    CPPUNIT_ASSERT( m_dvc->IsSelected(m_child2) );
+
+    // Selecting a hidden item expands its parent again.
+    m_dvc->Select(m_grandchild);
+    CPPUNIT_ASSERT( m_dvc->IsExpanded(m_child1) );
+    CPPUNIT_ASSERT_EQUAL( 2, m_dvc->GetSelections(selections) );
+    CPPUNIT_ASSERT( selections[0] == m_grandchild );
+    CPPUNIT_ASSERT( selections[1] == m_child2 );
+}
+
+void DataViewCtrlTestCase::Cleared()
+{
+    m_dvc->GetModel()->Cleared();
+    CPPUNIT_ASSERT( !m_dvc->IsExpanded(m_root) );
+
+    // The items not shown yet must still be found when they're needed.
+    m_dvc->Select(m_grandchild);
+    CPPUNIT_ASSERT( m_dvc->IsExpanded(m_root) );
+    CPPUNIT_ASSERT( m_dvc->IsExpanded(m_child1) );
+    CPPUNIT_ASSERT( m_dvc->IsSelected(m_grandchild) );
+
+    m_dvc->Select(m_child2);
+    m_dvc->DeleteItem(m_child1);
+
+    wxDataViewItemArray selections;
+    CPPUNIT_ASSERT_EQUAL( 1, m_dvc->GetSelections(selections) );
+    CPPUNIT_ASSERT( selections[0] == m_child2 );
+}
+
+void DataViewCtrlTestCase::VariableHeight()
+{
+    // The native implementations compute the row heights themselves, only
+    // test the generic one which caches them.
+#ifdef wxHAS_GENERIC_DATAVIEWCTRL
+    wxDataViewTreeStore * const store = new wxDataViewTreeStore;
+    const wxDataViewItem
+        first = store->AppendItem(wxDataViewItem(), "a"),
+        parent = store->AppendContainer(wxDataViewItem(), "bbbb");
+    store->AppendItem(parent, "cc");
+    const wxDataViewItem
+        middle = store->AppendItem(parent, "ddddddd"),
+        subparent = store->AppendContainer(parent, "eee");
+    store->AppendItem(subparent, "ffffffffff");
+    store->AppendItem(wxDataViewItem(), "g");
+
+    wxDataViewCtrl * const dvc = CreateVariableHeight(store);
+    store->DecRef();
+
+    dvc->Expand(parent);
+    dvc->Expand(subparent);
+    CheckSameAsRecreated(dvc, store);
+
+    // Add items both before and inside the expanded containers.
+    store->ItemAdded(wxDataViewItem(),
+                     store->InsertItem(wxDataViewItem(), first, "hhhhhhhhh"));
+    store->ItemAdded(wxDataViewItem(),
+                     store->PrependItem(wxDataViewItem(), "iiiii"));
+    store->ItemAdded(subparent, store->AppendItem(subparent, "j"));
+    CheckSameAsRecreated(dvc, store);
+
+    store->DeleteItem(middle);
+    store->ItemDeleted(parent, middle);
+    CheckSameAsRecreated(dvc, store);
+
+    dvc->Collapse(subparent);
+    CheckSameAsRecreated(dvc, store);
+
+    dvc->Collapse(parent);
+    CheckSameAsRecreated(dvc, store);
+
+    dvc->Expand(subparent);
+    CheckSameAsRecreated(dvc, store);
+
+    delete dvc;
+
+    // Check that the height of the parent item is updated when it becomes a
+    // container or stops being one.
+    wxDataViewTreeStore * const store2 = new TwoColumnTreeStore;
+    const wxDataViewItem
+        parent2 = store2->AppendContainer(wxDataViewItem(), "kk");
+    store2->AppendItem(wxDataViewItem(), "l");
+
+    wxDataViewCtrl * const dvc2 = CreateVariableHeight(store2);
+    store2->DecRef();
+    CheckSameAsRecreated(dvc2, store2);
+
+    const wxDataViewItem child2 = store2->AppendItem(parent2, "mmm");
+    store2->ItemAdded(parent2, child2);
+    CheckSameAsRecreated(dvc2, store2);
+
+    dvc2->Expand(parent2);
+    CheckSameAsRecreated(dvc2, store2);
+
+    store2->DeleteItem(child2);
+    store2->ItemDeleted(parent2, child2);
+    CheckSameAsRecreated(dvc2, store2);
+
+    delete dvc2;
+#endif // wxHAS_GENERIC_DATAVIEWCTRL
+}
+
 #endif //wxUSE_DATAVIEWCTRL
@@ -64,6 +64,7 @@ private:
         CPPUNIT_TEST( Labels );
         CPPUNIT_TEST( SelectionMode );
         CPPUNIT_TEST( CellFormatting );
+        CPPUNIT_TEST( CellAttrShift );
         WXUISIM_TEST( Editable );
         WXUISIM_TEST( ReadOnly );
         CPPUNIT_TEST( PseudoTest_NativeHeader );
@@ -93,6 +94,7 @@ private:
     void Labels();
     void SelectionMode();
     void CellFormatting();
+    void CellAttrShift();
     void Editable();
     void ReadOnly();
     void PseudoTest_NativeHeader() { ms_nativeheader = true; }
@@ -680,6 +682,59 @@ void GridTestCase::CellFormatting()
     CPPUNIT_ASSERT_EQUAL(*wxGREEN, m_grid->GetCellTextColour(0, 0));
 }
 
+void GridTestCase::CellAttrShift()
+{
+    const wxColour def = m_grid->GetDefaultCellBackgroundColour();
+
+    // Set the attributes in non-sorted order on purpose.
+    m_grid->SetCellBackgroundColour(5, 1, *wxRED);
+    m_grid->SetCellBackgroundColour(1, 1, *wxGREEN);
+    m_grid->SetCellBackgroundColour(5, 0, *wxBLUE);
+
+    CPPUNIT_ASSERT_EQUAL(*wxRED, m_grid->GetCellBackgroundColour(5, 1));
+    CPPUNIT_ASSERT_EQUAL(*wxGREEN, m_grid->GetCellBackgroundColour(1, 1));
+    CPPUNIT_ASSERT_EQUAL(*wxBLUE, m_grid->GetCellBackgroundColour(5, 0));
+    CPPUNIT_ASSERT_EQUAL(def, m_grid->GetCellBackgroundColour(1, 0));
+
+    m_grid->InsertRows(2, 2);
+    CPPUNIT_ASSERT_EQUAL(*wxGREEN, m_grid->GetCellBackgroundColour(1, 1));
+    CPPUNIT_ASSERT_EQUAL(*wxRED, m_grid->GetCellBackgroundColour(7, 1));
+    CPPUNIT_ASSERT_EQUAL(*wxBLUE, m_grid->GetCellBackgroundColour(7, 0));
+    CPPUNIT_ASSERT_EQUAL(def, m_grid->GetCellBackgroundColour(5, 1));
+
+    // Deleting the row with the attribute must remove it.
+    m_grid->DeleteRows(1, 2);
+    CPPUNIT_ASSERT_EQUAL(def, m_grid->GetCellBackgroundColour(1, 1));
+    CPPUNIT_ASSERT_EQUAL(*wxRED, m_grid->GetCellBackgroundColour(5, 1));
+
+    m_grid->DeleteCols(0);
+    CPPUNIT_ASSERT_EQUAL(*wxRED, m_grid->GetCellBackgroundColour(5, 0));
+
+    m_grid->InsertCols(0, 1);
+    CPPUNIT_ASSERT_EQUAL(*wxRED, m_grid->GetCellBackgroundColour(5, 1));
+    CPPUNIT_ASSERT_EQUAL(def, m_grid->GetCellBackgroundColour(5, 0));
+
+    // Resetting the attribute must work after all the shifts too.
+    m_grid->SetCellBackgroundColour(5, 0, *wxBLUE);
+    m_grid->GetTable()->SetAttr(NULL, 5, 1);
+    CPPUNIT_ASSERT_EQUAL(def, m_grid->GetCellBackgroundColour(5, 1));
+    CPPUNIT_ASSERT_EQUAL(*wxBLUE, m_grid->GetCellBackgroundColour(5, 0));
+
+    // Deleting a column must remove all its attributes, wherever they are,
+    // and shift the ones after it.
+    m_grid->AppendCols(2);
+    m_grid->SetCellBackgroundColour(0, 2, *wxGREEN);
+    m_grid->SetCellBackgroundColour(3, 2, *wxGREEN);
+    m_grid->SetCellBackgroundColour(3, 3, *wxRED);
+    m_grid->SetCellBackgroundColour(8, 2, *wxGREEN);
+
+    m_grid->DeleteCols(2);
+    CPPUNIT_ASSERT_EQUAL(def, m_grid->GetCellBackgroundColour(0, 2));
+    CPPUNIT_ASSERT_EQUAL(*wxRED, m_grid->GetCellBackgroundColour(3, 2));
+    CPPUNIT_ASSERT_EQUAL(def, m_grid->GetCellBackgroundColour(8, 2));
+    CPPUNIT_ASSERT_EQUAL(*wxBLUE, m_grid->GetCellBackgroundColour(5, 0));
+}
+
 void GridTestCase::Editable()
 {
 #if wxUSE_UIACTIONSIMULATOR
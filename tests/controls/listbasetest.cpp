@@ -351,6 +351,19 @@ void ListBaseTestCase::Find()
     CPPUNIT_ASSERT_EQUAL(2, list->FindItem(-1, "Item 4", true));
     CPPUNIT_ASSERT_EQUAL(2, list->FindItem(1, "Item 40"));
     CPPUNIT_ASSERT_EQUAL(3, list->FindItem(2, "Item 0", true));
+
+    // the items must still be found after they're modified
+    list->SetItemText(1, "Item 2");
+    CPPUNIT_ASSERT_EQUAL(wxNOT_FOUND, list->FindItem(-1, "Item 1"));
+    CPPUNIT_ASSERT_EQUAL(1, list->FindItem(-1, "item 2"));
+
+    list->DeleteItem(0);
+    CPPUNIT_ASSERT_EQUAL(0, list->FindItem(-1, "Item 2"));
+    CPPUNIT_ASSERT_EQUAL(2, list->FindItem(-1, "Item 0", true));
+
+    list->InsertItem(0, "Item 0");
+    CPPUNIT_ASSERT_EQUAL(0, list->FindItem(-1, "Item 0", true));
+    CPPUNIT_ASSERT_EQUAL(3, list->FindItem(1, "Item 0", true));
 }
 
 void ListBaseTestCase::Visible()
@@ -61,6 +61,7 @@ private:
         CPPUNIT_TEST( Bold );
         CPPUNIT_TEST( Visible );
         CPPUNIT_TEST( Sort );
+        CPPUNIT_TEST( HitTest );
         WXUISIM_TEST( KeyNavigation );
         CPPUNIT_TEST( HasChildren );
         CPPUNIT_TEST( SelectItemSingle );
@@ -88,6 +89,7 @@ private:
     void Bold();
     void Visible();
     void Sort();
+    void HitTest();
     void KeyNavigation();
     void HasChildren();
     void SelectItemSingle();
@@ -574,6 +576,40 @@ void TreeCtrlTestCase::Sort()
     CPPUNIT_ASSERT_EQUAL(zitem, m_tree->GetNextChild(m_root, cookie));
 }
 
+void TreeCtrlTestCase::HitTest()
+{
+    wxRect rect;
+    CPPUNIT_ASSERT( m_tree->GetBoundingRect(m_grandchild, rect, true) );
+
+    const wxPoint pt(rect.x + rect.width/2, rect.y + rect.height/2);
+
+    int flags = 0;
+    CPPUNIT_ASSERT_EQUAL( m_grandchild, m_tree->HitTest(pt, flags) );
+    CPPUNIT_ASSERT( flags & wxTREE_HITTEST_ONITEMLABEL );
+
+    // After collapsing its parent, the next item takes its place.
+    m_tree->Collapse(m_child1);
+
+    flags = 0;
+    CPPUNIT_ASSERT_EQUAL( m_child2, m_tree->HitTest(pt, flags) );
+
+    // And the place of the next item, which is the last one, becomes empty
+    // after deleting it.
+    m_tree->Expand(m_child1);
+    CPPUNIT_ASSERT( m_tree->GetBoundingRect(m_child2, rect, true) );
+
+    const wxPoint ptLast(rect.x + rect.width/2, rect.y + rect.height/2);
+
+    flags = 0;
+    CPPUNIT_ASSERT_EQUAL( m_child2, m_tree->HitTest(ptLast, flags) );
+
+    m_tree->Delete(m_child2);
+
+    flags = 0;
+    CPPUNIT_ASSERT( !m_tree->HitTest(ptLast, flags) );
+    CPPUNIT_ASSERT( flags & wxTREE_HITTEST_NOWHERE );
+}
+
 void TreeCtrlTestCase::KeyNavigation()
 {
 #if wxUSE_UIACTIONSIMULATOR && !defined(__WXGTK__)
@@ -145,6 +145,95 @@ BEGIN_EVENT_TABLE(MyClassWithEventTable, wxEvtHandler)
     //EVT_IDLE(MyClassWithEventTable::OnAnotherEvent)
 END_EVENT_TABLE()
 
+// handler recording the order in which its methods are called
+class OrderHandler : public wxEvtHandler
+{
+public:
+    void On1(MyEvent& event) { calls += '1'; event.Skip(); }
+    void On2(MyEvent& event) { calls += '2'; event.Skip(); }
+
+    // unbinds On1() which hasn't been called yet for this event
+    void OnUnbind(MyEvent& event)
+    {
+        calls += 'u';
+        Unbind(MyEventType, &OrderHandler::On1, this);
+        event.Skip();
+    }
+
+    // binds On2() which must not be called for this event
+    void OnBind(MyEvent& event)
+    {
+        calls += 'b';
+        Bind(MyEventType, &OrderHandler::On2, this);
+        event.Skip();
+    }
+
+    // unbinds On1() and dispatches another event of the same type from
+    // inside this handler
+    void OnNested(MyEvent& event)
+    {
+        calls += 'n';
+        Unbind(MyEventType, &OrderHandler::On1, this);
+
+        static bool s_nested = false;
+        if ( !s_nested )
+        {
+            s_nested = true;
+            MyEvent nested;
+            ProcessEvent(nested);
+            s_nested = false;
+        }
+
+        event.Skip();
+    }
+
+    // unbinds On1() and processes the event, i.e. doesn't skip it
+    void OnProcess(MyEvent&)
+    {
+        calls += 'p';
+        Unbind(MyEventType, &OrderHandler::On1, this);
+    }
+
+    void OnIdle(wxIdleEvent&) { calls += 'i'; }
+
+    // return the number of the slots used for storing the dynamic entries,
+    // including those of the handlers which had been unbound but not erased
+    // yet: it relies on the cookie being the index of the next slot to check
+    size_t GetDynamicEntrySlots() const
+    {
+        size_t cookie;
+        for ( wxDynamicEventTableEntry* entry = GetFirstDynamicEntry(cookie);
+              entry;
+              entry = GetNextDynamicEntry(cookie) )
+            ;
+
+        return cookie;
+    }
+
+    wxString calls;
+};
+
+// handler recording the strings of the thread events it processes
+class QueueHandler : public wxEvtHandler
+{
+public:
+    QueueHandler() { Bind(wxEVT_THREAD, &QueueHandler::OnThread, this); }
+
+    void Queue(int id, const wxString& s, bool replace)
+    {
+        wxThreadEvent * const event = new wxThreadEvent(wxEVT_THREAD, id);
+        event->SetString(s);
+        if ( replace )
+            QueueOrReplaceEvent(event);
+        else
+            QueueEvent(event);
+    }
+
+    void OnThread(wxThreadEvent& event) { strings += event.GetString(); }
+
+    wxString strings;
+};
+
 } // anonymous namespace
 
 
@@ -172,6 +261,10 @@ private:
         CPPUNIT_TEST( BindFunctionUsingBaseEvent );
         CPPUNIT_TEST( BindNonHandler );
         CPPUNIT_TEST( InvalidBind );
+        CPPUNIT_TEST( BindOrder );
+        CPPUNIT_TEST( UnbindNested );
+        CPPUNIT_TEST( UnbindChurn );
+        CPPUNIT_TEST( QueueOrReplace );
 #endif // wxHAS_EVENT_BIND
     CPPUNIT_TEST_SUITE_END();
 
@@ -188,6 +281,10 @@ private:
     void BindFunctionUsingBaseEvent();
     void BindNonHandler();
     void InvalidBind();
+    void BindOrder();
+    void UnbindNested();
+    void UnbindChurn();
+    void QueueOrReplace();
 #endif // wxHAS_EVENT_BIND
 
 
@@ -475,4 +572,144 @@ void EvtHandlerTestCase::InvalidBind()
 #endif
 }
 
+void EvtHandlerTestCase::BindOrder()
+{
+    OrderHandler h;
+
+    // the handlers are called in the reverse order of binding them,
+    // independently of the handlers for the other event types
+    h.Bind(MyEventType, &OrderHandler::On1, &h);
+    h.Bind(wxEVT_IDLE, &OrderHandler::OnIdle, &h);
+    h.Bind(MyEventType, &OrderHandler::On2, &h);
+    h.ProcessEvent(e);
+    CPPUNIT_ASSERT_EQUAL( "21", h.calls );
+
+    // unbinding a handler which wasn't called yet prevents it from being
+    // called for the event being currently dispatched
+    h.calls.clear();
+    h.Bind(MyEventType, &OrderHandler::OnUnbind, &h);
+    h.ProcessEvent(e);
+    CPPUNIT_ASSERT_EQUAL( "u2", h.calls );
+
+    // but binding a handler doesn't call it for the current event
+    h.calls.clear();
+    CPPUNIT_ASSERT( h.Unbind(MyEventType, &OrderHandler::OnUnbind, &h) );
+    h.Bind(MyEventType, &OrderHandler::OnBind, &h);
+    h.ProcessEvent(e);
+    CPPUNIT_ASSERT_EQUAL( "b2", h.calls );
+
+    h.calls.clear();
+    h.ProcessEvent(e);
+    CPPUNIT_ASSERT_EQUAL( "2b2", h.calls );
+
+    // the handlers for the other event types are still there
+    h.calls.clear();
+    wxIdleEvent idle;
+    h.ProcessEvent(idle);
+    CPPUNIT_ASSERT_EQUAL( "i", h.calls );
+    CPPUNIT_ASSERT( h.Unbind(wxEVT_IDLE, &OrderHandler::OnIdle, &h) );
+}
+
+void EvtHandlerTestCase::UnbindNested()
+{
+    OrderHandler h;
+    h.Bind(MyEventType, &OrderHandler::On2, &h);
+    h.Bind(MyEventType, &OrderHandler::On1, &h);
+    h.Bind(MyEventType, &OrderHandler::OnNested, &h);
+
+    // the nested dispatch must neither call the unbound handler nor change
+    // the handlers still to be called by the outer one
+    h.ProcessEvent(e);
+    CPPUNIT_ASSERT_EQUAL( "nn22", h.calls );
+
+    // and the unbound handler must be erased once the dispatch is over
+    CPPUNIT_ASSERT_EQUAL( 2, h.GetDynamicEntrySlots() );
+
+    h.calls.clear();
+    h.ProcessEvent(e);
+    CPPUNIT_ASSERT_EQUAL( "nn22", h.calls );
+}
+
+void EvtHandlerTestCase::UnbindChurn()
+{
+    OrderHandler h;
+    h.Bind(MyEventType, &OrderHandler::OnProcess, &h);
+
+    // the handlers unbound during the dispatch of an event which was
+    // processed must be erased too, so that they don't accumulate
+    for ( int n = 0; n < 1000; n++ )
+    {
+        h.Bind(MyEventType, &OrderHandler::On1, &h);
+        h.ProcessEvent(e);
+    }
+
+    CPPUNIT_ASSERT_EQUAL( 1, h.GetDynamicEntrySlots() );
+
+    // and the handlers unbound outside of any dispatch are erased at once
+    for ( int n = 0; n < 1000; n++ )
+    {
+        h.Bind(MyEventType, &OrderHandler::On2, &h);
+        CPPUNIT_ASSERT( h.Unbind(MyEventType, &OrderHandler::On2, &h) );
+    }
+
+    CPPUNIT_ASSERT_EQUAL( 1, h.GetDynamicEntrySlots() );
+
+    h.calls.clear();
+    h.ProcessEvent(e);
+    CPPUNIT_ASSERT_EQUAL( "p", h.calls );
+}
+
+void EvtHandlerTestCase::QueueOrReplace()
+{
+    QueueHandler h;
+    wxEvtHandler::ResetPendingEventsStats();
+
+    // only the last event with the same id is kept, but its position in the
+    // queue is preserved
+    h.Queue(1, "a", true);
+    h.Queue(2, "b", true);
+    h.Queue(1, "c", true);
+    h.Queue(3, "d", false);
+    h.Queue(3, "e", false);
+    h.Queue(3, "f", true);
+
+    for ( int n = 0; n < 4; n++ )
+        h.ProcessPendingEvents();
+    CPPUNIT_ASSERT_EQUAL( "cbdf", h.strings );
+
+    wxPendingEventsStats stats = wxEvtHandler::GetPendingEventsStats();
+    CPPUNIT_ASSERT_EQUAL( 6, stats.queued );
+    CPPUNIT_ASSERT_EQUAL( 2, stats.coalesced );
+    CPPUNIT_ASSERT_EQUAL( 0, stats.dropped );
+
+    // check that many events are queued in order, with the queue wrapping
+    // around as they're processed
+    h.strings.clear();
+    wxString expected;
+    for ( int n = 0; n < 100; n++ )
+    {
+        const wxString s(wxString::Format("%d,", n));
+        h.Queue(n, s, false);
+        expected += s;
+
+        if ( n % 3 == 2 )
+            h.ProcessPendingEvents();
+    }
+
+    while ( h.strings.length() < expected.length() )
+        h.ProcessPendingEvents();
+    CPPUNIT_ASSERT_EQUAL( expected, h.strings );
+
+    h.Queue(1, "x", false);
+    h.Queue(2, "y", false);
+    h.DeletePendingEvents();
+
+    stats = wxEvtHandler::GetPendingEventsStats();
+    CPPUNIT_ASSERT_EQUAL( 108, stats.queued );
+    CPPUNIT_ASSERT_EQUAL( 2, stats.dropped );
+
+    wxEvtHandler::ResetPendingEventsStats();
+    CPPUNIT_ASSERT_EQUAL( 0, wxEvtHandler::GetPendingEventsStats().queued );
+}
+
 #endif // wxHAS_EVENT_BIND
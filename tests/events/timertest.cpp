@@ -23,6 +23,7 @@
 
 #include "wx/evtloop.h"
 #include "wx/timer.h"
+#include "wx/vector.h"
 
 // --------------------------------------------------------------------------
 // helper class counting the number of timer events
@@ -55,6 +56,28 @@ private:
     DECLARE_NO_COPY_CLASS(TimerCounterHandler)
 };
 
+// --------------------------------------------------------------------------
+// helper timer class remembering the order of notifications
+// --------------------------------------------------------------------------
+
+class OrderedTimer : public wxTimer
+{
+public:
+    OrderedTimer(wxVector<int>& order, int id)
+        : m_order(order),
+          m_id(id)
+    {
+    }
+
+    virtual void Notify() { m_order.push_back(m_id); }
+
+private:
+    wxVector<int>& m_order;
+    const int m_id;
+
+    DECLARE_NO_COPY_CLASS(OrderedTimer)
+};
+
 // --------------------------------------------------------------------------
 // test class
 // --------------------------------------------------------------------------
@@ -68,10 +91,12 @@ private:
     CPPUNIT_TEST_SUITE( TimerEventTestCase );
         CPPUNIT_TEST( OneShot );
         CPPUNIT_TEST( Multiple );
+        CPPUNIT_TEST( Order );
     CPPUNIT_TEST_SUITE_END();
 
     void OneShot();
     void Multiple();
+    void Order();
 
     DECLARE_NO_COPY_CLASS(TimerEventTestCase)
 };
@@ -145,3 +170,56 @@ void TimerEventTestCase::Multiple()
     CPPUNIT_ASSERT( numTicks > 1 );
 #endif // !(wxGTK Unicode)
 }
+
+void TimerEventTestCase::Order()
+{
+    wxEventLoop loop;
+
+    // start many timers in an order different from their expiration order
+    static const int NUM_TIMERS = 100;
+
+    wxVector<int> order;
+    wxVector<OrderedTimer *> timers;
+    for ( int n = 0; n < NUM_TIMERS; n++ )
+    {
+        const int id = (n * 37) % NUM_TIMERS;
+        timers.push_back(new OrderedTimer(order, id));
+        timers.back()->Start(200 + 5*id, true);
+    }
+
+    // stopping some of them must prevent them from being notified
+    for ( int n = 0; n < NUM_TIMERS; n += 3 )
+        timers[n]->Stop();
+
+    // restarting a timer moves it at the end
+    timers[1]->Start(1000, true);
+
+    wxVector<int> expected;
+    for ( int id = 0; id < NUM_TIMERS; id++ )
+    {
+        const int n = (id * 73) % NUM_TIMERS; // 37*73 == 1 (mod 100)
+        if ( n % 3 && n != 1 )
+            expected.push_back(id);
+    }
+    expected.push_back(37);
+
+    time_t t;
+    time(&t);
+    const time_t tEnd = t + 5;
+    while ( order.size() < expected.size() && time(&t) < tEnd )
+    {
+        loop.Dispatch();
+    }
+
+    CPPUNIT_ASSERT_EQUAL( expected.size(), order.size() );
+    for ( size_t n = 0; n < expected.size(); n++ )
+    {
+        CPPUNIT_ASSERT_EQUAL( expected[n], order[n] );
+    }
+
+    for ( int n = 0; n < NUM_TIMERS; n++ )
+    {
+        CPPUNIT_ASSERT( !timers[n]->IsRunning() );
+        delete timers[n];
+    }
+}
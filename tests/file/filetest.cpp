@@ -19,6 +19,7 @@
 #if wxUSE_FILE
 
 #include "wx/file.h"
+#include "wx/wfstream.h"
 
 #include "testfile.h"
 
@@ -40,6 +41,7 @@ private:
         CPPUNIT_TEST( RoundTripUTF32 );
 #endif // wxUSE_UNICODE
         CPPUNIT_TEST( TempFile );
+        CPPUNIT_TEST( MappedFile );
     CPPUNIT_TEST_SUITE_END();
 
     void ReadAll();
@@ -51,6 +53,7 @@ private:
 
     void DoRoundTripTest(const wxMBConv& conv);
     void TempFile();
+    void MappedFile();
 
     wxDECLARE_NO_COPY_CLASS(FileTestCase);
 };
@@ -128,4 +131,55 @@ void FileTestCase::TempFile()
     CPPUNIT_ASSERT( wxRemoveFile(wxT("test2")) );
 }
 
+void FileTestCase::MappedFile()
+{
+    TestFile tf;
+
+    const char* text = "Mapped\nfile";
+    const size_t len = strlen(text);
+
+    {
+        wxFile fout(tf.GetName(), wxFile::write);
+        CPPUNIT_ASSERT( fout.IsOpened() );
+
+        wxMappedFile empty(tf.GetName());
+        CPPUNIT_ASSERT( empty.IsOpened() );
+        CPPUNIT_ASSERT_EQUAL( 0, empty.GetLength() );
+
+        fout.Write(text, len);
+        CPPUNIT_ASSERT( fout.Close() );
+    }
+
+    wxMappedFile mapped(tf.GetName());
+    CPPUNIT_ASSERT( mapped.IsOpened() );
+    CPPUNIT_ASSERT_EQUAL( len, mapped.GetLength() );
+    CPPUNIT_ASSERT( memcmp(mapped.GetData(), text, len) == 0 );
+
+    mapped.Close();
+    CPPUNIT_ASSERT( !mapped.IsOpened() );
+    CPPUNIT_ASSERT( !mapped.GetData() );
+
+    // the whole file is mapped independently of its current position
+    wxFile fin(tf.GetName());
+    CPPUNIT_ASSERT( fin.Seek(3) == 3 );
+    CPPUNIT_ASSERT( mapped.Open(fin) );
+    CPPUNIT_ASSERT_EQUAL( len, mapped.GetLength() );
+
+    wxMappedFileInputStream stream(tf.GetName());
+    CPPUNIT_ASSERT( stream.IsOk() );
+    CPPUNIT_ASSERT_EQUAL( (wxFileOffset)len, stream.GetLength() );
+    CPPUNIT_ASSERT_EQUAL( len, stream.GetMappedFile().GetLength() );
+
+    char buf[20];
+    CPPUNIT_ASSERT( stream.SeekI(7) == 7 );
+    CPPUNIT_ASSERT_EQUAL( 4, stream.Read(buf, sizeof(buf)).LastRead() );
+    CPPUNIT_ASSERT( memcmp(buf, "file", 4) == 0 );
+    CPPUNIT_ASSERT_EQUAL( 0, stream.Read(buf, sizeof(buf)).LastRead() );
+    CPPUNIT_ASSERT( stream.Eof() );
+
+    wxLogNull noLog;
+    wxMappedFileInputStream nonexistent("no such file");
+    CPPUNIT_ASSERT( !nonexistent.IsOk() );
+}
+
 #endif // wxUSE_FILE
@@ -79,6 +79,8 @@ private:
         CPPUNIT_TEST( DibPadding );
         CPPUNIT_TEST( BMPFlippingAndRLECompression );
         CPPUNIT_TEST( ScaleCompare );
+        CPPUNIT_TEST( ThreadCount );
+        CPPUNIT_TEST( Blur );
     CPPUNIT_TEST_SUITE_END();
 
     void LoadFromSocketStream();
@@ -95,6 +97,8 @@ private:
     void DibPadding();
     void BMPFlippingAndRLECompression();
     void ScaleCompare();
+    void ThreadCount();
+    void Blur();
 
     DECLARE_NO_COPY_CLASS(ImageTestCase)
 };
@@ -1386,6 +1390,167 @@ void ImageTestCase::ScaleCompare()
                                "image/horse_bilinear_300x300.png");
 }
 
+// The operations which may use several threads for processing big images.
+static wxImage ScaleBoxAverage(const wxImage& image)
+{
+    return image.Scale(801, 701, wxIMAGE_QUALITY_BOX_AVERAGE);
+}
+
+static wxImage ScaleBilinear(const wxImage& image)
+{
+    return image.Scale(1203, 903, wxIMAGE_QUALITY_BILINEAR);
+}
+
+static wxImage ScaleBicubic(const wxImage& image)
+{
+    return image.Scale(1203, 903, wxIMAGE_QUALITY_BICUBIC);
+}
+
+static wxImage RotateClockwise(const wxImage& image)
+{
+    return image.Rotate90(true);
+}
+
+static wxImage RotateCounterClockwise(const wxImage& image)
+{
+    return image.Rotate90(false);
+}
+
+static wxImage ConvertToGreyscale(const wxImage& image)
+{
+    return image.ConvertToGreyscale();
+}
+
+static wxImage ConvertToDisabled(const wxImage& image)
+{
+    return image.ConvertToDisabled();
+}
+
+static wxImage BlurImage(const wxImage& image)
+{
+    return image.Blur(5);
+}
+
+// Check that applying the given operation to the image gives exactly the same
+// result, including the alpha channel, when using one or several threads.
+static void CheckThreadCount(const wxImage& image,
+                             wxImage (*op)(const wxImage&),
+                             const char *name)
+{
+    wxImage::SetThreadCount(1);
+    const wxImage oneThread = op(image);
+
+    wxImage::SetThreadCount(4);
+    const wxImage fourThreads = op(image);
+    wxImage::SetThreadCount(1);
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( name, oneThread, fourThreads );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( name,
+                                  oneThread.HasAlpha(),
+                                  fourThreads.HasAlpha() );
+    if ( oneThread.HasAlpha() )
+    {
+        CPPUNIT_ASSERT_MESSAGE
+        (
+            name,
+            memcmp(oneThread.GetAlpha(), fourThreads.GetAlpha(),
+                   oneThread.GetWidth()*oneThread.GetHeight()) == 0
+        );
+    }
+}
+
+void ImageTestCase::ThreadCount()
+{
+    // Create an image big enough to be split between 4 threads and with the
+    // odd height, so that it can't be split into the bands of the same size.
+    const int width = 1001,
+              height = 767;
+    wxImage withAlpha(width, height);
+    withAlpha.InitAlpha();
+
+    unsigned char* const data = withAlpha.GetData();
+    unsigned char* const alpha = withAlpha.GetAlpha();
+    for ( int n = 0; n < width*height; n++ )
+    {
+        data[3*n] = n % 251;
+        data[3*n + 1] = (n / 7) % 253;
+        data[3*n + 2] = (n * 13) % 256;
+        alpha[n] = (n / 3) % 255;
+    }
+
+    wxImage withoutAlpha = withAlpha.Copy();
+    withoutAlpha.ClearAlpha();
+
+    const wxImage* const images[] = { &withAlpha, &withoutAlpha };
+    for ( size_t n = 0; n < WXSIZEOF(images); n++ )
+    {
+        const wxImage& image = *images[n];
+
+        CheckThreadCount(image, ScaleBoxAverage, "box average");
+        CheckThreadCount(image, ScaleBilinear, "bilinear");
+        CheckThreadCount(image, ScaleBicubic, "bicubic");
+        CheckThreadCount(image, RotateClockwise, "rotate clockwise");
+        CheckThreadCount(image, RotateCounterClockwise, "rotate back");
+        CheckThreadCount(image, ConvertToGreyscale, "greyscale");
+        CheckThreadCount(image, ConvertToDisabled, "disabled");
+        CheckThreadCount(image, BlurImage, "blur");
+    }
+}
+
+void ImageTestCase::Blur()
+{
+    // Single row image with alpha: the pixels beyond the edges are taken to
+    // be equal to the edge ones.
+    wxImage row(4, 1);
+    row.InitAlpha();
+    static const unsigned char values[] = { 0, 30, 60, 240 };
+    for ( int x = 0; x < 4; x++ )
+    {
+        row.SetRGB(x, 0, values[x], 0, 255 - values[x]);
+        row.SetAlpha(x, values[x]);
+    }
+
+    wxImage blurred = row.BlurHorizontal(1);
+    CPPUNIT_ASSERT_EQUAL( 10, (int)blurred.GetRed(0, 0) );
+    CPPUNIT_ASSERT_EQUAL( 30, (int)blurred.GetRed(1, 0) );
+    CPPUNIT_ASSERT_EQUAL( 110, (int)blurred.GetRed(2, 0) );
+    CPPUNIT_ASSERT_EQUAL( 180, (int)blurred.GetRed(3, 0) );
+    CPPUNIT_ASSERT_EQUAL( 245, (int)blurred.GetBlue(0, 0) );
+    CPPUNIT_ASSERT_EQUAL( 75, (int)blurred.GetBlue(3, 0) );
+    CPPUNIT_ASSERT_EQUAL( 110, (int)blurred.GetAlpha(2, 0) );
+
+    // The radius may be bigger than the image itself.
+    blurred = row.BlurHorizontal(5);
+    CPPUNIT_ASSERT_EQUAL( 73, (int)blurred.GetRed(0, 0) );
+    CPPUNIT_ASSERT_EQUAL( 139, (int)blurred.GetRed(3, 0) );
+
+    // Blurring a column must give the same result as blurring a row.
+    const wxImage rowBlurred = row.BlurHorizontal(1);
+    blurred = row.Rotate90().BlurVertical(1).Rotate90(false);
+    CPPUNIT_ASSERT_EQUAL( rowBlurred, blurred );
+    CPPUNIT_ASSERT( memcmp(rowBlurred.GetAlpha(), blurred.GetAlpha(), 4) == 0 );
+
+    // Gaussian blur with zero sigma doesn't change the image and a uniform
+    // image remains uniform with any sigma.
+    wxImage original;
+    CPPUNIT_ASSERT(original.LoadFile("horse.bmp"));
+    CPPUNIT_ASSERT_EQUAL( original, original.BlurGaussian(0) );
+
+    wxImage uniform(30, 20);
+    uniform.SetRGB(wxRect(0, 0, 30, 20), 17, 34, 51);
+    CPPUNIT_ASSERT_EQUAL( uniform, uniform.BlurGaussian(5.5) );
+
+    // Processing the image in several threads must give the same result.
+    wxImage big = original.Scale(1200, 1200);
+    const wxImage blurredOneThread = big.Blur(7);
+
+    wxImage::SetThreadCount(4);
+    const wxImage blurredFourThreads = big.Blur(7);
+    wxImage::SetThreadCount(1);
+
+    CPPUNIT_ASSERT_EQUAL( blurredOneThread, blurredFourThreads );
+}
+
 #endif //wxUSE_IMAGE
 
 
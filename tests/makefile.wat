@@ -369,6 +369,7 @@ TEST_OBJECTS =  &
 	$(OBJS)\test_atomic.obj &
 	$(OBJS)\test_misc.obj &
 	$(OBJS)\test_queue.obj &
+	$(OBJS)\test_threadpool.obj &
 	$(OBJS)\test_tls.obj &
 	$(OBJS)\test_ftp.obj &
 	$(OBJS)\test_uris.obj &
@@ -760,6 +761,9 @@ $(OBJS)\test_misc.obj :  .AUTODEPEND .\thread\misc.cpp
 $(OBJS)\test_queue.obj :  .AUTODEPEND .\thread\queue.cpp
 	$(CXX) -bt=nt -zq -fo=$^@ $(TEST_CXXFLAGS) $<
 
+$(OBJS)\test_threadpool.obj :  .AUTODEPEND .\thread\threadpool.cpp
+	$(CXX) -bt=nt -zq -fo=$^@ $(TEST_CXXFLAGS) $<
+
 $(OBJS)\test_tls.obj :  .AUTODEPEND .\thread\tls.cpp
 	$(CXX) -bt=nt -zq -fo=$^@ $(TEST_CXXFLAGS) $<
 
@@ -71,6 +71,7 @@ private:
         CPPUNIT_TEST( WC2CP1250 );
         CPPUNIT_TEST( UTF7Tests );
         CPPUNIT_TEST( UTF8Tests );
+        CPPUNIT_TEST( UTF8LongTests );
         CPPUNIT_TEST( UTF16LETests );
         CPPUNIT_TEST( UTF16BETests );
         CPPUNIT_TEST( CP932Tests );
@@ -106,6 +107,7 @@ private:
     void WC2CP1250();
     void UTF7Tests();
     void UTF8Tests();
+    void UTF8LongTests();
     void UTF16LETests();
     void UTF16BETests();
     void UTF32LETests();
@@ -463,6 +465,92 @@ void MBConvTestCase::UTF8Tests()
         );
 }
 
+void MBConvTestCase::UTF8LongTests()
+{
+    // check the conversions of ASCII runs of all lengths, as they are handled
+    // specially, followed by non-ASCII characters of different lengths
+    static const wchar_t nonASCII[] = { 0xe9, 0x4e2d, 0x7ff, 0x800, 0xfffd };
+
+    wxString wide;
+    wxCharBuffer utf8Buf(2000);
+    char *utf8 = utf8Buf.data();
+    for ( int n = 0; n < 40; n++ )
+    {
+        for ( int i = 0; i < n; i++ )
+        {
+            const char ch = 'a' + (n + i) % 26;
+            wide += ch;
+            *utf8++ = ch;
+        }
+
+        const wchar_t wch = nonASCII[n % WXSIZEOF(nonASCII)];
+        wide += wch;
+        if ( wch < 0x800 )
+        {
+            *utf8++ = (char)(0xc0 | (wch >> 6));
+        }
+        else
+        {
+            *utf8++ = (char)(0xe0 | (wch >> 12));
+            *utf8++ = (char)(0x80 | ((wch >> 6) & 0x3f));
+        }
+        *utf8++ = (char)(0x80 | (wch & 0x3f));
+    }
+
+    *utf8 = '\0';
+    const size_t utf8Len = utf8 - utf8Buf.data();
+    utf8 = utf8Buf.data();
+
+    CPPUNIT_ASSERT_EQUAL( utf8Len, wide.utf8_str().length() );
+    CPPUNIT_ASSERT( memcmp(utf8, wide.utf8_str().data(), utf8Len) == 0 );
+
+    CPPUNIT_ASSERT( wxString::FromUTF8(utf8) == wide );
+    CPPUNIT_ASSERT( wxString::FromUTF8(utf8, utf8Len) == wide );
+
+    // the conversion must fail if the output buffer is too small, whether it
+    // ends in the middle of an ASCII run or not
+    wxWCharBuffer wbuf(wide.length());
+    for ( size_t len = wide.length() - 20; len < wide.length(); len++ )
+    {
+        CPPUNIT_ASSERT_EQUAL( wxCONV_FAILED,
+                              wxConvUTF8.ToWChar(wbuf.data(), len,
+                                                 utf8, utf8Len) );
+    }
+
+    wxCharBuffer buf(utf8Len);
+    for ( size_t len = utf8Len - 20; len < utf8Len; len++ )
+    {
+        CPPUNIT_ASSERT_EQUAL( wxCONV_FAILED,
+                              wxConvUTF8.FromWChar(buf.data(), len,
+                                                   wide.wc_str(),
+                                                   wide.length()) );
+    }
+
+    // and also if an invalid sequence follows an ASCII run
+    utf8[utf8Len - 1] = 'x';
+    CPPUNIT_ASSERT_EQUAL( wxCONV_FAILED,
+                          wxConvUTF8.ToWChar(NULL, 0, utf8, utf8Len) );
+    utf8[utf8Len - 2] = '\xff';
+    utf8[utf8Len - 1] = '\0';
+    CPPUNIT_ASSERT_EQUAL( wxCONV_FAILED, wxConvUTF8.ToWChar(NULL, 0, utf8) );
+
+    // check that the input with explicit length ending in a non-ASCII
+    // character is not read beyond its end: allocate it separately, without
+    // the trailing NUL, for the memory checkers to detect it if it is
+    static const wchar_t abcE[] = { 'a', 'b', 'c', 0xe9 };
+    wchar_t * const src = new wchar_t[WXSIZEOF(abcE)];
+    memcpy(src, abcE, sizeof(abcE));
+
+    char out[16];
+    CPPUNIT_ASSERT_EQUAL( 5, wxConvUTF8.FromWChar(out, WXSIZEOF(out),
+                                                  src, WXSIZEOF(abcE)) );
+    CPPUNIT_ASSERT( memcmp(out, "abc\xc3\xa9", 5) == 0 );
+    CPPUNIT_ASSERT_EQUAL( 5, wxConvUTF8.FromWChar(NULL, 0,
+                                                  src, WXSIZEOF(abcE)) );
+
+    delete [] src;
+}
+
 void MBConvTestCase::UTF16LETests()
 {
     wxMBConvUTF16LE convUTF16LE;
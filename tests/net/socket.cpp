@@ -11,7 +11,8 @@
     hostname of the server to use for the tests below, if it is not set all
     tests are silently skipped (rationale: this makes it possible to run the
     test in the restricted environments (e.g. sandboxes) without any network
-    connectivity).
+    connectivity). The only exception are the tests using a connection over
+    the loopback interface, which are always run.
  */
 
 // For compilers that support precompilation, includes "wx/wx.h".
@@ -28,10 +29,13 @@
 #include "wx/url.h"
 #include "wx/sstream.h"
 #include "wx/evtloop.h"
+#include "wx/file.h"
+#include "wx/filename.h"
 #include <memory>
 
 typedef std::auto_ptr<wxSockAddress> wxSockAddressPtr;
 typedef std::auto_ptr<wxSocketClient> wxSocketClientPtr;
+typedef std::auto_ptr<wxSocketServer> wxSocketServerPtr;
 
 static wxString gs_serverHost(wxGetenv("WX_TEST_SERVER"));
 
@@ -50,6 +54,9 @@ private:
         CPPUNIT_TEST( ReadBlock ); \
         CPPUNIT_TEST( ReadNowait ); \
         CPPUNIT_TEST( ReadWaitall ); \
+        CPPUNIT_TEST( ReadWriteV ); \
+        CPPUNIT_TEST( ReadWriteMsg ); \
+        CPPUNIT_TEST( SendFile ); \
         CPPUNIT_TEST( UrlTest )
 
     CPPUNIT_TEST_SUITE( SocketTestCase );
@@ -94,6 +101,11 @@ private:
     // disabled
     wxSocketClientPtr GetHTTPSocket(int flags = wxSOCKET_NONE) const;
 
+    // create a server listening on the loopback interface and a client
+    // connected to it, return the server side socket of this connection
+    wxSocketBase *ConnectLoopback(wxSocketServerPtr& server,
+                                  wxSocketClient& client) const;
+
     void PseudoTest_SetUseEventLoop() { ms_useLoop = true; }
 
     void BlockingConnect();
@@ -102,6 +114,9 @@ private:
     void ReadBlock();
     void ReadNowait();
     void ReadWaitall();
+    void ReadWriteV();
+    void ReadWriteMsg();
+    void SendFile();
 
     void UrlTest();
 
@@ -147,6 +162,28 @@ wxSocketClientPtr SocketTestCase::GetHTTPSocket(int flags) const
     return wxSocketClientPtr(sock);
 }
 
+wxSocketBase *SocketTestCase::ConnectLoopback(wxSocketServerPtr& server,
+                                              wxSocketClient& client) const
+{
+    wxIPV4address addr;
+    addr.LocalHost();
+    addr.Service(0);
+
+    server.reset(new wxSocketServer(addr, wxSOCKET_REUSEADDR));
+    CPPUNIT_ASSERT( server->IsOk() );
+    CPPUNIT_ASSERT( server->GetLocal(addr) );
+
+    wxIPV4address peer;
+    peer.LocalHost();
+    peer.Service(addr.Service());
+    CPPUNIT_ASSERT( client.Connect(peer) );
+
+    wxSocketBase * const sock = server->Accept();
+    CPPUNIT_ASSERT( sock );
+
+    return sock;
+}
+
 void SocketTestCase::BlockingConnect()
 {
     wxSockAddressPtr addr = GetServer();
@@ -248,6 +285,156 @@ void SocketTestCase::ReadWaitall()
     CPPUNIT_ASSERT_EQUAL( WXSIZEOF(buf), (size_t)sock->LastReadCount() );
 }
 
+void SocketTestCase::ReadWriteV()
+{
+    SocketTestEventLoop loop(ms_useLoop);
+
+    wxSocketServerPtr server;
+    wxSocketClient client(wxSOCKET_WAITALL);
+    wxSocketBase * const sock = ConnectLoopback(server, client);
+    sock->SetFlags(wxSOCKET_WAITALL);
+
+    char hello[] = "Hello",
+         comma[] = ", ",
+         world[] = "world!";
+    const wxSocketIOVec out[] =
+    {
+        { hello, 5 },
+        { NULL, 0 },
+        { comma, 2 },
+        { world, 6 },
+    };
+
+    client.WriteV(out, WXSIZEOF(out));
+    CPPUNIT_ASSERT_EQUAL( wxSOCKET_NOERROR, client.LastError() );
+    CPPUNIT_ASSERT_EQUAL( 13, (int)client.LastWriteCount() );
+
+    // also check that the data pushed back by Peek() is taken into account
+    char peek[2];
+    sock->Peek(peek, WXSIZEOF(peek));
+    CPPUNIT_ASSERT_EQUAL( 2, (int)sock->LastCount() );
+
+    char buf1[3], buf2[7], buf3[3];
+    const wxSocketIOVec in[] =
+    {
+        { buf1, sizeof(buf1) },
+        { buf2, sizeof(buf2) },
+        { buf3, sizeof(buf3) },
+    };
+
+    sock->ReadV(in, WXSIZEOF(in));
+    CPPUNIT_ASSERT_EQUAL( wxSOCKET_NOERROR, sock->LastError() );
+    CPPUNIT_ASSERT_EQUAL( 13, (int)sock->LastReadCount() );
+    CPPUNIT_ASSERT_EQUAL( wxString("Hel"), wxString(buf1, sizeof(buf1)) );
+    CPPUNIT_ASSERT_EQUAL( wxString("lo, wor"), wxString(buf2, sizeof(buf2)) );
+    CPPUNIT_ASSERT_EQUAL( wxString("ld!"), wxString(buf3, sizeof(buf3)) );
+
+    sock->Destroy();
+}
+
+void SocketTestCase::ReadWriteMsg()
+{
+    SocketTestEventLoop loop(ms_useLoop);
+
+    wxSocketServerPtr server;
+    wxSocketClient client;
+    wxSocketBase * const sock = ConnectLoopback(server, client);
+
+    char out[1000];
+    for ( unsigned n = 0; n < WXSIZEOF(out); n++ )
+        out[n] = (char)n;
+
+    char in[WXSIZEOF(out)];
+
+    client.WriteMsg(out, sizeof(out));
+    CPPUNIT_ASSERT_EQUAL( wxSOCKET_NOERROR, client.LastError() );
+    CPPUNIT_ASSERT_EQUAL( sizeof(out), (size_t)client.LastWriteCount() );
+
+    sock->ReadMsg(in, sizeof(in));
+    CPPUNIT_ASSERT_EQUAL( wxSOCKET_NOERROR, sock->LastError() );
+    CPPUNIT_ASSERT_EQUAL( sizeof(in), (size_t)sock->LastReadCount() );
+    CPPUNIT_ASSERT( memcmp(in, out, sizeof(in)) == 0 );
+
+    // the part of the message not fitting into the buffer must be discarded
+    client.WriteMsg(out, sizeof(out));
+    sock->ReadMsg(in, 100);
+    CPPUNIT_ASSERT_EQUAL( wxSOCKET_NOERROR, sock->LastError() );
+    CPPUNIT_ASSERT_EQUAL( 100, (int)sock->LastReadCount() );
+
+    // and empty messages must work too
+    client.WriteMsg(out, 0);
+    CPPUNIT_ASSERT_EQUAL( wxSOCKET_NOERROR, client.LastError() );
+    sock->ReadMsg(in, sizeof(in));
+    CPPUNIT_ASSERT_EQUAL( wxSOCKET_NOERROR, sock->LastError() );
+    CPPUNIT_ASSERT_EQUAL( 0, (int)sock->LastReadCount() );
+
+    sock->Destroy();
+}
+
+void SocketTestCase::SendFile()
+{
+    SocketTestEventLoop loop(ms_useLoop);
+
+    const wxString filename = wxFileName::CreateTempFileName("socktest");
+    CPPUNIT_ASSERT( !filename.empty() );
+
+    // use a file bigger than the socket buffers to check that partial writes
+    // are handled correctly
+    static const size_t FILE_SIZE = 1024*1024;
+    wxCharBuffer data(FILE_SIZE);
+    for ( size_t n = 0; n < FILE_SIZE; n++ )
+        data.data()[n] = (char)(n ^ (n >> 8));
+
+    {
+        wxFile file(filename, wxFile::write);
+        CPPUNIT_ASSERT( file.IsOpened() );
+        CPPUNIT_ASSERT_EQUAL( FILE_SIZE, file.Write(data, FILE_SIZE) );
+    }
+
+    wxSocketServerPtr server;
+    wxSocketClient client(wxSOCKET_NOWAIT);
+    wxSocketBase * const sock = ConnectLoopback(server, client);
+    sock->SetFlags(wxSOCKET_NOWAIT);
+
+    // start sending from the middle of the file
+    static const size_t OFFSET = 1000;
+    wxFile file(filename);
+    CPPUNIT_ASSERT_EQUAL( (wxFileOffset)OFFSET, file.Seek(OFFSET) );
+
+    wxCharBuffer received(FILE_SIZE - OFFSET);
+    size_t sent = 0,
+           total = 0;
+    while ( total < FILE_SIZE - OFFSET )
+    {
+        if ( sent < FILE_SIZE - OFFSET )
+        {
+            client.SendFile(file, FILE_SIZE - OFFSET - sent);
+            if ( client.LastError() != wxSOCKET_WOULDBLOCK )
+            {
+                CPPUNIT_ASSERT_EQUAL( wxSOCKET_NOERROR, client.LastError() );
+            }
+
+            sent += client.LastWriteCount();
+            CPPUNIT_ASSERT_EQUAL( (wxFileOffset)(OFFSET + sent), file.Tell() );
+        }
+
+        sock->Read(received.data() + total, FILE_SIZE - OFFSET - total);
+        total += sock->LastReadCount();
+    }
+
+    CPPUNIT_ASSERT( memcmp(received, data.data() + OFFSET,
+                           FILE_SIZE - OFFSET) == 0 );
+
+    // trying to send past the end of file is an error
+    client.SendFile(file, 1);
+    CPPUNIT_ASSERT( client.Error() );
+
+    file.Close();
+    wxRemoveFile(filename);
+
+    sock->Destroy();
+}
+
 void SocketTestCase::UrlTest()
 {
     if ( gs_serverHost.empty() )
@@ -82,6 +82,11 @@ public:
         WXTEST_WITH_GZIP_CONDITION(TestStream_GZip_BestComp);
         WXTEST_WITH_GZIP_CONDITION(TestStream_GZip_Dictionary);
         WXTEST_WITH_GZIP_CONDITION(TestStream_ZLibGZip);
+        CPPUNIT_TEST(TestStream_Parallel_NoHeader);
+        CPPUNIT_TEST(TestStream_Parallel_ZLib);
+        WXTEST_WITH_GZIP_CONDITION(TestStream_Parallel_GZip);
+        CPPUNIT_TEST(TestStream_Parallel_Dictionary);
+        CPPUNIT_TEST(TestStream_Parallel_Sync);
         CPPUNIT_TEST(Decompress_BadData);
         CPPUNIT_TEST(Decompress_wx251_zlib114_Data_NoHeader);
         CPPUNIT_TEST(Decompress_wx251_zlib114_Data_ZLib);
@@ -105,6 +110,11 @@ protected:
     void TestStream_GZip_BestComp();
     void TestStream_GZip_Dictionary();
     void TestStream_ZLibGZip();
+    void TestStream_Parallel_NoHeader();
+    void TestStream_Parallel_ZLib();
+    void TestStream_Parallel_GZip();
+    void TestStream_Parallel_Dictionary();
+    void TestStream_Parallel_Sync();
     // Try to decompress bad data.
     void Decompress_BadData();
     // Decompress data that was compress by an external app.
@@ -118,6 +128,7 @@ private:
     const char *GetDataBuffer();
     const unsigned char *GetCompressedData();
     void doTestStreamData(int input_flag, int output_flag, int compress_level, const wxMemoryBuffer *buf = NULL);
+    void doTestParallelStream(int flag, const wxMemoryBuffer *buf = NULL, bool sync = false);
     void doDecompress_ExternalData(const unsigned char *data, const char *value, size_t data_size, size_t value_size, int flag = wxZLIB_AUTO);
 
 private:
@@ -244,6 +255,27 @@ void zlibStream::TestStream_ZLibGZip()
     doTestStreamData(wxZLIB_AUTO, wxZLIB_GZIP, wxZ_DEFAULT_COMPRESSION);
 }
 
+void zlibStream::TestStream_Parallel_NoHeader()
+{
+    doTestParallelStream(wxZLIB_NO_HEADER);
+}
+void zlibStream::TestStream_Parallel_ZLib()
+{
+    doTestParallelStream(wxZLIB_ZLIB);
+}
+void zlibStream::TestStream_Parallel_GZip()
+{
+    doTestParallelStream(wxZLIB_GZIP);
+}
+void zlibStream::TestStream_Parallel_Dictionary()
+{
+    doTestParallelStream(wxZLIB_NO_HEADER, &m_Dictionary);
+}
+void zlibStream::TestStream_Parallel_Sync()
+{
+    doTestParallelStream(wxZLIB_ZLIB, NULL, true);
+}
+
 void zlibStream::Decompress_BadData()
 {
     // Setup the bad data stream and the zlib stream.
@@ -384,6 +416,65 @@ void zlibStream::doTestStreamData(int input_flag, int output_flag, int compress_
     }
 }
 
+void zlibStream::doTestParallelStream(int flag, const wxMemoryBuffer *buf, bool sync)
+{
+    // Use enough data to be split into many blocks, some of which repeat the
+    // data of the previous ones to check that the window is preserved.
+    wxMemoryBuffer data;
+    for (int i = 0; i < 300; i++)
+    {
+        if (i % 3 == 0)
+            data.AppendData(GetDataBuffer(), DATABUFFER_SIZE);
+        for (int j = 0; j < DATABUFFER_SIZE; j++)
+            data.AppendByte((char)((i * j) ^ (j >> 3)));
+    }
+
+    const char * const pdata = static_cast<char *>(data.GetData());
+    const size_t size = data.GetDataLen();
+
+    wxMemoryOutputStream memstream_out;
+    {
+        wxZlibOutputStream zstream_out(memstream_out, wxZ_DEFAULT_COMPRESSION, flag);
+        CPPUNIT_ASSERT(zstream_out.SetThreadCount(4, 10000));
+
+        if (buf)
+            CPPUNIT_ASSERT(zstream_out.SetDictionary(*buf));
+
+        for (size_t pos = 0, len = 1; pos < size; pos += len, len = len * 3 + 1)
+        {
+            if (len > size - pos)
+                len = size - pos;
+
+            CPPUNIT_ASSERT_EQUAL(len, zstream_out.Write(pdata + pos, len).LastWrite());
+
+            if (sync && pos < size / 2 && pos + len >= size / 2)
+                zstream_out.Sync();
+        }
+
+        // It's too late to change the mode now.
+        CPPUNIT_ASSERT(!zstream_out.SetThreadCount(1));
+
+        CPPUNIT_ASSERT(zstream_out.Close());
+        CPPUNIT_ASSERT_EQUAL(size, zstream_out.GetLength());
+    }
+
+    wxMemoryInputStream memstream_in(memstream_out);
+    wxZlibInputStream zstream_in(memstream_in, flag);
+    CPPUNIT_ASSERT(zstream_in.IsOk());
+
+    if (buf)
+        zstream_in.SetDictionary(*buf);
+
+    wxMemoryBuffer result;
+    char chunk[4096];
+    while (zstream_in.Read(chunk, sizeof(chunk)).LastRead() > 0)
+        result.AppendData(chunk, zstream_in.LastRead());
+
+    CPPUNIT_ASSERT(zstream_in.Eof());
+    CPPUNIT_ASSERT_EQUAL(size, result.GetDataLen());
+    CPPUNIT_ASSERT(memcmp(result.GetData(), pdata, size) == 0);
+}
+
 void zlibStream::doDecompress_ExternalData(const unsigned char *data, const char *value, size_t data_size, size_t value_size, int flag)
 {
     // See that the input is ok.
@@ -349,6 +349,10 @@ SOURCE=.\thread\queue.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=.\thread\threadpool.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=.\config\regconf.cpp
 # End Source File
 # Begin Source File
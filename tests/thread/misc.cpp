@@ -194,6 +194,81 @@ private:
 
 WX_DEFINE_ARRAY_PTR(wxThread *, ArrayThreads);
 
+// thread incrementing a counter protected by the given mutex
+class MyIncrementingThread : public wxThread
+{
+public:
+    MyIncrementingThread(wxMutex *mutex, int *counter)
+        : wxThread(wxTHREAD_JOINABLE),
+          m_mutex(mutex),
+          m_counter(counter)
+    {
+        Create();
+    }
+
+    virtual ExitCode Entry()
+    {
+        for ( int n = 0; n < 10000; n++ )
+        {
+            wxMutexLocker lock(*m_mutex);
+            ++*m_counter;
+        }
+
+        return 0;
+    }
+
+private:
+    wxMutex *m_mutex;
+    int *m_counter;
+};
+
+// thread either checking that all the elements of the array protected by the
+// given lock are the same or changing all of them
+class MyRWLockThread : public wxThread
+{
+public:
+    MyRWLockThread(wxRWLock *lock, int *data, size_t count, bool writer)
+        : wxThread(wxTHREAD_JOINABLE),
+          m_lock(lock),
+          m_data(data),
+          m_count(count),
+          m_writer(writer)
+    {
+        Create();
+    }
+
+    virtual ExitCode Entry()
+    {
+        long errors = 0;
+        for ( int n = 0; n < 1000; n++ )
+        {
+            if ( m_writer )
+            {
+                wxWriteLocker lock(*m_lock);
+                for ( size_t i = 0; i < m_count; i++ )
+                    m_data[i] = n;
+            }
+            else
+            {
+                wxReadLocker lock(*m_lock);
+                for ( size_t i = 1; i < m_count; i++ )
+                {
+                    if ( m_data[i] != m_data[0] )
+                        errors++;
+                }
+            }
+        }
+
+        return (ExitCode)errors;
+    }
+
+private:
+    wxRWLock *m_lock;
+    int *m_data;
+    size_t m_count;
+    bool m_writer;
+};
+
 // ----------------------------------------------------------------------------
 // test class
 // ----------------------------------------------------------------------------
@@ -212,11 +287,15 @@ private:
         CPPUNIT_TEST( TestThreadRun );
         CPPUNIT_TEST( TestThreadConditions );
         CPPUNIT_TEST( TestSemaphore );
+        CPPUNIT_TEST( TestAdaptiveMutex );
+        CPPUNIT_TEST( TestRWLock );
     CPPUNIT_TEST_SUITE_END();
 
     void TestJoinable();
     void TestDetached();
     void TestSemaphore();
+    void TestAdaptiveMutex();
+    void TestRWLock();
 
     void TestThreadSuspend();
     void TestThreadDelete();
@@ -290,6 +369,76 @@ void MiscThreadTestCase::TestSemaphore()
     }
 }
 
+void MiscThreadTestCase::TestAdaptiveMutex()
+{
+    wxMutex mutex(wxMUTEX_ADAPTIVE);
+    CPPUNIT_ASSERT( mutex.IsOk() );
+
+    CPPUNIT_ASSERT_EQUAL( wxMUTEX_NO_ERROR, mutex.Lock() );
+    CPPUNIT_ASSERT_EQUAL( wxMUTEX_NO_ERROR, mutex.Unlock() );
+
+    int counter = 0;
+    ArrayThreads threads;
+
+    for ( int i = 0; i < 4; i++ )
+    {
+        threads.Add(new MyIncrementingThread(&mutex, &counter));
+        CPPUNIT_ASSERT_EQUAL( wxTHREAD_NO_ERROR, threads.Last()->Run() );
+    }
+
+    for ( size_t n = 0; n < threads.GetCount(); n++ )
+    {
+        CPPUNIT_ASSERT_EQUAL( 0, (long)threads[n]->Wait() );
+        delete threads[n];
+    }
+
+    CPPUNIT_ASSERT_EQUAL( 40000, counter );
+}
+
+void MiscThreadTestCase::TestRWLock()
+{
+    wxRWLock rwlock;
+    CPPUNIT_ASSERT( rwlock.IsOk() );
+
+    // any number of readers can hold the lock but not a writer
+    CPPUNIT_ASSERT_EQUAL( wxMUTEX_NO_ERROR, rwlock.ReadLock() );
+    CPPUNIT_ASSERT_EQUAL( wxMUTEX_NO_ERROR, rwlock.TryReadLock() );
+    CPPUNIT_ASSERT_EQUAL( wxMUTEX_BUSY, rwlock.TryWriteLock() );
+    CPPUNIT_ASSERT_EQUAL( wxMUTEX_NO_ERROR, rwlock.ReadUnlock() );
+    CPPUNIT_ASSERT_EQUAL( wxMUTEX_NO_ERROR, rwlock.ReadUnlock() );
+
+    // and a writer excludes everybody else
+    CPPUNIT_ASSERT_EQUAL( wxMUTEX_NO_ERROR, rwlock.TryWriteLock() );
+    CPPUNIT_ASSERT_EQUAL( wxMUTEX_BUSY, rwlock.TryReadLock() );
+    CPPUNIT_ASSERT_EQUAL( wxMUTEX_NO_ERROR, rwlock.WriteUnlock() );
+
+    {
+        wxWriteLocker lock(rwlock);
+        CPPUNIT_ASSERT( lock.IsOk() );
+    }
+
+    {
+        wxReadLocker lock(rwlock);
+        CPPUNIT_ASSERT( lock.IsOk() );
+    }
+
+    int data[16] = { 0 };
+    ArrayThreads threads;
+
+    for ( int i = 0; i < 6; i++ )
+    {
+        threads.Add(new MyRWLockThread(&rwlock, data, WXSIZEOF(data),
+                                       i % 3 == 0));
+        CPPUNIT_ASSERT_EQUAL( wxTHREAD_NO_ERROR, threads.Last()->Run() );
+    }
+
+    for ( size_t n = 0; n < threads.GetCount(); n++ )
+    {
+        CPPUNIT_ASSERT_EQUAL( 0, (long)threads[n]->Wait() );
+        delete threads[n];
+    }
+}
+
 void MiscThreadTestCase::TestThreadSuspend()
 {
     MyDetachedThread *thread = new MyDetachedThread(15, 'X');
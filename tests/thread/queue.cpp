@@ -72,13 +72,35 @@ private:
 
     WX_DEFINE_ARRAY_PTR(MyThread *, ArrayThread);
 
+    typedef wxLockFreeMessageQueue<int> LockFreeQueue;
+
+    // This thread posts the numbers from 0 to msgCount-1 to the given queue.
+    class ProducerThread : public wxThread
+    {
+    public:
+        ProducerThread(LockFreeQueue& queue, int msgCount)
+           : wxThread(wxTHREAD_JOINABLE),
+             m_queue(queue), m_msgCount(msgCount)
+        {}
+
+        virtual void *Entry();
+
+    private:
+        LockFreeQueue& m_queue;
+        const int      m_msgCount;
+    };
+
     CPPUNIT_TEST_SUITE( QueueTestCase );
         CPPUNIT_TEST( TestReceive );
         CPPUNIT_TEST( TestReceiveTimeout );
+        CPPUNIT_TEST( TestLockFreeReceive );
+        CPPUNIT_TEST( TestLockFreeReceiveTimeout );
     CPPUNIT_TEST_SUITE_END();
 
     void TestReceive();
     void TestReceiveTimeout();
+    void TestLockFreeReceive();
+    void TestLockFreeReceiveTimeout();
 
     DECLARE_NO_COPY_CLASS(QueueTestCase)
 };
@@ -212,3 +234,69 @@ void *QueueTestCase::MyThread::Entry()
 
     return (wxThread::ExitCode)wxMSGQUEUE_NO_ERROR;
 }
+
+// this function creates a thread posting messages to a small lock-free queue,
+// so that it often has to wait for the free space in it, and checks that all
+// the messages are received in the order of posting
+void QueueTestCase::TestLockFreeReceive()
+{
+    const int msgCount = 100000;
+
+    LockFreeQueue queue(16);
+    CPPUNIT_ASSERT( queue.IsOk() );
+
+    ProducerThread thread(queue, msgCount);
+    CPPUNIT_ASSERT_EQUAL ( thread.Create(), wxTHREAD_NO_ERROR );
+    thread.Run();
+
+    for ( int i = 0; i < msgCount; ++i )
+    {
+        int msg = -1;
+
+        // use both functions to check that they can be mixed
+        if ( i % 2 )
+            CPPUNIT_ASSERT_EQUAL( wxMSGQUEUE_NO_ERROR, queue.Receive(msg) );
+        else
+            CPPUNIT_ASSERT_EQUAL( wxMSGQUEUE_NO_ERROR,
+                                  queue.ReceiveTimeout(1000, msg) );
+
+        CPPUNIT_ASSERT_EQUAL( i, msg );
+    }
+
+    wxThread::ExitCode code = thread.Wait();
+    CPPUNIT_ASSERT_EQUAL( code, (wxThread::ExitCode)wxMSGQUEUE_NO_ERROR );
+
+    int msg;
+    CPPUNIT_ASSERT_EQUAL( wxMSGQUEUE_TIMEOUT, queue.ReceiveTimeout(0, msg) );
+}
+
+void QueueTestCase::TestLockFreeReceiveTimeout()
+{
+    LockFreeQueue queue;
+
+    int msg = -1;
+    CPPUNIT_ASSERT_EQUAL( wxMSGQUEUE_TIMEOUT, queue.ReceiveTimeout(10, msg) );
+
+    CPPUNIT_ASSERT_EQUAL( wxMSGQUEUE_NO_ERROR, queue.Post(17) );
+    CPPUNIT_ASSERT_EQUAL( wxMSGQUEUE_NO_ERROR, queue.ReceiveTimeout(10, msg) );
+    CPPUNIT_ASSERT_EQUAL( 17, msg );
+
+    CPPUNIT_ASSERT_EQUAL( wxMSGQUEUE_TIMEOUT, queue.ReceiveTimeout(0, msg) );
+
+    // check that the queue still works after timing out
+    CPPUNIT_ASSERT_EQUAL( wxMSGQUEUE_NO_ERROR, queue.Post(18) );
+    CPPUNIT_ASSERT_EQUAL( wxMSGQUEUE_NO_ERROR, queue.Receive(msg) );
+    CPPUNIT_ASSERT_EQUAL( 18, msg );
+}
+
+void *QueueTestCase::ProducerThread::Entry()
+{
+    for ( int i = 0; i < m_msgCount; ++i )
+    {
+        wxMessageQueueError res = m_queue.Post(i);
+        if ( res != wxMSGQUEUE_NO_ERROR )
+            return (wxThread::ExitCode)res;
+    }
+
+    return (wxThread::ExitCode)wxMSGQUEUE_NO_ERROR;
+}
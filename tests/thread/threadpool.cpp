@@ -0,0 +1,296 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        tests/thread/threadpool.cpp
+// Purpose:     Unit test for wxThreadPool and wxTask
+// Author:      wxWidgets team
+// Created:     2026-10-18
+// Copyright:   (c) 2026 wxWidgets team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+// ----------------------------------------------------------------------------
+// headers
+// ----------------------------------------------------------------------------
+
+#include "testprec.h"
+
+#ifdef __BORLANDC__
+    #pragma hdrstop
+#endif
+
+#ifndef WX_PRECOMP
+    #include "wx/app.h"
+    #include "wx/event.h"
+    #include "wx/thread.h"
+#endif // WX_PRECOMP
+
+#include "wx/threadpool.h"
+
+// ----------------------------------------------------------------------------
+// helper tasks
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+// task computing the sum of the numbers in the given range
+class SumTask : public wxTask
+{
+public:
+    SumTask(int from, int to) : m_from(from), m_to(to), m_sum(0) { }
+
+    long GetSum() const { return m_sum; }
+
+protected:
+    virtual void Run()
+    {
+        for ( int n = m_from; n < m_to; n++ )
+            m_sum += n;
+    }
+
+private:
+    const int m_from,
+              m_to;
+    long m_sum;
+};
+
+// task computing the same sum by recursively splitting the range in two
+// halves and submitting the tasks for them to the same pool
+class SplitSumTask : public wxTask
+{
+public:
+    SplitSumTask(wxThreadPool& pool, int from, int to)
+        : m_pool(pool), m_from(from), m_to(to), m_sum(0)
+    {
+    }
+
+    long GetSum() const { return m_sum; }
+
+protected:
+    virtual void Run()
+    {
+        if ( m_to - m_from < 100 )
+        {
+            for ( int n = m_from; n < m_to; n++ )
+                m_sum += n;
+            return;
+        }
+
+        const int middle = (m_from + m_to) / 2;
+
+        wxObjectDataPtr<SplitSumTask>
+            left = m_pool.Submit(new SplitSumTask(m_pool, m_from, middle)),
+            right = m_pool.Submit(new SplitSumTask(m_pool, middle, m_to));
+
+        left->Wait();
+        right->Wait();
+
+        m_sum = left->GetSum() + right->GetSum();
+    }
+
+private:
+    wxThreadPool& m_pool;
+    const int m_from,
+              m_to;
+    long m_sum;
+};
+
+// task blocking until it is cancelled or until another task is done
+class BlockingTask : public wxTask
+{
+public:
+    BlockingTask(const wxTask *other = NULL)
+        : m_other(other), m_started(false)
+    {
+    }
+
+    bool HasStarted() const
+    {
+        wxCriticalSectionLocker lock(m_cs);
+        return m_started;
+    }
+
+protected:
+    virtual void Run()
+    {
+        {
+            wxCriticalSectionLocker lock(m_cs);
+            m_started = true;
+        }
+
+        while ( !IsCancelled() && !(m_other && m_other->IsDone()) )
+            wxMilliSleep(1);
+    }
+
+private:
+    const wxTask * const m_other;
+
+    mutable wxCriticalSection m_cs;
+    bool m_started;
+};
+
+// blocking task remembering whether OnCompleted() was called
+class NotifyingTask : public BlockingTask
+{
+public:
+    NotifyingTask() : m_completed(false) { }
+
+    bool WasCompleted() const { return m_completed; }
+
+protected:
+    virtual void OnCompleted() { m_completed = true; }
+
+private:
+    // only used in the main thread, so doesn't need to be protected
+    bool m_completed;
+};
+
+} // anonymous namespace
+
+// ----------------------------------------------------------------------------
+// test class
+// ----------------------------------------------------------------------------
+
+class ThreadPoolTestCase : public CppUnit::TestCase
+{
+public:
+    ThreadPoolTestCase() { }
+
+private:
+    CPPUNIT_TEST_SUITE( ThreadPoolTestCase );
+        CPPUNIT_TEST( Submit );
+        CPPUNIT_TEST( Nested );
+        CPPUNIT_TEST( Cancel );
+        CPPUNIT_TEST( Destroy );
+        CPPUNIT_TEST( DestroyHandler );
+    CPPUNIT_TEST_SUITE_END();
+
+    void Submit();
+    void Nested();
+    void Cancel();
+    void Destroy();
+    void DestroyHandler();
+
+    DECLARE_NO_COPY_CLASS(ThreadPoolTestCase)
+};
+
+// register in the unnamed registry so that these tests are run by default
+CPPUNIT_TEST_SUITE_REGISTRATION( ThreadPoolTestCase );
+
+// also include in its own registry so that these tests can be run alone
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( ThreadPoolTestCase, "ThreadPoolTestCase" );
+
+void ThreadPoolTestCase::Submit()
+{
+    wxThreadPool pool(4);
+    CPPUNIT_ASSERT_EQUAL( 4, pool.GetThreadCount() );
+
+    wxVector< wxObjectDataPtr<SumTask> > tasks;
+    for ( int n = 0; n < 100; n++ )
+        tasks.push_back(pool.Submit(new SumTask(0, n)));
+
+    // wait for one of the tasks only
+    tasks[50]->Wait();
+    CPPUNIT_ASSERT( tasks[50]->IsDone() );
+    CPPUNIT_ASSERT_EQUAL( 1225L, tasks[50]->GetSum() );
+
+    pool.WaitAll();
+
+    for ( int n = 0; n < 100; n++ )
+    {
+        CPPUNIT_ASSERT( tasks[n]->IsDone() );
+        CPPUNIT_ASSERT( !tasks[n]->IsCancelled() );
+        CPPUNIT_ASSERT_EQUAL( (long)n*(n - 1)/2, tasks[n]->GetSum() );
+    }
+
+    CPPUNIT_ASSERT( wxThreadPool::Get().GetThreadCount() > 0 );
+}
+
+void ThreadPoolTestCase::Nested()
+{
+    // use fewer threads than the number of the tasks waiting for other tasks
+    // to check that they don't deadlock
+    wxThreadPool pool(2);
+
+    wxObjectDataPtr<SplitSumTask>
+        task = pool.Submit(new SplitSumTask(pool, 0, 10000));
+
+    task->Wait();
+    CPPUNIT_ASSERT_EQUAL( 49995000L, task->GetSum() );
+}
+
+void ThreadPoolTestCase::Cancel()
+{
+    wxThreadPool pool(1);
+
+    wxObjectDataPtr<BlockingTask> blocking = pool.Submit(new BlockingTask);
+    wxObjectDataPtr<SumTask> queued = pool.Submit(new SumTask(0, 10));
+
+    while ( !blocking->HasStarted() )
+        wxMilliSleep(1);
+
+    // the second task can't start as long as the first one is running, so
+    // cancelling it must prevent it from running at all
+    queued->Cancel();
+    CPPUNIT_ASSERT( queued->IsCancelled() );
+    CPPUNIT_ASSERT( queued->IsDone() );
+
+    CPPUNIT_ASSERT( !blocking->IsDone() );
+    blocking->Cancel();
+    blocking->Wait();
+
+    pool.WaitAll();
+    CPPUNIT_ASSERT_EQUAL( 0L, queued->GetSum() );
+}
+
+void ThreadPoolTestCase::Destroy()
+{
+    wxObjectDataPtr<BlockingTask> blocking;
+    wxObjectDataPtr<SumTask> queued;
+
+    {
+        wxThreadPool pool(1);
+
+        // the running task terminates only when the queued one is cancelled
+        // by the pool dtor, which then waits for it to finish
+        SumTask * const task = new SumTask(0, 10);
+        blocking = pool.Submit(new BlockingTask(task));
+        queued = pool.Submit(task);
+
+        while ( !blocking->HasStarted() )
+            wxMilliSleep(1);
+    }
+
+    CPPUNIT_ASSERT( blocking->IsDone() );
+    CPPUNIT_ASSERT( queued->IsDone() );
+    CPPUNIT_ASSERT( queued->IsCancelled() );
+    CPPUNIT_ASSERT_EQUAL( 0L, queued->GetSum() );
+}
+
+void ThreadPoolTestCase::DestroyHandler()
+{
+    wxThreadPool pool(1);
+
+    wxEvtHandler * const handler = new wxEvtHandler;
+    wxEvtHandler handlerAlive;
+
+    wxObjectDataPtr<NotifyingTask>
+        running = pool.Submit(new NotifyingTask, handler),
+        notified = pool.Submit(new NotifyingTask, &handlerAlive);
+
+    while ( !running->HasStarted() )
+        wxMilliSleep(1);
+
+    // destroying the handler while the task is running must be safe
+    delete handler;
+
+    running->Cancel();
+    running->Wait();
+
+    notified->Cancel();
+    notified->Wait();
+
+    wxTheApp->ProcessPendingEvents();
+
+    CPPUNIT_ASSERT( !running->WasCompleted() );
+    CPPUNIT_ASSERT( notified->WasCompleted() );
+}
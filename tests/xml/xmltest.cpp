@@ -59,6 +59,51 @@ void CheckXml(const wxXmlNode *n, ...)
     CPPUNIT_ASSERT( child == NULL ); // no more children
 }
 
+// reader recording everything it gets in a string
+class LogReader : public wxXmlReader
+{
+public:
+    LogReader() : stopDepth(-1) { }
+
+    virtual void OnStartElement(const char *name,
+                                const wxXmlAttributesView& attrs)
+    {
+        log << '<' << name << GetDepth();
+        for ( size_t n = 0; n < attrs.GetCount(); n++ )
+            log << ' ' << attrs.GetName(n) << '=' << attrs.GetValue(n);
+        log << '>';
+
+        if ( GetDepth() == stopDepth )
+            Stop();
+    }
+
+    virtual void OnEndElement(const char *name)
+    {
+        log << "</" << name << '>';
+    }
+
+    virtual void OnText(const char *text, size_t len)
+    {
+        log << wxString::FromUTF8(text, len);
+    }
+
+    virtual void OnStartCData() { log << '{'; }
+    virtual void OnEndCData() { log << '}'; }
+
+    virtual void OnComment(const char *text)
+    {
+        log << '!' << text;
+    }
+
+    virtual void OnProcessingInstruction(const char *target, const char *data)
+    {
+        log << '?' << target << ' ' << data;
+    }
+
+    wxString log;
+    int stopDepth;
+};
+
 } // anon namespace
 
 // ----------------------------------------------------------------------------
@@ -82,6 +127,8 @@ private:
         CPPUNIT_TEST( AppendToProlog );
         CPPUNIT_TEST( SetRoot );
         CPPUNIT_TEST( CopyNode );
+        CPPUNIT_TEST( Reader );
+        CPPUNIT_TEST( LoadArena );
     CPPUNIT_TEST_SUITE_END();
 
     void InsertChild();
@@ -94,6 +141,8 @@ private:
     void AppendToProlog();
     void SetRoot();
     void CopyNode();
+    void Reader();
+    void LoadArena();
 
     DECLARE_NO_COPY_CLASS(XmlTestCase)
 };
@@ -507,3 +556,94 @@ void XmlTestCase::CopyNode()
     ;
     CPPUNIT_ASSERT_EQUAL( xmlTextResult, sos.GetString() );
 }
+
+void XmlTestCase::Reader()
+{
+    const char *xmlText =
+"<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+"<root a=\"1\" b=\"x &amp; y\"><?pi data?><!--note-->"
+"<e>text<![CDATA[<raw>]]></e><e id=\"2\"/></root>\n"
+    ;
+
+    LogReader reader;
+    wxStringInputStream sis(xmlText);
+    CPPUNIT_ASSERT( reader.Parse(sis) );
+    CPPUNIT_ASSERT( !reader.WasStopped() );
+    CPPUNIT_ASSERT_EQUAL
+    (
+        "<root1 a=1 b=x & y>?pi data!note<e2>text{<raw>}</e><e2 id=2></e></root>",
+        reader.log
+    );
+
+    // check that parsing can be stopped
+    LogReader stopReader;
+    stopReader.stopDepth = 2;
+    wxStringInputStream sis2(xmlText);
+    CPPUNIT_ASSERT( stopReader.Parse(sis2) );
+    CPPUNIT_ASSERT( stopReader.WasStopped() );
+    CPPUNIT_ASSERT_EQUAL( "<root1 a=1 b=x & y>?pi data!note<e2>", stopReader.log );
+
+    // and that errors are reported
+    LogReader badReader;
+    wxStringInputStream sis3("<a><b></a>");
+    {
+        wxLogNull noLog;
+        CPPUNIT_ASSERT( !badReader.Parse(sis3) );
+    }
+
+    // check the attributes access functions
+    const char *atts[] = { "id", "7", "name", "foo", NULL };
+    wxXmlAttributesView attrs(atts);
+    CPPUNIT_ASSERT_EQUAL( 2, attrs.GetCount() );
+    CPPUNIT_ASSERT_EQUAL( std::string("foo"), attrs.FindUTF8("name") );
+    CPPUNIT_ASSERT( !attrs.FindUTF8("nosuch") );
+
+    wxString value;
+    CPPUNIT_ASSERT( attrs.GetAttribute("id", &value) );
+    CPPUNIT_ASSERT_EQUAL( "7", value );
+    CPPUNIT_ASSERT( !attrs.HasAttribute("nosuch") );
+}
+
+void XmlTestCase::LoadArena()
+{
+    const char *xmlText =
+"<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+"<root a=\"1\" b=\"2\">\n"
+"  <item id=\"1\">first</item>\n"
+"  <!--comment-->\n"
+"  <item id=\"2\"><![CDATA[second]]></item>\n"
+"  <text text=\"text\">text</text>\n"
+"</root>\n"
+    ;
+
+    wxXmlDocument doc;
+    wxStringInputStream sis(xmlText);
+    CPPUNIT_ASSERT( doc.Load(sis) );
+
+    wxStringOutputStream sos;
+    CPPUNIT_ASSERT( doc.Save(sos) );
+
+    // the document loaded using the arena must be the same
+    wxScopedPtr<wxXmlDocument> docArena(new wxXmlDocument);
+    wxStringInputStream sisArena(xmlText);
+    CPPUNIT_ASSERT( docArena->Load(sisArena, "UTF-8", wxXMLDOC_USE_ARENA) );
+
+    wxStringOutputStream sosArena;
+    CPPUNIT_ASSERT( docArena->Save(sosArena) );
+    CPPUNIT_ASSERT_EQUAL( sos.GetString(), sosArena.GetString() );
+
+    // and its nodes must remain usable after it is destroyed
+    wxScopedPtr<wxXmlNode> root(docArena->DetachRoot());
+    docArena.reset();
+
+    wxXmlNode * const item = root->GetChildren();
+    CPPUNIT_ASSERT( item );
+    CPPUNIT_ASSERT( root->RemoveChild(item) );
+    delete item;
+
+    root->AddAttribute("c", "3");
+    CPPUNIT_ASSERT( root->DeleteAttribute("a") );
+    CPPUNIT_ASSERT_EQUAL( "2", root->GetAttribute("b") );
+    CPPUNIT_ASSERT_EQUAL( "3", root->GetAttribute("c") );
+    CPPUNIT_ASSERT_EQUAL( "comment", root->GetChildren()->GetName() );
+}